@@ -116,6 +116,7 @@ class Data;
 class Date;
 class DeclaredAccessorDescriptor;
 class External;
+class ExtensionConfiguration;
 class Function;
 class FunctionTemplate;
 class HeapProfiler;
@@ -967,7 +968,9 @@ class V8EXPORT Script {
    * \param origin Script origin, owned by caller, no references are kept
    *   when New() returns
    * \param pre_data Pre-parsing data, as obtained by ScriptData::PreCompile()
-   *   using pre_data speeds compilation if it's done multiple times.
+   *   or Script::CreateCodeCache(), using pre_data speeds compilation if it's
+   *   done multiple times. A code cache that does not match the source or
+   *   the V8 version and flags is ignored.
    *   Owned by caller, no references are kept when New() returns.
    * \param script_data Arbitrary data associated with script. Using
    *   this has same effect as calling SetData(), but allows data to be
@@ -1000,7 +1003,9 @@ class V8EXPORT Script {
    * \param origin Script origin, owned by caller, no references are kept
    *   when Compile() returns
    * \param pre_data Pre-parsing data, as obtained by ScriptData::PreCompile()
-   *   using pre_data speeds compilation if it's done multiple times.
+   *   or Script::CreateCodeCache(), using pre_data speeds compilation if it's
+   *   done multiple times. A code cache that does not match the source or
+   *   the V8 version and flags is ignored.
    *   Owned by caller, no references are kept when Compile() returns.
    * \param script_data Arbitrary data associated with script. Using
    *   this has same effect as calling SetData(), but makes data available
@@ -1045,6 +1050,21 @@ class V8EXPORT Script {
    */
   Local<Value> Id();
 
+  /**
+   * Creates a code cache for this script, to be passed as pre_data when the
+   * same source is compiled again, e.g. in the next run of the embedder.
+   * Besides the pre-parsing data it records which functions of the script
+   * have been compiled so far; compiling with the cache compiles those
+   * together with the script instead of on their first call.
+   * The cache can be stored using ScriptData::Data() and restored with
+   * ScriptData::New(). It is platform-dependent and only valid for the same
+   * source, V8 version and flags.
+   *
+   * \return The code cache, owned by the caller, or NULL if none could be
+   *   created.
+   */
+  ScriptData* CreateCodeCache();
+
   /**
    * Associate an additional data object with the script. This is mainly used
    * with the debugger as this data object is only available through the
@@ -2337,6 +2357,20 @@ class V8EXPORT Function : public Object {
   int GetScriptColumnNumber() const;
   Handle<Value> GetScriptId() const;
   ScriptOrigin GetScriptOrigin() const;
+
+  /**
+   * Returns an object summarizing the inline cache states of the function,
+   * suitable for JSON serialization. It holds the number of inline cache
+   * sites per state ("uninitialized", "premonomorphic", "monomorphic",
+   * "polymorphic", "megamorphic" and "generic"), the number of distinct
+   * receiver maps seen ("maps"), the source positions of megamorphic and
+   * generic sites ("megamorphicPositions"), and the optimization and
+   * deoptimization counts ("optCount", "deoptCount"). Computing the summary
+   * only inspects the function's unoptimized code, so it is cheap enough to
+   * be sampled in production.
+   */
+  Local<Object> GetInlineCacheSummary() const;
+
   V8_INLINE(static Function* Cast(Value* obj));
   static const int kLineOffsetNotFound;
 
@@ -3787,6 +3821,29 @@ typedef void (*GCEpilogueCallback)(GCType type, GCCallbackFlags flags);
 
 typedef void (*GCCallback)();
 
+/**
+ * What V8 does after an isolate's heap outgrew its soft limit.
+ */
+enum SoftHeapLimitAction {
+  /** Continue with the soft limit the callback stored. */
+  kSoftHeapLimitRaise,
+  /** Terminate the JavaScript running in the isolate. */
+  kSoftHeapLimitTerminate,
+  /** Release as much memory as possible, see Isolate::ReduceMemory. */
+  kSoftHeapLimitReduceMemory
+};
+
+/**
+ * Called after a garbage collection left more objects in the heap than the
+ * soft limit allows.  used_heap_size is the size of those objects,
+ * *soft_heap_limit the current limit, which the callback may change before
+ * returning kSoftHeapLimitRaise.  The callback is not invoked again while
+ * it is running.
+ */
+typedef SoftHeapLimitAction (*SoftHeapLimitCallback)(Isolate* isolate,
+                                                     size_t used_heap_size,
+                                                     size_t* soft_heap_limit);
+
 
 /**
  * Collection of V8 heap information.
@@ -3815,6 +3872,71 @@ class V8EXPORT HeapStatistics {
 };
 
 
+/**
+ * Estimated durations of garbage collection work, derived from the speed
+ * of recent collections.
+ *
+ * Instances of this class can be passed to v8::Isolate::GetGCTimeEstimates
+ * to decide how much idle time to announce with
+ * v8::Isolate::IdleNotification.
+ */
+class V8EXPORT GCTimeEstimates {
+ public:
+  GCTimeEstimates();
+  /** Time a scavenge of the young generation would take now. */
+  double scavenge_time_in_ms() { return scavenge_time_in_ms_; }
+  /** Total time of all steps needed to mark the heap incrementally. */
+  double incremental_marking_time_in_ms() {
+    return incremental_marking_time_in_ms_;
+  }
+  /** Time of the pause that finishes incremental marking. */
+  double finalization_time_in_ms() { return finalization_time_in_ms_; }
+  /** Time a non-incremental mark-compact of the heap would take. */
+  double full_gc_time_in_ms() { return full_gc_time_in_ms_; }
+  /** Number of bytes an incremental marking step processes per ms. */
+  size_t incremental_marking_speed() { return incremental_marking_speed_; }
+
+ private:
+  double scavenge_time_in_ms_;
+  double incremental_marking_time_in_ms_;
+  double finalization_time_in_ms_;
+  double full_gc_time_in_ms_;
+  size_t incremental_marking_speed_;
+
+  friend class Isolate;
+};
+
+
+/**
+ * Size and usage of one space of the V8 heap.
+ *
+ * Instances of this class can be passed to
+ * v8::Isolate::GetHeapSpaceStatistics.
+ */
+class V8EXPORT HeapSpaceStatistics {
+ public:
+  HeapSpaceStatistics();
+  const char* space_name() { return space_name_; }
+  /** Memory committed for the space. */
+  size_t space_size() { return space_size_; }
+  /** Size of the live and not yet collected objects in the space. */
+  size_t space_used_size() { return space_used_size_; }
+  /** Memory the space can allocate without growing. */
+  size_t space_available_size() { return space_available_size_; }
+  /** Resident part of the committed memory. */
+  size_t physical_space_size() { return physical_space_size_; }
+
+ private:
+  const char* space_name_;
+  size_t space_size_;
+  size_t space_used_size_;
+  size_t space_available_size_;
+  size_t physical_space_size_;
+
+  friend class Isolate;
+};
+
+
 class RetainedObjectInfo;
 
 /**
@@ -3906,6 +4028,56 @@ class V8EXPORT Isolate {
    */
   void GetHeapStatistics(HeapStatistics* heap_statistics);
 
+  /**
+   * Returns the number of spaces in the heap.
+   */
+  size_t NumberOfHeapSpaces();
+
+  /**
+   * Get the statistics of the heap space with the given index, which must
+   * be below NumberOfHeapSpaces().  Returns false if the isolate is not
+   * initialized or the index is out of range.
+   */
+  bool GetHeapSpaceStatistics(HeapSpaceStatistics* space_statistics,
+                              size_t index);
+
+  /**
+   * Sets a soft limit on the size of the objects in this isolate's heap.
+   * After a garbage collection that left more objects in the heap, V8 calls
+   * the callback, which decides whether to raise the limit, terminate the
+   * running JavaScript or release memory.  The soft limit should be below
+   * the hard limit set with ResourceConstraints; exceeding the hard limit is
+   * a fatal out of memory error.  A NULL callback removes the soft limit.
+   */
+  void SetSoftHeapLimit(size_t limit_in_bytes,
+                        SoftHeapLimitCallback callback);
+
+  /**
+   * Get the estimated durations of garbage collection work.
+   */
+  void GetGCTimeEstimates(GCTimeEstimates* estimates);
+
+  /**
+   * Optional notification that the embedder is idle for the given number of
+   * milliseconds, e.g. until the next request is expected.  V8 performs only
+   * the garbage collection work it estimates to finish within that time.
+   * This call can be used repeatedly while the embedder remains idle.
+   * Returns true if the embedder should stop calling IdleNotification
+   * until real work has been done.
+   */
+  bool IdleNotification(int idle_time_in_ms);
+
+  /**
+   * Returns as much memory as possible to the operating system, e.g. when
+   * the embedder knows the isolate will stay inactive for a while.  This
+   * performs a full garbage collection that compacts all fragmented pages,
+   * releases empty pages and shrinks the young generation to its initial
+   * size.  IdleNotification does the same on its own once the isolate was
+   * inactive for --memory-reducer-delay ms.  Returns the number of bytes
+   * released.
+   */
+  size_t ReduceMemory();
+
   /**
    * Adjusts the amount of registered external memory. Used to give V8 an
    * indication of the amount of externally allocated memory that is kept alive
@@ -4247,6 +4419,53 @@ class V8EXPORT V8 {
   static void GetCompressedStartupData(StartupData* compressed_data);
   static void SetDecompressedStartupData(StartupData* decompressed_data);
 
+  /**
+   * Creates a startup snapshot that contains, besides the built-in natives,
+   * the state left behind by running the given script in a new context with
+   * the given extensions. Isolates that start from the snapshot, see
+   * SetSnapshotDataBlob(), get that state in every context they create
+   * without running the script again.
+   *
+   * Native functions of extensions, and any other objects that refer to C++
+   * callbacks, can only be serialized if the callbacks have been registered
+   * with SetEmbedderExternalReferences(). Such callbacks must be
+   * FunctionCallbacks; the deprecated InvocationCallback signature is not
+   * supported in snapshots.
+   *
+   * This must be called before V8 is initialized. All code generated in the
+   * process afterwards is restricted to what can be serialized, so this is
+   * meant for a build step that writes the blob to a file and exits.
+   *
+   * \param embedded_source The script to run, or NULL.
+   * \param extensions The extensions to install in the context, or NULL.
+   * \return The snapshot, allocated with new[] and owned by the caller.
+   *   Its data is NULL if the script threw an exception.
+   */
+  static StartupData CreateSnapshotDataBlob(
+      const char* embedded_source = NULL,
+      ExtensionConfiguration* extensions = NULL);
+
+  /**
+   * Makes V8 initialize isolates from the given startup snapshot, as created
+   * by CreateSnapshotDataBlob(), instead of from the snapshot built into V8.
+   * This must be called before V8 is initialized, and the data must stay
+   * valid until V8 is disposed.
+   *
+   * \return false if the blob is malformed or was created by a different
+   *   version of V8 or for a different architecture.
+   */
+  static bool SetSnapshotDataBlob(StartupData* snapshot_blob);
+
+  /**
+   * Registers the addresses of the embedder's C++ functions, such as the
+   * callbacks of function templates and accessors, that may be referenced
+   * from a snapshot. The array is terminated by 0 and must list the same
+   * functions in the same order in the process creating the snapshot and in
+   * the processes using it. It must stay valid until V8 is disposed, and be
+   * registered before V8 is initialized.
+   */
+  static void SetEmbedderExternalReferences(const intptr_t* references);
+
   /**
    * Adds a message listener.
    *
@@ -5318,7 +5537,7 @@ class Internals {
   static const int kNodeIsIndependentShift = 4;
   static const int kNodeIsPartiallyDependentShift = 5;
 
-  static const int kJSObjectType = 0xb0;
+  static const int kJSObjectType = 0xb1;
   static const int kFirstNonstringType = 0x80;
   static const int kOddballType = 0x83;
   static const int kForeignType = 0x88;
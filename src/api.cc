@@ -44,10 +44,9 @@
 #include "global-handles.h"
 #include "heap-profiler.h"
 #include "heap-snapshot-generator-inl.h"
+#include "ic.h"
 #include "messages.h"
-#ifdef COMPRESS_STARTUP_DATA_BZ2
 #include "natives.h"
-#endif
 #include "parser.h"
 #include "platform.h"
 #include "profile-generator-inl.h"
@@ -56,6 +55,8 @@
 #include "runtime.h"
 #include "runtime-profiler.h"
 #include "scanner-character-streams.h"
+#include "script-code-cache.h"
+#include "serialize.h"
 #include "snapshot.h"
 #include "unicode-inl.h"
 #include "v8threads.h"
@@ -461,6 +462,67 @@ void V8::SetDecompressedStartupData(StartupData* decompressed_data) {
 }
 
 
+StartupData V8::CreateSnapshotDataBlob(const char* embedded_source,
+                                       ExtensionConfiguration* extensions) {
+  StartupData result = { NULL, 0, 0 };
+  i::Serializer::Enable();
+  Isolate* isolate = Isolate::GetCurrent();
+  i::Isolate* internal_isolate = reinterpret_cast<i::Isolate*>(isolate);
+  i::Object* raw_context;
+  {
+    Persistent<Context> context;
+    {
+      HandleScope handle_scope(isolate);
+      context.Reset(isolate, Context::New(isolate, extensions));
+    }
+    if (context.IsEmpty()) return result;
+    if (embedded_source != NULL) {
+      HandleScope handle_scope(isolate);
+      Context::Scope context_scope(Local<Context>::New(isolate, context));
+      TryCatch try_catch;
+      Local<Script> script = Script::Compile(String::New(embedded_source));
+      if (script.IsEmpty() || script->Run().IsEmpty()) {
+        context.Dispose(isolate);
+        return result;
+      }
+    }
+    // Make sure all builtin scripts are cached.
+    { i::HandleScope scope(internal_isolate);
+      for (int i = 0; i < i::Natives::GetBuiltinsCount(); i++) {
+        internal_isolate->bootstrapper()->NativesSourceLookup(i);
+      }
+    }
+    i::Serializer::ResetCompiledFunctions();
+    // If we don't do this then we end up with a stray root pointing at the
+    // context even after we have disposed of it.
+    internal_isolate->heap()->CollectAllGarbage(
+        i::Heap::kNoGCFlags, "V8::CreateSnapshotDataBlob");
+    raw_context = *Utils::OpenPersistent(context);
+    context.Dispose(isolate);
+  }
+  i::Vector<i::byte> blob = i::Snapshot::CreateBlob(raw_context);
+  char* data = new char[blob.length()];
+  i::OS::MemCopy(data, blob.start(), blob.length());
+  result.data = data;
+  result.compressed_size = blob.length();
+  result.raw_size = blob.length();
+  blob.Dispose();
+  return result;
+}
+
+
+bool V8::SetSnapshotDataBlob(StartupData* snapshot_blob) {
+  return i::Snapshot::SetBlob(
+      reinterpret_cast<const i::byte*>(snapshot_blob->data),
+      snapshot_blob->raw_size);
+}
+
+
+void V8::SetEmbedderExternalReferences(const intptr_t* references) {
+  i::ExternalReferenceTable::SetEmbedderReferences(references);
+}
+
+
 void V8::SetFatalErrorHandler(FatalErrorCallback that) {
   i::Isolate* isolate = EnterIsolateIfNeeded();
   isolate->set_exception_behavior(that);
@@ -1878,6 +1940,13 @@ Local<Script> Script::New(v8::Handle<String> source,
     EXCEPTION_PREAMBLE(isolate);
     i::ScriptDataImpl* pre_data_impl =
         static_cast<i::ScriptDataImpl*>(pre_data);
+    // A code cache that does not match the source or the configuration is
+    // ignored, like pre-data that isn't sane.
+    i::ScriptDataImpl* code_cache_impl = NULL;
+    if (pre_data != NULL && i::ScriptCodeCache::IsCodeCache(pre_data)) {
+      code_cache_impl = i::ScriptCodeCache::Consume(str, pre_data);
+      pre_data_impl = code_cache_impl;
+    }
     // We assert that the pre-data is sane, even though we can actually
     // handle it if it turns out not to be in release mode.
     ASSERT(pre_data_impl == NULL || pre_data_impl->SanityCheck());
@@ -1895,6 +1964,7 @@ Local<Script> Script::New(v8::Handle<String> source,
                            pre_data_impl,
                            Utils::OpenHandle(*script_data, true),
                            i::NOT_NATIVES_CODE);
+    delete code_cache_impl;
     has_pending_exception = result.is_null();
     EXCEPTION_BAILOUT_CHECK(isolate, Local<Script>());
     raw_result = *result;
@@ -2005,6 +2075,17 @@ Local<Value> Script::Id() {
 }
 
 
+ScriptData* Script::CreateCodeCache() {
+  i::Isolate* isolate = i::Isolate::Current();
+  ON_BAILOUT(isolate, "v8::Script::CreateCodeCache()", return NULL);
+  LOG_API(isolate, "Script::CreateCodeCache");
+  ENTER_V8(isolate);
+  i::HandleScope scope(isolate);
+  i::Handle<i::SharedFunctionInfo> function_info = OpenScript(this);
+  return i::ScriptCodeCache::Create(function_info);
+}
+
+
 int Script::GetLineNumber(int code_pos) {
   i::Isolate* isolate = i::Isolate::Current();
   ON_BAILOUT(isolate, "v8::Script::GetLineNumber()", return -1);
@@ -4287,6 +4368,19 @@ Handle<Value> Function::GetScriptId() const {
   return Utils::ToLocal(i::Handle<i::Object>(script->id(), func->GetIsolate()));
 }
 
+
+Local<v8::Object> Function::GetInlineCacheSummary() const {
+  i::Handle<i::JSFunction> func = Utils::OpenHandle(this);
+  i::Isolate* isolate = func->GetIsolate();
+  ON_BAILOUT(isolate, "v8::Function::GetInlineCacheSummary()",
+             return Local<v8::Object>());
+  ENTER_V8(isolate);
+  i::HandleScope scope(isolate);
+  i::Handle<i::JSObject> result = i::IC::SummarizeStates(func);
+  return Utils::ToLocal(scope.CloseAndEscape(result));
+}
+
+
 int String::Length() const {
   i::Handle<i::String> str = Utils::OpenHandle(this);
   if (IsDeadCheck(str->GetIsolate(), "v8::String::Length()")) return 0;
@@ -5188,6 +5282,20 @@ HeapStatistics::HeapStatistics(): total_heap_size_(0),
                                   heap_size_limit_(0) { }
 
 
+HeapSpaceStatistics::HeapSpaceStatistics(): space_name_(0),
+                                            space_size_(0),
+                                            space_used_size_(0),
+                                            space_available_size_(0),
+                                            physical_space_size_(0) { }
+
+
+GCTimeEstimates::GCTimeEstimates(): scavenge_time_in_ms_(0),
+                                    incremental_marking_time_in_ms_(0),
+                                    finalization_time_in_ms_(0),
+                                    full_gc_time_in_ms_(0),
+                                    incremental_marking_speed_(0) { }
+
+
 void v8::V8::GetHeapStatistics(HeapStatistics* heap_statistics) {
   i::Isolate* isolate = i::Isolate::UncheckedCurrent();
   if (isolate == NULL || !isolate->IsInitialized()) {
@@ -6769,6 +6877,100 @@ void Isolate::GetHeapStatistics(HeapStatistics* heap_statistics) {
 }
 
 
+size_t Isolate::NumberOfHeapSpaces() {
+  return i::LAST_SPACE - i::FIRST_SPACE + 1;
+}
+
+
+bool Isolate::GetHeapSpaceStatistics(HeapSpaceStatistics* space_statistics,
+                                     size_t index) {
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
+  if (!isolate->IsInitialized() || index >= NumberOfHeapSpaces()) {
+    return false;
+  }
+  i::Heap* heap = isolate->heap();
+  i::AllocationSpace space =
+      static_cast<i::AllocationSpace>(i::FIRST_SPACE + index);
+  space_statistics->space_name_ = i::AllocationSpaceName(space);
+  if (space == i::NEW_SPACE) {
+    i::NewSpace* new_space = heap->new_space();
+    space_statistics->space_size_ = new_space->CommittedMemory();
+    space_statistics->space_used_size_ = new_space->SizeOfObjects();
+    space_statistics->space_available_size_ = new_space->Available();
+    space_statistics->physical_space_size_ =
+        new_space->CommittedPhysicalMemory();
+  } else if (space == i::LO_SPACE) {
+    i::LargeObjectSpace* lo_space = heap->lo_space();
+    space_statistics->space_size_ = lo_space->CommittedMemory();
+    space_statistics->space_used_size_ = lo_space->SizeOfObjects();
+    space_statistics->space_available_size_ = lo_space->Available();
+    space_statistics->physical_space_size_ =
+        lo_space->CommittedPhysicalMemory();
+  } else {
+    i::PagedSpace* paged_space = heap->paged_space(space);
+    space_statistics->space_size_ = paged_space->CommittedMemory();
+    space_statistics->space_used_size_ = paged_space->SizeOfObjects();
+    space_statistics->space_available_size_ = paged_space->Available();
+    space_statistics->physical_space_size_ =
+        paged_space->CommittedPhysicalMemory();
+  }
+  return true;
+}
+
+
+void Isolate::SetSoftHeapLimit(size_t limit_in_bytes,
+                               SoftHeapLimitCallback callback) {
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
+  isolate->heap()->SetSoftHeapLimit(static_cast<intptr_t>(limit_in_bytes),
+                                    callback);
+}
+
+
+void Isolate::GetGCTimeEstimates(GCTimeEstimates* estimates) {
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
+  if (!isolate->IsInitialized()) {
+    estimates->scavenge_time_in_ms_ = 0;
+    estimates->incremental_marking_time_in_ms_ = 0;
+    estimates->finalization_time_in_ms_ = 0;
+    estimates->full_gc_time_in_ms_ = 0;
+    estimates->incremental_marking_speed_ = 0;
+    return;
+  }
+  i::Heap* heap = isolate->heap();
+  i::GCIdleTimeHandler* handler = heap->gc_idle_time_handler();
+  intptr_t size_of_objects = heap->SizeOfObjects();
+  estimates->scavenge_time_in_ms_ =
+      handler->EstimateScavengeTime(heap->new_space()->Size());
+  estimates->incremental_marking_time_in_ms_ =
+      handler->EstimateIncrementalMarkingTime(size_of_objects);
+  estimates->finalization_time_in_ms_ =
+      handler->EstimateFinalizationTime(size_of_objects);
+  estimates->full_gc_time_in_ms_ =
+      handler->EstimateMarkCompactTime(size_of_objects);
+  estimates->incremental_marking_speed_ =
+      handler->MarkingSpeedInBytesPerMs();
+}
+
+
+bool Isolate::IdleNotification(int idle_time_in_ms) {
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
+  // Returning true tells the caller that it need not
+  // continue to call IdleNotification.
+  if (!isolate->IsInitialized() || !i::FLAG_use_idle_notification) {
+    return true;
+  }
+  return isolate->heap()->IdleTimeNotification(idle_time_in_ms);
+}
+
+
+size_t Isolate::ReduceMemory() {
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
+  if (!isolate->IsInitialized()) return 0;
+  return static_cast<size_t>(
+      isolate->heap()->ReduceMemory("external memory reduction request"));
+}
+
+
 String::Utf8Value::Utf8Value(v8::Handle<v8::Value> obj)
     : str_(NULL), length_(0) {
   i::Isolate* isolate = i::Isolate::Current();
@@ -219,6 +219,11 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   __ IncrementCounter(counters->megamorphic_stub_cache_probes(), 1,
                       extra2, extra3);
 
+  // The tables can grow, so the masks are loaded from the stub cache.  They
+  // are scaled by 1 << kHeapObjectTagSize, the offsets here are not.
+  ExternalReference primary_mask(mask_reference(kPrimary));
+  ExternalReference secondary_mask(mask_reference(kSecondary));
+
   // Check that the receiver isn't a smi.
   __ JumpIfSmi(receiver, &miss);
 
@@ -226,15 +231,16 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   __ ldr(scratch, FieldMemOperand(name, Name::kHashFieldOffset));
   __ ldr(ip, FieldMemOperand(receiver, HeapObject::kMapOffset));
   __ add(scratch, scratch, Operand(ip));
-  uint32_t mask = kPrimaryTableSize - 1;
   // We shift out the last two bits because they are not part of the hash and
   // they are always 01 for maps.
   __ mov(scratch, Operand(scratch, LSR, kHeapObjectTagSize));
-  // Mask down the eor argument to the minimum to keep the immediate
-  // ARM-encodable.
-  __ eor(scratch, scratch, Operand((flags >> kHeapObjectTagSize) & mask));
-  // Prefer and_ to ubfx here because ubfx takes 2 cycles.
-  __ and_(scratch, scratch, Operand(mask));
+  // Mask down the eor argument to the largest table size to keep the
+  // immediate small; the bits above the mask do not affect the result.
+  uint32_t max_mask = (1 << kMaxTableBits) - 1;
+  __ eor(scratch, scratch, Operand((flags >> kHeapObjectTagSize) & max_mask));
+  __ mov(ip, Operand(primary_mask));
+  __ ldr(ip, MemOperand(ip));
+  __ and_(scratch, scratch, Operand(ip, LSR, kHeapObjectTagSize));
 
   // Probe the primary table.
   ProbeTable(isolate,
@@ -248,11 +254,15 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
              extra2,
              extra3);
 
+  __ IncrementCounter(counters->megamorphic_stub_cache_primary_misses(), 1,
+                      extra2, extra3);
+
   // Primary miss: Compute hash for secondary probe.
   __ sub(scratch, scratch, Operand(name, LSR, kHeapObjectTagSize));
-  uint32_t mask2 = kSecondaryTableSize - 1;
-  __ add(scratch, scratch, Operand((flags >> kHeapObjectTagSize) & mask2));
-  __ and_(scratch, scratch, Operand(mask2));
+  __ add(scratch, scratch, Operand((flags >> kHeapObjectTagSize) & max_mask));
+  __ mov(ip, Operand(secondary_mask));
+  __ ldr(ip, MemOperand(ip));
+  __ and_(scratch, scratch, Operand(ip, LSR, kHeapObjectTagSize));
 
   // Probe the secondary table.
   ProbeTable(isolate,
@@ -2332,8 +2332,14 @@ bool Genesis::InstallExtension(Isolate* isolate,
       return false;
     }
   }
-  Handle<String> source_code =
-      isolate->factory()->NewExternalStringFromAscii(extension->source());
+  // A snapshot can only refer to the external strings of the natives, so
+  // extensions installed while creating one get a copy of their source.
+  const v8::String::ExternalAsciiStringResource* source = extension->source();
+  Handle<String> source_code = Serializer::enabled()
+      ? isolate->factory()->NewStringFromAscii(
+            Vector<const char>(source->data(),
+                               static_cast<int>(source->length())))
+      : isolate->factory()->NewExternalStringFromAscii(source);
   bool result = CompileScriptCached(isolate,
                                     CStrVector(extension->name()),
                                     source_code,
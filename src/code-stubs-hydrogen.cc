@@ -108,10 +108,25 @@ class CodeStubGraphBuilderBase : public HGraphBuilder {
   HValue* BuildArrayConstructor(ElementsKind kind,
                                 bool disable_allocation_sites,
                                 ArgumentClass argument_class);
+
+  HValue* BuildCheckLiteralAllocationSite(IfBuilder* checker);
+  HValue* BuildCloneLiteralArray(HValue* boilerplate,
+                                 HValue* allocation_site,
+                                 AllocationSiteMode mode,
+                                 ElementsKind kind,
+                                 int length);
+  HValue* BuildCloneLiteralObject(HValue* boilerplate,
+                                  HValue* allocation_site,
+                                  int size);
   HValue* BuildInternalArrayConstructor(ElementsKind kind,
                                         ArgumentClass argument_class);
 
  private:
+  void IfUndecidedAllocationSite(IfBuilder* builder, HValue* allocation_site);
+  HValue* BuildCloneShallowObject(HValue* boilerplate,
+                                  HValue* allocation_site,
+                                  int size,
+                                  AllocationSiteMode mode);
   HValue* BuildArraySingleArgumentConstructor(JSArrayBuilder* builder);
   HValue* BuildArrayNArgumentsConstructor(JSArrayBuilder* builder,
                                           ElementsKind kind);
@@ -305,59 +320,193 @@ static Handle<Code> DoGenerateCode(Stub* stub) {
 }
 
 
+// Loads the allocation site of a literal and starts the check that it has
+// been created already.  Copies for tenured sites are made by the runtime.
+HValue* CodeStubGraphBuilderBase::BuildCheckLiteralAllocationSite(
+    IfBuilder* checker) {
+  Zone* zone = this->zone();
+  HInstruction* allocation_site =
+      AddInstruction(new(zone) HLoadKeyed(GetParameter(0),
+                                          GetParameter(1),
+                                          NULL,
+                                          FAST_ELEMENTS));
+  checker->IfNot<HCompareObjectEqAndBranch, HValue*>(
+      allocation_site, graph()->GetConstantUndefined());
+  if (FLAG_allocation_site_pretenuring) {
+    checker->And();
+    HValue* decision = AddLoad(
+        allocation_site, HObjectAccess::ForAllocationSitePretenureDecision());
+    HValue* tenure = AddInstruction(new(zone) HConstant(
+        Handle<Object>(Smi::FromInt(AllocationSite::kTenure), isolate())));
+    checker->IfNot<HCompareObjectEqAndBranch, HValue*>(decision, tenure);
+  }
+  return allocation_site;
+}
+
+
+void CodeStubGraphBuilderBase::IfUndecidedAllocationSite(
+    IfBuilder* builder,
+    HValue* allocation_site) {
+  HValue* decision = AddLoad(
+      allocation_site, HObjectAccess::ForAllocationSitePretenureDecision());
+  HValue* undecided = AddInstruction(new(zone()) HConstant(
+      Handle<Object>(Smi::FromInt(AllocationSite::kUndecided), isolate())));
+  builder->If<HCompareObjectEqAndBranch, HValue*>(decision, undecided);
+}
+
+
+// Copies of undecided sites count towards the pretenuring decision, once
+// the site has decided they are only tracked if the stub asks for it.
+HValue* CodeStubGraphBuilderBase::BuildCloneLiteralArray(
+    HValue* boilerplate,
+    HValue* allocation_site,
+    AllocationSiteMode mode,
+    ElementsKind kind,
+    int length) {
+  if (!FLAG_allocation_site_pretenuring || mode == TRACK_ALLOCATION_SITE) {
+    return BuildCloneShallowArray(context(), boilerplate, allocation_site,
+                                  mode, kind, length);
+  }
+  // The clones are built before pushing them, so that the push goes to the
+  // environment of the branch they end up in.
+  IfBuilder if_undecided(this);
+  IfUndecidedAllocationSite(&if_undecided, allocation_site);
+  if_undecided.Then();
+  HValue* tracked = BuildCloneShallowArray(context(),
+                                           boilerplate,
+                                           allocation_site,
+                                           TRACK_ALLOCATION_SITE,
+                                           kind,
+                                           length);
+  environment()->Push(tracked);
+  if_undecided.Else();
+  HValue* untracked = BuildCloneShallowArray(context(),
+                                             boilerplate,
+                                             allocation_site,
+                                             mode,
+                                             kind,
+                                             length);
+  environment()->Push(untracked);
+  if_undecided.End();
+  return environment()->Pop();
+}
+
+
+HValue* CodeStubGraphBuilderBase::BuildCloneLiteralObject(
+    HValue* boilerplate,
+    HValue* allocation_site,
+    int size) {
+  if (!FLAG_allocation_site_pretenuring) {
+    return BuildCloneShallowObject(boilerplate, allocation_site, size,
+                                   DONT_TRACK_ALLOCATION_SITE);
+  }
+  IfBuilder if_undecided(this);
+  IfUndecidedAllocationSite(&if_undecided, allocation_site);
+  if_undecided.Then();
+  HValue* tracked = BuildCloneShallowObject(boilerplate,
+                                            allocation_site,
+                                            size,
+                                            TRACK_ALLOCATION_SITE);
+  environment()->Push(tracked);
+  if_undecided.Else();
+  HValue* untracked = BuildCloneShallowObject(boilerplate,
+                                              allocation_site,
+                                              size,
+                                              DONT_TRACK_ALLOCATION_SITE);
+  environment()->Push(untracked);
+  if_undecided.End();
+  return environment()->Pop();
+}
+
+
+HValue* CodeStubGraphBuilderBase::BuildCloneShallowObject(
+    HValue* boilerplate,
+    HValue* allocation_site,
+    int size,
+    AllocationSiteMode mode) {
+  Zone* zone = this->zone();
+  int allocation_size = size;
+  if (mode == TRACK_ALLOCATION_SITE) {
+    allocation_size += AllocationSiteInfo::kSize;
+  }
+
+  HValue* size_in_bytes = AddInstruction(new(zone) HConstant(allocation_size));
+  HAllocate::Flags flags = HAllocate::CAN_ALLOCATE_IN_NEW_SPACE;
+  if (isolate()->heap()->ShouldGloballyPretenure()) {
+    flags = static_cast<HAllocate::Flags>(
+       flags | HAllocate::CAN_ALLOCATE_IN_OLD_POINTER_SPACE);
+  }
+
+  HInstruction* object = AddInstruction(new(zone)
+      HAllocate(context(), size_in_bytes, HType::JSObject(), flags));
+
+  for (int i = 0; i < size; i += kPointerSize) {
+    HObjectAccess access = HObjectAccess::ForJSObjectOffset(i);
+    AddStore(object, access, AddLoad(boilerplate, access));
+  }
+
+  if (mode == TRACK_ALLOCATION_SITE) {
+    BuildCreateAllocationSiteInfo(object, size, allocation_site);
+    BuildIncrementMementoCreateCount(context(), allocation_site);
+  }
+  return object;
+}
+
+
 template <>
 HValue* CodeStubGraphBuilder<FastCloneShallowArrayStub>::BuildCodeStub() {
-  Zone* zone = this->zone();
   Factory* factory = isolate()->factory();
-  HValue* undefined = graph()->GetConstantUndefined();
   AllocationSiteMode alloc_site_mode = casted_stub()->allocation_site_mode();
   FastCloneShallowArrayStub::Mode mode = casted_stub()->mode();
   int length = casted_stub()->length();
 
-  HInstruction* boilerplate =
-      AddInstruction(new(zone) HLoadKeyed(GetParameter(0),
-                                          GetParameter(1),
-                                          NULL,
-                                          FAST_ELEMENTS));
-
   IfBuilder checker(this);
-  checker.IfNot<HCompareObjectEqAndBranch, HValue*>(boilerplate, undefined);
+  HValue* allocation_site = BuildCheckLiteralAllocationSite(&checker);
   checker.Then();
 
+  HValue* boilerplate = AddLoad(allocation_site,
+                                HObjectAccess::ForAllocationSiteBoilerplate());
+
   if (mode == FastCloneShallowArrayStub::CLONE_ANY_ELEMENTS) {
     HValue* elements = AddLoadElements(boilerplate);
 
     IfBuilder if_fixed_cow(this);
     if_fixed_cow.IfCompareMap(elements, factory->fixed_cow_array_map());
     if_fixed_cow.Then();
-    environment()->Push(BuildCloneShallowArray(context(),
-                                               boilerplate,
+    HValue* cow_clone = BuildCloneLiteralArray(boilerplate,
+                                               allocation_site,
                                                alloc_site_mode,
                                                FAST_ELEMENTS,
-                                               0/*copy-on-write*/));
+                                               0/*copy-on-write*/);
+    environment()->Push(cow_clone);
     if_fixed_cow.Else();
 
     IfBuilder if_fixed(this);
     if_fixed.IfCompareMap(elements, factory->fixed_array_map());
     if_fixed.Then();
-    environment()->Push(BuildCloneShallowArray(context(),
-                                               boilerplate,
-                                               alloc_site_mode,
-                                               FAST_ELEMENTS,
-                                               length));
+    HValue* fixed_clone = BuildCloneLiteralArray(boilerplate,
+                                                 allocation_site,
+                                                 alloc_site_mode,
+                                                 FAST_ELEMENTS,
+                                                 length);
+    environment()->Push(fixed_clone);
     if_fixed.Else();
-    environment()->Push(BuildCloneShallowArray(context(),
-                                               boilerplate,
-                                               alloc_site_mode,
-                                               FAST_DOUBLE_ELEMENTS,
-                                               length));
+    HValue* double_clone = BuildCloneLiteralArray(boilerplate,
+                                                  allocation_site,
+                                                  alloc_site_mode,
+                                                  FAST_DOUBLE_ELEMENTS,
+                                                  length);
+    environment()->Push(double_clone);
+    if_fixed.End();
+    if_fixed_cow.End();
   } else {
     ElementsKind elements_kind = casted_stub()->ComputeElementsKind();
-    environment()->Push(BuildCloneShallowArray(context(),
-                                               boilerplate,
-                                               alloc_site_mode,
-                                               elements_kind,
-                                               length));
+    HValue* clone = BuildCloneLiteralArray(boilerplate,
+                                           allocation_site,
+                                           alloc_site_mode,
+                                           elements_kind,
+                                           length);
+    environment()->Push(clone);
   }
 
   HValue* result = environment()->Pop();
@@ -374,18 +523,14 @@ Handle<Code> FastCloneShallowArrayStub::GenerateCode() {
 template <>
 HValue* CodeStubGraphBuilder<FastCloneShallowObjectStub>::BuildCodeStub() {
   Zone* zone = this->zone();
-  HValue* undefined = graph()->GetConstantUndefined();
-
-  HInstruction* boilerplate =
-      AddInstruction(new(zone) HLoadKeyed(GetParameter(0),
-                                          GetParameter(1),
-                                          NULL,
-                                          FAST_ELEMENTS));
 
   IfBuilder checker(this);
-  checker.IfNot<HCompareObjectEqAndBranch, HValue*>(boilerplate, undefined);
+  HValue* allocation_site = BuildCheckLiteralAllocationSite(&checker);
   checker.And();
 
+  HValue* boilerplate = AddLoad(allocation_site,
+                                HObjectAccess::ForAllocationSiteBoilerplate());
+
   int size = JSObject::kHeaderSize + casted_stub()->length() * kPointerSize;
   HValue* boilerplate_size =
       AddInstruction(new(zone) HInstanceSize(boilerplate));
@@ -394,20 +539,7 @@ HValue* CodeStubGraphBuilder<FastCloneShallowObjectStub>::BuildCodeStub() {
   checker.IfCompare(boilerplate_size, size_in_words, Token::EQ);
   checker.Then();
 
-  HValue* size_in_bytes = AddInstruction(new(zone) HConstant(size));
-  HAllocate::Flags flags = HAllocate::CAN_ALLOCATE_IN_NEW_SPACE;
-  if (isolate()->heap()->ShouldGloballyPretenure()) {
-    flags = static_cast<HAllocate::Flags>(
-       flags | HAllocate::CAN_ALLOCATE_IN_OLD_POINTER_SPACE);
-  }
-
-  HInstruction* object = AddInstruction(new(zone)
-      HAllocate(context(), size_in_bytes, HType::JSObject(), flags));
-
-  for (int i = 0; i < size; i += kPointerSize) {
-    HObjectAccess access = HObjectAccess::ForJSObjectOffset(i);
-    AddStore(object, access, AddLoad(boilerplate, access));
-  }
+  HValue* object = BuildCloneLiteralObject(boilerplate, allocation_site, size);
 
   checker.ElseDeopt();
   return object;
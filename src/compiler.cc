@@ -42,6 +42,7 @@
 #include "lithium.h"
 #include "liveedit.h"
 #include "parser.h"
+#include "preparse-data-cache.h"
 #include "rewriter.h"
 #include "runtime-profiler.h"
 #include "scanner-character-streams.h"
@@ -107,7 +108,7 @@ void CompilationInfo::Initialize(Isolate* isolate, Mode mode, Zone* zone) {
   no_frame_ranges_ = isolate->cpu_profiler()->is_profiling()
                    ? new List<OffsetRange>(2) : NULL;
   for (int i = 0; i < DependentCode::kGroupCount; i++) {
-    dependent_maps_[i] = NULL;
+    dependencies_[i] = NULL;
   }
   if (mode == STUB) {
     mode_ = STUB;
@@ -129,39 +130,46 @@ CompilationInfo::~CompilationInfo() {
   delete deferred_handles_;
   delete no_frame_ranges_;
 #ifdef DEBUG
-  // Check that no dependent maps have been added or added dependent maps have
+  // Check that no dependencies have been added or added dependencies have
   // been rolled back or committed.
   for (int i = 0; i < DependentCode::kGroupCount; i++) {
-    ASSERT_EQ(NULL, dependent_maps_[i]);
+    ASSERT_EQ(NULL, dependencies_[i]);
   }
 #endif  // DEBUG
 }
 
 
-void CompilationInfo::CommitDependentMaps(Handle<Code> code) {
+void CompilationInfo::CommitDependencies(Handle<Code> code) {
   for (int i = 0; i < DependentCode::kGroupCount; i++) {
-    ZoneList<Handle<Map> >* group_maps = dependent_maps_[i];
-    if (group_maps == NULL) continue;
+    ZoneList<Handle<HeapObject> >* group_objects = dependencies_[i];
+    if (group_objects == NULL) continue;
     ASSERT(!object_wrapper_.is_null());
-    for (int j = 0; j < group_maps->length(); j++) {
-      group_maps->at(j)->dependent_code()->UpdateToFinishedCode(
-          static_cast<DependentCode::DependencyGroup>(i), this, *code);
+    DependentCode::DependencyGroup group =
+        static_cast<DependentCode::DependencyGroup>(i);
+    for (int j = 0; j < group_objects->length(); j++) {
+      DependentCode* dependent_code =
+          DependentCode::ForObject(group_objects->at(j), group);
+      dependent_code->UpdateToFinishedCode(group, this, *code);
     }
-    dependent_maps_[i] = NULL;  // Zone-allocated, no need to delete.
+    dependencies_[i] = NULL;  // Zone-allocated, no need to delete.
   }
 }
 
 
-void CompilationInfo::RollbackDependentMaps() {
-  // Unregister from all dependent maps if not yet committed.
+void CompilationInfo::RollbackDependencies() {
+  // Unregister from all dependent maps and allocation sites if not yet
+  // committed.
   for (int i = 0; i < DependentCode::kGroupCount; i++) {
-    ZoneList<Handle<Map> >* group_maps = dependent_maps_[i];
-    if (group_maps == NULL) continue;
-    for (int j = 0; j < group_maps->length(); j++) {
-      group_maps->at(j)->dependent_code()->RemoveCompilationInfo(
-          static_cast<DependentCode::DependencyGroup>(i), this);
+    ZoneList<Handle<HeapObject> >* group_objects = dependencies_[i];
+    if (group_objects == NULL) continue;
+    DependentCode::DependencyGroup group =
+        static_cast<DependentCode::DependencyGroup>(i);
+    for (int j = 0; j < group_objects->length(); j++) {
+      DependentCode* dependent_code =
+          DependentCode::ForObject(group_objects->at(j), group);
+      dependent_code->RemoveCompilationInfo(group, this);
     }
-    dependent_maps_[i] = NULL;  // Zone-allocated, no need to delete.
+    dependencies_[i] = NULL;  // Zone-allocated, no need to delete.
   }
 }
 
@@ -700,6 +708,22 @@ Handle<SharedFunctionInfo> Compiler::Compile(Handle<String> source,
     script->set_data(script_data.is_null() ? HEAP->undefined_value()
                                            : *script_data);
 
+    // Large scripts are usually libraries loaded by every isolate of the
+    // process. Their preparse data is shared, so that only the first isolate
+    // has to scan the bodies of lazily compiled functions. The preparser
+    // always starts in classic mode, so this is skipped for --use-strict.
+    ScriptDataImpl* shared_pre_data = NULL;
+    if (pre_data == NULL &&
+        FLAG_cache_preparse_data &&
+        FLAG_lazy &&
+        !FLAG_use_strict &&
+        extension == NULL &&
+        natives != NATIVES_CODE &&
+        source_length > FLAG_min_preparse_length) {
+      shared_pre_data = PreparseDataCache::LookupOrPreparse(source);
+      pre_data = shared_pre_data;
+    }
+
     // Compile the function and add it to the cache.
     CompilationInfoWithZone info(script);
     info.MarkAsGlobal();
@@ -710,6 +734,7 @@ Handle<SharedFunctionInfo> Compiler::Compile(Handle<String> source,
       info.SetLanguageMode(FLAG_harmony_scoping ? EXTENDED_MODE : STRICT_MODE);
     }
     result = MakeFunctionInfo(&info);
+    delete shared_pre_data;
     if (extension == NULL && !result.is_null() && !result->dont_cache()) {
       compilation_cache->PutScript(source, context, result);
     }
@@ -943,8 +968,10 @@ bool Compiler::CompileLazy(CompilationInfo* info) {
 }
 
 
-void Compiler::RecompileParallel(Handle<JSFunction> closure) {
-  ASSERT(closure->IsMarkedForParallelRecompilation());
+bool Compiler::RecompileParallel(Handle<JSFunction> closure,
+                                 BailoutId osr_ast_id) {
+  ASSERT(!osr_ast_id.IsNone() ||
+         closure->IsMarkedForParallelRecompilation());
 
   Isolate* isolate = closure->GetIsolate();
   // Here we prepare compile data for the parallel recompilation thread, but
@@ -956,7 +983,7 @@ void Compiler::RecompileParallel(Handle<JSFunction> closure) {
     if (FLAG_trace_parallel_recompilation) {
       PrintF("  ** Compilation queue, will retry opting on next run.\n");
     }
-    return;
+    return false;
   }
 
   SmartPointer<CompilationInfo> info(new CompilationInfoWithZone(closure));
@@ -964,15 +991,18 @@ void Compiler::RecompileParallel(Handle<JSFunction> closure) {
   PostponeInterruptsScope postpone(isolate);
 
   Handle<SharedFunctionInfo> shared = info->shared_info();
+  // Hotter functions are optimized first.
+  int priority = shared->code()->profiler_ticks();
   int compiled_size = shared->end_position() - shared->start_position();
   isolate->counters()->total_compile_size()->Increment(compiled_size);
-  info->SetOptimizing(BailoutId::None());
+  info->SetOptimizing(osr_ast_id);
 
+  bool queued = false;
   {
     CompilationHandleScope handle_scope(*info);
 
     if (InstallCodeFromOptimizedCodeMap(*info)) {
-      return;
+      return false;
     }
 
     if (Parser::Parse(*info)) {
@@ -988,7 +1018,9 @@ void Compiler::RecompileParallel(Handle<JSFunction> closure) {
         if (status == OptimizingCompiler::SUCCEEDED) {
           info.Detach();
           shared->code()->set_profiler_ticks(0);
-          isolate->optimizing_compiler_thread()->QueueForOptimization(compiler);
+          isolate->optimizing_compiler_thread()->QueueForOptimization(
+              compiler, priority);
+          queued = true;
         } else if (status == OptimizingCompiler::BAILED_OUT) {
           isolate->clear_pending_exception();
           InstallFullCode(*info);
@@ -1012,6 +1044,7 @@ void Compiler::RecompileParallel(Handle<JSFunction> closure) {
   }
 
   if (isolate->has_pending_exception()) isolate->clear_pending_exception();
+  return queued;
 }
 
 
@@ -1039,8 +1072,16 @@ void Compiler::InstallOptimizedCode(OptimizingCompiler* optimizing_compiler) {
   // the unoptimized code.
   OptimizingCompiler::Status status = optimizing_compiler->last_status();
   if (info->HasAbortedDueToDependentMap()) {
+    // The job went stale while it was queued.  Drop it, but keep the
+    // function optimizable so that it is queued again once it is hot.
     info->set_bailout_reason("bailed out due to dependent map");
-    status = optimizing_compiler->AbortOptimization();
+    info->AbortOptimization();
+    status = OptimizingCompiler::BAILED_OUT;
+    if (FLAG_trace_parallel_recompilation) {
+      PrintF("  ** Dropping stale optimization job for ");
+      info->closure()->PrintName();
+      PrintF(".\n");
+    }
   } else if (status != OptimizingCompiler::SUCCEEDED) {
     info->set_bailout_reason("failed/bailed out last time");
     status = optimizing_compiler->AbortOptimization();
@@ -462,6 +462,20 @@ void Deoptimizer::DeoptimizeAllFunctionsWith(Isolate* isolate,
 }
 
 
+class DeoptimizeMarkedCodeFilter : public OptimizedFunctionFilter {
+ public:
+  virtual bool TakeFunction(JSFunction* function) {
+    return function->code()->marked_for_deoptimization();
+  }
+};
+
+
+void Deoptimizer::DeoptimizeMarkedCode(Isolate* isolate) {
+  DeoptimizeMarkedCodeFilter filter;
+  DeoptimizeAllFunctionsWith(isolate, &filter);
+}
+
+
 void Deoptimizer::HandleWeakDeoptimizedCode(v8::Isolate* isolate,
                                             v8::Persistent<v8::Value>* obj,
                                             void* parameter) {
@@ -538,6 +552,13 @@ Deoptimizer::Deoptimizer(Isolate* isolate,
       deferred_objects_double_values_(0),
       deferred_objects_(0),
       deferred_heap_numbers_(0),
+      deferred_object_aliases_(0),
+      jsframe_functions_(0),
+      jsframe_has_adapted_arguments_(0),
+      materialized_values_(NULL),
+      materialized_objects_(NULL),
+      materialization_value_index_(0),
+      materialization_object_index_(0),
       trace_(false) {
   // For COMPILED_STUBs called from builtins, the function pointer is a SMI
   // indicating an internal frame.
@@ -788,6 +809,8 @@ void Deoptimizer::DoComputeOutputFrames() {
       case Translation::DOUBLE_STACK_SLOT:
       case Translation::LITERAL:
       case Translation::ARGUMENTS_OBJECT:
+      case Translation::CAPTURED_OBJECT:
+      case Translation::DUPLICATED_OBJECT:
       case Translation::DUPLICATE:
       default:
         UNREACHABLE();
@@ -1224,6 +1247,21 @@ void Deoptimizer::DoComputeConstructStubFrame(TranslationIterator* iterator,
   output_offset -= kPointerSize;
   value = output_frame->GetFrameSlot(output_frame_size - kPointerSize);
   output_frame->SetFrameSlot(output_offset, value);
+  if (value == reinterpret_cast<intptr_t>(
+          isolate_->heap()->arguments_marker())) {
+    // The receiver was not allocated by optimized code, it is materialized
+    // later on and has to be stored into both slots.
+    Address receiver_slot = reinterpret_cast<Address>(
+        top_address + output_frame_size - kPointerSize);
+    int object_index = deferred_objects_.length() - 1;
+    while (deferred_objects_[object_index].slot_address() != receiver_slot) {
+      object_index--;
+    }
+    ObjectMaterializationDescriptor alias(
+        reinterpret_cast<Address>(top_address + output_offset),
+        jsframe_count_, -1, object_index, false);
+    deferred_object_aliases_.Add(alias);
+  }
   if (trace_) {
     PrintF("    0x%08" V8PRIxPTR ": [top + %d] <- 0x%08"
            V8PRIxPTR " ; allocated receiver\n",
@@ -1336,9 +1374,7 @@ void Deoptimizer::DoComputeAccessorStubFrame(TranslationIterator* iterator,
   }
 
   // Skip receiver.
-  Translation::Opcode opcode =
-      static_cast<Translation::Opcode>(iterator->Next());
-  iterator->Skip(Translation::NumberOfOperandsFor(opcode));
+  DoTranslateObjectAndSkip(iterator);
 
   if (is_setter_stub_frame) {
     // The implicit return value was part of the artificial setter stub
@@ -1564,9 +1600,111 @@ void Deoptimizer::DoComputeCompiledStubFrame(TranslationIterator* iterator,
 }
 
 
+Handle<Object> Deoptimizer::MaterializeNextHeapObject() {
+  int object_index = materialization_object_index_++;
+  ObjectMaterializationDescriptor desc = deferred_objects_[object_index];
+  const int length = desc.object_length();
+
+  if (desc.duplicate_object() >= 0) {
+    // Found a previously materialized object by de-duplication.
+    object_index = desc.duplicate_object();
+    materialized_objects_->Add(materialized_objects_->at(object_index));
+  } else if (desc.is_arguments() &&
+             jsframe_has_adapted_arguments_[desc.jsframe_index()]) {
+    // Use the arguments adapter frame we just built to materialize the
+    // arguments object. FunctionGetArguments can't throw an exception,
+    // so cast away the doubt with an assert.
+    Handle<JSFunction> function = jsframe_functions_[desc.jsframe_index()];
+    Handle<JSObject> arguments(JSObject::cast(
+        Accessors::FunctionGetArguments(*function,
+                                        NULL)->ToObjectUnchecked()));
+    materialized_objects_->Add(arguments);
+    // The values are not needed, but nested objects still have to be
+    // consumed.
+    for (int i = 0; i < length; ++i) MaterializeNextValue();
+  } else if (desc.is_arguments()) {
+    // Construct an arguments object and copy the parameters to a newly
+    // allocated arguments object backing store.
+    Handle<JSFunction> function = jsframe_functions_[desc.jsframe_index()];
+    Handle<JSObject> arguments =
+        isolate_->factory()->NewArgumentsObject(function, length);
+    Handle<FixedArray> array = isolate_->factory()->NewFixedArray(length);
+    ASSERT(array->length() == length);
+    arguments->set_elements(*array);
+    materialized_objects_->Add(arguments);
+    for (int i = 0; i < length; ++i) {
+      Handle<Object> value = MaterializeNextValue();
+      array->set(i, *value);
+    }
+  } else {
+    // Dispatch on the instance type of the object to be materialized, the
+    // map is always the first field.
+    Handle<Map> map = Handle<Map>::cast(MaterializeNextValue());
+    switch (map->instance_type()) {
+      case HEAP_NUMBER_TYPE: {
+        // Double values of captured heap numbers were boxed up front, a
+        // fresh heap number is needed since the box might be a smi.
+        Handle<Object> value = MaterializeNextValue();
+        Handle<HeapNumber> number =
+            isolate_->factory()->NewHeapNumber(value->Number());
+        materialized_objects_->Add(number);
+        materialization_value_index_ += length - 2;
+        break;
+      }
+      case JS_OBJECT_TYPE: {
+        Handle<JSObject> object =
+            isolate_->factory()->NewJSObjectFromMap(map, NOT_TENURED);
+        materialized_objects_->Add(object);
+        Handle<Object> properties = MaterializeNextValue();
+        Handle<Object> elements = MaterializeNextValue();
+        object->set_properties(FixedArray::cast(*properties));
+        object->set_elements(FixedArrayBase::cast(*elements));
+        for (int i = 0; i < length - 3; ++i) {
+          Handle<Object> value = MaterializeNextValue();
+          if (i < map->inobject_properties()) {
+            object->InObjectPropertyAtPut(i, *value);
+          }
+        }
+        break;
+      }
+      default:
+        PrintF("[couldn't handle instance type %d]\n", map->instance_type());
+        UNREACHABLE();
+    }
+  }
+
+  return materialized_objects_->at(object_index);
+}
+
+
+Handle<Object> Deoptimizer::MaterializeNextValue() {
+  int value_index = materialization_value_index_++;
+  Handle<Object> value = materialized_values_->at(value_index);
+  if (*value == isolate_->heap()->arguments_marker()) {
+    value = MaterializeNextHeapObject();
+  }
+  return value;
+}
+
+
 void Deoptimizer::MaterializeHeapObjects(JavaScriptFrameIterator* it) {
   ASSERT_NE(DEBUGGER, bailout_type_);
 
+  // Collect the functions of all output JavaScript frames. The iterator
+  // starts with the topmost frame, object descriptors count from the
+  // bottommost one.
+  jsframe_functions_.AddBlock(Handle<JSFunction>(), jsframe_count());
+  jsframe_has_adapted_arguments_.AddBlock(false, jsframe_count());
+  for (int frame_index = 0; frame_index < jsframe_count(); ++frame_index) {
+    if (frame_index != 0) it->Advance();
+    JavaScriptFrame* frame = it->frame();
+    int jsframe_index = jsframe_count() - 1 - frame_index;
+    jsframe_functions_[jsframe_index] =
+        Handle<JSFunction>(JSFunction::cast(frame->function()), isolate_);
+    jsframe_has_adapted_arguments_[jsframe_index] =
+        frame->has_adapted_arguments();
+  }
+
   // Handlify all tagged object values before triggering any allocation.
   List<Handle<Object> > values(deferred_objects_tagged_values_.length());
   for (int i = 0; i < deferred_objects_tagged_values_.length(); ++i) {
@@ -1591,65 +1729,58 @@ void Deoptimizer::MaterializeHeapObjects(JavaScriptFrameIterator* it) {
     Memory::Object_at(d.slot_address()) = *num;
   }
 
-  // Materialize all heap numbers required for arguments objects.
+  // Materialize all heap numbers required for arguments and captured objects.
   for (int i = 0; i < values.length(); i++) {
     if (!values.at(i)->IsTheHole()) continue;
     double double_value = deferred_objects_double_values_[i];
     Handle<Object> num = isolate_->factory()->NewNumber(double_value);
     if (trace_) {
-      PrintF("Materializing a new heap number %p [%e] for arguments object\n",
+      PrintF("Materializing a new heap number %p [%e] for object\n",
              reinterpret_cast<void*>(*num), double_value);
     }
     values.Set(i, num);
   }
 
-  // Materialize arguments objects one frame at a time.
-  for (int frame_index = 0; frame_index < jsframe_count(); ++frame_index) {
-    if (frame_index != 0) it->Advance();
-    JavaScriptFrame* frame = it->frame();
-    Handle<JSFunction> function(JSFunction::cast(frame->function()), isolate_);
-    Handle<JSObject> arguments;
-    for (int i = frame->ComputeExpressionsCount() - 1; i >= 0; --i) {
-      if (frame->GetExpression(i) == isolate_->heap()->arguments_marker()) {
-        ObjectMaterializationDescriptor descriptor =
-            deferred_objects_.RemoveLast();
-        const int length = descriptor.object_length();
-        if (arguments.is_null()) {
-          if (frame->has_adapted_arguments()) {
-            // Use the arguments adapter frame we just built to materialize the
-            // arguments object. FunctionGetArguments can't throw an exception,
-            // so cast away the doubt with an assert.
-            arguments = Handle<JSObject>(JSObject::cast(
-                Accessors::FunctionGetArguments(*function,
-                                                NULL)->ToObjectUnchecked()));
-            values.RewindBy(length);
-          } else {
-            // Construct an arguments object and copy the parameters to a newly
-            // allocated arguments object backing store.
-            arguments =
-                isolate_->factory()->NewArgumentsObject(function, length);
-            Handle<FixedArray> array =
-                isolate_->factory()->NewFixedArray(length);
-            ASSERT(array->length() == length);
-            for (int i = length - 1; i >= 0 ; --i) {
-              array->set(i, *values.RemoveLast());
-            }
-            arguments->set_elements(*array);
-          }
-        }
-        frame->SetExpression(i, *arguments);
-        ASSERT_EQ(Memory::Object_at(descriptor.slot_address()), *arguments);
-        if (trace_) {
-          PrintF("Materializing %sarguments object of length %d for %p: ",
-                 frame->has_adapted_arguments() ? "(adapted) " : "",
-                 arguments->elements()->length(),
-                 reinterpret_cast<void*>(descriptor.slot_address()));
-          arguments->ShortPrint();
-          PrintF("\n");
-        }
+  // Materialize arguments and captured objects in the order they were
+  // described, nested objects are materialized together with their parent.
+  List<Handle<Object> > materialized_objects(deferred_objects_.length());
+  materialized_values_ = &values;
+  materialized_objects_ = &materialized_objects;
+  while (materialization_object_index_ < deferred_objects_.length()) {
+    ObjectMaterializationDescriptor descriptor =
+        deferred_objects_[materialization_object_index_];
+    Handle<Object> object = MaterializeNextHeapObject();
+    if (descriptor.slot_address() == NULL) continue;
+    Memory::Object_at(descriptor.slot_address()) = *object;
+    if (trace_) {
+      if (descriptor.duplicate_object() >= 0) {
+        PrintF("Materializing duplicate of object #%d for %p: ",
+               descriptor.duplicate_object(),
+               reinterpret_cast<void*>(descriptor.slot_address()));
+      } else if (descriptor.is_arguments()) {
+        PrintF("Materializing %sarguments object of length %d for %p: ",
+               jsframe_has_adapted_arguments_[descriptor.jsframe_index()]
+                   ? "(adapted) " : "",
+               Handle<JSObject>::cast(object)->elements()->length(),
+               reinterpret_cast<void*>(descriptor.slot_address()));
+      } else {
+        PrintF("Materializing captured object of length %d for %p: ",
+               descriptor.object_length(),
+               reinterpret_cast<void*>(descriptor.slot_address()));
       }
+      object->ShortPrint();
+      PrintF("\n");
     }
   }
+  ASSERT(materialization_value_index_ == values.length());
+
+  for (int i = 0; i < deferred_object_aliases_.length(); i++) {
+    ObjectMaterializationDescriptor alias = deferred_object_aliases_[i];
+    Memory::Object_at(alias.slot_address()) =
+        *materialized_objects[alias.duplicate_object()];
+  }
+  materialized_values_ = NULL;
+  materialized_objects_ = NULL;
 }
 
 
@@ -1741,7 +1872,6 @@ void Deoptimizer::DoTranslateObject(TranslationIterator* iterator,
     case Translation::GETTER_STUB_FRAME:
     case Translation::SETTER_STUB_FRAME:
     case Translation::COMPILED_STUB_FRAME:
-    case Translation::ARGUMENTS_OBJECT:
     case Translation::DUPLICATE:
       UNREACHABLE();
       return;
@@ -1912,6 +2042,76 @@ void Deoptimizer::DoTranslateObject(TranslationIterator* iterator,
       AddObjectTaggedValue(value);
       return;
     }
+
+    case Translation::DUPLICATED_OBJECT: {
+      int object_index = iterator->Next();
+      if (trace_) {
+        PrintF("      nested @0x%08" V8PRIxPTR ": [field #%d] <- ",
+               reinterpret_cast<intptr_t>(object_slot),
+               field_index);
+        isolate_->heap()->arguments_marker()->ShortPrint();
+        PrintF(" ; duplicate of object #%d\n", object_index);
+      }
+      // Use the materialization marker value as a sentinel and fill in
+      // the object after the deoptimized frame is built.
+      intptr_t value = reinterpret_cast<intptr_t>(
+          isolate_->heap()->arguments_marker());
+      AddObjectDuplication(0, object_index);
+      AddObjectTaggedValue(value);
+      return;
+    }
+
+    case Translation::ARGUMENTS_OBJECT:
+    case Translation::CAPTURED_OBJECT: {
+      int length = iterator->Next();
+      bool is_args = opcode == Translation::ARGUMENTS_OBJECT;
+      if (trace_) {
+        PrintF("      nested @0x%08" V8PRIxPTR ": [field #%d] <- ",
+               reinterpret_cast<intptr_t>(object_slot),
+               field_index);
+        isolate_->heap()->arguments_marker()->ShortPrint();
+        PrintF(" ; object (length = %d, is_args = %d)\n", length, is_args);
+      }
+      // Use the materialization marker value as a sentinel and fill in
+      // the object after the deoptimized frame is built.
+      intptr_t value = reinterpret_cast<intptr_t>(
+          isolate_->heap()->arguments_marker());
+      AddObjectStart(0, length, is_args);
+      AddObjectTaggedValue(value);
+      // We save the object values on the side and materialize the actual
+      // object after the deoptimized frame is built.
+      for (int i = 0; i < length; i++) {
+        DoTranslateObject(iterator, opcode, i);
+      }
+      return;
+    }
+  }
+}
+
+
+void Deoptimizer::DoTranslateObjectAndSkip(TranslationIterator* iterator) {
+  Translation::Opcode opcode =
+      static_cast<Translation::Opcode>(iterator->Next());
+  switch (opcode) {
+    case Translation::DUPLICATED_OBJECT: {
+      int object_index = iterator->Next();
+      AddObjectDuplication(0, object_index);
+      return;
+    }
+
+    case Translation::ARGUMENTS_OBJECT:
+    case Translation::CAPTURED_OBJECT: {
+      int length = iterator->Next();
+      AddObjectStart(0, length, opcode == Translation::ARGUMENTS_OBJECT);
+      for (int i = 0; i < length; i++) {
+        DoTranslateObject(iterator, opcode, i);
+      }
+      return;
+    }
+
+    default:
+      iterator->Skip(Translation::NumberOfOperandsFor(opcode));
+      return;
   }
 }
 
@@ -2158,25 +2358,48 @@ void Deoptimizer::DoTranslateCommand(TranslationIterator* iterator,
       return;
     }
 
-    case Translation::ARGUMENTS_OBJECT: {
+    case Translation::DUPLICATED_OBJECT: {
+      int object_index = iterator->Next();
+      if (trace_) {
+        PrintF("    0x%08" V8PRIxPTR ": [top + %d] <- ",
+               output_[frame_index]->GetTop() + output_offset,
+               output_offset);
+        isolate_->heap()->arguments_marker()->ShortPrint();
+        PrintF(" ; duplicate of object #%d\n", object_index);
+      }
+      // Use the materialization marker value as a sentinel and fill in
+      // the object after the deoptimized frame is built.
+      intptr_t value = reinterpret_cast<intptr_t>(
+          isolate_->heap()->arguments_marker());
+      AddObjectDuplication(output_[frame_index]->GetTop() + output_offset,
+                           object_index);
+      output_[frame_index]->SetFrameSlot(output_offset, value);
+      return;
+    }
+
+    case Translation::ARGUMENTS_OBJECT:
+    case Translation::CAPTURED_OBJECT: {
       int length = iterator->Next();
+      bool is_args = opcode == Translation::ARGUMENTS_OBJECT;
       if (trace_) {
         PrintF("    0x%08" V8PRIxPTR ": [top + %d] <- ",
                output_[frame_index]->GetTop() + output_offset,
                output_offset);
         isolate_->heap()->arguments_marker()->ShortPrint();
-        PrintF(" ; arguments object (length = %d)\n", length);
+        PrintF(" ; %s object (length = %d)\n",
+               is_args ? "arguments" : "captured", length);
       }
-      // Use the arguments marker value as a sentinel and fill in the arguments
-      // object after the deoptimized frame is built.
+      // Use the materialization marker value as a sentinel and fill in
+      // the object after the deoptimized frame is built.
       intptr_t value = reinterpret_cast<intptr_t>(
           isolate_->heap()->arguments_marker());
-      AddObjectStart(output_[frame_index]->GetTop() + output_offset, length);
+      AddObjectStart(output_[frame_index]->GetTop() + output_offset,
+                     length, is_args);
       output_[frame_index]->SetFrameSlot(output_offset, value);
-      // We save the argument values on the side and materialize the actual
-      // arguments object after the deoptimized frame is built.
+      // We save the object values on the side and materialize the actual
+      // object after the deoptimized frame is built.
       for (int i = 0; i < length; i++) {
-        DoTranslateObject(iterator, Translation::ARGUMENTS_OBJECT, i);
+        DoTranslateObject(iterator, opcode, i);
       }
       return;
     }
@@ -2358,7 +2581,9 @@ bool Deoptimizer::DoOsrTranslateCommand(TranslationIterator* iterator,
       break;
     }
 
-    case Translation::ARGUMENTS_OBJECT: {
+    case Translation::DUPLICATED_OBJECT:
+    case Translation::ARGUMENTS_OBJECT:
+    case Translation::CAPTURED_OBJECT: {
       // Optimized code assumes that the argument object has not been
       // materialized and so bypasses it when doing arguments access.
       // We should have bailed out before starting the frame
@@ -2522,9 +2747,16 @@ Object* Deoptimizer::ComputeLiteral(int index) const {
 }
 
 
-void Deoptimizer::AddObjectStart(intptr_t slot_address, int length) {
+void Deoptimizer::AddObjectStart(intptr_t slot, int length, bool is_args) {
   ObjectMaterializationDescriptor object_desc(
-      reinterpret_cast<Address>(slot_address), length);
+      reinterpret_cast<Address>(slot), jsframe_count_, length, -1, is_args);
+  deferred_objects_.Add(object_desc);
+}
+
+
+void Deoptimizer::AddObjectDuplication(intptr_t slot, int object_index) {
+  ObjectMaterializationDescriptor object_desc(
+      reinterpret_cast<Address>(slot), jsframe_count_, -1, object_index, false);
   deferred_objects_.Add(object_desc);
 }
 
@@ -2761,6 +2993,18 @@ void Translation::BeginCompiledStubFrame() {
 }
 
 
+void Translation::BeginCapturedObject(int length) {
+  buffer_->Add(CAPTURED_OBJECT, zone());
+  buffer_->Add(length, zone());
+}
+
+
+void Translation::DuplicateObject(int object_index) {
+  buffer_->Add(DUPLICATED_OBJECT, zone());
+  buffer_->Add(object_index, zone());
+}
+
+
 void Translation::BeginArgumentsObject(int args_length) {
   buffer_->Add(ARGUMENTS_OBJECT, zone());
   buffer_->Add(args_length, zone());
@@ -2832,7 +3076,9 @@ int Translation::NumberOfOperandsFor(Opcode opcode) {
       return 0;
     case GETTER_STUB_FRAME:
     case SETTER_STUB_FRAME:
+    case DUPLICATED_OBJECT:
     case ARGUMENTS_OBJECT:
+    case CAPTURED_OBJECT:
     case REGISTER:
     case INT32_REGISTER:
     case UINT32_REGISTER:
@@ -2892,8 +3138,12 @@ const char* Translation::StringFor(Opcode opcode) {
       return "DOUBLE_STACK_SLOT";
     case LITERAL:
       return "LITERAL";
+    case DUPLICATED_OBJECT:
+      return "DUPLICATED_OBJECT";
     case ARGUMENTS_OBJECT:
       return "ARGUMENTS_OBJECT";
+    case CAPTURED_OBJECT:
+      return "CAPTURED_OBJECT";
     case DUPLICATE:
       return "DUPLICATE";
   }
@@ -2939,7 +3189,9 @@ SlotRef SlotRef::ComputeSlotForNextArgument(TranslationIterator* iterator,
       // Peeled off before getting here.
       break;
 
+    case Translation::DUPLICATED_OBJECT:
     case Translation::ARGUMENTS_OBJECT:
+    case Translation::CAPTURED_OBJECT:
       // This can be only emitted for local slots not for argument slots.
       break;
 
@@ -2993,6 +3245,21 @@ SlotRef SlotRef::ComputeSlotForNextArgument(TranslationIterator* iterator,
 }
 
 
+// Skips the translation command for a single value, including the values of
+// nested objects that are materialized by the deoptimizer.
+static void SkipTranslatedValue(TranslationIterator* iterator) {
+  Translation::Opcode opcode =
+      static_cast<Translation::Opcode>(iterator->Next());
+  if (opcode == Translation::ARGUMENTS_OBJECT ||
+      opcode == Translation::CAPTURED_OBJECT) {
+    int length = iterator->Next();
+    for (int i = 0; i < length; i++) SkipTranslatedValue(iterator);
+    return;
+  }
+  iterator->Skip(Translation::NumberOfOperandsFor(opcode));
+}
+
+
 void SlotRef::ComputeSlotsForArguments(Vector<SlotRef>* args_slots,
                                        TranslationIterator* it,
                                        DeoptimizationInputData* data,
@@ -3000,8 +3267,7 @@ void SlotRef::ComputeSlotsForArguments(Vector<SlotRef>* args_slots,
   // Process the translation commands for the arguments.
 
   // Skip the translation command for the receiver.
-  it->Skip(Translation::NumberOfOperandsFor(
-      static_cast<Translation::Opcode>(it->Next())));
+  SkipTranslatedValue(it);
 
   // Compute slots for arguments.
   for (int i = 0; i < args_slots->length(); ++i) {
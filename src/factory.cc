@@ -170,6 +170,14 @@ Handle<TypeFeedbackInfo> Factory::NewTypeFeedbackInfo() {
 }
 
 
+Handle<AllocationSite> Factory::NewAllocationSite(
+    Handle<JSObject> boilerplate) {
+  CALL_HEAP_FUNCTION(isolate(),
+                     isolate()->heap()->AllocateAllocationSite(*boilerplate),
+                     AllocationSite);
+}
+
+
 // Internalized strings are created in the old generation (data space).
 Handle<String> Factory::InternalizeUtf8String(Vector<const char> string) {
   CALL_HEAP_FUNCTION(isolate(),
@@ -84,6 +84,8 @@ class Factory {
 
   Handle<TypeFeedbackInfo> NewTypeFeedbackInfo();
 
+  Handle<AllocationSite> NewAllocationSite(Handle<JSObject> boilerplate);
+
   Handle<String> InternalizeUtf8String(Vector<const char> str);
   Handle<String> InternalizeUtf8String(const char* str) {
     return InternalizeUtf8String(CStrVector(str));
@@ -195,6 +195,8 @@ DEFINE_bool(clever_optimizations,
             true,
             "Optimize object size, Array shift, DOM strings and string +")
 DEFINE_bool(pretenuring, true, "allocate objects in old space")
+DEFINE_bool(allocation_site_pretenuring, true,
+            "pretenure literals whose copies survive scavenges")
 // TODO(hpayer): We will remove this flag as soon as we have pretenuring
 // support for specific allocation sites.
 DEFINE_bool(pretenuring_call_new, false, "pretenure call new")
@@ -217,6 +219,8 @@ DEFINE_bool(use_range, true, "use hydrogen range analysis")
 DEFINE_bool(use_gvn, true, "use hydrogen global value numbering")
 DEFINE_bool(use_canonicalizing, true, "use hydrogen instruction canonicalizing")
 DEFINE_bool(use_inlining, true, "use function inlining")
+DEFINE_bool(use_escape_analysis, true, "use hydrogen escape analysis")
+DEFINE_bool(use_load_elimination, true, "use hydrogen load elimination")
 DEFINE_int(max_inlined_source_size, 600,
            "maximum source size in bytes considered for a single inlining")
 DEFINE_int(max_inlined_nodes, 196,
@@ -236,9 +240,13 @@ DEFINE_bool(trace_alloc, false, "trace register allocator")
 DEFINE_bool(trace_all_uses, false, "trace all use positions")
 DEFINE_bool(trace_range, false, "trace range analysis")
 DEFINE_bool(trace_gvn, false, "trace global value numbering")
+DEFINE_bool(trace_escape_analysis, false, "trace hydrogen escape analysis")
+DEFINE_bool(trace_load_elimination, false, "trace hydrogen load elimination")
 DEFINE_bool(trace_representation, false, "trace representation types")
 DEFINE_bool(trace_track_allocation_sites, false,
             "trace the tracking of allocation sites")
+DEFINE_bool(trace_pretenuring, false,
+            "trace pretenuring decisions of allocation sites")
 DEFINE_bool(trace_migration, false, "trace object migration")
 DEFINE_bool(trace_generalization, false, "trace map generalization")
 DEFINE_bool(stress_pointer_maps, false, "pointer map for every instruction")
@@ -290,13 +298,17 @@ DEFINE_bool(opt_safe_uint32_operations, true,
             "allow uint32 values on optimize frames if they are used only in "
             "safe operations")
 
-DEFINE_bool(parallel_recompilation, false,
-            "optimizing hot functions asynchronously on a separate thread")
+DEFINE_bool(parallel_recompilation, true,
+            "optimizing hot functions asynchronously on separate threads")
 DEFINE_bool(trace_parallel_recompilation, false, "track parallel recompilation")
-DEFINE_int(parallel_recompilation_queue_length, 3,
+DEFINE_int(recompilation_threads, 0,
+           "number of parallel recompilation threads")
+DEFINE_int(parallel_recompilation_queue_length, 8,
            "the length of the parallel compilation queue")
 DEFINE_int(parallel_recompilation_delay, 0,
            "artificial compilation delay in ms")
+DEFINE_bool(parallel_osr, true,
+            "compile on-stack replacement code on the recompilation threads")
 DEFINE_bool(omit_prototype_checks_for_leaf_maps, true,
             "do not emit prototype checks if all prototypes have leaf maps, "
             "deoptimize the optimized code if the layout of the maps changes.")
@@ -407,6 +419,10 @@ DEFINE_bool(trace_stub_failures, false,
 // compiler.cc
 DEFINE_int(min_preparse_length, 1024,
            "minimum length for automatic enable preparsing")
+DEFINE_bool(cache_preparse_data, true,
+            "share the preparse data of large scripts between isolates")
+DEFINE_int(preparse_cache_size, 4096,
+           "maximum size of the process-wide preparse data cache (in kBytes)")
 DEFINE_bool(always_full_compiler, false,
             "try to use the dedicated run-once backend for all code")
 DEFINE_int(max_opt_count, 10,
@@ -488,11 +504,28 @@ DEFINE_bool(trace_incremental_marking, false,
 DEFINE_bool(track_gc_object_stats, false,
             "track object counts and memory usage")
 DEFINE_bool(parallel_sweeping, true, "enable parallel sweeping")
-DEFINE_bool(concurrent_sweeping, false, "enable concurrent sweeping")
+DEFINE_bool(concurrent_sweeping, true, "enable concurrent sweeping")
 DEFINE_int(sweeper_threads, 0,
            "number of parallel and concurrent sweeping threads")
 DEFINE_bool(parallel_marking, false, "enable parallel marking")
 DEFINE_int(marking_threads, 0, "number of parallel marking threads")
+DEFINE_int(parallel_marking_threshold, 256,
+           "minimum length of the marking deque to start parallel marking")
+DEFINE_bool(parallel_incremental_marking, false,
+            "let the marking threads help incremental marking steps")
+DEFINE_bool(trace_parallel_marking, false,
+            "print the work done by each task of parallel marking")
+DEFINE_bool(parallel_compaction, false,
+            "evacuate objects and update pointers with the marking threads")
+DEFINE_int(compaction_threads, 0,
+           "maximum number of marking threads used for parallel compaction "
+           "(0 means all)")
+DEFINE_bool(trace_parallel_compaction, false,
+            "print the work done by each task of parallel compaction")
+DEFINE_bool(parallel_scavenge, false, "enable parallel scavenging")
+DEFINE_int(scavenger_threads, 0, "number of parallel scavenging threads")
+DEFINE_bool(trace_parallel_scavenge, false,
+            "print the work done by each task of a parallel scavenge")
 #ifdef VERIFY_HEAP
 DEFINE_bool(verify_heap, false, "verify heap pointers before and after GC")
 #endif
@@ -500,9 +533,27 @@ DEFINE_bool(verify_heap, false, "verify heap pointers before and after GC")
 // v8.cc
 DEFINE_bool(use_idle_notification, true,
             "Use idle notification to reduce memory footprint.")
+DEFINE_bool(trace_idle_notification, false,
+            "print the GC work done for deadline based idle notifications")
+DEFINE_bool(memory_reducer, true,
+            "release memory of heaps that stay inactive during idle "
+            "notifications")
+DEFINE_int(memory_reducer_delay, 8000,
+           "ms of inactivity before the memory reducer runs")
 // ic.cc
 DEFINE_bool(use_ic, true, "use inline caching")
 
+// stub-cache.cc
+DEFINE_int(stub_cache_primary_bits, 11,
+           "log2 of the initial size of the primary stub cache table")
+DEFINE_int(stub_cache_secondary_bits, 9,
+           "log2 of the initial size of the secondary stub cache table")
+DEFINE_int(stub_cache_max_primary_bits, 14,
+           "log2 of the size up to which the primary stub cache table grows "
+           "when it thrashes")
+DEFINE_int(stub_cache_max_secondary_bits, 12,
+           "log2 of the size up to which the secondary stub cache table grows")
+
 // macro-assembler-ia32.cc
 DEFINE_bool(native_code_counters, false,
             "generate extra code for manipulating stats counters")
@@ -582,6 +633,9 @@ DEFINE_string(testing_serialization_file, "/tmp/serdes",
 // mksnapshot.cc
 DEFINE_string(extra_code, NULL, "A filename with extra code to be included in"
                   " the snapshot (mksnapshot only)")
+DEFINE_bool(lazy_snapshot_functions, true,
+            "serialize compiled functions as uncompiled, so that they are "
+            "only compiled when they are first called after deserialization")
 
 //
 // Dev shell flags
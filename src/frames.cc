@@ -968,16 +968,24 @@ void OptimizedFrame::Summarize(List<FrameSummary>* frames) {
 
       // The translation commands are ordered and the receiver is always
       // at the first position. Since we are always at a call when we need
-      // to construct a stack trace, the receiver is always in a stack slot.
+      // to construct a stack trace, the receiver is always in a stack slot
+      // unless it was never allocated by the optimized code.
       opcode = static_cast<Translation::Opcode>(it.Next());
       ASSERT(opcode == Translation::STACK_SLOT ||
-             opcode == Translation::LITERAL);
+             opcode == Translation::LITERAL ||
+             opcode == Translation::CAPTURED_OBJECT ||
+             opcode == Translation::DUPLICATED_OBJECT);
       int index = it.Next();
 
       // Get the correct receiver in the optimized frame.
       Object* receiver = NULL;
       if (opcode == Translation::LITERAL) {
         receiver = data->LiteralArray()->get(index);
+      } else if (opcode == Translation::CAPTURED_OBJECT ||
+                 opcode == Translation::DUPLICATED_OBJECT) {
+        // The receiver is only materialized on deoptimization. The values of
+        // a captured object are skipped like any other command below.
+        receiver = isolate()->heap()->undefined_value();
       } else {
         // Positive index means the value is spilled to the locals
         // area. Negative means it is stored in the incoming parameter
@@ -0,0 +1,142 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "v8.h"
+
+#include "gc-idle-time-handler.h"
+
+namespace v8 {
+namespace internal {
+
+
+const char* GCIdleTimeAction::ToString() const {
+  switch (type_) {
+    case DONE: return "done";
+    case DO_NOTHING: return "nothing";
+    case DO_INCREMENTAL_MARKING: return "incremental marking";
+    case DO_SWEEPING: return "sweeping";
+    case DO_SCAVENGE: return "scavenge";
+    case DO_FINALIZE_MARKING: return "finalize marking";
+    case DO_FULL_GC: return "full GC";
+  }
+  UNREACHABLE();
+  return NULL;
+}
+
+
+intptr_t GCIdleTimeHandler::EstimateMarkingStepSize(
+    int idle_time_in_ms) const {
+  ASSERT(idle_time_in_ms > 0);
+  intptr_t speed = MarkingSpeedInBytesPerMs();
+  // Avoid overflowing the step size for very long idle times.
+  const intptr_t kMaxStepSize = static_cast<intptr_t>(kMaxInt);
+  if (idle_time_in_ms > kMaxStepSize / speed) return kMaxStepSize;
+  return speed * idle_time_in_ms / 100 * kIdleTimeUsagePercent;
+}
+
+
+double GCIdleTimeHandler::EstimateScavengeTime(intptr_t new_space_size) const {
+  return EstimateTime(new_space_size,
+                      scavenge_speed_.SpeedInBytesPerMs(kInitialScavengeSpeed));
+}
+
+
+double GCIdleTimeHandler::EstimateIncrementalMarkingTime(
+    intptr_t size_of_objects) const {
+  return EstimateTime(size_of_objects, MarkingSpeedInBytesPerMs());
+}
+
+
+double GCIdleTimeHandler::EstimateFinalizationTime(
+    intptr_t size_of_objects) const {
+  // Until a finalization was measured assume it is as expensive as a
+  // full mark-compact, which is an upper bound.
+  intptr_t speed = finalization_speed_.SpeedInBytesPerMs(
+      mark_compact_speed_.SpeedInBytesPerMs(kInitialMarkCompactSpeed));
+  return Min(EstimateTime(size_of_objects, speed),
+             static_cast<double>(kMaxMarkCompactTimeInMs));
+}
+
+
+double GCIdleTimeHandler::EstimateMarkCompactTime(
+    intptr_t size_of_objects) const {
+  intptr_t speed =
+      mark_compact_speed_.SpeedInBytesPerMs(kInitialMarkCompactSpeed);
+  return Min(EstimateTime(size_of_objects, speed),
+             static_cast<double>(kMaxMarkCompactTimeInMs));
+}
+
+
+// The order of the checks below determines the priorities:
+// 1. A scavenge that would otherwise interrupt the mutator soon.
+// 2. Finishing incremental marking, which is the only work left then.
+// 3. A full GC after contexts were disposed, there is a lot of garbage.
+// 4. Sweeping the pages left from the last mark-compact.
+// 5. Starting or continuing incremental marking.
+GCIdleTimeAction GCIdleTimeHandler::Compute(int idle_time_in_ms,
+                                            const HeapState& state) {
+  if (idle_time_in_ms <= 0) {
+    if (state.incremental_marking_stopped &&
+        !state.can_start_incremental_marking) {
+      return GCIdleTimeAction::Done();
+    }
+    return GCIdleTimeAction::Nothing();
+  }
+
+  if (ScavengeMayHappenSoon(state) &&
+      EstimateScavengeTime(state.new_space_size) <= idle_time_in_ms) {
+    return GCIdleTimeAction::Scavenge();
+  }
+
+  if (state.incremental_marking_complete) {
+    if (EstimateFinalizationTime(state.size_of_objects) <= idle_time_in_ms) {
+      return GCIdleTimeAction::FinalizeMarking();
+    }
+    return GCIdleTimeAction::Nothing();
+  }
+
+  if (state.contexts_disposed > 0 && state.incremental_marking_stopped &&
+      EstimateMarkCompactTime(state.size_of_objects) <= idle_time_in_ms) {
+    return GCIdleTimeAction::FullGC();
+  }
+
+  intptr_t step_size = EstimateMarkingStepSize(idle_time_in_ms);
+  if (state.sweeping_in_progress) {
+    // Sweeping a page is cheaper than marking its objects, so the marking
+    // step size is a safe amount of sweeping.
+    return GCIdleTimeAction::Sweeping(step_size);
+  }
+
+  if (state.incremental_marking_stopped &&
+      !state.can_start_incremental_marking) {
+    return GCIdleTimeAction::Done();
+  }
+  return GCIdleTimeAction::IncrementalMarking(step_size);
+}
+
+} }  // namespace v8::internal
@@ -0,0 +1,189 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef V8_GC_IDLE_TIME_HANDLER_H_
+#define V8_GC_IDLE_TIME_HANDLER_H_
+
+#include "utils.h"
+
+namespace v8 {
+namespace internal {
+
+// Garbage collection work the heap performs in one idle period.
+class GCIdleTimeAction {
+ public:
+  enum Type {
+    DONE,                 // No more work until the mutator made garbage.
+    DO_NOTHING,           // Nothing fits into the idle time.
+    DO_INCREMENTAL_MARKING,
+    DO_SWEEPING,
+    DO_SCAVENGE,
+    DO_FINALIZE_MARKING,
+    DO_FULL_GC
+  };
+
+  static GCIdleTimeAction Done() { return GCIdleTimeAction(DONE, 0); }
+  static GCIdleTimeAction Nothing() { return GCIdleTimeAction(DO_NOTHING, 0); }
+  static GCIdleTimeAction IncrementalMarking(intptr_t step_size) {
+    return GCIdleTimeAction(DO_INCREMENTAL_MARKING, step_size);
+  }
+  static GCIdleTimeAction Sweeping(intptr_t step_size) {
+    return GCIdleTimeAction(DO_SWEEPING, step_size);
+  }
+  static GCIdleTimeAction Scavenge() {
+    return GCIdleTimeAction(DO_SCAVENGE, 0);
+  }
+  static GCIdleTimeAction FinalizeMarking() {
+    return GCIdleTimeAction(DO_FINALIZE_MARKING, 0);
+  }
+  static GCIdleTimeAction FullGC() { return GCIdleTimeAction(DO_FULL_GC, 0); }
+
+  Type type() const { return type_; }
+  // The number of bytes to mark or sweep.
+  intptr_t step_size() const { return step_size_; }
+
+  const char* ToString() const;
+
+ private:
+  GCIdleTimeAction(Type type, intptr_t step_size)
+      : type_(type), step_size_(step_size) { }
+
+  Type type_;
+  intptr_t step_size_;
+};
+
+
+// Tracks the throughput of one kind of garbage collection work.  Every new
+// sample halves the weight of the older ones, so the speed follows changes
+// of the heap shape quickly.
+class GCSpeedCounter {
+ public:
+  GCSpeedCounter() : bytes_(0), time_in_ms_(0) { }
+
+  void AddSample(intptr_t bytes, double time_in_ms) {
+    bytes_ = bytes_ / 2 + bytes;
+    time_in_ms_ = time_in_ms_ / 2 + time_in_ms;
+  }
+
+  // Returns the measured speed, or the given default if nothing was
+  // measured yet.
+  intptr_t SpeedInBytesPerMs(intptr_t default_speed) const {
+    if (bytes_ <= 0 || time_in_ms_ <= 0) return default_speed;
+    return Max(static_cast<intptr_t>(bytes_ / time_in_ms_),
+               static_cast<intptr_t>(1));
+  }
+
+ private:
+  double bytes_;
+  double time_in_ms_;
+};
+
+
+// Decides which garbage collection work fits into the idle time the embedder
+// announced.  The cost of each kind of work is estimated from the speed the
+// heap measured for it recently.
+class GCIdleTimeHandler {
+ public:
+  // The state of the heap the decision is based on.
+  struct HeapState {
+    int contexts_disposed;
+    intptr_t size_of_objects;
+    intptr_t new_space_size;
+    intptr_t new_space_capacity;
+    bool incremental_marking_stopped;
+    bool incremental_marking_complete;
+    bool can_start_incremental_marking;
+    bool sweeping_in_progress;
+  };
+
+  // Speeds assumed before anything was measured.  They are deliberately
+  // pessimistic so that an unmeasured heap does not overrun the idle time.
+  static const intptr_t kInitialMarkingSpeed = 100 * KB;
+  static const intptr_t kInitialMarkCompactSpeed = 100 * KB;
+  static const intptr_t kInitialScavengeSpeed = 100 * KB;
+
+  // Maximum time estimated for a finalization or a full GC.
+  static const int kMaxMarkCompactTimeInMs = 1000;
+
+  // Scavenge in idle time once the new space is this full (in percent).
+  static const int kScavengeNewSpaceUsagePercent = 80;
+
+  // Only this part of the idle time is planned for marking, to leave some
+  // slack for the bookkeeping around the step (in percent).
+  static const int kIdleTimeUsagePercent = 90;
+
+  GCIdleTimeHandler() { }
+
+  GCIdleTimeAction Compute(int idle_time_in_ms, const HeapState& state);
+
+  void RecordScavenge(intptr_t bytes, double time_in_ms) {
+    scavenge_speed_.AddSample(bytes, time_in_ms);
+  }
+  void RecordIncrementalMarkingStep(intptr_t bytes, double time_in_ms) {
+    marking_speed_.AddSample(bytes, time_in_ms);
+  }
+  void RecordFinalization(intptr_t bytes, double time_in_ms) {
+    finalization_speed_.AddSample(bytes, time_in_ms);
+  }
+  void RecordMarkCompact(intptr_t bytes, double time_in_ms) {
+    mark_compact_speed_.AddSample(bytes, time_in_ms);
+  }
+
+  intptr_t MarkingSpeedInBytesPerMs() const {
+    return marking_speed_.SpeedInBytesPerMs(kInitialMarkingSpeed);
+  }
+
+  // The number of bytes incremental marking can process in the given time.
+  intptr_t EstimateMarkingStepSize(int idle_time_in_ms) const;
+
+  double EstimateScavengeTime(intptr_t new_space_size) const;
+  double EstimateIncrementalMarkingTime(intptr_t size_of_objects) const;
+  double EstimateFinalizationTime(intptr_t size_of_objects) const;
+  double EstimateMarkCompactTime(intptr_t size_of_objects) const;
+
+ private:
+  static double EstimateTime(intptr_t bytes, intptr_t speed) {
+    return static_cast<double>(bytes) / speed;
+  }
+
+  bool ScavengeMayHappenSoon(const HeapState& state) const {
+    return state.new_space_size * 100 >=
+        state.new_space_capacity * kScavengeNewSpaceUsagePercent;
+  }
+
+  GCSpeedCounter scavenge_speed_;
+  GCSpeedCounter marking_speed_;
+  GCSpeedCounter finalization_speed_;
+  GCSpeedCounter mark_compact_speed_;
+
+  DISALLOW_COPY_AND_ASSIGN(GCIdleTimeHandler);
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_GC_IDLE_TIME_HANDLER_H_
@@ -164,7 +164,10 @@ void SetExpectedNofProperties(Handle<JSFunction> func, int nof) {
         func->GetIsolate()->factory()->CopyMap(
             Handle<Map>(func->initial_map()));
     new_initial_map->set_unused_property_fields(nof);
+    Handle<Map> old_initial_map(func->initial_map());
     func->set_initial_map(*new_initial_map);
+    old_initial_map->dependent_code()->DeoptimizeDependentCodeGroup(
+        func->GetIsolate(), DependentCode::kInitialMapChangedGroup);
   }
 }
 
@@ -836,6 +839,15 @@ Handle<FixedArray> GetEnumPropertyKeys(Handle<JSObject> object,
       return Handle<FixedArray>(isolate->heap()->empty_fixed_array());
     }
 
+    // Reuse the keys cached by the previous enumeration if the dictionary
+    // has not changed since. Global objects are not cached.
+    bool cache_keys = cache_result && !object->IsGlobalObject();
+    if (cache_keys && dictionary->GetEnumCache()->IsFixedArray()) {
+      isolate->counters()->enum_cache_hits()->Increment();
+      return Handle<FixedArray>(FixedArray::cast(dictionary->GetEnumCache()),
+                                isolate);
+    }
+
     // The enumeration array is generated by allocating an array big enough to
     // hold all properties that have been seen, whether they are are deleted or
     // not. Subsequently all visible properties are added to the array. If some
@@ -859,6 +871,10 @@ Handle<FixedArray> GetEnumPropertyKeys(Handle<JSObject> object,
 
     storage = Handle<FixedArray>(dictionary->CopyEnumKeysTo(*storage));
     ASSERT(storage->length() == object->NumberOfLocalProperties(DONT_SHOW));
+    if (cache_keys) {
+      isolate->counters()->enum_cache_misses()->Increment();
+      dictionary->SetEnumCache(*storage);
+    }
     return storage;
   }
 }
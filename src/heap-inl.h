@@ -198,13 +198,14 @@ MaybeObject* Heap::AllocateTwoByteInternalizedString(Vector<const uc16> str,
   return answer;
 }
 
-MaybeObject* Heap::CopyFixedArray(FixedArray* src) {
-  return CopyFixedArrayWithMap(src, src->map());
+MaybeObject* Heap::CopyFixedArray(FixedArray* src, PretenureFlag pretenure) {
+  return CopyFixedArrayWithMap(src, src->map(), pretenure);
 }
 
 
-MaybeObject* Heap::CopyFixedDoubleArray(FixedDoubleArray* src) {
-  return CopyFixedDoubleArrayWithMap(src, src->map());
+MaybeObject* Heap::CopyFixedDoubleArray(FixedDoubleArray* src,
+                                       PretenureFlag pretenure) {
+  return CopyFixedDoubleArrayWithMap(src, src->map(), pretenure);
 }
 
 
@@ -493,6 +494,39 @@ void Heap::ScavengeObject(HeapObject** p, HeapObject* object) {
 }
 
 
+void Heap::UpdateAllocationSiteFeedback(HeapObject* object, Map* map) {
+  if (!FLAG_allocation_site_pretenuring) return;
+  if (!map->CanTrackAllocationSite()) return;
+  ASSERT(InFromSpace(object));
+
+  // The allocation site info directly follows the object. It has to lie on
+  // the same page and below the allocation top the space had when it was
+  // flipped, everything else is not initialized.
+  Address info_address = object->address() + map->instance_size();
+  Address info_end = info_address + AllocationSiteInfo::kSize;
+  NewSpacePage* page = NewSpacePage::FromAddress(object->address());
+  if (NewSpacePage::FromLimit(info_end) != page) return;
+  if (page == NewSpacePage::FromLimit(scavenged_space_top_) &&
+      info_end > scavenged_space_top_) {
+    return;
+  }
+  if (Memory::Object_at(info_address) != allocation_site_info_map()) return;
+
+  Object* payload = Memory::Object_at(
+      info_address + AllocationSiteInfo::kPayloadOffset);
+  // Other payloads, e.g. the cells of array constructor call sites, may be
+  // in new space and already forwarded.
+  if (!payload->IsHeapObject() || InNewSpace(payload)) return;
+  if (HeapObject::cast(payload)->map() != allocation_site_map()) return;
+
+  AllocationSite* site = AllocationSite::cast(payload);
+  if (site->IncrementMementoFoundCount()) {
+    ScopedLock lock(surviving_allocation_sites_mutex_);
+    surviving_allocation_sites_.Add(site);
+  }
+}
+
+
 MaybeObject* Heap::AllocateEmptyJSArrayWithAllocationSite(
       ElementsKind elements_kind,
       Handle<Object> allocation_site_payload) {
@@ -113,6 +113,8 @@ Heap::Heap()
       gc_count_(0),
       remembered_unmapped_pages_index_(0),
       unflattened_strings_length_(0),
+      scavenged_space_top_(NULL),
+      surviving_allocation_sites_mutex_(NULL),
 #ifdef DEBUG
       allocation_timeout_(0),
       disallow_allocation_failure_(false),
@@ -128,6 +130,9 @@ Heap::Heap()
       hidden_string_(NULL),
       global_gc_prologue_callback_(NULL),
       global_gc_epilogue_callback_(NULL),
+      soft_heap_limit_(0),
+      soft_heap_limit_callback_(NULL),
+      in_soft_heap_limit_callback_(false),
       gc_safe_size_of_old_object_(NULL),
       total_regexp_code_generated_(0),
       tracer_(NULL),
@@ -148,6 +153,7 @@ Heap::Heap()
       store_buffer_(this),
       marking_(this),
       incremental_marking_(this),
+      parallel_scavenger_(this),
       number_idle_notifications_(0),
       last_idle_notification_gc_count_(0),
       last_idle_notification_gc_count_init_(false),
@@ -155,6 +161,10 @@ Heap::Heap()
       ms_count_at_last_idle_notification_(0),
       gc_count_at_last_idle_gc_(0),
       scavenges_since_last_idle_round_(kIdleScavengeThreshold),
+      memory_reducer_inactive_since_ms_(-1),
+      memory_reducer_gc_count_(0),
+      memory_reducer_new_space_top_(NULL),
+      memory_reduced_since_last_activity_(false),
       gcs_since_last_deopt_(0),
 #ifdef VERIFY_HEAP
       no_weak_embedded_maps_verification_scope_depth_(0),
@@ -625,6 +635,25 @@ void Heap::CollectAllAvailableGarbage(const char* gc_reason) {
 }
 
 
+intptr_t Heap::ReduceMemory(const char* gc_reason) {
+  intptr_t committed_before = CommittedMemory();
+  CollectAllGarbage(kReduceMemoryMask, gc_reason);
+  // The full GC emptied the new space, so the semispaces go back to their
+  // initial capacity.
+  new_space_.Shrink();
+  UncommitFromSpace();
+  incremental_marking()->UncommitMarkingDeque();
+  intptr_t released = Max(committed_before - CommittedMemory(),
+                          static_cast<intptr_t>(0));
+  if (FLAG_trace_gc) {
+    PrintPID("Memory reducer: released %" V8_PTR_PREFIX "d KB, "
+             "committed %" V8_PTR_PREFIX "d KB\n",
+             released / KB, CommittedMemory() / KB);
+  }
+  return released;
+}
+
+
 bool Heap::CollectGarbage(AllocationSpace space,
                           GarbageCollector collector,
                           const char* gc_reason,
@@ -698,10 +727,50 @@ bool Heap::CollectGarbage(AllocationSpace space,
     incremental_marking()->Start();
   }
 
+  CheckSoftHeapLimit();
+
   return next_gc_likely_to_collect_more;
 }
 
 
+void Heap::CheckSoftHeapLimit() {
+  if (soft_heap_limit_callback_ == NULL || in_soft_heap_limit_callback_) {
+    return;
+  }
+  intptr_t size_of_objects = SizeOfObjects();
+  if (size_of_objects <= soft_heap_limit_) return;
+
+  if (FLAG_trace_gc) {
+    PrintPID("Soft heap limit of %" V8_PTR_PREFIX "d KB exceeded, "
+             "%" V8_PTR_PREFIX "d KB used\n",
+             soft_heap_limit_ / KB, size_of_objects / KB);
+  }
+  // The callback may trigger another GC, which must not call it again.
+  in_soft_heap_limit_callback_ = true;
+  size_t limit = static_cast<size_t>(soft_heap_limit_);
+  v8::SoftHeapLimitAction action;
+  {
+    VMState<EXTERNAL> state(isolate_);
+    action = soft_heap_limit_callback_(
+        reinterpret_cast<v8::Isolate*>(isolate_),
+        static_cast<size_t>(size_of_objects),
+        &limit);
+  }
+  switch (action) {
+    case v8::kSoftHeapLimitRaise:
+      soft_heap_limit_ = static_cast<intptr_t>(limit);
+      break;
+    case v8::kSoftHeapLimitTerminate:
+      isolate_->stack_guard()->TerminateExecution();
+      break;
+    case v8::kSoftHeapLimitReduceMemory:
+      ReduceMemory("soft heap limit exceeded");
+      break;
+  }
+  in_soft_heap_limit_callback_ = false;
+}
+
+
 void Heap::PerformScavenge() {
   GCTracer tracer(this, NULL, NULL);
   if (incremental_marking()->IsStopped()) {
@@ -934,8 +1003,20 @@ bool Heap::PerformGarbageCollection(GarbageCollector collector,
   }
 
   if (collector == MARK_COMPACTOR) {
-    // Perform mark-sweep with optional compaction.
+    // Perform mark-sweep with optional compaction.  Mark-compacts that only
+    // finish incremental marking partially are not representative of either
+    // kind and are not measured.
+    intptr_t size_of_objects = SizeOfObjects();
+    bool finalizes_marking = incremental_marking()->IsComplete();
+    bool is_full = incremental_marking()->IsStopped();
+    double start = OS::TimeCurrentMillis();
     MarkCompact(tracer);
+    double duration = OS::TimeCurrentMillis() - start;
+    if (finalizes_marking) {
+      gc_idle_time_handler_.RecordFinalization(size_of_objects, duration);
+    } else if (is_full) {
+      gc_idle_time_handler_.RecordMarkCompact(size_of_objects, duration);
+    }
     sweep_generation_++;
 
     UpdateSurvivalRateTrend(start_new_space_size);
@@ -948,7 +1029,10 @@ bool Heap::PerformGarbageCollection(GarbageCollector collector,
     old_gen_exhausted_ = false;
   } else {
     tracer_ = tracer;
+    double start = OS::TimeCurrentMillis();
     Scavenge();
+    gc_idle_time_handler_.RecordScavenge(start_new_space_size,
+                                         OS::TimeCurrentMillis() - start);
     tracer_ = NULL;
 
     UpdateSurvivalRateTrend(start_new_space_size);
@@ -1335,6 +1419,15 @@ void Heap::Scavenge() {
   paged_space(OLD_DATA_SPACE)->EnsureSweeperProgress(new_space_.Size());
   paged_space(OLD_POINTER_SPACE)->EnsureSweeperProgress(new_space_.Size());
 
+  bool scavenge_in_parallel =
+      parallel_scavenger()->CanScavengeInParallel() &&
+      parallel_scavenger()->ReserveOldSpace(new_space_.Size());
+
+  // Remember where allocation stopped, allocation site infos beyond this
+  // address in from space are stale.
+  scavenged_space_top_ = new_space_.top();
+  surviving_allocation_sites_.Clear();
+
   // Flip the semispaces.  After flipping, to space is empty, from space has
   // live objects.
   new_space_.Flip();
@@ -1365,42 +1458,59 @@ void Heap::Scavenge() {
 #endif
 
   ScavengeVisitor scavenge_visitor(this);
-  // Copy roots.
-  IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
-
-  // Copy objects reachable from the old generation.
-  {
-    StoreBufferRebuildScope scope(this,
-                                  store_buffer(),
-                                  &ScavengeStoreBufferCallback);
-    store_buffer()->IteratePointersToNewSpace(&ScavengeObject);
-  }
+  if (scavenge_in_parallel) {
+    // Copy everything reachable from the roots and from the old generation
+    // using all scavenger threads.  Every copied object has been scanned
+    // afterwards, so the serial phase below starts at the allocation top.
+    GCTracer::Scope gc_scope(tracer(), GCTracer::Scope::SCAVENGER_PARALLEL);
+    parallel_scavenger()->Scavenge();
+    new_space_front = new_space_.top();
+    // The scavenger threads fill to-space through their own buffers and
+    // never move the limit of the promotion queue.  Catch up before the
+    // serial phase below starts promoting objects.
+    promotion_queue_.ActivateGuardIfOnTheSamePage();
+    promotion_queue_.SetNewLimit(new_space_front);
+  } else {
+    // Copy roots.
+    IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
 
-  // Copy objects reachable from simple cells by scavenging cell values
-  // directly.
-  HeapObjectIterator cell_iterator(cell_space_);
-  for (HeapObject* heap_object = cell_iterator.Next();
-       heap_object != NULL;
-       heap_object = cell_iterator.Next()) {
-    if (heap_object->IsCell()) {
-      Cell* cell = Cell::cast(heap_object);
-      Address value_address = cell->ValueAddress();
-      scavenge_visitor.VisitPointer(reinterpret_cast<Object**>(value_address));
+    // Copy objects reachable from the old generation.
+    {
+      StoreBufferRebuildScope scope(this,
+                                    store_buffer(),
+                                    &ScavengeStoreBufferCallback);
+      store_buffer()->IteratePointersToNewSpace(&ScavengeObject);
+    }
+
+    // Copy objects reachable from simple cells by scavenging cell values
+    // directly.
+    HeapObjectIterator cell_iterator(cell_space_);
+    for (HeapObject* heap_object = cell_iterator.Next();
+         heap_object != NULL;
+         heap_object = cell_iterator.Next()) {
+      if (heap_object->IsCell()) {
+        Cell* cell = Cell::cast(heap_object);
+        Address value_address = cell->ValueAddress();
+        scavenge_visitor.VisitPointer(
+            reinterpret_cast<Object**>(value_address));
+      }
     }
-  }
 
-  // Copy objects reachable from global property cells by scavenging global
-  // property cell values directly.
-  HeapObjectIterator js_global_property_cell_iterator(property_cell_space_);
-  for (HeapObject* heap_object = js_global_property_cell_iterator.Next();
-       heap_object != NULL;
-       heap_object = js_global_property_cell_iterator.Next()) {
-    if (heap_object->IsJSGlobalPropertyCell()) {
-      JSGlobalPropertyCell* cell = JSGlobalPropertyCell::cast(heap_object);
-      Address value_address = cell->ValueAddress();
-      scavenge_visitor.VisitPointer(reinterpret_cast<Object**>(value_address));
-      Address type_address = cell->TypeAddress();
-      scavenge_visitor.VisitPointer(reinterpret_cast<Object**>(type_address));
+    // Copy objects reachable from global property cells by scavenging global
+    // property cell values directly.
+    HeapObjectIterator js_global_property_cell_iterator(property_cell_space_);
+    for (HeapObject* heap_object = js_global_property_cell_iterator.Next();
+         heap_object != NULL;
+         heap_object = js_global_property_cell_iterator.Next()) {
+      if (heap_object->IsJSGlobalPropertyCell()) {
+        JSGlobalPropertyCell* cell = JSGlobalPropertyCell::cast(heap_object);
+        Address value_address = cell->ValueAddress();
+        scavenge_visitor.VisitPointer(
+            reinterpret_cast<Object**>(value_address));
+        Address type_address = cell->TypeAddress();
+        scavenge_visitor.VisitPointer(
+            reinterpret_cast<Object**>(type_address));
+      }
     }
   }
 
@@ -1445,6 +1555,10 @@ void Heap::Scavenge() {
 
   ASSERT(new_space_front == new_space_.top());
 
+  if (ProcessPretenuringFeedback()) {
+    Deoptimizer::DeoptimizeMarkedCode(isolate_);
+  }
+
   // Set age mark.
   new_space_.set_age_mark(new_space_.top());
 
@@ -1463,6 +1577,18 @@ void Heap::Scavenge() {
 }
 
 
+bool Heap::ProcessPretenuringFeedback() {
+  bool deoptimize = false;
+  for (int i = 0; i < surviving_allocation_sites_.length(); i++) {
+    if (surviving_allocation_sites_[i]->DigestPretenuringFeedback()) {
+      deoptimize = true;
+    }
+  }
+  surviving_allocation_sites_.Clear();
+  return deoptimize;
+}
+
+
 String* Heap::UpdateNewSpaceReferenceInExternalStringTableEntry(Heap* heap,
                                                                 Object** p) {
   MapWord first_word = HeapObject::cast(*p)->map_word();
@@ -1905,6 +2031,10 @@ class ScavengingVisitor : public StaticVisitorBase {
                     &ObjectEvacuationStrategy<POINTER_OBJECT>::
                     Visit);
 
+    table_.Register(kVisitAllocationSite,
+                    &ObjectEvacuationStrategy<POINTER_OBJECT>::
+                        template VisitSpecialized<AllocationSite::kSize>);
+
     table_.Register(kVisitJSArrayBuffer,
                     &ObjectEvacuationStrategy<POINTER_OBJECT>::
                     Visit);
@@ -2233,12 +2363,16 @@ static void InitializeScavengingVisitorsTables() {
 }
 
 
-void Heap::SelectScavengingVisitorsTable() {
-  bool logging_and_profiling =
-      isolate()->logger()->is_logging() ||
+bool Heap::IsLoggingOrProfiling() {
+  return isolate()->logger()->is_logging() ||
       isolate()->cpu_profiler()->is_profiling() ||
       (isolate()->heap_profiler() != NULL &&
        isolate()->heap_profiler()->is_profiling());
+}
+
+
+void Heap::SelectScavengingVisitorsTable() {
+  bool logging_and_profiling = IsLoggingOrProfiling();
 
   if (!incremental_marking()->IsMarking()) {
     if (!logging_and_profiling) {
@@ -2280,6 +2414,7 @@ void Heap::ScavengeObjectSlow(HeapObject** p, HeapObject* object) {
   MapWord first_word = object->map_word();
   SLOW_ASSERT(!first_word.IsForwardingAddress());
   Map* map = first_word.ToMap();
+  map->GetHeap()->UpdateAllocationSiteFeedback(object, map);
   map->GetHeap()->DoScavengeObject(map, p, object);
 }
 
@@ -2381,6 +2516,22 @@ MaybeObject* Heap::AllocateTypeFeedbackInfo() {
 }
 
 
+MaybeObject* Heap::AllocateAllocationSite(JSObject* boilerplate) {
+  AllocationSite* site;
+  { MaybeObject* maybe_site = AllocateStruct(ALLOCATION_SITE_TYPE);
+    if (!maybe_site->To(&site)) return maybe_site;
+  }
+  site->set_boilerplate(boilerplate);
+  site->set_dependent_code(DependentCode::cast(empty_fixed_array()),
+                           SKIP_WRITE_BARRIER);
+  site->set_memento_found_count(0);
+  site->set_memento_create_count(0);
+  site->set_pretenure_decision(AllocationSite::kUndecided);
+  site->set_weak_next(Smi::FromInt(0), SKIP_WRITE_BARRIER);
+  return site;
+}
+
+
 MaybeObject* Heap::AllocateAliasedArgumentsEntry(int aliased_context_slot) {
   AliasedArgumentsEntry* entry;
   { MaybeObject* maybe_entry = AllocateStruct(ALIASED_ARGUMENTS_ENTRY_TYPE);
@@ -3294,8 +3445,9 @@ int Heap::FullSizeNumberStringCacheLength() {
 void Heap::AllocateFullSizeNumberStringCache() {
   // The idea is to have a small number string cache in the snapshot to keep
   // boot-time memory usage down.  If we expand the number string cache already
-  // while creating the snapshot then that didn't work out.
-  ASSERT(!Serializer::enabled() || FLAG_extra_code != NULL);
+  // while setting up the natives for the snapshot then that didn't work out.
+  // Embedder code included in the snapshot may expand it.
+  ASSERT(!Serializer::enabled() || !isolate()->bootstrapper()->IsActive());
   MaybeObject* maybe_obj =
       AllocateFixedArray(FullSizeNumberStringCacheLength(), TENURED);
   Object* new_cache;
@@ -4785,7 +4937,7 @@ MaybeObject* Heap::AllocateGlobalObject(JSFunction* constructor) {
 }
 
 
-MaybeObject* Heap::CopyJSObject(JSObject* source) {
+MaybeObject* Heap::CopyJSObject(JSObject* source, AllocationSite* site) {
   // Never used to copy functions.  If functions need to be copied we
   // have to be careful to clear the literals array.
   SLOW_ASSERT(!source->IsJSFunction());
@@ -4795,95 +4947,29 @@ MaybeObject* Heap::CopyJSObject(JSObject* source) {
   int object_size = map->instance_size();
   Object* clone;
 
-  WriteBarrierMode wb_mode = UPDATE_WRITE_BARRIER;
-
-  // If we're forced to always allocate, we use the general allocation
-  // functions which may leave us with an object in old space.
-  if (always_allocate()) {
-    { MaybeObject* maybe_clone =
-          AllocateRaw(object_size, NEW_SPACE, OLD_POINTER_SPACE);
-      if (!maybe_clone->ToObject(&clone)) return maybe_clone;
-    }
-    Address clone_address = HeapObject::cast(clone)->address();
-    CopyBlock(clone_address,
-              source->address(),
-              object_size);
-    // Update write barrier for all fields that lie beyond the header.
-    RecordWrites(clone_address,
-                 JSObject::kHeaderSize,
-                 (object_size - JSObject::kHeaderSize) / kPointerSize);
-  } else {
-    wb_mode = SKIP_WRITE_BARRIER;
-
-    { MaybeObject* maybe_clone = new_space_.AllocateRaw(object_size);
-      if (!maybe_clone->ToObject(&clone)) return maybe_clone;
-    }
-    SLOW_ASSERT(InNewSpace(clone));
-    // Since we know the clone is allocated in new space, we can copy
-    // the contents without worrying about updating the write barrier.
-    CopyBlock(HeapObject::cast(clone)->address(),
-              source->address(),
-              object_size);
-  }
-
-  SLOW_ASSERT(
-      JSObject::cast(clone)->GetElementsKind() == source->GetElementsKind());
-  FixedArrayBase* elements = FixedArrayBase::cast(source->elements());
-  FixedArray* properties = FixedArray::cast(source->properties());
-  // Update elements if necessary.
-  if (elements->length() > 0) {
-    Object* elem;
-    { MaybeObject* maybe_elem;
-      if (elements->map() == fixed_cow_array_map()) {
-        maybe_elem = FixedArray::cast(elements);
-      } else if (source->HasFastDoubleElements()) {
-        maybe_elem = CopyFixedDoubleArray(FixedDoubleArray::cast(elements));
-      } else {
-        maybe_elem = CopyFixedArray(FixedArray::cast(elements));
-      }
-      if (!maybe_elem->ToObject(&elem)) return maybe_elem;
-    }
-    JSObject::cast(clone)->set_elements(FixedArrayBase::cast(elem), wb_mode);
-  }
-  // Update properties if necessary.
-  if (properties->length() > 0) {
-    Object* prop;
-    { MaybeObject* maybe_prop = CopyFixedArray(properties);
-      if (!maybe_prop->ToObject(&prop)) return maybe_prop;
-    }
-    JSObject::cast(clone)->set_properties(FixedArray::cast(prop), wb_mode);
-  }
-  // Return the new clone.
-  return clone;
-}
-
-
-MaybeObject* Heap::CopyJSObjectWithAllocationSite(JSObject* source) {
-  // Never used to copy functions.  If functions need to be copied we
-  // have to be careful to clear the literals array.
-  SLOW_ASSERT(!source->IsJSFunction());
-
-  // Make the clone.
-  Map* map = source->map();
-  int object_size = map->instance_size();
-  Object* clone;
-
-  ASSERT(map->CanTrackAllocationSite());
-  ASSERT(map->instance_type() == JS_ARRAY_TYPE);
+  // Copies made for a tenured allocation site go directly to old space,
+  // all others may record their site in an allocation site info.
+  PretenureFlag pretenure =
+      site != NULL ? site->GetPretenureMode() : NOT_TENURED;
+  bool track_origin = site != NULL && pretenure == NOT_TENURED &&
+      map->CanTrackAllocationSite() && site->GetMode() == TRACK_ALLOCATION_SITE;
   WriteBarrierMode wb_mode = UPDATE_WRITE_BARRIER;
 
   // If we're forced to always allocate, we use the general allocation
   // functions which may leave us with an object in old space.
   int adjusted_object_size = object_size;
-  if (always_allocate()) {
+  if (always_allocate() || pretenure == TENURED) {
     // We'll only track origin if we are certain to allocate in new space
     const int kMinFreeNewSpaceAfterGC = InitialSemiSpaceSize() * 3/4;
-    if ((object_size + AllocationSiteInfo::kSize) < kMinFreeNewSpaceAfterGC) {
+    if (track_origin &&
+        (object_size + AllocationSiteInfo::kSize) < kMinFreeNewSpaceAfterGC) {
       adjusted_object_size += AllocationSiteInfo::kSize;
     }
 
+    AllocationSpace space =
+        pretenure == TENURED ? OLD_POINTER_SPACE : NEW_SPACE;
     { MaybeObject* maybe_clone =
-          AllocateRaw(adjusted_object_size, NEW_SPACE, OLD_POINTER_SPACE);
+          AllocateRaw(adjusted_object_size, space, OLD_POINTER_SPACE);
       if (!maybe_clone->ToObject(&clone)) return maybe_clone;
     }
     Address clone_address = HeapObject::cast(clone)->address();
@@ -4891,29 +4977,12 @@ MaybeObject* Heap::CopyJSObjectWithAllocationSite(JSObject* source) {
               source->address(),
               object_size);
     // Update write barrier for all fields that lie beyond the header.
-    int write_barrier_offset = adjusted_object_size > object_size
-        ? JSArray::kSize + AllocationSiteInfo::kSize
-        : JSObject::kHeaderSize;
-    if (((object_size - write_barrier_offset) / kPointerSize) > 0) {
-      RecordWrites(clone_address,
-                   write_barrier_offset,
-                   (object_size - write_barrier_offset) / kPointerSize);
-    }
-
-    // Track allocation site information, if we failed to allocate it inline.
-    if (InNewSpace(clone) &&
-        adjusted_object_size == object_size) {
-      MaybeObject* maybe_alloc_info =
-          AllocateStruct(ALLOCATION_SITE_INFO_TYPE);
-      AllocationSiteInfo* alloc_info;
-      if (maybe_alloc_info->To(&alloc_info)) {
-        alloc_info->set_map_no_write_barrier(allocation_site_info_map());
-        alloc_info->set_payload(source, SKIP_WRITE_BARRIER);
-      }
-    }
+    RecordWrites(clone_address,
+                 JSObject::kHeaderSize,
+                 (object_size - JSObject::kHeaderSize) / kPointerSize);
   } else {
     wb_mode = SKIP_WRITE_BARRIER;
-    adjusted_object_size += AllocationSiteInfo::kSize;
+    if (track_origin) adjusted_object_size += AllocationSiteInfo::kSize;
 
     { MaybeObject* maybe_clone = new_space_.AllocateRaw(adjusted_object_size);
       if (!maybe_clone->ToObject(&clone)) return maybe_clone;
@@ -4930,7 +4999,8 @@ MaybeObject* Heap::CopyJSObjectWithAllocationSite(JSObject* source) {
     AllocationSiteInfo* alloc_info = reinterpret_cast<AllocationSiteInfo*>(
         reinterpret_cast<Address>(clone) + object_size);
     alloc_info->set_map_no_write_barrier(allocation_site_info_map());
-    alloc_info->set_payload(source, SKIP_WRITE_BARRIER);
+    alloc_info->set_payload(site, SKIP_WRITE_BARRIER);
+    site->IncrementMementoCreateCount();
   }
 
   SLOW_ASSERT(
@@ -4944,9 +5014,10 @@ MaybeObject* Heap::CopyJSObjectWithAllocationSite(JSObject* source) {
       if (elements->map() == fixed_cow_array_map()) {
         maybe_elem = FixedArray::cast(elements);
       } else if (source->HasFastDoubleElements()) {
-        maybe_elem = CopyFixedDoubleArray(FixedDoubleArray::cast(elements));
+        maybe_elem = CopyFixedDoubleArray(FixedDoubleArray::cast(elements),
+                                          pretenure);
       } else {
-        maybe_elem = CopyFixedArray(FixedArray::cast(elements));
+        maybe_elem = CopyFixedArray(FixedArray::cast(elements), pretenure);
       }
       if (!maybe_elem->ToObject(&elem)) return maybe_elem;
     }
@@ -4955,7 +5026,7 @@ MaybeObject* Heap::CopyJSObjectWithAllocationSite(JSObject* source) {
   // Update properties if necessary.
   if (properties->length() > 0) {
     Object* prop;
-    { MaybeObject* maybe_prop = CopyFixedArray(properties);
+    { MaybeObject* maybe_prop = CopyFixedArray(properties, pretenure);
       if (!maybe_prop->ToObject(&prop)) return maybe_prop;
     }
     JSObject::cast(clone)->set_properties(FixedArray::cast(prop), wb_mode);
@@ -5397,10 +5468,12 @@ MaybeObject* Heap::AllocateRawFixedArray(int length) {
 }
 
 
-MaybeObject* Heap::CopyFixedArrayWithMap(FixedArray* src, Map* map) {
+MaybeObject* Heap::CopyFixedArrayWithMap(FixedArray* src,
+                                         Map* map,
+                                         PretenureFlag pretenure) {
   int len = src->length();
   Object* obj;
-  { MaybeObject* maybe_obj = AllocateRawFixedArray(len);
+  { MaybeObject* maybe_obj = AllocateRawFixedArray(len, pretenure);
     if (!maybe_obj->ToObject(&obj)) return maybe_obj;
   }
   if (InNewSpace(obj)) {
@@ -5424,10 +5497,11 @@ MaybeObject* Heap::CopyFixedArrayWithMap(FixedArray* src, Map* map) {
 
 
 MaybeObject* Heap::CopyFixedDoubleArrayWithMap(FixedDoubleArray* src,
-                                               Map* map) {
+                                               Map* map,
+                                               PretenureFlag pretenure) {
   int len = src->length();
   Object* obj;
-  { MaybeObject* maybe_obj = AllocateRawFixedDoubleArray(len, NOT_TENURED);
+  { MaybeObject* maybe_obj = AllocateRawFixedDoubleArray(len, pretenure);
     if (!maybe_obj->ToObject(&obj)) return maybe_obj;
   }
   HeapObject* dst = HeapObject::cast(obj);
@@ -5852,19 +5926,140 @@ void Heap::AdvanceIdleIncrementalMarking(intptr_t step_size) {
                               IncrementalMarking::NO_GC_VIA_STACK_GUARD);
 
   if (incremental_marking()->IsComplete()) {
-    bool uncommit = false;
-    if (gc_count_at_last_idle_gc_ == gc_count_) {
-      // No GC since the last full GC, the mutator is probably not active.
-      isolate_->compilation_cache()->Clear();
-      uncommit = true;
-    }
-    CollectAllGarbage(kNoGCFlags, "idle notification: finalize incremental");
-    gc_count_at_last_idle_gc_ = gc_count_;
-    if (uncommit) {
-      new_space_.Shrink();
-      UncommitFromSpace();
-    }
+    FinalizeIdleIncrementalMarking();
+  }
+}
+
+
+void Heap::FinalizeIdleIncrementalMarking() {
+  bool uncommit = false;
+  if (gc_count_at_last_idle_gc_ == gc_count_) {
+    // No GC since the last full GC, the mutator is probably not active.
+    isolate_->compilation_cache()->Clear();
+    uncommit = true;
+  }
+  CollectAllGarbage(kNoGCFlags, "idle notification: finalize incremental");
+  gc_count_at_last_idle_gc_ = gc_count_;
+  if (uncommit) {
+    new_space_.Shrink();
+    UncommitFromSpace();
+  }
+}
+
+
+GCIdleTimeHandler::HeapState Heap::ComputeIdleTimeHeapState() {
+  // Start a new idle round once the mutator produced enough garbage since
+  // the last one finished, and finish the current round after it did
+  // enough mark-sweeps.
+  if (mark_sweeps_since_idle_round_started_ >= kMaxMarkSweepsInIdleRound) {
+    if (EnoughGarbageSinceLastIdleRound()) StartIdleRound();
+  } else {
+    int new_mark_sweeps = ms_count_ - ms_count_at_last_idle_notification_;
+    mark_sweeps_since_idle_round_started_ += new_mark_sweeps;
+    ms_count_at_last_idle_notification_ = ms_count_;
+    if (mark_sweeps_since_idle_round_started_ >= kMaxMarkSweepsInIdleRound) {
+      FinishIdleRound();
+    }
+  }
+
+  GCIdleTimeHandler::HeapState state;
+  state.contexts_disposed = contexts_disposed_;
+  state.size_of_objects = SizeOfObjects();
+  state.new_space_size = new_space_.Size();
+  state.new_space_capacity = new_space_.Capacity();
+  state.incremental_marking_stopped = incremental_marking()->IsStopped();
+  state.incremental_marking_complete = incremental_marking()->IsComplete();
+  state.can_start_incremental_marking =
+      FLAG_incremental_marking && !Serializer::enabled() &&
+      !mark_compact_collector()->abort_incremental_marking() &&
+      mark_sweeps_since_idle_round_started_ < kMaxMarkSweepsInIdleRound;
+  state.sweeping_in_progress = state.incremental_marking_stopped &&
+      !mark_compact_collector()->AreSweeperThreadsActivated() &&
+      !IsSweepingComplete();
+  return state;
+}
+
+
+void Heap::ResetMemoryReducer() {
+  memory_reducer_inactive_since_ms_ = -1;
+  memory_reduced_since_last_activity_ = false;
+}
+
+
+void Heap::TryReduceMemoryWhenInactive(int idle_time_in_ms) {
+  if (!FLAG_memory_reducer) return;
+  double now = OS::TimeCurrentMillis();
+  if (memory_reducer_gc_count_ != gc_count_ ||
+      memory_reducer_new_space_top_ != new_space_.top()) {
+    // The mutator allocated since the last notification.
+    memory_reducer_inactive_since_ms_ = now;
+    memory_reduced_since_last_activity_ = false;
+  } else if (memory_reducer_inactive_since_ms_ < 0) {
+    memory_reducer_inactive_since_ms_ = now;
+  } else if (!memory_reduced_since_last_activity_ &&
+             now - memory_reducer_inactive_since_ms_ >=
+                 FLAG_memory_reducer_delay &&
+             gc_idle_time_handler_.EstimateMarkCompactTime(
+                 SizeOfObjects()) <= idle_time_in_ms) {
+    intptr_t released = ReduceMemory("idle notification: memory reducer");
+    memory_reduced_since_last_activity_ = true;
+    if (FLAG_trace_idle_notification) {
+      PrintPID("Idle notification: inactive for %.0f ms, memory reducer "
+               "released %" V8_PTR_PREFIX "d KB\n",
+               now - memory_reducer_inactive_since_ms_, released / KB);
+    }
+  }
+  // The reducer's own GC does not count as mutator activity.
+  memory_reducer_gc_count_ = gc_count_;
+  memory_reducer_new_space_top_ = new_space_.top();
+}
+
+
+bool Heap::IdleTimeNotification(int idle_time_in_ms) {
+  GCIdleTimeHandler::HeapState state = ComputeIdleTimeHeapState();
+  GCIdleTimeAction action =
+      gc_idle_time_handler_.Compute(idle_time_in_ms, state);
+
+  double start = OS::TimeCurrentMillis();
+  bool done = false;
+  switch (action.type()) {
+    case GCIdleTimeAction::DONE:
+      done = true;
+      break;
+    case GCIdleTimeAction::DO_NOTHING:
+      break;
+    case GCIdleTimeAction::DO_INCREMENTAL_MARKING:
+      if (incremental_marking()->IsStopped()) incremental_marking()->Start();
+      // The final pause is left to a later notification with enough time.
+      incremental_marking()->IdleStep(action.step_size());
+      break;
+    case GCIdleTimeAction::DO_SWEEPING:
+      AdvanceSweepers(static_cast<int>(action.step_size()));
+      break;
+    case GCIdleTimeAction::DO_SCAVENGE:
+      CollectGarbage(NEW_SPACE, "idle notification: scavenge");
+      break;
+    case GCIdleTimeAction::DO_FINALIZE_MARKING:
+      FinalizeIdleIncrementalMarking();
+      break;
+    case GCIdleTimeAction::DO_FULL_GC:
+      CollectAllGarbage(kReduceMemoryFootprintMask,
+                        "idle notification: contexts disposed");
+      break;
   }
+
+  if (done) {
+    TryReduceMemoryWhenInactive(idle_time_in_ms);
+  } else {
+    ResetMemoryReducer();
+  }
+
+  if (FLAG_trace_idle_notification) {
+    PrintPID("Idle notification: requested %d ms, %s took %.1f ms\n",
+             idle_time_in_ms, action.ToString(),
+             OS::TimeCurrentMillis() - start);
+  }
+  return done;
 }
 
 
@@ -6704,6 +6899,7 @@ V8_DECLARE_ONCE(initialize_gc_once);
 static void InitializeGCOnce() {
   InitializeScavengingVisitorsTables();
   NewSpaceScavenger::Initialize();
+  ParallelScavenger::Initialize();
   MarkCompactCollector::Initialize();
 }
 
@@ -6810,6 +7006,7 @@ bool Heap::SetUp() {
   store_buffer()->SetUp();
 
   if (FLAG_parallel_recompilation) relocation_mutex_ = OS::CreateMutex();
+  surviving_allocation_sites_mutex_ = OS::CreateMutex();
 #ifdef DEBUG
   relocation_mutex_locked_by_optimizer_thread_ = false;
 #endif  // DEBUG
@@ -6921,10 +7118,12 @@ void Heap::TearDown() {
 
   store_buffer()->TearDown();
   incremental_marking()->TearDown();
+  parallel_scavenger()->TearDown();
 
   isolate_->memory_allocator()->TearDown();
 
   delete relocation_mutex_;
+  delete surviving_allocation_sites_mutex_;
 }
 
 
@@ -7507,6 +7706,9 @@ GCTracer::GCTracer(Heap* heap,
       nodes_died_in_new_space_(0),
       nodes_copied_in_new_space_(0),
       nodes_promoted_(0),
+      background_marking_time_(0.0),
+      compaction_tasks_(0),
+      background_steps_took_(0.0),
       heap_(heap),
       gc_reason_(gc_reason),
       collector_reason_(collector_reason) {
@@ -7535,6 +7737,8 @@ GCTracer::GCTracer(Heap* heap,
       heap_->incremental_marking()->steps_count_since_last_gc();
   steps_took_since_last_gc_ =
       heap_->incremental_marking()->steps_took_since_last_gc();
+  background_steps_took_ =
+      heap_->incremental_marking()->background_steps_took();
 }
 
 
@@ -7599,6 +7803,26 @@ GCTracer::~GCTracer() {
       }
     }
 
+    if (background_marking_time_ > 0 ||
+        (collector_ == MARK_COMPACTOR && background_steps_took_ > 0)) {
+      PrintF(" (+ %.1f ms on marking threads during pause",
+             background_marking_time_);
+      if (collector_ == MARK_COMPACTOR) {
+        PrintF(", %.1f ms during steps", background_steps_took_);
+      }
+      PrintF(")");
+    }
+
+    if (compaction_tasks_ > 0) {
+      PrintF(" (evacuate %.1f ms, update pointers %.1f ms with %d tasks)",
+             scopes_[Scope::MC_SWEEP_NEWSPACE] +
+                 scopes_[Scope::MC_EVACUATE_PAGES],
+             scopes_[Scope::MC_UPDATE_NEW_TO_NEW_POINTERS] +
+                 scopes_[Scope::MC_UPDATE_POINTERS_TO_EVACUATED] +
+                 scopes_[Scope::MC_UPDATE_POINTERS_BETWEEN_EVACUATED],
+             compaction_tasks_);
+    }
+
     if (gc_reason_ != NULL) {
       PrintF(" [%s]", gc_reason_);
     }
@@ -7625,7 +7849,9 @@ GCTracer::~GCTracer() {
     PrintF(" ");
 
     PrintF("external=%.1f ", scopes_[Scope::EXTERNAL]);
+    PrintF("scavenge_parallel=%.1f ", scopes_[Scope::SCAVENGER_PARALLEL]);
     PrintF("mark=%.1f ", scopes_[Scope::MC_MARK]);
+    PrintF("mark_background=%.1f ", background_marking_time_);
     PrintF("sweep=%.1f ", scopes_[Scope::MC_SWEEP]);
     PrintF("sweepns=%.1f ", scopes_[Scope::MC_SWEEP_NEWSPACE]);
     PrintF("evacuate=%.1f ", scopes_[Scope::MC_EVACUATE_PAGES]);
@@ -7637,6 +7863,7 @@ GCTracer::~GCTracer() {
     PrintF("intracompaction_ptrs=%.1f ",
         scopes_[Scope::MC_UPDATE_POINTERS_BETWEEN_EVACUATED]);
     PrintF("misc_compaction=%.1f ", scopes_[Scope::MC_UPDATE_MISC_POINTERS]);
+    PrintF("compaction_tasks=%d ", compaction_tasks_);
     PrintF("weakmap_process=%.1f ", scopes_[Scope::MC_WEAKMAP_PROCESS]);
     PrintF("weakmap_clear=%.1f ", scopes_[Scope::MC_WEAKMAP_CLEAR]);
 
@@ -7659,6 +7886,7 @@ GCTracer::~GCTracer() {
       PrintF("stepscount=%d ", steps_count_);
       PrintF("stepstook=%.1f ", steps_took_);
       PrintF("longeststep=%.1f ", longest_step_);
+      PrintF("stepsbackground=%.1f ", background_steps_took_);
     }
 
     PrintF("\n");
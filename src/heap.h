@@ -32,11 +32,13 @@
 
 #include "allocation.h"
 #include "assert-scope.h"
+#include "gc-idle-time-handler.h"
 #include "globals.h"
 #include "incremental-marking.h"
 #include "list.h"
 #include "mark-compact.h"
 #include "objects-visiting.h"
+#include "parallel-scavenger.h"
 #include "spaces.h"
 #include "splay-tree-inl.h"
 #include "store-buffer.h"
@@ -715,10 +717,12 @@ class Heap {
 
   // Returns a deep copy of the JavaScript object.
   // Properties and elements are copied too.
+  // A copy of a literal boilerplate is either followed by an allocation site
+  // info pointing to the given allocation site, or allocated in old space if
+  // the site decided to pretenure.
   // Returns failure if allocation failed.
-  MUST_USE_RESULT MaybeObject* CopyJSObject(JSObject* source);
-
-  MUST_USE_RESULT MaybeObject* CopyJSObjectWithAllocationSite(JSObject* source);
+  MUST_USE_RESULT MaybeObject* CopyJSObject(JSObject* source,
+                                            AllocationSite* site = NULL);
 
   // Allocates the function prototype.
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
@@ -813,6 +817,9 @@ class Heap {
   // Allocates an empty TypeFeedbackInfo.
   MUST_USE_RESULT MaybeObject* AllocateTypeFeedbackInfo();
 
+  // Allocates the allocation site of a literal with the given boilerplate.
+  MUST_USE_RESULT MaybeObject* AllocateAllocationSite(JSObject* boilerplate);
+
   // Allocates an AliasedArgumentsEntry.
   MUST_USE_RESULT MaybeObject* AllocateAliasedArgumentsEntry(int slot);
 
@@ -977,21 +984,29 @@ class Heap {
 
   // Make a copy of src and return it. Returns
   // Failure::RetryAfterGC(requested_bytes, space) if the allocation failed.
-  MUST_USE_RESULT inline MaybeObject* CopyFixedArray(FixedArray* src);
+  MUST_USE_RESULT inline MaybeObject* CopyFixedArray(
+      FixedArray* src,
+      PretenureFlag pretenure = NOT_TENURED);
 
   // Make a copy of src, set the map, and return the copy. Returns
   // Failure::RetryAfterGC(requested_bytes, space) if the allocation failed.
-  MUST_USE_RESULT MaybeObject* CopyFixedArrayWithMap(FixedArray* src, Map* map);
+  MUST_USE_RESULT MaybeObject* CopyFixedArrayWithMap(
+      FixedArray* src,
+      Map* map,
+      PretenureFlag pretenure = NOT_TENURED);
 
   // Make a copy of src and return it. Returns
   // Failure::RetryAfterGC(requested_bytes, space) if the allocation failed.
   MUST_USE_RESULT inline MaybeObject* CopyFixedDoubleArray(
-      FixedDoubleArray* src);
+      FixedDoubleArray* src,
+      PretenureFlag pretenure = NOT_TENURED);
 
   // Make a copy of src, set the map, and return the copy. Returns
   // Failure::RetryAfterGC(requested_bytes, space) if the allocation failed.
   MUST_USE_RESULT MaybeObject* CopyFixedDoubleArrayWithMap(
-      FixedDoubleArray* src, Map* map);
+      FixedDoubleArray* src,
+      Map* map,
+      PretenureFlag pretenure = NOT_TENURED);
 
   // Allocates a fixed array initialized with the hole values.
   // Returns Failure::RetryAfterGC(requested_bytes, space) if the allocation
@@ -1258,12 +1273,19 @@ class Heap {
   static const int kSweepPreciselyMask = 1;
   static const int kReduceMemoryFootprintMask = 2;
   static const int kAbortIncrementalMarkingMask = 4;
+  static const int kCompactAllFragmentedPagesMask = 8;
 
   // Making the heap iterable requires us to sweep precisely and abort any
   // incremental marking as well.
   static const int kMakeHeapIterableMask =
       kSweepPreciselyMask | kAbortIncrementalMarkingMask;
 
+  // Reducing memory compacts every fragmented page, including the ones an
+  // incremental marking cycle did not select, and releases all empty pages.
+  static const int kReduceMemoryMask =
+      kReduceMemoryFootprintMask | kCompactAllFragmentedPagesMask |
+      kAbortIncrementalMarkingMask;
+
   // Performs a full garbage collection.  If (flags & kMakeHeapIterableMask) is
   // non-zero, then the slower precise sweeper is used, which leaves the heap
   // in a state where we can iterate over the heap visiting all objects.
@@ -1327,6 +1349,15 @@ class Heap {
     global_gc_epilogue_callback_ = callback;
   }
 
+  // The callback is invoked after a garbage collection that left more than
+  // limit bytes of objects in the heap.  A NULL callback disables the soft
+  // limit.
+  void SetSoftHeapLimit(intptr_t limit, v8::SoftHeapLimitCallback callback) {
+    soft_heap_limit_ = limit;
+    soft_heap_limit_callback_ = callback;
+  }
+  intptr_t soft_heap_limit() { return soft_heap_limit_; }
+
   // Heap root getters.  We have versions with and without type::cast() here.
   // You can't use type::cast during GC because the assert fails.
   // TODO(1490): Try removing the unchecked accessors, now that GC marking does
@@ -1536,6 +1567,11 @@ class Heap {
   static inline void ScavengePointer(HeapObject** p);
   static inline void ScavengeObject(HeapObject** p, HeapObject* object);
 
+  // Counts an object that is about to survive a scavenge against the
+  // allocation site of its allocation site info, if it has one.  Safe to
+  // call from several scavenger threads at once.
+  inline void UpdateAllocationSiteFeedback(HeapObject* object, Map* map);
+
   // Commits from space if it is uncommitted.
   void EnsureFromSpaceIsCommitted();
 
@@ -1619,6 +1655,16 @@ class Heap {
   // Implements the corresponding V8 API function.
   bool IdleNotification(int hint);
 
+  // Implements the deadline based Isolate::IdleNotification.  Performs only
+  // the garbage collection work that is expected to finish within the given
+  // time.  Returns true if no more GC work is left.
+  bool IdleTimeNotification(int idle_time_in_ms);
+
+  // Returns as much memory to the operating system as possible: compacts
+  // all fragmented pages, releases empty pages and shrinks the semispaces
+  // to their initial capacity.  Returns the number of bytes uncommitted.
+  intptr_t ReduceMemory(const char* gc_reason);
+
   // Declare all the root indices.
   enum RootListIndex {
 #define ROOT_INDEX_DECLARATION(type, name, camel_name) k##camel_name##RootIndex,
@@ -1769,6 +1815,14 @@ class Heap {
     return &incremental_marking_;
   }
 
+  ParallelScavenger* parallel_scavenger() {
+    return &parallel_scavenger_;
+  }
+
+  GCIdleTimeHandler* gc_idle_time_handler() {
+    return &gc_idle_time_handler_;
+  }
+
   bool IsSweepingComplete() {
     return !mark_compact_collector()->IsConcurrentSweepingInProgress() &&
            old_data_space()->IsLazySweepingComplete() &&
@@ -1989,6 +2043,14 @@ class Heap {
   // Total length of the strings we failed to flatten since the last GC.
   int unflattened_strings_length_;
 
+  // Allocation top of the semispace that is being scavenged. Allocation site
+  // infos are only read below it.
+  Address scavenged_space_top_;
+
+  // Allocation sites with copies that survived the current scavenge.
+  List<AllocationSite*> surviving_allocation_sites_;
+  Mutex* surviving_allocation_sites_mutex_;
+
 #define ROOT_ACCESSOR(type, name, camel_name)                                  \
   inline void set_##name(type* value) {                                        \
     /* The deserializer makes use of the fact that these common roots are */   \
@@ -2099,6 +2161,14 @@ class Heap {
   GCCallback global_gc_prologue_callback_;
   GCCallback global_gc_epilogue_callback_;
 
+  // Lets the embedder react to the heap outgrowing the soft limit before
+  // it runs into the hard limit, which is a fatal out of memory error.
+  void CheckSoftHeapLimit();
+
+  intptr_t soft_heap_limit_;
+  v8::SoftHeapLimitCallback soft_heap_limit_callback_;
+  bool in_soft_heap_limit_callback_;
+
   // Support for computing object sizes during GC.
   HeapObjectCallback gc_safe_size_of_old_object_;
   static int GcSafeSizeOfOldObject(HeapObject* object);
@@ -2174,6 +2244,10 @@ class Heap {
   // Performs a minor collection in new generation.
   void Scavenge();
 
+  // Lets the allocation sites found during the last scavenge decide whether
+  // to pretenure. Returns true if code has been marked for deoptimization.
+  bool ProcessPretenuringFeedback();
+
   static String* UpdateNewSpaceReferenceInExternalStringTableEntry(
       Heap* heap,
       Object** pointer);
@@ -2291,6 +2365,10 @@ class Heap {
 
   void SelectScavengingVisitorsTable();
 
+  // Returns true if objects moved by the GC have to be reported to the
+  // logger or one of the profilers.
+  bool IsLoggingOrProfiling();
+
   void StartIdleRound() {
     mark_sweeps_since_idle_round_started_ = 0;
     ms_count_at_last_idle_notification_ = ms_count_;
@@ -2322,6 +2400,15 @@ class Heap {
 
   void AdvanceIdleIncrementalMarking(intptr_t step_size);
 
+  void FinalizeIdleIncrementalMarking();
+
+  GCIdleTimeHandler::HeapState ComputeIdleTimeHeapState();
+
+  // Runs the memory reducer once the mutator did not allocate for
+  // --memory-reducer-delay ms of idle notifications.
+  void TryReduceMemoryWhenInactive(int idle_time_in_ms);
+  void ResetMemoryReducer();
+
   void ClearObjectStats(bool clear_last_time_stats = false);
 
   static const int kInitialStringTableSize = 2048;
@@ -2365,6 +2452,10 @@ class Heap {
 
   IncrementalMarking incremental_marking_;
 
+  ParallelScavenger parallel_scavenger_;
+
+  GCIdleTimeHandler gc_idle_time_handler_;
+
   int number_idle_notifications_;
   unsigned int last_idle_notification_gc_count_;
   bool last_idle_notification_gc_count_init_;
@@ -2374,6 +2465,13 @@ class Heap {
   unsigned int gc_count_at_last_idle_gc_;
   int scavenges_since_last_idle_round_;
 
+  // Inactivity tracking of the memory reducer.  The mutator is inactive as
+  // long as neither the GC count nor the new space top changes.
+  double memory_reducer_inactive_since_ms_;
+  unsigned int memory_reducer_gc_count_;
+  Address memory_reducer_new_space_top_;
+  bool memory_reduced_since_last_activity_;
+
   // If the --deopt_every_n_garbage_collections flag is set to a positive value,
   // this variable holds the number of garbage collections since the last
   // deoptimization triggered by garbage collection.
@@ -2415,6 +2513,8 @@ class Heap {
   friend class MarkCompactCollector;
   friend class MarkCompactMarkingVisitor;
   friend class MapCompact;
+  friend class ParallelEvacuator;
+  friend class ParallelScavenger;
 #ifdef VERIFY_HEAP
   friend class NoWeakEmbeddedMapsVerificationScope;
 #endif
@@ -2750,6 +2850,7 @@ class GCTracer BASE_EMBEDDED {
       MC_WEAKMAP_PROCESS,
       MC_WEAKMAP_CLEAR,
       MC_FLUSH_CODE,
+      SCAVENGER_PARALLEL,
       kNumberOfScopes
     };
 
@@ -2788,6 +2889,16 @@ class GCTracer BASE_EMBEDDED {
     promoted_objects_size_ += object_size;
   }
 
+  // Time the marking threads spent in parallel marking rounds of this
+  // collection.  The main thread's share is part of the MC_MARK scope.
+  void AddBackgroundMarkingTime(double time) {
+    background_marking_time_ += time;
+  }
+
+  // Number of tasks that took part in parallel evacuation and pointer
+  // updating, including the main thread.
+  void set_compaction_tasks(int tasks) { compaction_tasks_ = tasks; }
+
   void increment_nodes_died_in_new_space() {
     nodes_died_in_new_space_++;
   }
@@ -2853,12 +2964,19 @@ class GCTracer BASE_EMBEDDED {
   // Number of promoted nodes to the old space.
   int nodes_promoted_;
 
+  // Time spent by the marking threads during this collection.
+  double background_marking_time_;
+
+  // Number of parallel compaction tasks, 0 if compaction was serial.
+  int compaction_tasks_;
+
   // Incremental marking steps counters.
   int steps_count_;
   double steps_took_;
   double longest_step_;
   int steps_count_since_last_gc_;
   double steps_took_since_last_gc_;
+  double background_steps_took_;
 
   Heap* heap_;
 
@@ -0,0 +1,416 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "hydrogen-escape-analysis.h"
+
+namespace v8 {
+namespace internal {
+
+
+HEscapeAnalysis::HEscapeAnalysis(HGraph* graph)
+    : graph_(graph),
+      captured_(0, graph->zone()),
+      number_of_values_(0),
+      capture_id_(0),
+      block_states_(graph->blocks()->length(), graph->zone()) { }
+
+
+bool HEscapeAnalysis::HasNoEscapingUses(HValue* value,
+                                        HAllocate* allocate,
+                                        int size) {
+  for (HUseIterator it(value->uses()); !it.Done(); it.Advance()) {
+    HValue* use = it.value();
+    if (use->HasEscapingOperandAt(it.index())) {
+      if (FLAG_trace_escape_analysis) {
+        PrintF("#%d (%s) escapes through #%d (%s) @%d\n", allocate->id(),
+               allocate->Mnemonic(), use->id(), use->Mnemonic(), it.index());
+      }
+      return false;
+    }
+    if (use->IsCheckMaps() || use->IsCheckNonSmi()) {
+      // Checks are only removed when they directly check the allocation,
+      // their own uses are subject to the same restrictions.
+      if (use->OperandAt(0) != allocate) return false;
+      if (!HasNoEscapingUses(use, allocate, size)) return false;
+    } else if (use->IsLoadNamedField() || use->IsStoreNamedField()) {
+      bool is_load = use->IsLoadNamedField();
+      HValue* object = is_load
+          ? HLoadNamedField::cast(use)->object()
+          : HStoreNamedField::cast(use)->object();
+      HObjectAccess access = is_load
+          ? HLoadNamedField::cast(use)->access()
+          : HStoreNamedField::cast(use)->access();
+      // Only accesses to fields within the allocated object can be replaced.
+      if (object != allocate ||
+          !access.IsInobject() ||
+          access.offset() >= size ||
+          access.offset() % kPointerSize != 0) {
+        if (FLAG_trace_escape_analysis) {
+          PrintF("#%d (%s) has unsupported access #%d (%s)\n", allocate->id(),
+                 allocate->Mnemonic(), use->id(), use->Mnemonic());
+        }
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+
+static bool IsKnownMap(UniqueValueId map, HCheckMaps* check) {
+  if (!map.IsInitialized()) return false;
+  const ZoneList<UniqueValueId>* maps = check->map_unique_ids();
+  for (int i = 0; i < maps->length(); i++) {
+    if (maps->at(i) == map) return true;
+  }
+  return false;
+}
+
+
+// Map checks on a captured allocation are removed, which is only possible if
+// the outcome of every such check is known at compile time. To keep this
+// simple the map of the object may only change within the block of the
+// allocation, where it is tracked in instruction order.
+bool HEscapeAnalysis::HasStaticallyKnownMaps(HAllocate* allocate) {
+  HBasicBlock* allocate_block = allocate->block();
+  UniqueValueId map;
+  for (HInstruction* instr = allocate->next();
+       instr != NULL;
+       instr = instr->next()) {
+    if (instr->IsStoreNamedField()) {
+      HStoreNamedField* store = HStoreNamedField::cast(instr);
+      if (store->object() != allocate) continue;
+      if (!store->transition().is_null()) {
+        map = store->transition_unique_id();
+      } else if (store->access().offset() == HeapObject::kMapOffset) {
+        HValue* value = store->value();
+        map = value->IsConstant()
+            ? HConstant::cast(value)->unique_id()
+            : UniqueValueId();
+      }
+    } else if (instr->IsCheckMaps()) {
+      HCheckMaps* check = HCheckMaps::cast(instr);
+      if (check->value() != allocate) continue;
+      if (!IsKnownMap(map, check)) return false;
+    }
+  }
+
+  for (HUseIterator it(allocate->uses()); !it.Done(); it.Advance()) {
+    HValue* use = it.value();
+    if (use->block() == allocate_block) continue;
+    if (use->IsStoreNamedField()) {
+      HStoreNamedField* store = HStoreNamedField::cast(use);
+      if (!store->transition().is_null() ||
+          store->access().offset() == HeapObject::kMapOffset) {
+        return false;
+      }
+    } else if (use->IsCheckMaps()) {
+      if (!IsKnownMap(map, HCheckMaps::cast(use))) return false;
+    }
+  }
+  return true;
+}
+
+
+void HEscapeAnalysis::CollectCapturedValues() {
+  int block_count = graph()->blocks()->length();
+  for (int i = 0; i < block_count; ++i) {
+    HBasicBlock* block = graph()->blocks()->at(i);
+    for (HInstruction* instr = block->first();
+         instr != NULL;
+         instr = instr->next()) {
+      if (!instr->IsAllocate()) continue;
+      HAllocate* allocate = HAllocate::cast(instr);
+
+      // The deoptimizer only knows how to materialize plain objects and
+      // heap numbers of a statically known size.
+      HType type = allocate->CalculateInferredType();
+      if (!type.IsHeapNumber() && (!type.IsJSObject() || type.IsJSArray())) {
+        continue;
+      }
+      if (!allocate->size()->IsInteger32Constant()) continue;
+      int size = allocate->size()->GetInteger32Constant();
+      if (size > HAllocate::kMaxInlineSize) continue;
+
+      if (!HasNoEscapingUses(allocate, allocate, size)) continue;
+      if (!HasStaticallyKnownMaps(allocate)) continue;
+      if (FLAG_trace_escape_analysis) {
+        PrintF("#%d (%s) is being captured\n", allocate->id(),
+               allocate->Mnemonic());
+      }
+      captured_.Add(allocate, zone());
+    }
+  }
+}
+
+
+HCapturedObject* HEscapeAnalysis::NewState(HInstruction* previous) {
+  HCapturedObject* state =
+      new(zone()) HCapturedObject(number_of_values_, capture_id_, zone());
+  state->InsertAfter(previous);
+  return state;
+}
+
+
+// Create a new state for replacing HAllocate instructions.
+HCapturedObject* HEscapeAnalysis::NewStateForAllocation(
+    HInstruction* previous) {
+  HConstant* undefined = graph()->GetConstantUndefined();
+  HCapturedObject* state = NewState(previous);
+  for (int index = 0; index < number_of_values_; index++) {
+    state->SetOperandAt(index, undefined);
+  }
+  return state;
+}
+
+
+// Create a new state full of phis for loop header entries.
+HCapturedObject* HEscapeAnalysis::NewStateForLoopHeader(
+    HInstruction* previous,
+    HCapturedObject* old_state) {
+  HBasicBlock* block = previous->block();
+  HCapturedObject* state = NewState(previous);
+  for (int index = 0; index < number_of_values_; index++) {
+    HValue* operand = old_state->OperandAt(index);
+    HPhi* phi = NewPhiAndInsert(block, operand, index);
+    state->SetOperandAt(index, phi);
+  }
+  return state;
+}
+
+
+// Create a new state by copying an existing one.
+HCapturedObject* HEscapeAnalysis::NewStateCopy(
+    HInstruction* previous,
+    HCapturedObject* old_state) {
+  HCapturedObject* state = NewState(previous);
+  for (int index = 0; index < number_of_values_; index++) {
+    HValue* operand = old_state->OperandAt(index);
+    state->SetOperandAt(index, operand);
+  }
+  return state;
+}
+
+
+// Insert a newly created phi into the given block and fill all incoming
+// edges with the given value.
+HPhi* HEscapeAnalysis::NewPhiAndInsert(
+    HBasicBlock* block, HValue* incoming_value, int index) {
+  HPhi* phi = new(zone()) HPhi(HPhi::kInvalidMergedIndex, zone());
+  for (int i = 0; i < block->predecessors()->length(); i++) {
+    phi->AddInput(incoming_value);
+  }
+  block->AddPhi(phi);
+  return phi;
+}
+
+
+// Field values of stores that require a certain representation are forced
+// into it, so that the check performed by the removed store is preserved.
+HValue* HEscapeAnalysis::NewStoreValue(HStoreNamedField* store) {
+  HValue* value = store->value();
+  Representation representation = store->field_representation();
+  if ((FLAG_track_fields && representation.IsSmi()) ||
+      (FLAG_track_double_fields && representation.IsDouble())) {
+    HInstruction* force =
+        new(zone()) HForceRepresentation(value, representation);
+    force->InsertBefore(store);
+    return force;
+  }
+  return value;
+}
+
+
+// The map of an object changes with the store that transitions it.
+HValue* HEscapeAnalysis::NewMapValue(HStoreNamedField* store) {
+  HConstant* map = new(zone()) HConstant(store->transition(),
+                                         store->transition_unique_id(),
+                                         Representation::Tagged(),
+                                         HType::NonPrimitive(),
+                                         false,  // Not a string.
+                                         true,   // Maps are never in new space.
+                                         true);  // Not falsy.
+  map->InsertBefore(store);
+  return map;
+}
+
+
+void HEscapeAnalysis::AnalyzeDataFlow(HAllocate* allocate) {
+  HBasicBlock* allocate_block = allocate->block();
+  block_states_.Rewind(0);
+  block_states_.AddBlock(NULL, graph()->blocks()->length(), zone());
+
+  // Iterate all blocks starting with the allocation block, since the
+  // allocation cannot dominate blocks that come before.
+  int start = allocate_block->block_id();
+  for (int i = start; i < graph()->blocks()->length(); i++) {
+    HBasicBlock* block = graph()->blocks()->at(i);
+    HCapturedObject* state = StateAt(block);
+
+    // Skip blocks that are not dominated by the captured allocation.
+    if (!allocate_block->Dominates(block) && allocate_block != block) continue;
+    if (FLAG_trace_escape_analysis) {
+      PrintF("Analyzing data-flow in B%d\n", block->block_id());
+    }
+
+    // Go through all instructions of the current block.
+    HInstruction* next = NULL;
+    for (HInstruction* instr = block->first(); instr != NULL; instr = next) {
+      next = instr->next();
+      switch (instr->opcode()) {
+        case HValue::kAllocate: {
+          if (instr != allocate) continue;
+          state = NewStateForAllocation(allocate);
+          break;
+        }
+        case HValue::kLoadNamedField: {
+          HLoadNamedField* load = HLoadNamedField::cast(instr);
+          if (load->object() != allocate) continue;
+          int index = load->access().offset() / kPointerSize;
+          HValue* replacement = state->OperandAt(index);
+          load->DeleteAndReplaceWith(replacement);
+          if (FLAG_trace_escape_analysis) {
+            PrintF("Replacing load #%d with #%d (%s)\n", instr->id(),
+                   replacement->id(), replacement->Mnemonic());
+          }
+          break;
+        }
+        case HValue::kStoreNamedField: {
+          HStoreNamedField* store = HStoreNamedField::cast(instr);
+          if (store->object() != allocate) continue;
+          int index = store->access().offset() / kPointerSize;
+          HValue* value = NewStoreValue(store);
+          HValue* map = store->transition().is_null()
+              ? NULL
+              : NewMapValue(store);
+          state = NewStateCopy(store->previous(), state);
+          state->SetOperandAt(index, value);
+          if (map != NULL) state->SetOperandAt(0, map);
+          store->DeleteAndReplaceWith(NULL);
+          if (FLAG_trace_escape_analysis) {
+            PrintF("Replacing store #%d%s\n", instr->id(),
+                   store->transition().is_null() ? "" : " (with transition)");
+          }
+          break;
+        }
+        case HValue::kArgumentsObject:
+        case HValue::kCapturedObject:
+        case HValue::kSimulate: {
+          for (int i = 0; i < instr->OperandCount(); i++) {
+            if (instr->OperandAt(i) != allocate) continue;
+            instr->SetOperandAt(i, state);
+          }
+          break;
+        }
+        case HValue::kCheckMaps:
+        case HValue::kCheckNonSmi: {
+          // The outcome of map checks was verified when collecting values.
+          if (instr->OperandAt(0) != allocate) continue;
+          instr->DeleteAndReplaceWith(allocate);
+          if (FLAG_trace_escape_analysis) {
+            PrintF("Removing check #%d (%s)\n", instr->id(),
+                   instr->Mnemonic());
+          }
+          break;
+        }
+        default:
+          // Nothing to see here, move along ...
+          break;
+      }
+    }
+
+    // Propagate the block state forward to all successor blocks.
+    for (int i = 0; i < block->end()->SuccessorCount(); i++) {
+      HBasicBlock* succ = block->end()->SuccessorAt(i);
+      if (!allocate_block->Dominates(succ)) continue;
+      if (succ->predecessors()->length() == 1) {
+        // Case 1: This is the only predecessor, just reuse state.
+        SetStateAt(succ, state);
+      } else if (StateAt(succ) == NULL && succ->IsLoopHeader()) {
+        // Case 2: This is a state that enters a loop header, be
+        // pessimistic about loop headers, add phis for all values.
+        SetStateAt(succ, NewStateForLoopHeader(succ->first(), state));
+      } else if (StateAt(succ) == NULL) {
+        // Case 3: This is the first state propagated forward to the
+        // successor, leave a copy of the current state.
+        SetStateAt(succ, NewStateCopy(succ->first(), state));
+      } else {
+        // Case 4: This is a state that needs merging with previously
+        // propagated states, potentially introducing new phis lazily or
+        // adding values to existing phis.
+        HCapturedObject* succ_state = StateAt(succ);
+        for (int index = 0; index < number_of_values_; index++) {
+          HValue* operand = state->OperandAt(index);
+          HValue* succ_operand = succ_state->OperandAt(index);
+          if (succ_operand->IsPhi() && succ_operand->block() == succ) {
+            // Phi already exists, add operand.
+            HPhi* phi = HPhi::cast(succ_operand);
+            phi->SetOperandAt(succ->PredecessorIndexOf(block), operand);
+          } else if (succ_operand != operand) {
+            // Phi does not exist, introduce one.
+            HPhi* phi = NewPhiAndInsert(succ, succ_operand, index);
+            phi->SetOperandAt(succ->PredecessorIndexOf(block), operand);
+            succ_state->SetOperandAt(index, phi);
+          }
+        }
+      }
+    }
+  }
+
+  // All uses have been handled.
+  ASSERT(allocate->HasNoUses());
+  allocate->DeleteAndReplaceWith(NULL);
+}
+
+
+void HEscapeAnalysis::PerformScalarReplacement() {
+  for (int i = 0; i < captured_.length(); i++) {
+    HAllocate* allocate = captured_.at(i);
+
+    // Compute number of scalar values and start with clean slate.
+    int size_in_bytes = allocate->size()->GetInteger32Constant();
+    number_of_values_ = size_in_bytes / kPointerSize;
+    capture_id_ = allocate->id();
+    AnalyzeDataFlow(allocate);
+  }
+}
+
+
+bool HEscapeAnalysis::Analyze() {
+  bool replaced = false;
+  for (int i = 0; i < kMaxIterations; i++) {
+    CollectCapturedValues();
+    if (captured_.is_empty()) break;
+    PerformScalarReplacement();
+    captured_.Clear();
+    replaced = true;
+  }
+  return replaced;
+}
+
+} }  // namespace v8::internal
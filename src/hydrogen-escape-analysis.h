@@ -0,0 +1,103 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef V8_HYDROGEN_ESCAPE_ANALYSIS_H_
+#define V8_HYDROGEN_ESCAPE_ANALYSIS_H_
+
+#include "allocation.h"
+#include "hydrogen.h"
+
+namespace v8 {
+namespace internal {
+
+
+// Finds allocations that never escape the optimized function and replaces
+// them by SSA values for each of their fields (scalar replacement). Loads
+// and stores on such an allocation are removed, the field values are tracked
+// through HCapturedObject snapshots so that the deoptimizer is able to
+// rematerialize the object when it is needed by the unoptimized code.
+class HEscapeAnalysis BASE_EMBEDDED {
+ public:
+  explicit HEscapeAnalysis(HGraph* graph);
+
+  // Returns true if at least one allocation was replaced.
+  bool Analyze();
+
+ private:
+  // Allocations are captured repeatedly so that objects which were only
+  // reachable through another captured object (e.g. the boxes of double
+  // fields) are picked up in a later iteration.
+  static const int kMaxIterations = 2;
+
+  void CollectCapturedValues();
+  bool HasNoEscapingUses(HValue* value, HAllocate* allocate, int size);
+  bool HasStaticallyKnownMaps(HAllocate* allocate);
+  void PerformScalarReplacement();
+  void AnalyzeDataFlow(HAllocate* allocate);
+
+  HCapturedObject* NewState(HInstruction* previous);
+  HCapturedObject* NewStateForAllocation(HInstruction* previous);
+  HCapturedObject* NewStateForLoopHeader(HInstruction* previous,
+                                         HCapturedObject* old_state);
+  HCapturedObject* NewStateCopy(HInstruction* previous,
+                                HCapturedObject* old_state);
+  HPhi* NewPhiAndInsert(HBasicBlock* block, HValue* incoming_value, int index);
+  HValue* NewStoreValue(HStoreNamedField* store);
+  HValue* NewMapValue(HStoreNamedField* store);
+
+  HCapturedObject* StateAt(HBasicBlock* block) {
+    return block_states_.at(block->block_id());
+  }
+
+  void SetStateAt(HBasicBlock* block, HCapturedObject* state) {
+    block_states_.Set(block->block_id(), state);
+  }
+
+  HGraph* graph() const { return graph_; }
+  Zone* zone() const { return graph_->zone(); }
+
+  HGraph* graph_;
+
+  // List of allocations identified as non-escaping.
+  ZoneList<HAllocate*> captured_;
+
+  // Number of fields of the allocation currently being replaced.
+  int number_of_values_;
+
+  // Identifier shared by all snapshots of the current allocation.
+  int capture_id_;
+
+  // Snapshots of the current allocation at block entries, indexed by
+  // block id.
+  ZoneList<HCapturedObject*> block_states_;
+};
+
+
+} }  // namespace v8::internal
+
+#endif  // V8_HYDROGEN_ESCAPE_ANALYSIS_H_
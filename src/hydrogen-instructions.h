@@ -86,6 +86,7 @@ class LChunkBuilder;
   V(CallNewArray)                              \
   V(CallRuntime)                               \
   V(CallStub)                                  \
+  V(CapturedObject)                            \
   V(Change)                                    \
   V(CheckFunction)                             \
   V(CheckInstanceType)                         \
@@ -1062,6 +1063,10 @@ class HValue: public ZoneObject {
   virtual Representation RequiredInputRepresentation(int index) = 0;
   virtual void InferRepresentation(HInferRepresentation* h_infer);
 
+  // Escape analysis helpers. Returns true if the value passed in as the
+  // operand at the given index might escape through this instruction.
+  virtual bool HasEscapingOperandAt(int index) { return true; }
+
   // This gives the instruction an opportunity to replace itself with an
   // instruction that does the same in some better way.  To replace an
   // instruction with a new one, first add the new instruction to the graph,
@@ -1880,6 +1885,7 @@ class HSimulate: public HInstruction {
   virtual int OperandCount() { return values_.length(); }
   virtual HValue* OperandAt(int index) const { return values_[index]; }
 
+  virtual bool HasEscapingOperandAt(int index) { return false; }
   virtual Representation RequiredInputRepresentation(int index) {
     return Representation::None();
   }
@@ -2789,6 +2795,7 @@ class HCheckMaps: public HTemplateInstruction<2> {
     return check_map;
   }
 
+  virtual bool HasEscapingOperandAt(int index) { return false; }
   virtual Representation RequiredInputRepresentation(int index) {
     return Representation::Tagged();
   }
@@ -2798,6 +2805,9 @@ class HCheckMaps: public HTemplateInstruction<2> {
 
   HValue* value() { return OperandAt(0); }
   SmallMapList* map_set() { return &map_set_; }
+  const ZoneList<UniqueValueId>* map_unique_ids() const {
+    return &map_unique_ids_;
+  }
 
   virtual void FinalizeUniqueValueId();
 
@@ -2947,6 +2957,7 @@ class HCheckNonSmi: public HUnaryOperation {
     SetFlag(kUseGVN);
   }
 
+  virtual bool HasEscapingOperandAt(int index) { return false; }
   virtual Representation RequiredInputRepresentation(int index) {
     return Representation::Tagged();
   }
@@ -3051,6 +3062,10 @@ class HCheckPrototypeMaps: public HTemplateInstruction<0> {
 
 class HPhi: public HValue {
  public:
+  // Merged index used for phis that do not correspond to any slot in the
+  // environment (e.g. phis introduced by escape analysis).
+  static const int kInvalidMergedIndex = -1;
+
   HPhi(int merged_index, Zone* zone)
       : inputs_(2, zone),
         merged_index_(merged_index),
@@ -3059,7 +3074,7 @@ class HPhi: public HValue {
       non_phi_uses_[i] = 0;
       indirect_uses_[i] = 0;
     }
-    ASSERT(merged_index >= 0);
+    ASSERT(merged_index >= 0 || merged_index == kInvalidMergedIndex);
     SetFlag(kFlexibleRepresentation);
     SetFlag(kAllowUndefinedAsNaN);
   }
@@ -3083,6 +3098,7 @@ class HPhi: public HValue {
   bool HasRealUses();
 
   bool IsReceiver() const { return merged_index_ == 0; }
+  bool HasMergedIndex() const { return merged_index_ != kInvalidMergedIndex; }
 
   int merged_index() const { return merged_index_; }
 
@@ -3221,6 +3237,10 @@ class HArgumentsObject: public HTemplateInstruction<0> {
   virtual int OperandCount() { return values_.length(); }
   virtual HValue* OperandAt(int index) const { return values_[index]; }
 
+  // The receiver is not part of the materialized arguments object. Other
+  // values are captured at the entry of the inlined function and would not
+  // see later changes to a replaced allocation.
+  virtual bool HasEscapingOperandAt(int index) { return index != 0; }
   virtual Representation RequiredInputRepresentation(int index) {
     return Representation::None();
   }
@@ -3239,6 +3259,49 @@ class HArgumentsObject: public HTemplateInstruction<0> {
 };
 
 
+// Snapshot of the fields of an allocation that was replaced by escape
+// analysis. The operands are the values of the object's fields (starting
+// with the map) at the position of this instruction. The object itself is
+// never built in optimized code, it is only materialized by the deoptimizer.
+// All snapshots of the same allocation share the same capture id.
+class HCapturedObject: public HTemplateInstruction<0> {
+ public:
+  HCapturedObject(int length, int capture_id, Zone* zone)
+      : values_(length, zone), capture_id_(capture_id) {
+    values_.AddBlock(NULL, length, zone);  // Resize list.
+    set_representation(Representation::Tagged());
+  }
+
+  int length() const { return values_.length(); }
+  int capture_id() const { return capture_id_; }
+
+  // Replaces all older snapshots of the same allocation in the given
+  // environment (and its outer environments) with this one.
+  void ReplayEnvironment(HEnvironment* env);
+
+  virtual int OperandCount() { return values_.length(); }
+  virtual HValue* OperandAt(int index) const { return values_[index]; }
+
+  virtual bool HasEscapingOperandAt(int index) { return false; }
+  virtual Representation RequiredInputRepresentation(int index) {
+    return Representation::None();
+  }
+
+  virtual void PrintDataTo(StringStream* stream);
+
+  DECLARE_CONCRETE_INSTRUCTION(CapturedObject)
+
+ protected:
+  virtual void InternalSetOperandAt(int index, HValue* value) {
+    values_[index] = value;
+  }
+
+ private:
+  ZoneList<HValue*> values_;
+  int capture_id_;
+};
+
+
 class HConstant: public HTemplateInstruction<0> {
  public:
   HConstant(Handle<Object> handle, Representation r = Representation::None());
@@ -3332,6 +3395,7 @@ class HConstant: public HTemplateInstruction<0> {
     ASSERT(HasDoubleValue());
     return double_value_;
   }
+  UniqueValueId unique_id() const { return unique_id_; }
   bool IsTheHole() const {
     if (HasDoubleValue() && FixedDoubleArray::is_the_hole_nan(double_value_)) {
       return true;
@@ -5261,6 +5325,12 @@ class HObjectAccess {
     return portion() != kBackingStore;
   }
 
+  // Returns true for ordinary in-object slots, i.e. not the map, the
+  // elements pointer, a length or the value of a double box.
+  inline bool IsInobjectField() const {
+    return portion() == kInobject;
+  }
+
   inline int offset() const {
     return OffsetField::decode(value_);
   }
@@ -5301,6 +5371,18 @@ class HObjectAccess {
     return HObjectAccess(kInobject, AllocationSiteInfo::kPayloadOffset);
   }
 
+  static HObjectAccess ForAllocationSiteBoilerplate() {
+    return HObjectAccess(kInobject, AllocationSite::kBoilerplateOffset);
+  }
+
+  static HObjectAccess ForAllocationSiteMementoCreateCount() {
+    return HObjectAccess(kInobject, AllocationSite::kMementoCreateCountOffset);
+  }
+
+  static HObjectAccess ForAllocationSitePretenureDecision() {
+    return HObjectAccess(kInobject, AllocationSite::kPretenureDecisionOffset);
+  }
+
   // Create an access to an offset in a fixed array header.
   static HObjectAccess ForFixedArrayHeader(int offset);
 
@@ -5398,6 +5480,7 @@ class HLoadNamedField: public HTemplateInstruction<2> {
   HObjectAccess access() const { return access_; }
   Representation field_representation() const { return representation_; }
 
+  virtual bool HasEscapingOperandAt(int index) { return false; }
   virtual Representation RequiredInputRepresentation(int index) {
     return Representation::Tagged();
   }
@@ -5730,6 +5813,7 @@ class HStoreNamedField: public HTemplateInstruction<2> {
 
   DECLARE_CONCRETE_INSTRUCTION(StoreNamedField)
 
+  virtual bool HasEscapingOperandAt(int index) { return index == 1; }
   virtual Representation RequiredInputRepresentation(int index) {
     if (FLAG_track_double_fields &&
         index == 1 && field_representation_.IsDouble()) {
@@ -0,0 +1,419 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "hydrogen-load-elimination.h"
+
+namespace v8 {
+namespace internal {
+
+
+// Only the first few in-object fields of an object are tracked, and for each
+// of them only a bounded number of objects, in order to keep the copying and
+// merging of states at block boundaries cheap.
+static const int kMaxTrackedFields = 16;
+static const int kMaxTrackedObjects = 5;
+
+
+// The value last loaded from or stored into a field of a given object.
+class HFieldApproximation : public ZoneObject {
+ public:
+  HFieldApproximation(HValue* object,
+                      HValue* last_value,
+                      HFieldApproximation* next)
+      : object_(object), last_value_(last_value), next_(next) { }
+
+  HValue* object_;
+  HValue* last_value_;
+  HFieldApproximation* next_;
+};
+
+
+// The set of maps a given object is known to have.
+class HMapApproximation : public ZoneObject {
+ public:
+  HMapApproximation(HValue* object,
+                    const ZoneList<UniqueValueId>* maps,
+                    HMapApproximation* next)
+      : object_(object), maps_(maps), next_(next) { }
+
+  HValue* object_;
+  const ZoneList<UniqueValueId>* maps_;
+  HMapApproximation* next_;
+};
+
+
+// The state of the analysis at a given program point: for every tracked
+// field a list of objects whose value in that field is known, and the maps
+// known from dominating map checks and transitions, which are used to refine
+// alias queries.
+class HLoadEliminationTable : public ZoneObject {
+ public:
+  HLoadEliminationTable(Zone* zone, HAliasAnalyzer* aliasing)
+      : zone_(zone), fields_(kMaxTrackedFields, zone), maps_(NULL),
+        aliasing_(aliasing) {
+    fields_.AddBlock(NULL, kMaxTrackedFields, zone);
+  }
+
+  // Updates the state with the effects of the given instruction, replacing
+  // redundant loads and removing redundant stores on the way.
+  void Process(HInstruction* instr) {
+    if (instr->IsLoadNamedField()) {
+      HValue* result = Load(HLoadNamedField::cast(instr));
+      if (result != instr) {
+        if (FLAG_trace_load_elimination) {
+          PrintF("Replacing load #%d with #%d (%s)\n", instr->id(),
+                 result->id(), result->Mnemonic());
+        }
+        instr->DeleteAndReplaceWith(result);
+      }
+    } else if (instr->IsStoreNamedField()) {
+      if (IsRedundantStore(HStoreNamedField::cast(instr))) {
+        if (FLAG_trace_load_elimination) {
+          PrintF("Removing redundant store #%d\n", instr->id());
+        }
+        instr->DeleteAndReplaceWith(NULL);
+      } else {
+        Store(HStoreNamedField::cast(instr));
+      }
+    } else if (instr->IsCheckMaps()) {
+      HCheckMaps* check = HCheckMaps::cast(instr);
+      SetMaps(check->value()->ActualValue(), check->map_unique_ids());
+    } else {
+      if (instr->CheckGVNFlag(kChangesInobjectFields)) KillFields();
+      if (instr->CheckGVNFlag(kChangesMaps)) KillMaps();
+    }
+  }
+
+  HLoadEliminationTable* Copy() {
+    HLoadEliminationTable* copy =
+        new(zone_) HLoadEliminationTable(zone_, aliasing_);
+    for (int i = 0; i < kMaxTrackedFields; i++) {
+      HFieldApproximation** last = &copy->fields_[i];
+      for (HFieldApproximation* a = fields_[i]; a != NULL; a = a->next_) {
+        *last = new(zone_) HFieldApproximation(a->object_, a->last_value_,
+                                               NULL);
+        last = &(*last)->next_;
+      }
+    }
+    HMapApproximation** last = &copy->maps_;
+    for (HMapApproximation* m = maps_; m != NULL; m = m->next_) {
+      *last = new(zone_) HMapApproximation(m->object_, m->maps_, NULL);
+      last = &(*last)->next_;
+    }
+    return copy;
+  }
+
+  // Computes the state at a control flow join: a field value is known only
+  // if it is known to be the same on all incoming edges, and the maps of an
+  // object are known only if they are known on all incoming edges.
+  void Merge(HLoadEliminationTable* that) {
+    for (int i = 0; i < kMaxTrackedFields; i++) {
+      HFieldApproximation** link = &fields_[i];
+      while (*link != NULL) {
+        HFieldApproximation* other = that->Find((*link)->object_, i);
+        if (other == NULL || other->last_value_ != (*link)->last_value_) {
+          *link = (*link)->next_;
+        } else {
+          link = &(*link)->next_;
+        }
+      }
+    }
+    HMapApproximation** link = &maps_;
+    while (*link != NULL) {
+      const ZoneList<UniqueValueId>* other = that->MapsOf((*link)->object_);
+      if (other == NULL) {
+        *link = (*link)->next_;
+      } else {
+        (*link)->maps_ = UnionOf((*link)->maps_, other);
+        link = &(*link)->next_;
+      }
+    }
+  }
+
+  void KillFields() {
+    for (int i = 0; i < kMaxTrackedFields; i++) fields_[i] = NULL;
+  }
+
+  void KillField(int field) {
+    fields_[field] = NULL;
+  }
+
+  void KillMaps() {
+    maps_ = NULL;
+  }
+
+  // Returns the index under which accesses to the given field are tracked,
+  // or -1 if they are not tracked.
+  static int FieldOf(HObjectAccess access) {
+    if (!access.IsInobjectField()) return -1;
+    // The first word is only accessed as an in-object field in the headers
+    // of fixed arrays, where it holds the map.
+    if (access.offset() < kPointerSize) return -1;
+    if ((access.offset() % kPointerSize) != 0) return -1;
+    int field = access.offset() / kPointerSize;
+    return field < kMaxTrackedFields ? field : -1;
+  }
+
+  void Print() {
+    for (int i = 0; i < kMaxTrackedFields; i++) {
+      for (HFieldApproximation* a = fields_[i]; a != NULL; a = a->next_) {
+        PrintF("  field %d: #%d = #%d\n", i, a->object_->id(),
+               a->last_value_->id());
+      }
+    }
+    for (HMapApproximation* m = maps_; m != NULL; m = m->next_) {
+      PrintF("  maps: #%d has %d\n", m->object_->id(), m->maps_->length());
+    }
+  }
+
+ private:
+  HValue* Load(HLoadNamedField* instr) {
+    int field = FieldOf(instr->access());
+    if (field < 0) return instr;
+    HValue* object = instr->object()->ActualValue();
+    // Objects allocated as part of a bigger allocation overlap with the
+    // fields of the enclosing object, so they are never tracked.
+    if (object->IsInnerAllocatedObject()) return instr;
+
+    HFieldApproximation* approx = FindOrCreate(object, field);
+    if (approx->last_value_ != NULL &&
+        approx->last_value_->representation().Equals(
+            instr->representation())) {
+      return approx->last_value_;
+    }
+    approx->last_value_ = instr;
+    return instr;
+  }
+
+  void Store(HStoreNamedField* instr) {
+    HValue* object = instr->object()->ActualValue();
+    if (!instr->transition().is_null()) {
+      // Only the maps of the stored-to object change.
+      KillMapsOfAliases(object);
+      ZoneList<UniqueValueId>* maps = new(zone_) ZoneList<UniqueValueId>(1,
+                                                                         zone_);
+      maps->Add(instr->transition_unique_id(), zone_);
+      SetMaps(object, maps);
+    }
+    if (object->IsInnerAllocatedObject()) {
+      if (instr->CheckGVNFlag(kChangesInobjectFields)) KillFields();
+      return;
+    }
+    int field = FieldOf(instr->access());
+    if (field < 0) return;
+
+    KillFieldOfAliases(object, field);
+    FindOrCreate(object, field)->last_value_ = instr->value();
+  }
+
+  bool IsRedundantStore(HStoreNamedField* instr) {
+    if (!instr->transition().is_null()) return false;
+    int field = FieldOf(instr->access());
+    if (field < 0) return false;
+    HFieldApproximation* approx =
+        Find(instr->object()->ActualValue(), field);
+    return approx != NULL && approx->last_value_ == instr->value();
+  }
+
+  HFieldApproximation* Find(HValue* object, int field) {
+    for (HFieldApproximation* a = fields_[field]; a != NULL; a = a->next_) {
+      if (a->object_ == object) return a;
+    }
+    return NULL;
+  }
+
+  HFieldApproximation* FindOrCreate(HValue* object, int field) {
+    HFieldApproximation* approx = Find(object, field);
+    if (approx != NULL) return approx;
+
+    approx = new(zone_) HFieldApproximation(object, NULL, fields_[field]);
+    fields_[field] = approx;
+    // Forget the least recently added objects if there are too many.
+    HFieldApproximation* a = approx;
+    for (int count = 1; a != NULL; a = a->next_, count++) {
+      if (count == kMaxTrackedObjects) {
+        a->next_ = NULL;
+        break;
+      }
+    }
+    return approx;
+  }
+
+  // Removes the values known for the given field of all objects that may be
+  // the same as the given object, except for the object itself.
+  void KillFieldOfAliases(HValue* object, int field) {
+    HFieldApproximation** link = &fields_[field];
+    while (*link != NULL) {
+      HValue* other = (*link)->object_;
+      if (other != object && MayAlias(object, other)) {
+        *link = (*link)->next_;
+      } else {
+        link = &(*link)->next_;
+      }
+    }
+  }
+
+  void KillMapsOfAliases(HValue* object) {
+    HMapApproximation** link = &maps_;
+    while (*link != NULL) {
+      if (aliasing_->MayAlias(object, (*link)->object_)) {
+        *link = (*link)->next_;
+      } else {
+        link = &(*link)->next_;
+      }
+    }
+  }
+
+  const ZoneList<UniqueValueId>* MapsOf(HValue* object) {
+    for (HMapApproximation* m = maps_; m != NULL; m = m->next_) {
+      if (m->object_ == object) return m->maps_;
+    }
+    return NULL;
+  }
+
+  void SetMaps(HValue* object, const ZoneList<UniqueValueId>* maps) {
+    for (HMapApproximation* m = maps_; m != NULL; m = m->next_) {
+      if (m->object_ == object) {
+        m->maps_ = maps;
+        return;
+      }
+    }
+    maps_ = new(zone_) HMapApproximation(object, maps, maps_);
+  }
+
+  bool MayAlias(HValue* a, HValue* b) {
+    return aliasing_->Query(a, MapsOf(a), b, MapsOf(b)) != kNoAlias;
+  }
+
+  const ZoneList<UniqueValueId>* UnionOf(const ZoneList<UniqueValueId>* a,
+                                         const ZoneList<UniqueValueId>* b) {
+    if (a == b) return a;
+    ZoneList<UniqueValueId>* result =
+        new(zone_) ZoneList<UniqueValueId>(a->length() + b->length(), zone_);
+    result->AddAll(*a, zone_);
+    for (int i = 0; i < b->length(); i++) {
+      if (!result->Contains(b->at(i))) result->Add(b->at(i), zone_);
+    }
+    return result;
+  }
+
+  Zone* zone_;
+  ZoneList<HFieldApproximation*> fields_;
+  HMapApproximation* maps_;
+  HAliasAnalyzer* aliasing_;
+};
+
+
+HLoadElimination::HLoadElimination(HGraph* graph)
+    : graph_(graph),
+      aliasing_(new(graph->zone()) HAliasAnalyzer()),
+      block_states_(graph->blocks()->length(), graph->zone()) {
+  block_states_.AddBlock(NULL, graph->blocks()->length(), zone());
+}
+
+
+void HLoadElimination::Analyze() {
+  const ZoneList<HBasicBlock*>* blocks = graph()->blocks();
+  for (int i = 0; i < blocks->length(); i++) {
+    HBasicBlock* block = blocks->at(i);
+    HLoadEliminationTable* state = StateAtEntryOf(block);
+    HInstruction* instr = block->first();
+    while (instr != NULL) {
+      HInstruction* next = instr->next();
+      state->Process(instr);
+      instr = next;
+    }
+    if (FLAG_trace_load_elimination) {
+      PrintF("State at the end of B%d:\n", block->block_id());
+      state->Print();
+    }
+    block_states_.Set(block->block_id(), state);
+  }
+}
+
+
+HLoadEliminationTable* HLoadElimination::StateAtEntryOf(HBasicBlock* block) {
+  if (!block->HasPredecessor()) {
+    return new(zone()) HLoadEliminationTable(zone(), aliasing_);
+  }
+  if (block->IsLoopHeader()) return StateAtLoopHeader(block);
+
+  const ZoneList<HBasicBlock*>* predecessors = block->predecessors();
+  HBasicBlock* first = predecessors->at(0);
+  HLoadEliminationTable* state = StateAtExitOf(first);
+  ASSERT(state != NULL);
+  // The state at the end of a block with a single successor is not needed
+  // anywhere else and can be reused directly.
+  if (predecessors->length() == 1 && first->end()->SuccessorCount() == 1) {
+    return state;
+  }
+  state = state->Copy();
+  for (int i = 1; i < predecessors->length(); i++) {
+    HLoadEliminationTable* incoming = StateAtExitOf(predecessors->at(i));
+    ASSERT(incoming != NULL);
+    state->Merge(incoming);
+  }
+  return state;
+}
+
+
+HLoadEliminationTable* HLoadElimination::StateAtLoopHeader(
+    HBasicBlock* block) {
+  // Start from the state on loop entry and forget everything the loop body
+  // may change on a back edge.
+  HLoadEliminationTable* state =
+      StateAtExitOf(block->predecessors()->at(0))->Copy();
+  ComputeLoopKills(block->loop_information(), state);
+  return state;
+}
+
+
+void HLoadElimination::ComputeLoopKills(HLoopInformation* loop,
+                                        HLoadEliminationTable* state) {
+  const ZoneList<HBasicBlock*>* blocks = loop->blocks();
+  for (int i = 0; i < blocks->length(); i++) {
+    for (HInstruction* instr = blocks->at(i)->first();
+         instr != NULL;
+         instr = instr->next()) {
+      if (instr->IsStoreNamedField()) {
+        HStoreNamedField* store = HStoreNamedField::cast(instr);
+        int field = HLoadEliminationTable::FieldOf(store->access());
+        if (store->object()->ActualValue()->IsInnerAllocatedObject()) {
+          if (store->CheckGVNFlag(kChangesInobjectFields)) state->KillFields();
+        } else if (field >= 0) {
+          state->KillField(field);
+        }
+      } else if (instr->CheckGVNFlag(kChangesInobjectFields)) {
+        state->KillFields();
+      }
+      if (instr->CheckGVNFlag(kChangesMaps)) state->KillMaps();
+    }
+  }
+}
+
+
+} }  // namespace v8::internal
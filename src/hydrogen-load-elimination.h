@@ -0,0 +1,76 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef V8_HYDROGEN_LOAD_ELIMINATION_H_
+#define V8_HYDROGEN_LOAD_ELIMINATION_H_
+
+#include "hydrogen.h"
+#include "hydrogen-alias-analysis.h"
+
+namespace v8 {
+namespace internal {
+
+
+class HLoadEliminationTable;
+
+
+// Replaces loads of in-object fields by the value that was last loaded from
+// or stored into the same field of the same object, and removes stores that
+// write the value a field is already known to contain. In contrast to GVN,
+// which only knows that "some in-object field" was changed, the analysis
+// tracks individual (object, field offset) pairs and uses alias analysis to
+// decide which of them a store may clobber.
+class HLoadElimination BASE_EMBEDDED {
+ public:
+  explicit HLoadElimination(HGraph* graph);
+
+  void Analyze();
+
+ private:
+  HLoadEliminationTable* StateAtEntryOf(HBasicBlock* block);
+  HLoadEliminationTable* StateAtLoopHeader(HBasicBlock* block);
+  void ComputeLoopKills(HLoopInformation* loop,
+                        HLoadEliminationTable* state);
+
+  HLoadEliminationTable* StateAtExitOf(HBasicBlock* block) {
+    return block_states_.at(block->block_id());
+  }
+
+  HGraph* graph() const { return graph_; }
+  Zone* zone() const { return graph_->zone(); }
+
+  HGraph* graph_;
+  HAliasAnalyzer* aliasing_;
+
+  // States at the end of already processed blocks, indexed by block id.
+  ZoneList<HLoadEliminationTable*> block_states_;
+};
+
+
+} }  // namespace v8::internal
+
+#endif  // V8_HYDROGEN_LOAD_ELIMINATION_H_
@@ -35,6 +35,8 @@
 #include "full-codegen.h"
 #include "hashmap.h"
 #include "hydrogen-environment-liveness.h"
+#include "hydrogen-escape-analysis.h"
+#include "hydrogen-load-elimination.h"
 #include "lithium-allocator.h"
 #include "parser.h"
 #include "scopeinfo.h"
@@ -1215,6 +1217,92 @@ HValue* HGraphBuilder::BuildCopyElementsOnWrite(HValue* object,
 }
 
 
+HValue* HGraphBuilder::BuildArrayPush(HValue* array,
+                                      HCheckMaps* mapcheck,
+                                      HValue* value,
+                                      ElementsKind kind) {
+  Zone* zone = this->zone();
+  // Convert the value before the backing store is grown, so that a value
+  // which does not fit the elements kind deoptimizes before the array has
+  // been modified.
+  if (IsFastDoubleElementsKind(kind)) {
+    value = AddInstruction(new(zone) HForceRepresentation(
+        value, Representation::Double()));
+  }
+  HInstruction* length = AddLoad(array, HObjectAccess::ForArrayLength(),
+                                 mapcheck, Representation::Smi());
+  length->set_type(HType::Smi());
+
+  // Storing at index length grows the backing store on demand and updates
+  // the length of the array.
+  BuildUncheckedMonomorphicElementAccess(array, length, value, mapcheck,
+                                         true, kind, true, NEVER_RETURN_HOLE,
+                                         STORE_AND_GROW_NO_TRANSITION);
+
+  HValue* context = environment()->LookupContext();
+  HInstruction* new_length = AddInstruction(
+      HAdd::New(zone, context, length, graph()->GetConstant1()));
+  new_length->ClearFlag(HValue::kCanOverflow);
+  return new_length;
+}
+
+
+HValue* HGraphBuilder::BuildArrayPop(HValue* array,
+                                     HCheckMaps* mapcheck,
+                                     ElementsKind kind) {
+  Zone* zone = this->zone();
+  HValue* context = environment()->LookupContext();
+  HInstruction* length = AddLoad(array, HObjectAccess::ForArrayLength(),
+                                 mapcheck, Representation::Smi());
+  length->set_type(HType::Smi());
+
+  IfBuilder length_checker(this);
+  length_checker.IfCompare(length, graph()->GetConstant0(), Token::EQ);
+  length_checker.Then();
+
+  environment()->Push(graph()->GetConstantUndefined());
+
+  length_checker.Else();
+
+  HValue* elements = AddLoadElements(array, mapcheck);
+  if (IsFastSmiOrObjectElementsKind(kind)) {
+    HCheckMaps* check_cow_map = HCheckMaps::New(
+        elements, isolate()->factory()->fixed_array_map(), zone);
+    check_cow_map->ClearGVNFlag(kDependsOnElementsKind);
+    AddInstruction(check_cow_map);
+  }
+  HInstruction* new_length = AddInstruction(
+      HSub::New(zone, context, length, graph()->GetConstant1()));
+  new_length->ClearFlag(HValue::kCanOverflow);
+
+  // Holes deoptimize, they would have to be looked up in the prototype chain.
+  HInstruction* element = AddInstruction(
+      BuildFastElementAccess(elements, new_length, NULL, mapcheck, kind,
+                             false, NEVER_RETURN_HOLE, STANDARD_STORE));
+
+  // Clear the slot that is no longer part of the array.
+  HValue* hole;
+  ElementsKind hole_kind = kind;
+  if (IsFastSmiOrObjectElementsKind(kind)) {
+    hole = AddInstruction(new(zone) HConstant(
+        isolate()->factory()->the_hole_value()));
+    hole_kind = FAST_HOLEY_ELEMENTS;
+  } else {
+    hole = AddInstruction(new(zone) HConstant(
+        FixedDoubleArray::hole_nan_as_double()));
+  }
+  AddInstruction(new(zone) HStoreKeyed(elements, new_length, hole, hole_kind));
+  AddStore(array, HObjectAccess::ForArrayLength(), new_length,
+           Representation::Smi());
+
+  environment()->Push(element);
+
+  length_checker.End();
+
+  return environment()->Pop();
+}
+
+
 HInstruction* HGraphBuilder::BuildUncheckedMonomorphicElementAccess(
     HValue* object,
     HValue* key,
@@ -1600,6 +1688,7 @@ void HGraphBuilder::BuildCopyElements(HValue* context,
 
 HValue* HGraphBuilder::BuildCloneShallowArray(HContext* context,
                                               HValue* boilerplate,
+                                              HValue* allocation_site,
                                               AllocationSiteMode mode,
                                               ElementsKind kind,
                                               int length) {
@@ -1639,7 +1728,8 @@ HValue* HGraphBuilder::BuildCloneShallowArray(HContext* context,
 
   // Create an allocation site info if requested.
   if (mode == TRACK_ALLOCATION_SITE) {
-    BuildCreateAllocationSiteInfo(object, JSArray::kSize, boilerplate);
+    BuildCreateAllocationSiteInfo(object, JSArray::kSize, allocation_site);
+    BuildIncrementMementoCreateCount(context, allocation_site);
   }
 
   if (length > 0) {
@@ -1732,6 +1822,18 @@ HValue* HGraphBuilder::BuildCreateAllocationSiteInfo(HValue* previous_object,
 }
 
 
+void HGraphBuilder::BuildIncrementMementoCreateCount(HValue* context,
+                                                     HValue* allocation_site) {
+  HObjectAccess access = HObjectAccess::ForAllocationSiteMementoCreateCount();
+  HValue* count = AddLoad(allocation_site, access, NULL,
+                          Representation::Smi());
+  // Overflowing the counter deoptimizes, the runtime starts over then.
+  HValue* new_count = AddInstruction(
+      HAdd::New(zone(), context, count, graph()->GetConstant1()));
+  AddStore(allocation_site, access, new_count, Representation::Smi());
+}
+
+
 HInstruction* HGraphBuilder::BuildGetNativeContext(HValue* context) {
   // Get the global context, then the native context
   HInstruction* global_object = AddInstruction(new(zone())
@@ -1948,6 +2050,7 @@ HOptimizedGraphBuilder::HOptimizedGraphBuilder(CompilationInfo* info)
       break_scope_(NULL),
       inlined_count_(0),
       globals_(10, info->zone()),
+      preallocated_double_boxes_(0, info->zone()),
       inline_bailout_(false) {
   // This is not initialized in the initializer list because the
   // constructor for the initial state relies on function_state_ == NULL
@@ -3979,12 +4082,16 @@ bool HGraph::Optimize(SmartArrayPointer<char>* bailout_reason) {
   if (FLAG_dead_code_elimination) {
     DeadCodeElimination("H_Eliminate early dead code");
   }
+
+  if (FLAG_use_escape_analysis) EscapeAnalysis();
+
   CollectPhis();
 
   if (has_osr_loop_entry()) {
     const ZoneList<HPhi*>* phis = osr_loop_entry()->phis();
     for (int j = 0; j < phis->length(); j++) {
       HPhi* phi = phis->at(j);
+      if (!phi->HasMergedIndex()) continue;
       osr_values()->at(phi->merged_index())->set_incoming_value(phi);
     }
   }
@@ -4011,6 +4118,8 @@ bool HGraph::Optimize(SmartArrayPointer<char>* bailout_reason) {
 
   if (FLAG_use_gvn) GlobalValueNumbering();
 
+  if (FLAG_use_load_elimination) LoadElimination();
+
   if (FLAG_use_range) {
     HRangeAnalysis rangeAnalysis(this);
     rangeAnalysis.Analyze();
@@ -4597,11 +4706,31 @@ void HGraph::RemoveDeadInstructions() {
     HPhi* phi = dead_phis.RemoveLast();
     HBasicBlock* block = phi->block();
     phi->DeleteAndReplaceWith(NULL);
-    block->RecordDeletedPhi(phi->merged_index());
+    if (phi->HasMergedIndex()) {
+      block->RecordDeletedPhi(phi->merged_index());
+    }
   }
 }
 
 
+void HGraph::EscapeAnalysis() {
+  HPhase phase("H_Escape analysis", this);
+  // Code stubs build their allocations explicitly for the runtime.
+  if (info()->IsStub()) return;
+  HEscapeAnalysis analysis(this);
+  if (analysis.Analyze()) EliminateRedundantPhis();
+}
+
+
+// Replace loads of in-object fields whose value is already known and remove
+// stores that do not change the value of a field.
+void HGraph::LoadElimination() {
+  HPhase phase("H_Load elimination", this);
+  HLoadElimination load_elimination(this);
+  load_elimination.Analyze();
+}
+
+
 void HGraph::RestoreActualValues() {
   HPhase phase("H_Restore actual values", this);
 
@@ -5850,25 +5979,28 @@ void HOptimizedGraphBuilder::VisitObjectLiteral(ObjectLiteral* expr) {
   int data_size = 0;
   int pointer_size = 0;
   int max_properties = kMaxFastLiteralProperties;
-  Handle<Object> original_boilerplate(closure->literals()->get(
+  Handle<Object> literal_site(closure->literals()->get(
       expr->literal_index()), isolate());
-  if (original_boilerplate->IsJSObject() &&
-      IsFastLiteral(Handle<JSObject>::cast(original_boilerplate),
+  if (literal_site->IsAllocationSite() &&
+      IsFastLiteral(Handle<JSObject>(JSObject::cast(
+                        AllocationSite::cast(*literal_site)->boilerplate())),
                     kMaxFastLiteralDepth,
                     &max_properties,
                     &data_size,
                     &pointer_size)) {
-    Handle<JSObject> original_boilerplate_object =
-        Handle<JSObject>::cast(original_boilerplate);
+    Handle<AllocationSite> site = Handle<AllocationSite>::cast(literal_site);
+    Handle<JSObject> original_boilerplate_object(
+        JSObject::cast(site->boilerplate()));
     Handle<JSObject> boilerplate_object =
         DeepCopy(original_boilerplate_object);
 
     literal = BuildFastLiteral(context,
                                boilerplate_object,
                                original_boilerplate_object,
+                               site,
                                data_size,
                                pointer_size,
-                               DONT_TRACK_ALLOCATION_SITE);
+                               site->GetMode());
   } else {
     NoObservableSideEffectsScope no_effects(this);
     Handle<FixedArray> closure_literals(closure->literals(), isolate());
@@ -5980,32 +6112,36 @@ void HOptimizedGraphBuilder::VisitArrayLiteral(ArrayLiteral* expr) {
   HInstruction* literal;
 
   Handle<FixedArray> literals(environment()->closure()->literals(), isolate());
-  Handle<Object> raw_boilerplate(literals->get(expr->literal_index()),
-                                 isolate());
+  Handle<Object> literal_site(literals->get(expr->literal_index()),
+                              isolate());
 
-  if (raw_boilerplate->IsUndefined()) {
-    raw_boilerplate = Runtime::CreateArrayLiteralBoilerplate(
+  Handle<AllocationSite> site;
+  if (literal_site->IsUndefined()) {
+    Handle<Object> raw_boilerplate = Runtime::CreateArrayLiteralBoilerplate(
         isolate(), literals, expr->constant_elements());
     if (raw_boilerplate.is_null()) {
       return Bailout("array boilerplate creation failed");
     }
-    literals->set(expr->literal_index(), *raw_boilerplate);
+    site = isolate()->factory()->NewAllocationSite(
+        Handle<JSObject>::cast(raw_boilerplate));
+    literals->set(expr->literal_index(), *site);
     if (JSObject::cast(*raw_boilerplate)->elements()->map() ==
         isolate()->heap()->fixed_cow_array_map()) {
       isolate()->counters()->cow_arrays_created_runtime()->Increment();
     }
+  } else {
+    site = Handle<AllocationSite>::cast(literal_site);
   }
 
-  Handle<JSObject> original_boilerplate_object =
-      Handle<JSObject>::cast(raw_boilerplate);
+  Handle<JSObject> original_boilerplate_object(
+      JSObject::cast(site->boilerplate()));
   ElementsKind boilerplate_elements_kind =
-      Handle<JSObject>::cast(original_boilerplate_object)->GetElementsKind();
+      original_boilerplate_object->GetElementsKind();
 
   // TODO(mvstanton): This heuristic is only a temporary solution.  In the
   // end, we want to quit creating allocation site info after a certain number
   // of GCs for a call site.
-  AllocationSiteMode mode = AllocationSiteInfo::GetMode(
-      boilerplate_elements_kind);
+  AllocationSiteMode mode = site->GetMode();
 
   // Check whether to use fast or slow deep-copying for boilerplate.
   int data_size = 0;
@@ -6016,14 +6152,11 @@ void HOptimizedGraphBuilder::VisitArrayLiteral(ArrayLiteral* expr) {
                     &max_properties,
                     &data_size,
                     &pointer_size)) {
-    if (mode == TRACK_ALLOCATION_SITE) {
-      pointer_size += AllocationSiteInfo::kSize;
-    }
-
     Handle<JSObject> boilerplate_object = DeepCopy(original_boilerplate_object);
     literal = BuildFastLiteral(context,
                                boilerplate_object,
                                original_boilerplate_object,
+                               site,
                                data_size,
                                pointer_size,
                                mode);
@@ -6214,14 +6347,19 @@ HInstruction* HOptimizedGraphBuilder::BuildStoreNamedField(
   HStoreNamedField *instr;
   if (FLAG_track_double_fields && representation.IsDouble()) {
     if (transition_to_field) {
-      // The store requires a mutable HeapNumber to be allocated.
+      // The store requires a mutable HeapNumber, unless one was allocated
+      // together with the receiver of an inlined constructor.
       NoObservableSideEffectsScope no_side_effects(this);
-      HInstruction* heap_number_size = AddInstruction(new(zone()) HConstant(
-          HeapNumber::kSize));
-      HInstruction* double_box = AddInstruction(new(zone()) HAllocate(
-          environment()->LookupContext(), heap_number_size,
-          HType::HeapNumber(), HAllocate::CAN_ALLOCATE_IN_NEW_SPACE));
-      AddStoreMapConstant(double_box, isolate()->factory()->heap_number_map());
+      HInstruction* double_box = TakePreallocatedDoubleBox(object);
+      if (double_box == NULL) {
+        HInstruction* heap_number_size = AddInstruction(new(zone()) HConstant(
+            HeapNumber::kSize));
+        double_box = AddInstruction(new(zone()) HAllocate(
+            environment()->LookupContext(), heap_number_size,
+            HType::HeapNumber(), HAllocate::CAN_ALLOCATE_IN_NEW_SPACE));
+        AddStoreMapConstant(double_box,
+                            isolate()->factory()->heap_number_map());
+      }
       AddStore(double_box, HObjectAccess::ForHeapNumberValue(),
           value, Representation::Double());
       instr = new(zone()) HStoreNamedField(object, field_access, double_box);
@@ -6249,6 +6387,19 @@ HInstruction* HOptimizedGraphBuilder::BuildStoreNamedField(
 }
 
 
+HInstruction* HOptimizedGraphBuilder::TakePreallocatedDoubleBox(
+    HValue* object) {
+  for (int i = 0; i < preallocated_double_boxes_.length(); i++) {
+    HInnerAllocatedObject* double_box = preallocated_double_boxes_[i];
+    if (double_box->base_object() == object) {
+      preallocated_double_boxes_.Remove(i);
+      return double_box;
+    }
+  }
+  return NULL;
+}
+
+
 HInstruction* HOptimizedGraphBuilder::BuildStoreNamedGeneric(
     HValue* object,
     Handle<String> name,
@@ -8388,6 +8539,36 @@ bool HOptimizedGraphBuilder::TryInlineBuiltinMethodCall(
         return true;
       }
       break;
+    case kArrayPush:
+    case kArrayPop:
+      if (check_type == RECEIVER_MAP_CHECK &&
+          expr->IsMonomorphic() &&
+          argument_count == (id == kArrayPush ? 2 : 1) &&
+          CanInlineArrayResizeOperation(receiver_map)) {
+        // The exact elements kind is needed, so elements kind transitions of
+        // the receiver map are not accepted here.
+        BuildCheckNonSmi(receiver);
+        HCheckMaps* mapcheck = HCheckMaps::New(receiver, receiver_map, zone());
+        AddInstruction(mapcheck);
+        AddCheckPrototypeMaps(expr->holder(), receiver_map);
+        ElementsKind elements_kind = receiver_map->elements_kind();
+        HValue* result;
+        {
+          NoObservableSideEffectsScope scope(this);
+          if (id == kArrayPush) {
+            HValue* value = Pop();
+            result = BuildArrayPush(receiver, mapcheck, value, elements_kind);
+          } else {
+            result = BuildArrayPop(receiver, mapcheck, elements_kind);
+          }
+        }
+        Drop(1);  // Receiver.
+        Push(result);
+        AddSimulate(expr->id(), REMOVABLE_SIMULATE);
+        ast_context()->ReturnValue(Pop());
+        return true;
+      }
+      break;
     default:
       // Not yet supported for inlining.
       break;
@@ -8396,6 +8577,18 @@ bool HOptimizedGraphBuilder::TryInlineBuiltinMethodCall(
 }
 
 
+// Array.prototype.push and pop are inlined for arrays with fast elements
+// whose length changes do not have to be reported or rejected.
+bool HOptimizedGraphBuilder::CanInlineArrayResizeOperation(
+    Handle<Map> receiver_map) {
+  return !receiver_map.is_null() &&
+      receiver_map->instance_type() == JS_ARRAY_TYPE &&
+      IsFastElementsKind(receiver_map->elements_kind()) &&
+      !receiver_map->is_observed() &&
+      receiver_map->is_extensible();
+}
+
+
 bool HOptimizedGraphBuilder::TryCallApply(Call* expr) {
   Expression* callee = expr->expression();
   Property* prop = callee->AsProperty();
@@ -8765,6 +8958,31 @@ static bool IsAllocationInlineable(Handle<JSFunction> constructor) {
 }
 
 
+// Follows the chain of single transitions from the initial map of a
+// constructor, which is what a constructor adding the same properties in the
+// same order produces, and counts the double fields of the map at its end.
+// The result is limited so that the boxes for these fields can be allocated
+// together with an instance of the initial map.
+static int ExpectedDoubleFieldCount(Handle<Map> initial_map) {
+  Map* map = *initial_map;
+  while (map->HasTransitionArray() &&
+         map->transitions()->number_of_transitions() == 1) {
+    map = map->transitions()->GetTarget(0);
+  }
+  int count = 0;
+  DescriptorArray* descriptors = map->instance_descriptors();
+  for (int i = 0; i < map->NumberOfOwnDescriptors(); i++) {
+    PropertyDetails details = descriptors->GetDetails(i);
+    if (details.type() == FIELD && details.representation().IsDouble()) {
+      count++;
+    }
+  }
+  int max_count = (HAllocate::kMaxInlineSize - initial_map->instance_size()) /
+      HeapNumber::kSize;
+  return Min(count, max_count);
+}
+
+
 void HOptimizedGraphBuilder::VisitCallNew(CallNew* expr) {
   ASSERT(!HasStackOverflow());
   ASSERT(current_block() != NULL);
@@ -8797,9 +9015,15 @@ void HOptimizedGraphBuilder::VisitCallNew(CallNew* expr) {
     int instance_size = initial_map->instance_size();
     ASSERT(initial_map->InitialPropertiesLength() == 0);
 
-    // Allocate an instance of the implicit receiver object.
-    HValue* size_in_bytes =
-        AddInstruction(new(zone()) HConstant(instance_size));
+    // Allocate an instance of the implicit receiver object. The mutable
+    // boxes for the double fields the constructor is expected to add are
+    // allocated right behind it, so that the transitioning stores do not
+    // have to allocate them one by one.
+    int double_box_count = FLAG_track_double_fields
+        ? ExpectedDoubleFieldCount(initial_map)
+        : 0;
+    HValue* size_in_bytes = AddInstruction(new(zone()) HConstant(
+        instance_size + double_box_count * HeapNumber::kSize));
 
     HAllocate::Flags flags = HAllocate::DefaultFlags();
     if (FLAG_pretenuring_call_new &&
@@ -8815,12 +9039,10 @@ void HOptimizedGraphBuilder::VisitCallNew(CallNew* expr) {
                                              flags));
     HAllocate::cast(receiver)->set_known_initial_map(initial_map);
 
-    // Load the initial map from the constructor.
-    HValue* constructor_value =
-        AddInstruction(new(zone()) HConstant(constructor));
-    HValue* initial_map_value =
-        AddLoad(constructor_value, HObjectAccess::ForJSObjectOffset(
-            JSFunction::kPrototypeOrInitialMapOffset));
+    // Use the initial map as a constant so that the map of the receiver is
+    // statically known, optimized code is deoptimized when it changes.
+    HInstruction* initial_map_value =
+        AddInstruction(new(zone()) HConstant(initial_map));
 
     // Initialize map and fields of the newly allocated object.
     { NoObservableSideEffectsScope no_effects(this);
@@ -8845,6 +9067,14 @@ void HOptimizedGraphBuilder::VisitCallNew(CallNew* expr) {
                    undefined);
         }
       }
+      // The boxes must be valid heap objects before the next allocation.
+      for (int i = 0; i < double_box_count; i++) {
+        HInnerAllocatedObject* double_box = new(zone()) HInnerAllocatedObject(
+            receiver, instance_size + i * HeapNumber::kSize);
+        AddInstruction(double_box);
+        AddStoreMapConstant(double_box, factory->heap_number_map());
+        preallocated_double_boxes_.Add(double_box, zone());
+      }
     }
 
     // Replace the constructor function with a newly allocated receiver using
@@ -8853,7 +9083,16 @@ void HOptimizedGraphBuilder::VisitCallNew(CallNew* expr) {
     ASSERT(environment()->ExpressionStackAt(receiver_index) == function);
     environment()->SetExpressionStackAt(receiver_index, receiver);
 
-    if (TryInlineConstruct(expr, receiver)) return;
+    bool inlined = TryInlineConstruct(expr, receiver);
+
+    // Boxes not taken by the inlined constructor remain unused.
+    while (TakePreallocatedDoubleBox(receiver) != NULL) { }
+
+    if (inlined) {
+      initial_map->AddDependentCompilationInfo(
+          DependentCode::kInitialMapChangedGroup, top_info());
+      return;
+    }
 
     // TODO(mstarzinger): For now we remove the previous HAllocate and all
     // corresponding instructions and instead add HPushArgument for the
@@ -9935,22 +10174,43 @@ HInstruction* HOptimizedGraphBuilder::BuildFastLiteral(
     HValue* context,
     Handle<JSObject> boilerplate_object,
     Handle<JSObject> original_boilerplate_object,
+    Handle<AllocationSite> allocation_site,
     int data_size,
     int pointer_size,
     AllocationSiteMode mode) {
   Zone* zone = this->zone();
-  int total_size = data_size + pointer_size;
-
   NoObservableSideEffectsScope no_effects(this);
 
+  bool pretenure = isolate()->heap()->ShouldGloballyPretenure();
+  if (!allocation_site.is_null()) {
+    if (allocation_site->GetPretenureMode() == TENURED) {
+      pretenure = true;
+    } else if (FLAG_allocation_site_pretenuring &&
+               allocation_site->pretenure_decision() ==
+                   AllocationSite::kUndecided) {
+      // The copies made by this code count towards the pretenuring decision,
+      // which invalidates the code once it is made.
+      AllocationSite::AddDependentCompilationInfo(
+          allocation_site,
+          DependentCode::kAllocationSiteTenuringChangedGroup,
+          top_info());
+    }
+  }
+
   HAllocate::Flags flags = HAllocate::CAN_ALLOCATE_IN_NEW_SPACE;
   // TODO(hpayer): add support for old data space
-  if (isolate()->heap()->ShouldGloballyPretenure() &&
-      data_size == 0) {
+  if (pretenure && data_size == 0) {
     flags = static_cast<HAllocate::Flags>(
         flags | HAllocate::CAN_ALLOCATE_IN_OLD_POINTER_SPACE);
   }
 
+  if (mode == TRACK_ALLOCATION_SITE &&
+      boilerplate_object->map()->CanTrackAllocationSite()) {
+    ASSERT(!allocation_site.is_null());
+    pointer_size += AllocationSiteInfo::kSize;
+  }
+  int total_size = data_size + pointer_size;
+
   HValue* size_in_bytes = AddInstruction(new(zone) HConstant(total_size));
   HInstruction* result =
       AddInstruction(new(zone) HAllocate(context,
@@ -9958,8 +10218,8 @@ HInstruction* HOptimizedGraphBuilder::BuildFastLiteral(
                                          HType::JSObject(),
                                          flags));
   int offset = 0;
-  BuildEmitDeepCopy(boilerplate_object, original_boilerplate_object, result,
-                    &offset, mode);
+  BuildEmitDeepCopy(boilerplate_object, original_boilerplate_object,
+                    allocation_site, result, &offset, mode);
   return result;
 }
 
@@ -9967,6 +10227,7 @@ HInstruction* HOptimizedGraphBuilder::BuildFastLiteral(
 void HOptimizedGraphBuilder::BuildEmitDeepCopy(
     Handle<JSObject> boilerplate_object,
     Handle<JSObject> original_boilerplate_object,
+    Handle<AllocationSite> allocation_site,
     HInstruction* target,
     int* offset,
     AllocationSiteMode mode) {
@@ -9986,6 +10247,15 @@ void HOptimizedGraphBuilder::BuildEmitDeepCopy(
           elements->Size() : 0;
   int elements_offset = *offset + object_size;
 
+  // The allocation site info directly follows the object, in front of its
+  // elements.
+  bool create_allocation_site_info = mode == TRACK_ALLOCATION_SITE &&
+      boilerplate_object->map()->CanTrackAllocationSite();
+  if (create_allocation_site_info) {
+    elements_offset += AllocationSiteInfo::kSize;
+    *offset += AllocationSiteInfo::kSize;
+  }
+
   *offset += object_size + elements_size;
 
   // Copy object elements if non-COW.
@@ -10003,13 +10273,10 @@ void HOptimizedGraphBuilder::BuildEmitDeepCopy(
       object_properties, target, offset);
 
   // Create allocation site info.
-  if (mode == TRACK_ALLOCATION_SITE &&
-      boilerplate_object->map()->CanTrackAllocationSite()) {
-    elements_offset += AllocationSiteInfo::kSize;
-    *offset += AllocationSiteInfo::kSize;
-    HInstruction* original_boilerplate = AddInstruction(new(zone) HConstant(
-        original_boilerplate_object));
-    BuildCreateAllocationSiteInfo(target, JSArray::kSize, original_boilerplate);
+  if (create_allocation_site_info) {
+    HInstruction* site = AddInstruction(new(zone) HConstant(allocation_site));
+    BuildCreateAllocationSiteInfo(target, object_offset + object_size, site);
+    BuildIncrementMementoCreateCount(environment()->LookupContext(), site);
   }
 }
 
@@ -10106,8 +10373,9 @@ void HOptimizedGraphBuilder::BuildEmitInObjectProperties(
 
       AddStore(object_properties, access, value_instruction);
 
-      BuildEmitDeepCopy(value_object, original_value_object, target,
-          offset, DONT_TRACK_ALLOCATION_SITE);
+      BuildEmitDeepCopy(value_object, original_value_object,
+          Handle<AllocationSite>::null(), target, offset,
+          DONT_TRACK_ALLOCATION_SITE);
     } else {
       Representation representation = details.representation();
       HInstruction* value_instruction =
@@ -10213,8 +10481,9 @@ void HOptimizedGraphBuilder::BuildEmitFixedArray(
           AddInstruction(new(zone) HInnerAllocatedObject(target, *offset));
       AddInstruction(new(zone) HStoreKeyed(
           object_elements, key_constant, value_instruction, kind));
-      BuildEmitDeepCopy(value_object, original_value_object, target,
-          offset, DONT_TRACK_ALLOCATION_SITE);
+      BuildEmitDeepCopy(value_object, original_value_object,
+          Handle<AllocationSite>::null(), target, offset,
+          DONT_TRACK_ALLOCATION_SITE);
     } else {
       HInstruction* value_instruction =
           AddInstruction(new(zone) HLoadKeyed(
@@ -11301,7 +11570,7 @@ void HTracer::Trace(const char* name, HGraph* graph, LChunk* chunk) {
       for (int j = 0; j < total; ++j) {
         HPhi* phi = current->phis()->at(j);
         PrintIndent();
-        trace_.Add("%d ", phi->merged_index());
+        if (phi->HasMergedIndex()) trace_.Add("%d ", phi->merged_index());
         phi->PrintNameTo(&trace_);
         trace_.Add(" ");
         phi->PrintTo(&trace_);
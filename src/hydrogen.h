@@ -294,6 +294,8 @@ class HGraph: public ZoneObject {
   void DehoistSimpleArrayIndexComputations();
   void RestoreActualValues();
   void DeadCodeElimination(const char *phase_name);
+  void EscapeAnalysis();
+  void LoadElimination();
   void PropagateDeoptimizingMark();
   void AnalyzeAndPruneEnvironmentLiveness();
 
@@ -1045,6 +1047,18 @@ class HGraphBuilder {
                                    ElementsKind kind,
                                    HValue* length);
 
+  // Inline versions of Array.prototype.push with a single argument and
+  // Array.prototype.pop on a JSArray with the given fast elements kind. They
+  // must be used in a NoObservableSideEffectsScope, the caller is responsible
+  // for simulating the environment afterwards.
+  HValue* BuildArrayPush(HValue* array,
+                         HCheckMaps* mapcheck,
+                         HValue* value,
+                         ElementsKind kind);
+  HValue* BuildArrayPop(HValue* array,
+                        HCheckMaps* mapcheck,
+                        ElementsKind kind);
+
   HInstruction* BuildUncheckedMonomorphicElementAccess(
       HValue* object,
       HValue* key,
@@ -1355,6 +1369,7 @@ class HGraphBuilder {
 
   HValue* BuildCloneShallowArray(HContext* context,
                                  HValue* boilerplate,
+                                 HValue* allocation_site,
                                  AllocationSiteMode mode,
                                  ElementsKind kind,
                                  int length);
@@ -1369,6 +1384,10 @@ class HGraphBuilder {
                                         int previous_object_size,
                                         HValue* payload);
 
+  // Counts a copy made for the given literal allocation site.
+  void BuildIncrementMementoCreateCount(HValue* context,
+                                        HValue* allocation_site);
+
   HInstruction* BuildGetNativeContext(HValue* context);
   HInstruction* BuildGetArrayFunction(HValue* context);
 
@@ -1679,6 +1698,7 @@ class HOptimizedGraphBuilder: public HGraphBuilder, public AstVisitor {
                                   Handle<Map> receiver_map,
                                   CheckType check_type);
   bool TryInlineBuiltinFunctionCall(Call* expr, bool drop_extra);
+  bool CanInlineArrayResizeOperation(Handle<Map> receiver_map);
 
   // If --trace-inlining, print a line of the inlining trace.  Inlining
   // succeeded if the reason string is NULL and failed if there is a
@@ -1783,6 +1803,7 @@ class HOptimizedGraphBuilder: public HGraphBuilder, public AstVisitor {
                                      HValue* value,
                                      Handle<Map> map,
                                      LookupResult* lookup);
+  HInstruction* TakePreallocatedDoubleBox(HValue* object);
   HInstruction* BuildStoreNamedGeneric(HValue* object,
                                        Handle<String> name,
                                        HValue* value);
@@ -1806,12 +1827,14 @@ class HOptimizedGraphBuilder: public HGraphBuilder, public AstVisitor {
   HInstruction* BuildFastLiteral(HValue* context,
                                  Handle<JSObject> boilerplate_object,
                                  Handle<JSObject> original_boilerplate_object,
+                                 Handle<AllocationSite> allocation_site,
                                  int data_size,
                                  int pointer_size,
                                  AllocationSiteMode mode);
 
   void BuildEmitDeepCopy(Handle<JSObject> boilerplat_object,
                          Handle<JSObject> object,
+                         Handle<AllocationSite> allocation_site,
                          HInstruction* result,
                          int* offset,
                          AllocationSiteMode mode);
@@ -1875,6 +1898,11 @@ class HOptimizedGraphBuilder: public HGraphBuilder, public AstVisitor {
   int inlined_count_;
   ZoneList<Handle<Object> > globals_;
 
+  // Mutable HeapNumber boxes allocated together with the receivers of
+  // inlined constructors, waiting for the double field stores that take
+  // them.
+  ZoneList<HInnerAllocatedObject*> preallocated_double_boxes_;
+
   bool inline_bailout_;
 
   friend class FunctionState;  // Pushes and pops the state stack.
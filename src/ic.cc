@@ -866,8 +866,7 @@ MaybeObject* LoadIC::Load(State state,
       } else if (state == MONOMORPHIC && object->IsStringWrapper()) {
         StringLengthStub string_length_stub(kind(), true);
         stub = string_length_stub.GetCode(isolate());
-      } else if (state != MEGAMORPHIC) {
-        ASSERT(state != GENERIC);
+      } else if (state != MEGAMORPHIC && state != GENERIC) {
         stub = megamorphic_stub();
       }
       if (!stub.is_null()) {
@@ -893,8 +892,7 @@ MaybeObject* LoadIC::Load(State state,
       } else if (state == PREMONOMORPHIC) {
         FunctionPrototypeStub function_prototype_stub(kind());
         stub = function_prototype_stub.GetCode(isolate());
-      } else if (state != MEGAMORPHIC) {
-        ASSERT(state != GENERIC);
+      } else if (state != MEGAMORPHIC && state != GENERIC) {
         stub = megamorphic_stub();
       }
       if (!stub.is_null()) {
@@ -971,6 +969,116 @@ static bool AddOneReceiverMapIfMissing(MapHandleList* receiver_maps,
 }
 
 
+static void AddSummaryProperty(Handle<JSObject> summary,
+                               const char* name,
+                               Handle<Object> value) {
+  Isolate* isolate = summary->GetIsolate();
+  Handle<String> key = isolate->factory()->InternalizeUtf8String(name);
+  CHECK_NOT_EMPTY_HANDLE(isolate,
+                         JSObject::SetLocalPropertyIgnoreAttributes(
+                             summary, key, value, NONE));
+}
+
+
+static void AddSummaryCount(Handle<JSObject> summary,
+                            const char* name,
+                            int count) {
+  Handle<Object> value(Smi::FromInt(count), summary->GetIsolate());
+  AddSummaryProperty(summary, name, value);
+}
+
+
+Handle<JSObject> IC::SummarizeStates(Handle<JSFunction> function) {
+  Isolate* isolate = function->GetIsolate();
+  Factory* factory = isolate->factory();
+  Handle<SharedFunctionInfo> shared(function->shared());
+
+  int counts[GENERIC + 1] = { 0 };
+  int ic_total_count = 0;
+  int ic_with_type_info_count = 0;
+  MapHandleList maps;
+  List<int> megamorphic_positions;
+
+  // The inline caches live in the unoptimized code, which is kept around
+  // while the function is optimized.
+  Handle<Code> code(shared->code());
+  if (code->kind() == Code::FUNCTION) {
+    Object* raw_info = code->type_feedback_info();
+    if (raw_info->IsTypeFeedbackInfo()) {
+      TypeFeedbackInfo* info = TypeFeedbackInfo::cast(raw_info);
+      ic_total_count = info->ic_total_count();
+      ic_with_type_info_count = info->ic_with_type_info_count();
+    }
+
+    int mask = RelocInfo::ModeMask(RelocInfo::CODE_TARGET) |
+               RelocInfo::ModeMask(RelocInfo::CONSTRUCT_CALL) |
+               RelocInfo::ModeMask(RelocInfo::CODE_TARGET_WITH_ID) |
+               RelocInfo::ModeMask(RelocInfo::CODE_TARGET_CONTEXT);
+    for (RelocIterator it(*code, mask); !it.done(); it.next()) {
+      RelocInfo* info = it.rinfo();
+      Code* target = Code::GetCodeFromTargetAddress(info->target_address());
+      if (!target->is_inline_cache_stub()) continue;
+      State state = target->ic_state();
+      switch (state) {
+        case UNINITIALIZED:
+        case PREMONOMORPHIC:
+          break;
+        case MONOMORPHIC: {
+          Map* map = target->FindFirstMap();
+          if (map != NULL) {
+            AddOneReceiverMapIfMissing(&maps, Handle<Map>(map));
+          }
+          break;
+        }
+        case POLYMORPHIC: {
+          MapHandleList target_maps;
+          target->FindAllMaps(&target_maps);
+          for (int i = 0; i < target_maps.length(); i++) {
+            AddOneReceiverMapIfMissing(&maps, target_maps.at(i));
+          }
+          break;
+        }
+        case MEGAMORPHIC:
+        case GENERIC:
+          megamorphic_positions.Add(code->SourcePosition(info->pc()));
+          break;
+        case MONOMORPHIC_PROTOTYPE_FAILURE:
+        case DEBUG_STUB:
+          continue;
+      }
+      counts[state]++;
+    }
+  }
+
+  Handle<FixedArray> positions =
+      factory->NewFixedArray(megamorphic_positions.length());
+  for (int i = 0; i < megamorphic_positions.length(); i++) {
+    positions->set(i, Smi::FromInt(megamorphic_positions[i]));
+  }
+
+  Handle<JSObject> summary =
+      factory->NewJSObject(isolate->object_function());
+  AddSummaryProperty(summary, "name", Handle<Object>(shared->DebugName(),
+                                                     isolate));
+  AddSummaryCount(summary, "uninitialized", counts[UNINITIALIZED]);
+  AddSummaryCount(summary, "premonomorphic", counts[PREMONOMORPHIC]);
+  AddSummaryCount(summary, "monomorphic", counts[MONOMORPHIC]);
+  AddSummaryCount(summary, "polymorphic", counts[POLYMORPHIC]);
+  AddSummaryCount(summary, "megamorphic", counts[MEGAMORPHIC]);
+  AddSummaryCount(summary, "generic", counts[GENERIC]);
+  AddSummaryCount(summary, "icTotalCount", ic_total_count);
+  AddSummaryCount(summary, "icWithTypeInfoCount", ic_with_type_info_count);
+  AddSummaryCount(summary, "maps", maps.length());
+  AddSummaryProperty(summary, "megamorphicPositions",
+                     factory->NewJSArrayWithElements(positions));
+  AddSummaryCount(summary, "optCount", shared->opt_count());
+  AddSummaryCount(summary, "deoptCount", shared->deopt_count());
+  AddSummaryProperty(summary, "optimized",
+                     factory->ToBoolean(function->IsOptimized()));
+  return summary;
+}
+
+
 bool IC::UpdatePolymorphicIC(State state,
                              StrictModeFlag strict_mode,
                              Handle<JSObject> receiver,
@@ -1141,6 +1249,7 @@ void IC::PatchCache(State state,
       } else {
         // When trying to patch a polymorphic keyed load/store element stub
         // with anything other than another polymorphic stub, go generic.
+        UpdateMegamorphicCache(receiver->map(), *name, *code);
         set_target((strict_mode == kStrictMode)
                    ? *generic_stub_strict()
                    : *generic_stub());
@@ -1149,7 +1258,10 @@ void IC::PatchCache(State state,
     case DEBUG_STUB:
       break;
     case GENERIC:
-      UNREACHABLE();
+      // The generic keyed load stub probes the stub cache for unique names
+      // and misses into the IC when the probe fails.
+      ASSERT(target()->is_keyed_load_stub());
+      UpdateMegamorphicCache(receiver->map(), *name, *code);
       break;
   }
 }
@@ -1447,6 +1559,14 @@ MaybeObject* KeyedLoadIC::Load(State state,
 }
 
 
+void KeyedLoadIC::UpdateMegamorphicCache(Map* map, Name* name, Code* code) {
+  // Only handlers may be entered into the stub cache; the generic stub would
+  // otherwise end up jumping to itself.
+  if (code->is_inline_cache_stub()) return;
+  IC::UpdateMegamorphicCache(map, name, code);
+}
+
+
 Handle<Code> KeyedLoadIC::ComputeLoadHandler(LookupResult* lookup,
                                              Handle<JSObject> receiver,
                                              Handle<String> name) {
@@ -105,6 +105,13 @@ class IC {
   // Clear the inline cache to initial state.
   static void Clear(Address address);
 
+  // Returns an object summarizing the states of the inline caches in the
+  // unoptimized code of the function: the number of sites per state, the
+  // number of distinct receiver maps seen by monomorphic and polymorphic
+  // sites, the source positions of megamorphic and generic sites, and the
+  // optimization and deoptimization counts.
+  static Handle<JSObject> SummarizeStates(Handle<JSFunction> function);
+
   // Computes the reloc info for this IC. This is a fairly expensive
   // operation as it has to search through the heap to find the code
   // object that contains this IC site.
@@ -472,7 +479,7 @@ class KeyedLoadIC: public LoadIC {
   virtual Handle<Code> ComputeLoadHandler(LookupResult* lookup,
                                           Handle<JSObject> receiver,
                                           Handle<String> name);
-  virtual void UpdateMegamorphicCache(Map* map, Name* name, Code* code) { }
+  virtual void UpdateMegamorphicCache(Map* map, Name* name, Code* code);
 
  private:
   // Stub accessors.
@@ -51,6 +51,7 @@ IncrementalMarking::IncrementalMarking(Heap* heap)
       old_generation_space_used_at_start_of_incremental_(0),
       steps_count_since_last_gc_(0),
       steps_took_since_last_gc_(0),
+      background_steps_took_(0),
       should_hurry_(false),
       marking_speed_(0),
       allocated_(0),
@@ -280,6 +281,15 @@ class IncrementalMarkingMarkingVisitor
                   HeapObject::RawField(object, JSWeakMap::kSize));
   }
 
+  static void VisitAllocationSite(Map* map, HeapObject* object) {
+    Heap* heap = map->GetHeap();
+    VisitPointers(heap,
+                  HeapObject::RawField(object,
+                                       AllocationSite::kBoilerplateOffset),
+                  HeapObject::RawField(object,
+                                       AllocationSite::kWeakNextOffset));
+  }
+
   static void BeforeVisitingSharedFunctionInfo(HeapObject* object) {}
 
   INLINE(static void VisitPointer(Heap* heap, Object** p)) {
@@ -735,7 +745,32 @@ void IncrementalMarking::VisitObject(Map* map, HeapObject* obj, int size) {
 }
 
 
-void IncrementalMarking::ProcessMarkingDeque(intptr_t bytes_to_process) {
+void IncrementalMarking::ProcessMainThreadObjects() {
+  ParallelMarker* parallel_marker =
+      heap_->mark_compact_collector()->parallel_marker();
+  List<HeapObject*>* objects = parallel_marker->main_thread_objects();
+  for (int i = 0; i < objects->length(); i++) {
+    HeapObject* obj = objects->at(i);
+    Map* map = obj->map();
+    VisitObject(map, obj, obj->SizeFromMap(map));
+  }
+  objects->Clear();
+}
+
+
+intptr_t IncrementalMarking::ProcessMarkingDeque(intptr_t bytes_to_process) {
+  intptr_t budget = bytes_to_process;
+  ParallelMarker* parallel_marker =
+      heap_->mark_compact_collector()->parallel_marker();
+  if (parallel_marker->IsEnabledForIncrementalMarking() &&
+      parallel_marker->ShouldMarkInParallel(&marking_deque_)) {
+    bytes_to_process -= parallel_marker->MarkIncrementallyInParallel(
+        &marking_deque_, bytes_to_process);
+    // The objects handed back by the round are visited regardless of the
+    // remaining budget, otherwise the next round would hand them back again.
+    ProcessMainThreadObjects();
+  }
+
   Map* filler_map = heap_->one_pointer_filler_map();
   while (!marking_deque_.IsEmpty() && bytes_to_process > 0) {
     HeapObject* obj = marking_deque_.Pop();
@@ -750,12 +785,22 @@ void IncrementalMarking::ProcessMarkingDeque(intptr_t bytes_to_process) {
     VisitObject(map, obj, size);
     bytes_to_process -= (size - unscanned_bytes_of_large_object_);
   }
+  return budget - Max(bytes_to_process, static_cast<intptr_t>(0));
 }
 
 
 void IncrementalMarking::ProcessMarkingDeque() {
+  ParallelMarker* parallel_marker =
+      heap_->mark_compact_collector()->parallel_marker();
+  bool parallel_marking = parallel_marker->IsEnabledForIncrementalMarking();
   Map* filler_map = heap_->one_pointer_filler_map();
   while (!marking_deque_.IsEmpty()) {
+    if (parallel_marking &&
+        parallel_marker->ShouldMarkInParallel(&marking_deque_)) {
+      parallel_marker->MarkIncrementallyInParallel(&marking_deque_, kMaxInt);
+      ProcessMainThreadObjects();
+      continue;
+    }
     HeapObject* obj = marking_deque_.Pop();
 
     // Explicitly skip one word fillers. Incremental markbit patterns are
@@ -928,15 +973,7 @@ void IncrementalMarking::Step(intptr_t allocated_bytes,
     start = OS::TimeCurrentMillis();
   }
 
-  if (state_ == SWEEPING) {
-    if (heap_->EnsureSweepersProgressed(static_cast<int>(bytes_to_process))) {
-      bytes_scanned_ = 0;
-      StartMarking(PREVENT_COMPACTION);
-    }
-  } else if (state_ == MARKING) {
-    ProcessMarkingDeque(bytes_to_process);
-    if (marking_deque_.IsEmpty()) MarkingComplete(action);
-  }
+  ProcessStep(bytes_to_process, action);
 
   steps_count_++;
   steps_count_since_last_gc_++;
@@ -1016,6 +1053,37 @@ void IncrementalMarking::Step(intptr_t allocated_bytes,
 }
 
 
+void IncrementalMarking::IdleStep(intptr_t bytes_to_process) {
+  if (heap_->gc_state() != Heap::NOT_IN_GC ||
+      (state_ != SWEEPING && state_ != MARKING)) {
+    return;
+  }
+  if (state_ == MARKING && no_marking_scope_depth_ > 0) return;
+
+  bytes_scanned_ += bytes_to_process;
+  ProcessStep(bytes_to_process, NO_GC_VIA_STACK_GUARD);
+  steps_count_++;
+  steps_count_since_last_gc_++;
+}
+
+
+void IncrementalMarking::ProcessStep(intptr_t bytes_to_process,
+                                     CompletionAction action) {
+  if (state_ == SWEEPING) {
+    if (heap_->EnsureSweepersProgressed(static_cast<int>(bytes_to_process))) {
+      bytes_scanned_ = 0;
+      StartMarking(PREVENT_COMPACTION);
+    }
+  } else if (state_ == MARKING) {
+    double start = OS::TimeCurrentMillis();
+    intptr_t bytes_marked = ProcessMarkingDeque(bytes_to_process);
+    heap_->gc_idle_time_handler()->RecordIncrementalMarkingStep(
+        bytes_marked, OS::TimeCurrentMillis() - start);
+    if (marking_deque_.IsEmpty()) MarkingComplete(action);
+  }
+}
+
+
 void IncrementalMarking::ResetStepCounters() {
   steps_count_ = 0;
   steps_took_ = 0;
@@ -1026,6 +1094,7 @@ void IncrementalMarking::ResetStepCounters() {
       heap_->PromotedTotalSize();
   steps_count_since_last_gc_ = 0;
   steps_took_since_last_gc_ = 0;
+  background_steps_took_ = 0;
   bytes_rescanned_ = 0;
   marking_speed_ = kInitialMarkingSpeed;
   bytes_scanned_ = 0;
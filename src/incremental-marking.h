@@ -116,6 +116,11 @@ class IncrementalMarking {
 
   void Step(intptr_t allocated, CompletionAction action);
 
+  // Processes the given number of bytes independent of the marking speed,
+  // so that the step fits into the idle time it was sized for.  Completing
+  // the marking does not request a GC.
+  void IdleStep(intptr_t bytes_to_process);
+
   inline void RestartIfNotMarking() {
     if (state_ == COMPLETE) {
       state_ = MARKING;
@@ -183,6 +188,16 @@ class IncrementalMarking {
     return steps_took_since_last_gc_;
   }
 
+  // Time the marking threads spent helping steps since the start of marking.
+  // steps_took() only accounts for the main thread.
+  inline double background_steps_took() {
+    return background_steps_took_;
+  }
+
+  void AddBackgroundMarkingTime(double time) {
+    background_steps_took_ += time;
+  }
+
   inline void SetOldSpacePageFlags(MemoryChunk* chunk) {
     SetOldSpacePageFlags(chunk, IsMarking(), IsCompacting());
   }
@@ -249,7 +264,15 @@ class IncrementalMarking {
 
   INLINE(void ProcessMarkingDeque());
 
-  INLINE(void ProcessMarkingDeque(intptr_t bytes_to_process));
+  // Returns the number of bytes that were processed.
+  INLINE(intptr_t ProcessMarkingDeque(intptr_t bytes_to_process));
+
+  // Sweeps or marks the given number of bytes, depending on the state.
+  void ProcessStep(intptr_t bytes_to_process, CompletionAction action);
+
+  // Visits the objects a parallel marking round handed back to the main
+  // thread.
+  void ProcessMainThreadObjects();
 
   INLINE(void VisitObject(Map* map, HeapObject* obj, int size));
 
@@ -269,6 +292,7 @@ class IncrementalMarking {
   int64_t old_generation_space_used_at_start_of_incremental_;
   int steps_count_since_last_gc_;
   double steps_took_since_last_gc_;
+  double background_steps_took_;
   int64_t bytes_rescanned_;
   bool should_hurry_;
   int marking_speed_;
@@ -45,6 +45,7 @@
 #include "platform.h"
 #include "regexp-stack.h"
 #include "runtime-profiler.h"
+#include "scavenger-thread.h"
 #include "scopeinfo.h"
 #include "serialize.h"
 #include "simulator.h"
@@ -143,7 +144,14 @@ int SystemThreadManager::NumberOfParallelSystemThreads(
   } else if (type == CONCURRENT_SWEEPING) {
     return number_of_threads - 1;
   } else if (type == PARALLEL_MARKING) {
-    return number_of_threads;
+    // The main thread takes part in parallel marking as well.
+    return number_of_threads - 1;
+  } else if (type == PARALLEL_SCAVENGING) {
+    // The main thread takes part in the scavenge as well.
+    return number_of_threads - 1;
+  } else if (type == PARALLEL_RECOMPILATION) {
+    // The main thread keeps running JavaScript and creating graphs.
+    return number_of_threads - 1;
   }
   return 1;
 }
@@ -1760,6 +1768,7 @@ Isolate::Isolate()
       optimizing_compiler_thread_(this),
       marking_thread_(NULL),
       sweeper_thread_(NULL),
+      scavenger_thread_(NULL),
       callback_table_(NULL) {
   id_ = NoBarrier_AtomicIncrement(&isolate_counter_, 1);
   TRACE_ISOLATE(constructor);
@@ -1848,7 +1857,7 @@ void Isolate::Deinit() {
   if (state_ == INITIALIZED) {
     TRACE_ISOLATE(deinit);
 
-    if (FLAG_parallel_recompilation) optimizing_compiler_thread_.Stop();
+    optimizing_compiler_thread_.Stop();
 
     if (FLAG_sweeper_threads > 0) {
       for (int i = 0; i < FLAG_sweeper_threads; i++) {
@@ -1866,6 +1875,14 @@ void Isolate::Deinit() {
       delete[] marking_thread_;
     }
 
+    if (FLAG_scavenger_threads > 0) {
+      for (int i = 0; i < FLAG_scavenger_threads; i++) {
+        scavenger_thread_[i]->Stop();
+        delete scavenger_thread_[i];
+      }
+      delete[] scavenger_thread_;
+    }
+
     if (FLAG_hydrogen_stats) GetHStatistics()->Print();
 
     // We must stop the logger before we tear down other components.
@@ -2257,9 +2274,21 @@ bool Isolate::Init(Deserializer* des) {
     InternalArrayConstructorStubBase::InstallDescriptors(this);
   }
 
-  if (FLAG_parallel_recompilation) optimizing_compiler_thread_.Start();
+  if (FLAG_parallel_recompilation && FLAG_recompilation_threads == 0) {
+    FLAG_recompilation_threads = SystemThreadManager::
+        NumberOfParallelSystemThreads(
+            SystemThreadManager::PARALLEL_RECOMPILATION);
+  }
+  if (FLAG_parallel_recompilation && FLAG_recompilation_threads > 0 &&
+      V8::UseCrankshaft()) {
+    optimizing_compiler_thread_.Start(FLAG_recompilation_threads);
+  } else {
+    FLAG_parallel_recompilation = false;
+  }
 
-  if (FLAG_parallel_marking && FLAG_marking_threads == 0) {
+  if ((FLAG_parallel_marking || FLAG_parallel_incremental_marking ||
+       FLAG_parallel_compaction) &&
+      FLAG_marking_threads == 0) {
     FLAG_marking_threads = SystemThreadManager::
         NumberOfParallelSystemThreads(
             SystemThreadManager::PARALLEL_MARKING);
@@ -2267,11 +2296,29 @@ bool Isolate::Init(Deserializer* des) {
   if (FLAG_marking_threads > 0) {
     marking_thread_ = new MarkingThread*[FLAG_marking_threads];
     for (int i = 0; i < FLAG_marking_threads; i++) {
-      marking_thread_[i] = new MarkingThread(this);
+      marking_thread_[i] = new MarkingThread(this, i + 1);
       marking_thread_[i]->Start();
     }
   } else {
     FLAG_parallel_marking = false;
+    FLAG_parallel_incremental_marking = false;
+    FLAG_parallel_compaction = false;
+  }
+
+  if (FLAG_parallel_scavenge && FLAG_scavenger_threads == 0) {
+    FLAG_scavenger_threads = SystemThreadManager::
+        NumberOfParallelSystemThreads(
+            SystemThreadManager::PARALLEL_SCAVENGING);
+  }
+  if (FLAG_parallel_scavenge && FLAG_scavenger_threads > 0) {
+    scavenger_thread_ = new ScavengerThread*[FLAG_scavenger_threads];
+    for (int i = 0; i < FLAG_scavenger_threads; i++) {
+      scavenger_thread_[i] = new ScavengerThread(this, i + 1);
+      scavenger_thread_[i]->Start();
+    }
+  } else {
+    FLAG_parallel_scavenge = false;
+    FLAG_scavenger_threads = 0;
   }
 
   if (FLAG_sweeper_threads == 0) {
@@ -2295,11 +2342,6 @@ bool Isolate::Init(Deserializer* des) {
     FLAG_concurrent_sweeping = false;
     FLAG_parallel_sweeping = false;
   }
-  if (FLAG_parallel_recompilation &&
-      SystemThreadManager::NumberOfParallelSystemThreads(
-          SystemThreadManager::PARALLEL_RECOMPILATION) == 0) {
-    FLAG_parallel_recompilation = false;
-  }
   return true;
 }
 
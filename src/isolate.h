@@ -79,6 +79,7 @@ class MarkingThread;
 class PreallocatedMemoryThread;
 class RegExpStack;
 class SaveContext;
+class ScavengerThread;
 class UnicodeCache;
 class ConsStringIteratorOp;
 class StringTracker;
@@ -297,6 +298,7 @@ class SystemThreadManager {
     PARALLEL_SWEEPING,
     CONCURRENT_SWEEPING,
     PARALLEL_MARKING,
+    PARALLEL_SCAVENGING,
     PARALLEL_RECOMPILATION
   };
 
@@ -1100,6 +1102,10 @@ class Isolate {
     return sweeper_thread_;
   }
 
+  ScavengerThread** scavenger_threads() {
+    return scavenger_thread_;
+  }
+
   CallbackTable* callback_table() {
     return callback_table_;
   }
@@ -1341,6 +1347,7 @@ class Isolate {
   OptimizingCompilerThread optimizing_compiler_thread_;
   MarkingThread** marking_thread_;
   SweeperThread** sweeper_thread_;
+  ScavengerThread** scavenger_thread_;
   CallbackTable* callback_table_;
 
   friend class ExecutionAccess;
@@ -1348,6 +1355,7 @@ class Isolate {
   friend class IsolateInitializer;
   friend class MarkingThread;
   friend class OptimizingCompilerThread;
+  friend class ScavengerThread;
   friend class SweeperThread;
   friend class ThreadManager;
   friend class Simulator;
@@ -321,6 +321,13 @@ void LiveRange::SplitAt(LifetimePosition position,
   // position after it.
   UsePosition* use_after = first_pos_;
   UsePosition* use_before = NULL;
+  // The last processed use is usually close to the split position, start the
+  // search from there if it precedes the split.
+  if (last_processed_use_ != NULL &&
+      last_processed_use_->pos().Value() < position.Value()) {
+    use_before = last_processed_use_;
+    use_after = use_before->next();
+  }
   if (split_at_start) {
     // The split position coincides with the beginning of a use interval (the
     // end of a lifetime hole). Use at this position should be attributed to
@@ -1124,27 +1131,48 @@ void LAllocator::ResolvePhis() {
 }
 
 
+// Returns the child in the sorted list of children of a split live range
+// that can cover the given position, or NULL if there is none.
+static LiveRange* FindCoveringChild(const ZoneList<LiveRange*>* children,
+                                    LifetimePosition position) {
+  int low = 0;
+  int high = children->length();
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (children->at(mid)->Start().Value() <= position.Value()) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low == 0) return NULL;
+  LiveRange* child = children->at(low - 1);
+  return child->CanCover(position) ? child : NULL;
+}
+
+
+ZoneList<LiveRange*>* LAllocator::CollectChildren(LiveRange* range) {
+  ZoneList<LiveRange*>* children = new(zone()) ZoneList<LiveRange*>(4, zone());
+  for (LiveRange* cur = range; cur != NULL; cur = cur->next()) {
+    if (cur->IsEmpty()) continue;
+    ASSERT(children->is_empty() ||
+           children->last()->End().Value() <= cur->Start().Value());
+    children->Add(cur, zone());
+  }
+  return children;
+}
+
+
 void LAllocator::ResolveControlFlow(LiveRange* range,
+                                    const ZoneList<LiveRange*>* children,
                                     HBasicBlock* block,
                                     HBasicBlock* pred) {
   LifetimePosition pred_end =
       LifetimePosition::FromInstructionIndex(pred->last_instruction_index());
   LifetimePosition cur_start =
       LifetimePosition::FromInstructionIndex(block->first_instruction_index());
-  LiveRange* pred_cover = NULL;
-  LiveRange* cur_cover = NULL;
-  LiveRange* cur_range = range;
-  while (cur_range != NULL && (cur_cover == NULL || pred_cover == NULL)) {
-    if (cur_range->CanCover(cur_start)) {
-      ASSERT(cur_cover == NULL);
-      cur_cover = cur_range;
-    }
-    if (cur_range->CanCover(pred_end)) {
-      ASSERT(pred_cover == NULL);
-      pred_cover = cur_range;
-    }
-    cur_range = cur_range->next();
-  }
+  LiveRange* pred_cover = FindCoveringChild(children, pred_end);
+  LiveRange* cur_cover = FindCoveringChild(children, cur_start);
 
   if (cur_cover->IsSpilled()) return;
   ASSERT(pred_cover != NULL && cur_cover != NULL);
@@ -1245,6 +1273,11 @@ bool LAllocator::CanEagerlyResolveControlFlow(HBasicBlock* block) const {
 
 void LAllocator::ResolveControlFlow() {
   HPhase phase("L_Resolve control flow", this);
+  // The sorted children of each split live range, collected on first use so
+  // that the child covering either end of an edge can be found by binary
+  // search instead of walking the chain of children for every edge.
+  ZoneList<ZoneList<LiveRange*>*> children(live_ranges()->length(), zone());
+  children.AddBlock(NULL, live_ranges()->length(), zone());
   const ZoneList<HBasicBlock*>* blocks = graph_->blocks();
   for (int block_id = 1; block_id < blocks->length(); ++block_id) {
     HBasicBlock* block = blocks->at(block_id);
@@ -1253,10 +1286,18 @@ void LAllocator::ResolveControlFlow() {
     BitVector::Iterator iterator(live);
     while (!iterator.Done()) {
       int operand_index = iterator.Current();
-      for (int i = 0; i < block->predecessors()->length(); ++i) {
-        HBasicBlock* cur = block->predecessors()->at(i);
-        LiveRange* cur_range = LiveRangeFor(operand_index);
-        ResolveControlFlow(cur_range, block, cur);
+      LiveRange* cur_range = LiveRangeFor(operand_index);
+      // A live range that was never split is in the same location at both
+      // ends of every edge.
+      if (cur_range->next() != NULL) {
+        ASSERT(operand_index < children.length());
+        if (children[operand_index] == NULL) {
+          children[operand_index] = CollectChildren(cur_range);
+        }
+        for (int i = 0; i < block->predecessors()->length(); ++i) {
+          HBasicBlock* cur = block->predecessors()->at(i);
+          ResolveControlFlow(cur_range, children[operand_index], block, cur);
+        }
       }
       iterator.Advance();
     }
@@ -1423,6 +1464,9 @@ void LAllocator::PopulatePointerMaps() {
     }
 
     // Step through the safe points to see whether they are in the range.
+    // Both the safe points and the children of the range are sorted, so the
+    // search for the covering child resumes where it left off.
+    LiveRange* cur = range;
     for (int safe_point_index = first_safe_point_index;
          safe_point_index < pointer_maps->length();
          ++safe_point_index) {
@@ -1432,15 +1476,18 @@ void LAllocator::PopulatePointerMaps() {
       // The safe points are sorted so we can stop searching here.
       if (safe_point - 1 > end) break;
 
-      // Advance to the next active range that covers the current
-      // safe point position.
+      // Advance to the first child that does not end before the current
+      // safe point position; no earlier child can cover this or any of the
+      // following safe points.
       LifetimePosition safe_point_pos =
           LifetimePosition::FromInstructionIndex(safe_point);
-      LiveRange* cur = range;
-      while (cur != NULL && !cur->Covers(safe_point_pos)) {
+      while (cur != NULL &&
+             (cur->IsEmpty() ||
+              cur->End().Value() <= safe_point_pos.Value())) {
         cur = cur->next();
       }
-      if (cur == NULL) continue;
+      if (cur == NULL) break;
+      if (!cur->Covers(safe_point_pos)) continue;
 
       // Check if the live range is spilled and the safe point is after
       // the spill position.
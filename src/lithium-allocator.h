@@ -566,8 +566,10 @@ class LAllocator BASE_EMBEDDED {
 
   // Helper methods for resolving control flow.
   void ResolveControlFlow(LiveRange* range,
+                          const ZoneList<LiveRange*>* children,
                           HBasicBlock* block,
                           HBasicBlock* pred);
+  ZoneList<LiveRange*>* CollectChildren(LiveRange* range);
 
   inline void SetLiveRangeAssignedRegister(LiveRange* range,
                                            int reg,
@@ -533,6 +533,7 @@ class LEnvironment: public ZoneObject {
         values_(value_count, zone),
         is_tagged_(value_count, zone),
         is_uint32_(value_count, zone),
+        object_mapping_(0, zone),
         spilled_registers_(NULL),
         spilled_double_registers_(NULL),
         outer_(outer),
@@ -579,6 +580,45 @@ class LEnvironment: public ZoneObject {
     return is_uint32_.Contains(index);
   }
 
+  // Objects that are not present in optimized code and have to be
+  // materialized by the deoptimizer are marked in the value array. They are
+  // described here in the order their markers are visited, their field
+  // values follow the translated values (see WriteTranslation).
+  void AddNewObject(int length, bool is_arguments) {
+    uint32_t encoded = LengthOrDupeField::encode(length) |
+                       IsArgumentsField::encode(is_arguments) |
+                       IsDuplicateField::encode(false);
+    object_mapping_.Add(encoded, zone());
+  }
+
+  void AddDuplicateObject(int dupe_of) {
+    uint32_t encoded = LengthOrDupeField::encode(dupe_of) |
+                       IsDuplicateField::encode(true);
+    object_mapping_.Add(encoded, zone());
+  }
+
+  int ObjectDuplicateOfAt(int index) {
+    ASSERT(ObjectIsDuplicateAt(index));
+    return LengthOrDupeField::decode(object_mapping_[index]);
+  }
+
+  int ObjectLengthAt(int index) {
+    ASSERT(!ObjectIsDuplicateAt(index));
+    return LengthOrDupeField::decode(object_mapping_[index]);
+  }
+
+  bool ObjectIsArgumentsAt(int index) {
+    ASSERT(!ObjectIsDuplicateAt(index));
+    return IsArgumentsField::decode(object_mapping_[index]);
+  }
+
+  bool ObjectIsDuplicateAt(int index) {
+    return IsDuplicateField::decode(object_mapping_[index]);
+  }
+
+  // Marker value indicating a de-materialized object.
+  static LOperand* materialization_marker() { return NULL; }
+
   void Register(int deoptimization_index,
                 int translation_index,
                 int pc_offset) {
@@ -599,6 +639,11 @@ class LEnvironment: public ZoneObject {
 
   void PrintTo(StringStream* stream);
 
+  // Encoding used for the object_mapping map below.
+  class LengthOrDupeField : public BitField<int, 0, 30> { };
+  class IsArgumentsField : public BitField<bool, 30, 1> { };
+  class IsDuplicateField : public BitField<bool, 31, 1> { };
+
  private:
   Handle<JSFunction> closure_;
   FrameType frame_type_;
@@ -616,6 +661,9 @@ class LEnvironment: public ZoneObject {
   GrowableBitVector is_tagged_;
   GrowableBitVector is_uint32_;
 
+  // Map with encoded information about materialization_marker operands.
+  ZoneList<uint32_t> object_mapping_;
+
   // Allocation index indexed arrays of spill slot operands for registers
   // that are also in spill slots at an OSR entry.  NULL for environments
   // that do not correspond to an OSR entry.
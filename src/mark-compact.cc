@@ -62,6 +62,7 @@ MarkCompactCollector::MarkCompactCollector() :  // NOLINT
 #endif
       sweep_precisely_(false),
       reduce_memory_footprint_(false),
+      compact_all_fragmented_pages_(false),
       abort_incremental_marking_(false),
       marking_parity_(ODD_MARKING_PARITY),
       compacting_(false),
@@ -71,8 +72,11 @@ MarkCompactCollector::MarkCompactCollector() :  // NOLINT
       tracer_(NULL),
       migration_slots_buffer_(NULL),
       heap_(NULL),
+      parallel_marker_(this),
+      parallel_evacuator_(this),
       code_flusher_(NULL),
-      encountered_weak_maps_(NULL) { }
+      encountered_weak_maps_(NULL),
+      encountered_allocation_sites_(NULL) { }
 
 
 #ifdef VERIFY_HEAP
@@ -396,6 +400,7 @@ void MarkCompactCollector::CollectGarbage() {
   // update the state as they proceed.
   ASSERT(state_ == PREPARE_GC);
   ASSERT(encountered_weak_maps_ == Smi::FromInt(0));
+  ASSERT(encountered_allocation_sites_ == Smi::FromInt(0));
 
   MarkLiveObjects();
   ASSERT(heap_->incremental_marking()->IsStopped());
@@ -563,8 +568,12 @@ void MarkCompactCollector::WaitUntilSweepingCompleted() {
   sweeping_pending_ = false;
   StealMemoryFromSweeperThreads(heap()->paged_space(OLD_DATA_SPACE));
   StealMemoryFromSweeperThreads(heap()->paged_space(OLD_POINTER_SPACE));
+  StealMemoryFromSweeperThreads(heap()->paged_space(CODE_SPACE));
+  StealMemoryFromSweeperThreads(heap()->paged_space(MAP_SPACE));
   heap()->paged_space(OLD_DATA_SPACE)->ResetUnsweptFreeBytes();
   heap()->paged_space(OLD_POINTER_SPACE)->ResetUnsweptFreeBytes();
+  heap()->paged_space(CODE_SPACE)->ResetUnsweptFreeBytes();
+  heap()->paged_space(MAP_SPACE)->ResetUnsweptFreeBytes();
 }
 
 
@@ -604,6 +613,31 @@ void MarkCompactCollector::WaitUntilMarkingCompleted() {
 }
 
 
+void MarkCompactCollector::StartMarkingThreads(int count) {
+  ASSERT(count <= FLAG_marking_threads);
+  for (int i = 0; i < count; i++) {
+    isolate()->marking_threads()[i]->StartMarking();
+  }
+}
+
+
+void MarkCompactCollector::WaitForMarkingThreads(int count) {
+  ASSERT(count <= FLAG_marking_threads);
+  for (int i = 0; i < count; i++) {
+    isolate()->marking_threads()[i]->WaitForMarkingThread();
+  }
+}
+
+
+void MarkCompactCollector::RunParallelTask(int task_id) {
+  if (parallel_evacuator_.IsActive()) {
+    parallel_evacuator_.RunTask(task_id);
+  } else {
+    parallel_marker_.MarkInParallel(task_id);
+  }
+}
+
+
 bool Marking::TransferMark(Address old_start, Address new_start) {
   // This is only used when resizing an object.
   ASSERT(MemoryChunk::FromAddress(old_start) ==
@@ -779,6 +813,13 @@ void MarkCompactCollector::CollectEvacuationCandidates(PagedSpace* space) {
     max_evacuation_candidates *= 2;
   }
 
+  if (compact_all_fragmented_pages_ && over_reserved >= space->AreaSize()) {
+    // The memory reducer asked to free as many pages as possible, so every
+    // page above the freeness threshold becomes a candidate.
+    mode = REDUCE_MEMORY_FOOTPRINT;
+    max_evacuation_candidates = kMaxMaxEvacuationCandidates;
+  }
+
   if (FLAG_trace_fragmentation && mode == REDUCE_MEMORY_FOOTPRINT) {
     PrintF("Estimated over reserved memory: %.1f / %.1f MB (threshold %d)\n",
            static_cast<double>(over_reserved) / MB,
@@ -810,7 +851,8 @@ void MarkCompactCollector::CollectEvacuationCandidates(PagedSpace* space) {
       if ((counter & 1) == (page_number & 1)) fragmentation = 1;
     } else if (mode == REDUCE_MEMORY_FOOTPRINT) {
       // Don't try to release too many pages.
-      if (estimated_release >= ((over_reserved * 3) / 4)) {
+      if (!compact_all_fragmented_pages_ &&
+          estimated_release >= ((over_reserved * 3) / 4)) {
         continue;
       }
 
@@ -942,14 +984,6 @@ void MarkCompactCollector::Prepare(GCTracer* tracer) {
 }
 
 
-class DeoptimizeMarkedCodeFilter : public OptimizedFunctionFilter {
- public:
-  virtual bool TakeFunction(JSFunction* function) {
-    return function->code()->marked_for_deoptimization();
-  }
-};
-
-
 void MarkCompactCollector::Finish() {
 #ifdef DEBUG
   ASSERT(state_ == SWEEP_SPACES || state_ == RELOCATE_OBJECTS);
@@ -961,8 +995,7 @@ void MarkCompactCollector::Finish() {
   // objects (empty string, illegal builtin).
   isolate()->stub_cache()->Clear();
 
-  DeoptimizeMarkedCodeFilter filter;
-  Deoptimizer::DeoptimizeAllFunctionsWith(isolate(), &filter);
+  Deoptimizer::DeoptimizeMarkedCode(isolate());
 }
 
 
@@ -1478,6 +1511,39 @@ class MarkCompactMarkingVisitor
     ASSERT(MarkCompactCollector::IsMarked(table->map()));
   }
 
+  static void VisitAllocationSite(Map* map, HeapObject* object) {
+    Heap* heap = map->GetHeap();
+    AllocationSite* site = reinterpret_cast<AllocationSite*>(object);
+    if (!FLAG_collect_maps) {
+      VisitPointers(heap,
+                    HeapObject::RawField(site,
+                                         AllocationSite::kBoilerplateOffset),
+                    HeapObject::RawField(site,
+                                         AllocationSite::kWeakNextOffset));
+      return;
+    }
+    MarkCompactCollector* collector = heap->mark_compact_collector();
+
+    // Enqueue the site in the linked list of encountered allocation sites,
+    // its dead dependent code is cleared in ClearNonLiveReferences.
+    if (site->weak_next() == Smi::FromInt(0)) {
+      site->set_weak_next(collector->encountered_allocation_sites());
+      collector->set_encountered_allocation_sites(site);
+    }
+
+    // Mark the dependent code array without pushing it on the marking stack,
+    // this makes the references from it weak, the same as for maps.
+    Object** slot =
+        HeapObject::RawField(site, AllocationSite::kDependentCodeOffset);
+    HeapObject* dependent_code = HeapObject::cast(*slot);
+    collector->RecordSlot(slot, slot, dependent_code);
+    MarkObjectWithoutPush(heap, dependent_code);
+
+    Object** boilerplate_slot =
+        HeapObject::RawField(site, AllocationSite::kBoilerplateOffset);
+    VisitPointer(heap, boilerplate_slot);
+  }
+
  private:
   template<int id>
   static inline void TrackObjectStatsAndVisit(Map* map, HeapObject* obj);
@@ -1708,6 +1774,513 @@ VisitorDispatchTable<MarkCompactMarkingVisitor::Callback>
     MarkCompactMarkingVisitor::non_count_table_;
 
 
+// Visits object bodies on behalf of the task running on the current thread.
+// Only objects that consist of plain tagged fields are visited here, the
+// bodies of all other objects are deferred to MarkCompactMarkingVisitor on
+// the main thread.
+class ParallelMarkingVisitor : public StaticVisitorBase {
+ public:
+  static void Initialize();
+
+  INLINE(static void IterateBody(Map* map, HeapObject* object)) {
+    table_.GetVisitor(map)(map, object);
+  }
+
+  INLINE(static void VisitPointers(Heap* heap, Object** start, Object** end)) {
+    ParallelMarker::CurrentTask()->VisitPointers(start, end);
+  }
+
+ private:
+  static void DeferObject(Map* map, HeapObject* object) {
+    ParallelMarker::CurrentTask()->DeferObject(object);
+  }
+
+  class DataObjectVisitor {
+   public:
+    template<int size>
+    static inline void VisitSpecialized(Map* map, HeapObject* object) {
+    }
+
+    INLINE(static void Visit(Map* map, HeapObject* object)) {
+    }
+  };
+
+  typedef FlexibleBodyVisitor<ParallelMarkingVisitor,
+                              FixedArray::BodyDescriptor,
+                              void> FixedArrayVisitor;
+
+  typedef FlexibleBodyVisitor<ParallelMarkingVisitor,
+                              JSObject::BodyDescriptor,
+                              void> JSObjectVisitor;
+
+  typedef FlexibleBodyVisitor<ParallelMarkingVisitor,
+                              StructBodyDescriptor,
+                              void> StructObjectVisitor;
+
+  typedef void (*Callback)(Map* map, HeapObject* object);
+
+  static VisitorDispatchTable<Callback> table_;
+};
+
+
+VisitorDispatchTable<ParallelMarkingVisitor::Callback>
+    ParallelMarkingVisitor::table_;
+
+
+void ParallelMarkingVisitor::Initialize() {
+  for (int id = 0; id < kVisitorIdCount; id++) {
+    table_.Register(static_cast<VisitorId>(id), &DeferObject);
+  }
+
+  table_.Register(kVisitShortcutCandidate,
+                  &FixedBodyVisitor<ParallelMarkingVisitor,
+                  ConsString::BodyDescriptor,
+                  void>::Visit);
+
+  table_.Register(kVisitConsString,
+                  &FixedBodyVisitor<ParallelMarkingVisitor,
+                  ConsString::BodyDescriptor,
+                  void>::Visit);
+
+  table_.Register(kVisitSlicedString,
+                  &FixedBodyVisitor<ParallelMarkingVisitor,
+                  SlicedString::BodyDescriptor,
+                  void>::Visit);
+
+  table_.Register(kVisitSymbol,
+                  &FixedBodyVisitor<ParallelMarkingVisitor,
+                  Symbol::BodyDescriptor,
+                  void>::Visit);
+
+  table_.Register(kVisitFixedArray, &FixedArrayVisitor::Visit);
+
+  table_.Register(kVisitFixedDoubleArray, &DataObjectVisitor::Visit);
+
+  table_.Register(kVisitByteArray, &DataObjectVisitor::Visit);
+
+  table_.Register(kVisitFreeSpace, &DataObjectVisitor::Visit);
+
+  table_.Register(kVisitSeqOneByteString, &DataObjectVisitor::Visit);
+
+  table_.Register(kVisitSeqTwoByteString, &DataObjectVisitor::Visit);
+
+  table_.Register(kVisitOddball,
+                  &FixedBodyVisitor<ParallelMarkingVisitor,
+                  Oddball::BodyDescriptor,
+                  void>::Visit);
+
+  table_.Register(kVisitCell,
+                  &FixedBodyVisitor<ParallelMarkingVisitor,
+                  Cell::BodyDescriptor,
+                  void>::Visit);
+
+  table_.Register(kVisitPropertyCell,
+                  &FixedBodyVisitor<ParallelMarkingVisitor,
+                  JSGlobalPropertyCell::BodyDescriptor,
+                  void>::Visit);
+
+  table_.RegisterSpecializations<DataObjectVisitor,
+                                 kVisitDataObject,
+                                 kVisitDataObjectGeneric>();
+
+  table_.RegisterSpecializations<JSObjectVisitor,
+                                 kVisitJSObject,
+                                 kVisitJSObjectGeneric>();
+
+  table_.RegisterSpecializations<StructObjectVisitor,
+                                 kVisitStruct,
+                                 kVisitStructGeneric>();
+}
+
+
+MarkingTask::MarkingTask()
+    : marker_(NULL),
+      collector_(NULL),
+      task_id_(0),
+      shared_mutex_(OS::CreateMutex()),
+      shared_length_(0),
+      marked_bytes_(0),
+      visited_bytes_(0),
+      unbudgeted_bytes_(0),
+      visited_objects_(0),
+      steals_(0),
+      time_(0.0) {
+}
+
+
+MarkingTask::~MarkingTask() {
+  delete shared_mutex_;
+}
+
+
+void MarkingTask::Initialize(ParallelMarker* marker, int task_id) {
+  ASSERT(private_stack_.is_empty());
+  ASSERT(shared_list_.is_empty());
+  ASSERT(deferred_objects_.is_empty());
+  ASSERT(recorded_slots_.is_empty());
+  marker_ = marker;
+  collector_ = marker->collector();
+  task_id_ = task_id;
+  NoBarrier_Store(&shared_length_, 0);
+  marked_bytes_ = 0;
+  visited_bytes_ = 0;
+  unbudgeted_bytes_ = 0;
+  visited_objects_ = 0;
+  steals_ = 0;
+  time_ = 0.0;
+}
+
+
+void MarkingTask::AddSharedWork(HeapObject* object) {
+  shared_list_.Add(object);
+  NoBarrier_Store(&shared_length_, shared_list_.length());
+}
+
+
+void MarkingTask::MarkObject(HeapObject* object) {
+  MarkBit mark_bit = Marking::MarkBitFrom(object);
+  if (mark_bit.Get() || !mark_bit.AtomicSet()) return;
+  int size = object->Size();
+  MemoryChunk::IncrementLiveBytesFromGCAtomically(object->address(), size);
+  marked_bytes_ += size;
+  private_stack_.Add(object);
+}
+
+
+void MarkingTask::VisitPointers(Object** start, Object** end) {
+  bool record_slots = collector_->is_compacting() &&
+      !MarkCompactCollector::ShouldSkipEvacuationSlotRecording(start);
+  for (Object** p = start; p < end; p++) {
+    if (!(*p)->IsHeapObject()) continue;
+    // Like the incremental marking visitor, incremental rounds leave cons
+    // strings alone.
+    HeapObject* object = marker_->incremental_ ?
+        HeapObject::cast(*p) : ShortCircuitConsString(p);
+    if (record_slots && MarkCompactCollector::IsOnEvacuationCandidate(object)) {
+      recorded_slots_.Add(start);
+      recorded_slots_.Add(p);
+    }
+    MarkObject(object);
+  }
+}
+
+
+void MarkingTask::VisitObject(HeapObject* object) {
+  ASSERT(Marking::IsBlack(Marking::MarkBitFrom(object)));
+  Map* map = object->map();
+  MarkObject(map);
+  ParallelMarkingVisitor::IterateBody(map, object);
+  int size = object->SizeFromMap(map);
+  visited_bytes_ += size;
+  unbudgeted_bytes_ += size;
+  visited_objects_++;
+}
+
+
+void MarkingTask::ShareWork() {
+  ScopedLock lock(shared_mutex_);
+  int count = private_stack_.length() / 2;
+  for (int i = 0; i < count; i++) {
+    shared_list_.Add(private_stack_.RemoveLast());
+  }
+  Release_Store(&shared_length_, shared_list_.length());
+}
+
+
+bool MarkingTask::TakeWork(MarkingTask* victim) {
+  if (Acquire_Load(&victim->shared_length_) == 0) return false;
+  ScopedLock lock(victim->shared_mutex_);
+  int length = victim->shared_list_.length();
+  int count = (victim == this) ? length : (length + 1) / 2;
+  for (int i = 0; i < count; i++) {
+    private_stack_.Add(victim->shared_list_.RemoveLast());
+  }
+  Release_Store(&victim->shared_length_, victim->shared_list_.length());
+  if (victim != this && count > 0) steals_++;
+  return count > 0;
+}
+
+
+bool MarkingTask::StealWork() {
+  int task_count = marker_->task_count();
+  for (int i = 1; i < task_count; i++) {
+    MarkingTask* victim = &marker_->tasks_[(task_id_ + i) % task_count];
+    if (TakeWork(victim)) return true;
+  }
+  return false;
+}
+
+
+void MarkingTask::Run() {
+  while (true) {
+    while (!private_stack_.is_empty()) {
+      if (private_stack_.length() > kMinWorkToShare &&
+          NoBarrier_Load(&shared_length_) == 0) {
+        ShareWork();
+      }
+      VisitObject(private_stack_.RemoveLast());
+      if (marker_->incremental_ &&
+          unbudgeted_bytes_ >= kBytesPerBudgetUpdate) {
+        bool exhausted = marker_->UpdateBudget(unbudgeted_bytes_);
+        unbudgeted_bytes_ = 0;
+        if (exhausted || marker_->IsBudgetExhausted()) return;
+      }
+    }
+    if (marker_->IsBudgetExhausted()) return;
+    if (TakeWork(this) || StealWork()) continue;
+    if (marker_->TryToTerminate()) break;
+  }
+}
+
+
+void MarkingTask::Finalize() {
+  ASSERT(private_stack_.is_empty());
+  ASSERT(shared_list_.is_empty());
+  for (int i = 0; i < recorded_slots_.length(); i += 2) {
+    Object** anchor_slot = recorded_slots_[i];
+    Object** slot = recorded_slots_[i + 1];
+    collector_->RecordSlot(anchor_slot, slot, *slot);
+  }
+  recorded_slots_.Clear();
+  // The maps of deferred objects have already been marked by the task.
+  for (int i = 0; i < deferred_objects_.length(); i++) {
+    HeapObject* object = deferred_objects_[i];
+    MarkCompactMarkingVisitor::IterateBody(object->map(), object);
+  }
+  deferred_objects_.Clear();
+}
+
+
+void MarkingTask::ReturnToDeque(HeapObject* object,
+                                MarkingDeque* marking_deque) {
+  Marking::BlackToGrey(object);
+  MemoryChunk::IncrementLiveBytesFromGC(object->address(), -object->Size());
+  marking_deque->PushGrey(object);
+}
+
+
+void MarkingTask::FinalizeIncremental(MarkingDeque* marking_deque) {
+  for (int i = 0; i < recorded_slots_.length(); i += 2) {
+    Object** anchor_slot = recorded_slots_[i];
+    Object** slot = recorded_slots_[i + 1];
+    collector_->RecordSlot(anchor_slot, slot, *slot);
+  }
+  recorded_slots_.Clear();
+  for (int i = 0; i < private_stack_.length(); i++) {
+    ReturnToDeque(private_stack_[i], marking_deque);
+  }
+  private_stack_.Clear();
+  for (int i = 0; i < shared_list_.length(); i++) {
+    ReturnToDeque(shared_list_[i], marking_deque);
+  }
+  shared_list_.Clear();
+  NoBarrier_Store(&shared_length_, 0);
+  List<HeapObject*>* main_thread_objects = marker_->main_thread_objects();
+  for (int i = 0; i < deferred_objects_.length(); i++) {
+    HeapObject* object = deferred_objects_[i];
+    Marking::BlackToGrey(object);
+    MemoryChunk::IncrementLiveBytesFromGC(object->address(), -object->Size());
+    main_thread_objects->Add(object);
+  }
+  deferred_objects_.Clear();
+}
+
+
+Thread::LocalStorageKey ParallelMarker::current_task_key_;
+
+
+ParallelMarker::ParallelMarker(MarkCompactCollector* collector)
+    : collector_(collector),
+      tasks_(NULL),
+      idle_tasks_(0),
+      incremental_(false),
+      remaining_bytes_(0) {
+}
+
+
+ParallelMarker::~ParallelMarker() {
+  delete[] tasks_;
+}
+
+
+void ParallelMarker::Initialize() {
+  current_task_key_ = Thread::CreateThreadLocalKey();
+  ParallelMarkingVisitor::Initialize();
+}
+
+
+bool ParallelMarker::IsEnabled() {
+  return FLAG_parallel_marking &&
+      collector_->isolate()->marking_threads() != NULL &&
+      !FLAG_track_gc_object_stats;
+}
+
+
+bool ParallelMarker::IsEnabledForIncrementalMarking() {
+  return FLAG_parallel_incremental_marking &&
+      collector_->isolate()->marking_threads() != NULL &&
+      !FLAG_track_gc_object_stats;
+}
+
+
+void ParallelMarker::InitializeTasks() {
+  if (tasks_ == NULL) tasks_ = new MarkingTask[task_count()];
+  for (int i = 0; i < task_count(); i++) {
+    tasks_[i].Initialize(this, i);
+  }
+  NoBarrier_Store(&idle_tasks_, 0);
+}
+
+
+void ParallelMarker::RunTasks() {
+  double start_time = 0.0;
+  if (FLAG_trace_parallel_marking) start_time = OS::TimeCurrentMillis();
+
+  collector_->MarkInParallel();
+  MarkInParallel(0);
+  collector_->WaitUntilMarkingCompleted();
+
+  if (FLAG_trace_parallel_marking) {
+    PrintStatistics(OS::TimeCurrentMillis() - start_time);
+  }
+  RecordBackgroundTime();
+}
+
+
+void ParallelMarker::RecordBackgroundTime() {
+  double background_time = 0.0;
+  for (int i = 1; i < task_count(); i++) {
+    background_time += tasks_[i].time();
+  }
+  GCTracer* tracer = collector_->tracer();
+  if (tracer != NULL) {
+    tracer->AddBackgroundMarkingTime(background_time);
+  } else {
+    collector_->heap()->incremental_marking()->AddBackgroundMarkingTime(
+        background_time);
+  }
+}
+
+
+void ParallelMarker::MarkInParallel(MarkingDeque* marking_deque) {
+  incremental_ = false;
+  InitializeTasks();
+
+  // Hand out the objects on the deque round-robin, so that every task can
+  // start without stealing.
+  int next_task = 0;
+  while (!marking_deque->IsEmpty()) {
+    tasks_[next_task].AddSharedWork(marking_deque->Pop());
+    next_task = (next_task + 1) % task_count();
+  }
+  for (int i = 0; i < overflow_list_.length(); i++) {
+    tasks_[next_task].AddSharedWork(overflow_list_[i]);
+    next_task = (next_task + 1) % task_count();
+  }
+  overflow_list_.Clear();
+
+  RunTasks();
+
+  for (int i = 0; i < task_count(); i++) {
+    tasks_[i].Finalize();
+  }
+}
+
+
+intptr_t ParallelMarker::MarkIncrementallyInParallel(
+    MarkingDeque* marking_deque,
+    intptr_t bytes_to_process) {
+  ASSERT(main_thread_objects_.is_empty());
+  incremental_ = true;
+  NoBarrier_Store(&remaining_bytes_, bytes_to_process);
+  InitializeTasks();
+
+  // The objects on the incremental marking deque are grey.  They are turned
+  // black before they are handed out, like the tasks do with the objects
+  // they mark themselves.  Partially scanned large arrays are already black
+  // and keep their progress bar on the main thread.
+  Map* filler_map = collector_->heap()->one_pointer_filler_map();
+  int next_task = 0;
+  while (!marking_deque->IsEmpty()) {
+    HeapObject* object = marking_deque->Pop();
+    Map* map = object->map();
+    if (map == filler_map) continue;
+    MarkBit mark_bit = Marking::MarkBitFrom(object);
+    if (!Marking::IsGrey(mark_bit)) {
+      main_thread_objects_.Add(object);
+      continue;
+    }
+    Marking::GreyToBlack(mark_bit);
+    MemoryChunk::IncrementLiveBytesFromGC(object->address(),
+                                          object->SizeFromMap(map));
+    tasks_[next_task].AddSharedWork(object);
+    next_task = (next_task + 1) % task_count();
+  }
+
+  RunTasks();
+
+  intptr_t visited_bytes = 0;
+  for (int i = 0; i < task_count(); i++) {
+    visited_bytes += tasks_[i].visited_bytes();
+    tasks_[i].FinalizeIncremental(marking_deque);
+  }
+  incremental_ = false;
+  return visited_bytes;
+}
+
+
+void ParallelMarker::MarkInParallel(int task_id) {
+  MarkingTask* task = &tasks_[task_id];
+  double start_time = OS::TimeCurrentMillis();
+  Thread::SetThreadLocal(current_task_key_, task);
+  task->Run();
+  Thread::SetThreadLocal(current_task_key_, NULL);
+  task->time_ = OS::TimeCurrentMillis() - start_time;
+}
+
+
+bool ParallelMarker::HasSharedWork() {
+  for (int i = 0; i < task_count(); i++) {
+    if (Acquire_Load(&tasks_[i].shared_length_) > 0) return true;
+  }
+  return false;
+}
+
+
+bool ParallelMarker::TryToTerminate() {
+  // A task only becomes idle after it took back all of its shared work and
+  // idle tasks never share work.  Hence there is no work left once all tasks
+  // are idle.
+  NoBarrier_AtomicIncrement(&idle_tasks_, 1);
+  while (true) {
+    if (Acquire_Load(&idle_tasks_) == task_count()) return true;
+    if (IsBudgetExhausted()) return true;
+    if (HasSharedWork()) {
+      NoBarrier_AtomicIncrement(&idle_tasks_, -1);
+      return false;
+    }
+    Thread::YieldCPU();
+  }
+}
+
+
+void ParallelMarker::PrintStatistics(double time) {
+  PrintF("parallel marking%s: %.1f ms\n",
+         incremental_ ? " (incremental step)" : "",
+         time);
+  for (int i = 0; i < task_count(); i++) {
+    PrintF("  task %d: %.1f ms, %d objects, %" V8_PTR_PREFIX "d bytes, "
+           "%d deferred, %d steals\n",
+           i,
+           tasks_[i].time(),
+           tasks_[i].visited_objects(),
+           tasks_[i].marked_bytes(),
+           tasks_[i].deferred_objects(),
+           tasks_[i].steals());
+  }
+}
+
+
 class MarkingVisitor : public ObjectVisitor {
  public:
   explicit MarkingVisitor(Heap* heap) : heap_(heap) { }
@@ -2098,7 +2671,13 @@ void MarkCompactCollector::MarkImplicitRefGroups() {
 // After: the marking stack is empty, and all objects reachable from the
 // marking stack have been marked, or are overflowed in the heap.
 void MarkCompactCollector::EmptyMarkingDeque() {
+  bool parallel_marking = parallel_marker_.IsEnabled();
   while (!marking_deque_.IsEmpty()) {
+    if (parallel_marking &&
+        parallel_marker_.ShouldMarkInParallel(&marking_deque_)) {
+      parallel_marker_.MarkInParallel(&marking_deque_);
+      continue;
+    }
     HeapObject* object = marking_deque_.Pop();
     ASSERT(object->IsHeapObject());
     ASSERT(heap()->Contains(object));
@@ -2233,6 +2812,9 @@ void MarkCompactCollector::MarkLiveObjects() {
   marking_deque_.Initialize(marking_deque_start,
                             marking_deque_end);
   ASSERT(!marking_deque_.overflowed());
+  if (parallel_marker_.IsEnabled()) {
+    marking_deque_.set_overflow_list(parallel_marker_.overflow_list());
+  }
 
   if (incremental_marking_overflowed) {
     // There are overflowed objects left in the heap after incremental marking.
@@ -2450,11 +3032,13 @@ void MarkCompactCollector::ClearNonLiveReferences() {
     ClearNonLiveMapTransitions(map, map_mark);
 
     if (map_mark.Get()) {
-      ClearNonLiveDependentCode(map);
+      ClearNonLiveDependentCode(map->dependent_code());
     } else {
       ClearAndDeoptimizeDependentCode(map);
     }
   }
+
+  ClearNonLiveAllocationSiteDependentCode();
 }
 
 
@@ -2540,9 +3124,8 @@ void MarkCompactCollector::ClearAndDeoptimizeDependentCode(Map* map) {
 }
 
 
-void MarkCompactCollector::ClearNonLiveDependentCode(Map* map) {
+void MarkCompactCollector::ClearNonLiveDependentCode(DependentCode* entries) {
   DisallowHeapAllocation no_allocation;
-  DependentCode* entries = map->dependent_code();
   DependentCode::GroupStartIndexes starts(entries);
   int number_of_entries = starts.number_of_entries();
   if (number_of_entries == 0) return;
@@ -2576,6 +3159,19 @@ void MarkCompactCollector::ClearNonLiveDependentCode(Map* map) {
 }
 
 
+void MarkCompactCollector::ClearNonLiveAllocationSiteDependentCode() {
+  Object* site_obj = encountered_allocation_sites();
+  while (site_obj != Smi::FromInt(0)) {
+    ASSERT(MarkCompactCollector::IsMarked(HeapObject::cast(site_obj)));
+    AllocationSite* site = reinterpret_cast<AllocationSite*>(site_obj);
+    ClearNonLiveDependentCode(site->dependent_code());
+    site_obj = site->weak_next();
+    site->set_weak_next(Smi::FromInt(0));
+  }
+  set_encountered_allocation_sites(Smi::FromInt(0));
+}
+
+
 void MarkCompactCollector::ProcessWeakMaps() {
   GCTracer::Scope gc_scope(tracer_, GCTracer::Scope::MC_WEAKMAP_PROCESS);
   Object* weak_map_obj = encountered_weak_maps();
@@ -2639,6 +3235,16 @@ void MarkCompactCollector::MigrateObject(Address dst,
                                          Address src,
                                          int size,
                                          AllocationSpace dest) {
+  MigrateObject(dst, src, size, dest, &migration_slots_buffer_, NULL);
+}
+
+
+void MarkCompactCollector::MigrateObject(Address dst,
+                                         Address src,
+                                         int size,
+                                         AllocationSpace dest,
+                                         SlotsBuffer** slots_buffer,
+                                         List<Address>* old_to_new_slots) {
   HEAP_PROFILE(heap(), ObjectMoveEvent(src, dst));
   if (dest == OLD_POINTER_SPACE || dest == LO_SPACE) {
     Address src_slot = src;
@@ -2651,10 +3257,14 @@ void MarkCompactCollector::MigrateObject(Address dst,
       Memory::Object_at(dst_slot) = value;
 
       if (heap_->InNewSpace(value)) {
-        heap_->store_buffer()->Mark(dst_slot);
+        if (old_to_new_slots == NULL) {
+          heap_->store_buffer()->Mark(dst_slot);
+        } else {
+          old_to_new_slots->Add(dst_slot);
+        }
       } else if (value->IsHeapObject() && IsOnEvacuationCandidate(value)) {
         SlotsBuffer::AddTo(&slots_buffer_allocator_,
-                           &migration_slots_buffer_,
+                           slots_buffer,
                            reinterpret_cast<Object**>(dst_slot),
                            SlotsBuffer::IGNORE_OVERFLOW);
       }
@@ -2669,7 +3279,7 @@ void MarkCompactCollector::MigrateObject(Address dst,
 
       if (Page::FromAddress(code_entry)->IsEvacuationCandidate()) {
         SlotsBuffer::AddTo(&slots_buffer_allocator_,
-                           &migration_slots_buffer_,
+                           slots_buffer,
                            SlotsBuffer::CODE_ENTRY_SLOT,
                            code_entry_slot,
                            SlotsBuffer::IGNORE_OVERFLOW);
@@ -2679,7 +3289,7 @@ void MarkCompactCollector::MigrateObject(Address dst,
     PROFILE(isolate(), CodeMoveEvent(src, dst));
     heap()->MoveBlock(dst, src, size);
     SlotsBuffer::AddTo(&slots_buffer_allocator_,
-                       &migration_slots_buffer_,
+                       slots_buffer,
                        SlotsBuffer::RELOCATED_CODE_OBJECT,
                        dst,
                        SlotsBuffer::IGNORE_OVERFLOW);
@@ -2868,6 +3478,14 @@ void MarkCompactCollector::EvacuateNewSpace() {
   new_space->ResetAllocationInfo();
 
   int survivors_size = 0;
+  if (parallel_evacuator_.IsEnabled() &&
+      parallel_evacuator_.EvacuateNewSpace(from_bottom,
+                                           from_top,
+                                           &survivors_size)) {
+    heap_->IncrementYoungSurvivorsCounter(survivors_size);
+    new_space->set_age_mark(new_space->top());
+    return;
+  }
 
   // First pass: traverse all objects in inactive semispace, remove marks,
   // migrate live objects and write forwarding addresses.  This stage puts
@@ -2980,11 +3598,32 @@ void MarkCompactCollector::EvacuateLiveObjectsFromPage(Page* p) {
 
 void MarkCompactCollector::EvacuatePages() {
   int npages = evacuation_candidates_.length();
+  if (parallel_evacuator_.IsEnabled()) {
+    // Code objects are moved by the main thread below, since moving them
+    // has to be reported to the code event listeners.
+    List<Page*> pages(npages);
+    for (int i = 0; i < npages; i++) {
+      Page* p = evacuation_candidates_[i];
+      if (p->IsEvacuationCandidate() &&
+          p->owner()->identity() != CODE_SPACE) {
+        pages.Add(p);
+      }
+    }
+    List<Page*> aborted_pages;
+    parallel_evacuator_.EvacuatePages(&pages, &aborted_pages);
+    // Objects moved from these pages left forwarding addresses behind, so
+    // the pages cannot be abandoned.  Finish them here, expanding the space
+    // if needed.
+    for (int i = 0; i < aborted_pages.length(); i++) {
+      EvacuateLiveObjectsFromPage(aborted_pages[i]);
+    }
+  }
   for (int i = 0; i < npages; i++) {
     Page* p = evacuation_candidates_[i];
     ASSERT(p->IsEvacuationCandidate() ||
            p->IsFlagSet(Page::RESCAN_ON_EVACUATION));
-    if (p->IsEvacuationCandidate()) {
+    // Skip pages that were evacuated in parallel.
+    if (p->IsEvacuationCandidate() && !p->WasSwept()) {
       // During compaction we might have to request a new page.
       // Check that space still have room for that.
       if (static_cast<PagedSpace*>(p->owner())->CanExpand()) {
@@ -2994,6 +3633,7 @@ void MarkCompactCollector::EvacuatePages() {
         // Pessimistically abandon unevacuated pages.
         for (int j = i; j < npages; j++) {
           Page* page = evacuation_candidates_[j];
+          if (page->IsEvacuationCandidate() && page->WasSwept()) continue;
           slots_buffer_allocator_.DeallocateChain(page->slots_buffer_address());
           page->ClearEvacuationCandidate();
           page->SetFlag(Page::RESCAN_ON_EVACUATION);
@@ -3006,22 +3646,477 @@ void MarkCompactCollector::EvacuatePages() {
 }
 
 
-class EvacuationWeakObjectRetainer : public WeakObjectRetainer {
- public:
-  virtual Object* RetainAs(Object* object) {
-    if (object->IsHeapObject()) {
-      HeapObject* heap_object = HeapObject::cast(object);
-      MapWord map_word = heap_object->map_word();
-      if (map_word.IsForwardingAddress()) {
-        return map_word.ToForwardingAddress();
-      }
-    }
-    return object;
-  }
-};
+EvacuationTask::EvacuationTask()
+    : evacuator_(NULL),
+      collector_(NULL),
+      heap_(NULL),
+      migration_slots_buffer_(NULL),
+      survivors_size_(0),
+      promoted_size_(0),
+      work_items_(0),
+      time_(0.0) {
+}
 
 
-static inline void UpdateSlot(ObjectVisitor* v,
+void EvacuationTask::Initialize(ParallelEvacuator* evacuator,
+                                MarkCompactCollector* collector) {
+  ASSERT(migration_slots_buffer_ == NULL);
+  ASSERT(old_to_new_slots_.is_empty());
+  evacuator_ = evacuator;
+  collector_ = collector;
+  heap_ = collector->heap();
+  to_space_buffer_.Initialize(heap_, NEW_SPACE);
+  old_pointer_space_buffer_.Initialize(heap_, OLD_POINTER_SPACE);
+  old_data_space_buffer_.Initialize(heap_, OLD_DATA_SPACE);
+  survivors_size_ = 0;
+  promoted_size_ = 0;
+  work_items_ = 0;
+  time_ = 0.0;
+}
+
+
+HeapObject* EvacuationTask::Allocate(AllocationSpace space,
+                                     int size_in_bytes) {
+  Object* result;
+  if (space == LO_SPACE) {
+    ScopedLock lock(evacuator_->allocation_mutex());
+    MaybeObject* maybe_result =
+        heap_->lo_space()->AllocateRaw(size_in_bytes, NOT_EXECUTABLE);
+    if (!maybe_result->ToObject(&result)) return NULL;
+    return HeapObject::cast(result);
+  }
+  LocalAllocationBuffer* buffer;
+  switch (space) {
+    case NEW_SPACE:
+      buffer = &to_space_buffer_;
+      break;
+    case OLD_POINTER_SPACE:
+      buffer = &old_pointer_space_buffer_;
+      break;
+    case OLD_DATA_SPACE:
+      buffer = &old_data_space_buffer_;
+      break;
+    default:
+      UNREACHABLE();
+      return NULL;
+  }
+  HeapObject* object = buffer->AllocateLinearly(size_in_bytes);
+  if (object != NULL) return object;
+  ScopedLock lock(evacuator_->allocation_mutex());
+  if (!buffer->SlowAllocateRaw(size_in_bytes)->ToObject(&result)) return NULL;
+  return HeapObject::cast(result);
+}
+
+
+bool EvacuationTask::TryPromoteObject(HeapObject* object, int size) {
+  AllocationSpace space;
+  if (size > Page::kMaxNonCodeHeapObjectSize) {
+    space = LO_SPACE;
+  } else {
+    space = heap_->TargetSpaceId(object->map()->instance_type());
+  }
+  HeapObject* target = Allocate(space, size);
+  if (target == NULL) return false;
+  collector_->MigrateObject(target->address(),
+                            object->address(),
+                            size,
+                            space,
+                            &migration_slots_buffer_,
+                            &old_to_new_slots_);
+  promoted_size_ += size;
+  return true;
+}
+
+
+void EvacuationTask::EvacuateNewSpacePage(Address start, Address end) {
+  SemiSpaceIterator from_it(start, end);
+  for (HeapObject* object = from_it.Next();
+       object != NULL;
+       object = from_it.Next()) {
+    MarkBit mark_bit = Marking::MarkBitFrom(object);
+    if (mark_bit.Get()) {
+      // The mark bits of a page are only touched by the task evacuating it.
+      mark_bit.Clear();
+      int size = object->Size();
+      survivors_size_ += size;
+
+      if (TryPromoteObject(object, size)) continue;
+
+      HeapObject* target = Allocate(NEW_SPACE, size);
+      if (target == NULL) {
+        V8::FatalProcessOutOfMemory("EvacuationTask::EvacuateNewSpacePage");
+        return;
+      }
+      collector_->MigrateObject(target->address(),
+                                object->address(),
+                                size,
+                                NEW_SPACE,
+                                &migration_slots_buffer_,
+                                &old_to_new_slots_);
+    } else {
+      // Mark dead objects in the new space with null in their map field.
+      Memory::Address_at(object->address()) = NULL;
+    }
+  }
+}
+
+
+bool EvacuationTask::EvacuatePage(Page* p) {
+  PagedSpace* space = static_cast<PagedSpace*>(p->owner());
+  AllocationSpace identity = space->identity();
+  ASSERT(identity == OLD_POINTER_SPACE || identity == OLD_DATA_SPACE);
+  ASSERT(p->IsEvacuationCandidate() && !p->WasSwept());
+  MarkBit::CellType* cells = p->markbits()->cells();
+
+  int last_cell_index =
+      Bitmap::IndexToCell(
+          Bitmap::CellAlignIndex(
+              p->AddressToMarkbitIndex(p->area_end())));
+
+  Address cell_base = p->area_start();
+  int cell_index = Bitmap::IndexToCell(
+          Bitmap::CellAlignIndex(
+              p->AddressToMarkbitIndex(cell_base)));
+
+  int offsets[16];
+
+  for (;
+       cell_index < last_cell_index;
+       cell_index++, cell_base += 32 * kPointerSize) {
+    if (cells[cell_index] == 0) continue;
+
+    int live_objects = MarkWordToObjectStarts(cells[cell_index], offsets);
+    for (int i = 0; i < live_objects; i++) {
+      Address object_addr = cell_base + offsets[i] * kPointerSize;
+      HeapObject* object = HeapObject::FromAddress(object_addr);
+      ASSERT(Marking::IsBlack(Marking::MarkBitFrom(object)));
+
+      int size = object->Size();
+      HeapObject* target = Allocate(identity, size);
+      if (target == NULL) {
+        // Clear the mark bits of the objects moved already, the main thread
+        // evacuates the rest of the page.
+        for (int j = 0; j < i; j++) {
+          cells[cell_index] &= ~(static_cast<MarkBit::CellType>(1) <<
+                                 offsets[j]);
+        }
+        return false;
+      }
+      collector_->MigrateObject(target->address(),
+                                object_addr,
+                                size,
+                                identity,
+                                &migration_slots_buffer_,
+                                &old_to_new_slots_);
+      ASSERT(object->map_word().IsForwardingAddress());
+    }
+
+    // Clear marking bits for current cell.
+    cells[cell_index] = 0;
+  }
+  p->ResetLiveBytes();
+  p->MarkSweptPrecisely();
+  return true;
+}
+
+
+void EvacuationTask::UpdatePointersInToSpace(Address start, Address end) {
+  PointersUpdatingVisitor updating_visitor(heap_);
+  SemiSpaceIterator to_it(start, end);
+  for (HeapObject* object = to_it.Next();
+       object != NULL;
+       object = to_it.Next()) {
+    Map* map = object->map();
+    object->IterateBody(map->instance_type(),
+                        object->SizeFromMap(map),
+                        &updating_visitor);
+  }
+}
+
+
+void EvacuationTask::Finalize() {
+  to_space_buffer_.Close();
+  old_pointer_space_buffer_.Close();
+  old_data_space_buffer_.Close();
+
+  StoreBuffer* store_buffer = heap_->store_buffer();
+  for (int i = 0; i < old_to_new_slots_.length(); i++) {
+    store_buffer->Mark(old_to_new_slots_[i]);
+  }
+  old_to_new_slots_.Clear();
+
+  if (migration_slots_buffer_ != NULL) {
+    evacuator_->migration_slots_buffers()->Add(migration_slots_buffer_);
+    migration_slots_buffer_ = NULL;
+  }
+}
+
+
+ParallelEvacuator::ParallelEvacuator(MarkCompactCollector* collector)
+    : collector_(collector),
+      allocation_mutex_(OS::CreateMutex()),
+      tasks_(NULL),
+      phase_(IDLE),
+      work_items_(0),
+      next_work_item_(0),
+      code_slots_filtering_(false),
+      pages_(NULL),
+      aborted_pages_(NULL) {
+  for (int i = 0; i <= LAST_PAGED_SPACE; i++) unclaimed_bytes_[i] = 0;
+}
+
+
+ParallelEvacuator::~ParallelEvacuator() {
+  delete[] tasks_;
+  delete allocation_mutex_;
+}
+
+
+bool ParallelEvacuator::IsEnabled() {
+  return FLAG_parallel_compaction &&
+      collector_->isolate()->marking_threads() != NULL &&
+      !collector_->heap()->IsLoggingOrProfiling();
+}
+
+
+bool ParallelEvacuator::EvacuateNewSpace(Address from_bottom,
+                                         Address from_top,
+                                         int* survivors_size) {
+  *survivors_size = 0;
+  AddNewSpacePages(from_bottom, from_top);
+  if (new_space_pages_.is_empty()) return true;
+
+  // Survivors that do not fit into to-space because of the memory lost at
+  // the ends of the to-space buffers are promoted.
+  intptr_t size = 0;
+  for (int i = 0; i < new_space_pages_.length(); i++) {
+    size += new_space_pages_[i].end - new_space_pages_[i].start;
+  }
+  if (!ReserveOldSpace(LocalAllocationBuffer::MaxWaste(size))) {
+    new_space_pages_.Clear();
+    return false;
+  }
+
+  RunPhase(EVACUATE_NEW_SPACE, new_space_pages_.length());
+  new_space_pages_.Clear();
+
+  for (int i = 0; i < task_count(); i++) {
+    *survivors_size += tasks_[i].survivors_size();
+    collector_->tracer()->increment_promoted_objects_size(
+        static_cast<int>(tasks_[i].promoted_size()));
+  }
+  return true;
+}
+
+
+void ParallelEvacuator::EvacuatePages(List<Page*>* pages,
+                                      List<Page*>* aborted_pages) {
+  AlwaysAllocateScope always_allocate;
+
+  // The tasks cannot expand the spaces.  Grow them up front so that the
+  // candidates fit, and let every task claim the memory for a candidate
+  // before evacuating it.
+  intptr_t live_bytes[LAST_PAGED_SPACE + 1] = { 0 };
+  for (int i = 0; i < pages->length(); i++) {
+    Page* p = pages->at(i);
+    live_bytes[p->owner()->identity()] += p->LiveBytes();
+  }
+  intptr_t slack = task_count() * LocalAllocationBuffer::kSize;
+  for (int i = FIRST_PAGED_SPACE; i <= LAST_PAGED_SPACE; i++) {
+    unclaimed_bytes_[i] = 0;
+    if (live_bytes[i] == 0) continue;
+    PagedSpace* space = collector_->heap()->paged_space(i);
+    // Without the room the candidates of the space are left to the caller.
+    if (!space->EnsureAvailable(live_bytes[i] + slack)) continue;
+    unclaimed_bytes_[i] = space->Available() - slack;
+  }
+
+  pages_ = pages;
+  aborted_pages_ = aborted_pages;
+  RunPhase(EVACUATE_PAGES, pages->length());
+  pages_ = NULL;
+  aborted_pages_ = NULL;
+}
+
+
+void ParallelEvacuator::UpdatePointersInToSpace(Address bottom, Address top) {
+  AddNewSpacePages(bottom, top);
+  RunPhase(UPDATE_TO_SPACE, new_space_pages_.length());
+  new_space_pages_.Clear();
+}
+
+
+void ParallelEvacuator::UpdateSlots(List<SlotsBuffer*>* chains,
+                                    bool code_slots_filtering) {
+  for (int i = 0; i < chains->length(); i++) {
+    for (SlotsBuffer* buffer = chains->at(i);
+         buffer != NULL;
+         buffer = buffer->next()) {
+      slots_buffers_.Add(buffer);
+    }
+  }
+  code_slots_filtering_ = code_slots_filtering;
+  RunPhase(UPDATE_SLOTS, slots_buffers_.length());
+  slots_buffers_.Clear();
+}
+
+
+void ParallelEvacuator::DeallocateMigrationSlotsBuffers() {
+  for (int i = 0; i < migration_slots_buffers_.length(); i++) {
+    collector_->slots_buffer_allocator()->DeallocateChain(
+        &migration_slots_buffers_[i]);
+  }
+  migration_slots_buffers_.Clear();
+}
+
+
+// The tasks cannot expand the old generation, so the main thread makes room
+// for them before a phase that promotes objects.
+bool ParallelEvacuator::ReserveOldSpace(intptr_t size_in_bytes) {
+  Heap* heap = collector_->heap();
+  intptr_t size = size_in_bytes + task_count() * LocalAllocationBuffer::kSize;
+  return heap->paged_space(OLD_POINTER_SPACE)->EnsureAvailable(size) &&
+      heap->paged_space(OLD_DATA_SPACE)->EnsureAvailable(size);
+}
+
+
+void ParallelEvacuator::AddNewSpacePages(Address bottom, Address top) {
+  ASSERT(new_space_pages_.is_empty());
+  NewSpacePageIterator it(bottom, top);
+  while (it.has_next()) {
+    NewSpacePage* page = it.next();
+    Address start = page->Contains(bottom) ? bottom : page->area_start();
+    Address end = (page == NewSpacePage::FromLimit(top))
+        ? top
+        : page->area_end();
+    if (start < end) new_space_pages_.Add(AddressRange(start, end));
+  }
+}
+
+
+bool ParallelEvacuator::ClaimWorkItem(int* index) {
+  *index = NoBarrier_AtomicIncrement(&next_work_item_, 1) - 1;
+  return *index < work_items_;
+}
+
+
+void ParallelEvacuator::RunPhase(Phase phase, int work_items) {
+  if (work_items == 0) return;
+
+  double start_time = 0.0;
+  if (FLAG_trace_parallel_compaction) start_time = OS::TimeCurrentMillis();
+
+  if (tasks_ == NULL) tasks_ = new EvacuationTask[task_count()];
+  for (int i = 0; i < task_count(); i++) {
+    tasks_[i].Initialize(this, collector_);
+  }
+  phase_ = phase;
+  work_items_ = work_items;
+  NoBarrier_Store(&next_work_item_, 0);
+  collector_->tracer()->set_compaction_tasks(task_count());
+
+  int thread_count = task_count() - 1;
+  collector_->StartMarkingThreads(thread_count);
+  RunTask(0);
+  collector_->WaitForMarkingThreads(thread_count);
+
+  if (FLAG_trace_parallel_compaction) {
+    PrintStatistics(OS::TimeCurrentMillis() - start_time);
+  }
+
+  for (int i = 0; i < task_count(); i++) {
+    tasks_[i].Finalize();
+  }
+  phase_ = IDLE;
+}
+
+
+void ParallelEvacuator::RunTask(int task_id) {
+  double start_time = OS::TimeCurrentMillis();
+  EvacuationTask* task = &tasks_[task_id];
+  int index;
+  while (ClaimWorkItem(&index)) {
+    switch (phase_) {
+      case EVACUATE_NEW_SPACE:
+        task->EvacuateNewSpacePage(new_space_pages_[index].start,
+                                   new_space_pages_[index].end);
+        break;
+      case EVACUATE_PAGES: {
+        Page* p = pages_->at(index);
+        {
+          // Candidates whose live objects do not fit into the memory left
+          // for the tasks are left to the main thread, which evacuates them
+          // serially or abandons them.
+          ScopedLock lock(allocation_mutex_);
+          intptr_t* unclaimed = &unclaimed_bytes_[p->owner()->identity()];
+          if (*unclaimed < p->LiveBytes()) continue;
+          *unclaimed -= p->LiveBytes();
+        }
+        if (!task->EvacuatePage(p)) {
+          ScopedLock lock(allocation_mutex_);
+          aborted_pages_->Add(p);
+        }
+        break;
+      }
+      case UPDATE_TO_SPACE:
+        task->UpdatePointersInToSpace(new_space_pages_[index].start,
+                                      new_space_pages_[index].end);
+        break;
+      case UPDATE_SLOTS:
+        if (code_slots_filtering_) {
+          slots_buffers_[index]->UpdateSlotsWithFilter(collector_->heap());
+        } else {
+          slots_buffers_[index]->UpdateSlots(collector_->heap());
+        }
+        break;
+      case IDLE:
+        UNREACHABLE();
+    }
+    task->increment_work_items();
+  }
+  task->set_time(OS::TimeCurrentMillis() - start_time);
+}
+
+
+const char* ParallelEvacuator::PhaseName() {
+  switch (phase_) {
+    case EVACUATE_NEW_SPACE: return "evacuate new space";
+    case EVACUATE_PAGES: return "evacuate pages";
+    case UPDATE_TO_SPACE: return "update to-space";
+    case UPDATE_SLOTS: return "update slots";
+    case IDLE: break;
+  }
+  UNREACHABLE();
+  return NULL;
+}
+
+
+void ParallelEvacuator::PrintStatistics(double time) {
+  PrintF("parallel compaction (%s): %.1f ms, %d work items\n",
+         PhaseName(), time, work_items_);
+  for (int i = 0; i < task_count(); i++) {
+    PrintF("  task %d: %.1f ms, %d work items\n",
+           i, tasks_[i].time(), tasks_[i].work_items());
+  }
+}
+
+
+class EvacuationWeakObjectRetainer : public WeakObjectRetainer {
+ public:
+  virtual Object* RetainAs(Object* object) {
+    if (object->IsHeapObject()) {
+      HeapObject* heap_object = HeapObject::cast(object);
+      MapWord map_word = heap_object->map_word();
+      if (map_word.IsForwardingAddress()) {
+        return map_word.ToForwardingAddress();
+      }
+    }
+    return object;
+  }
+};
+
+
+static inline void UpdateSlot(ObjectVisitor* v,
                               SlotsBuffer::SlotType slot_type,
                               Address addr) {
   switch (slot_type) {
@@ -3073,28 +4168,55 @@ enum SkipListRebuildingMode {
 };
 
 
+template<MarkCompactCollector::SweepingParallelism mode>
+static intptr_t Free(PagedSpace* space,
+                     FreeList* free_list,
+                     Address start,
+                     int size) {
+  if (mode == MarkCompactCollector::SWEEP_SEQUENTIALLY) {
+    return space->Free(start, size);
+  } else {
+    return size - free_list->Free(start, size);
+  }
+}
+
+
 // Sweep a space precisely.  After this has been done the space can
 // be iterated precisely, hitting only the live objects.  Code space
 // is always swept precisely because we want to be able to iterate
 // over it.  Map space is swept precisely, because it is not compacted.
 // Slots in live objects pointing into evacuation candidates are updated
-// if requested.
-template<SweepingMode sweeping_mode, SkipListRebuildingMode skip_list_mode>
-static void SweepPrecisely(PagedSpace* space,
-                           Page* p,
-                           ObjectVisitor* v) {
-  ASSERT(!p->IsEvacuationCandidate() && !p->WasSwept());
+// if requested.  In SWEEP_IN_PARALLEL mode the freed memory is put on the
+// given free list and the page has already been flagged as swept.
+template<MarkCompactCollector::SweepingParallelism parallelism,
+         SweepingMode sweeping_mode,
+         SkipListRebuildingMode skip_list_mode>
+static intptr_t SweepPrecisely(PagedSpace* space,
+                               FreeList* free_list,
+                               Page* p,
+                               ObjectVisitor* v) {
+  ASSERT(!p->IsEvacuationCandidate());
+  ASSERT(parallelism == MarkCompactCollector::SWEEP_IN_PARALLEL ||
+         !p->WasSwept());
+  ASSERT((parallelism == MarkCompactCollector::SWEEP_IN_PARALLEL &&
+         free_list != NULL && sweeping_mode == SWEEP_ONLY) ||
+         (parallelism == MarkCompactCollector::SWEEP_SEQUENTIALLY &&
+         free_list == NULL));
   ASSERT_EQ(skip_list_mode == REBUILD_SKIP_LIST,
             space->identity() == CODE_SPACE);
   ASSERT((p->skip_list() == NULL) || (skip_list_mode == REBUILD_SKIP_LIST));
 
   double start_time = 0.0;
-  if (FLAG_print_cumulative_gc_stat) {
+  if (parallelism == MarkCompactCollector::SWEEP_SEQUENTIALLY &&
+      FLAG_print_cumulative_gc_stat) {
     start_time = OS::TimeCurrentMillis();
   }
 
   MarkBit::CellType* cells = p->markbits()->cells();
-  p->MarkSweptPrecisely();
+  if (parallelism == MarkCompactCollector::SWEEP_SEQUENTIALLY) {
+    p->MarkSweptPrecisely();
+  }
+  intptr_t freed_bytes = 0;
 
   int last_cell_index =
       Bitmap::IndexToCell(
@@ -3129,7 +4251,9 @@ static void SweepPrecisely(PagedSpace* space,
     for ( ; live_objects != 0; live_objects--) {
       Address free_end = object_address + offsets[live_index++] * kPointerSize;
       if (free_end != free_start) {
-        space->Free(free_start, static_cast<int>(free_end - free_start));
+        freed_bytes += Free<parallelism>(
+            space, free_list, free_start,
+            static_cast<int>(free_end - free_start));
       }
       HeapObject* live_object = HeapObject::FromAddress(free_end);
       ASSERT(Marking::IsBlack(Marking::MarkBitFrom(live_object)));
@@ -3155,12 +4279,16 @@ static void SweepPrecisely(PagedSpace* space,
     cells[cell_index] = 0;
   }
   if (free_start != p->area_end()) {
-    space->Free(free_start, static_cast<int>(p->area_end() - free_start));
+    freed_bytes += Free<parallelism>(
+        space, free_list, free_start,
+        static_cast<int>(p->area_end() - free_start));
   }
   p->ResetLiveBytes();
-  if (FLAG_print_cumulative_gc_stat) {
+  if (parallelism == MarkCompactCollector::SWEEP_SEQUENTIALLY &&
+      FLAG_print_cumulative_gc_stat) {
     space->heap()->AddSweepingTime(OS::TimeCurrentMillis() - start_time);
   }
+  return freed_bytes;
 }
 
 
@@ -3297,19 +4425,25 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
 
   // Second pass: find pointers to new space and update them.
   PointersUpdatingVisitor updating_visitor(heap());
+  bool parallel_compaction = parallel_evacuator_.IsEnabled();
 
   { GCTracer::Scope gc_scope(tracer_,
                              GCTracer::Scope::MC_UPDATE_NEW_TO_NEW_POINTERS);
     // Update pointers in to space.
-    SemiSpaceIterator to_it(heap()->new_space()->bottom(),
-                            heap()->new_space()->top());
-    for (HeapObject* object = to_it.Next();
-         object != NULL;
-         object = to_it.Next()) {
-      Map* map = object->map();
-      object->IterateBody(map->instance_type(),
-                          object->SizeFromMap(map),
-                          &updating_visitor);
+    if (parallel_compaction) {
+      parallel_evacuator_.UpdatePointersInToSpace(heap()->new_space()->bottom(),
+                                                  heap()->new_space()->top());
+    } else {
+      SemiSpaceIterator to_it(heap()->new_space()->bottom(),
+                              heap()->new_space()->top());
+      for (HeapObject* object = to_it.Next();
+           object != NULL;
+           object = to_it.Next()) {
+        Map* map = object->map();
+        object->IterateBody(map->instance_type(),
+                            object->SizeFromMap(map),
+                            &updating_visitor);
+      }
     }
   }
 
@@ -3329,9 +4463,16 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
 
   { GCTracer::Scope gc_scope(tracer_,
                              GCTracer::Scope::MC_UPDATE_POINTERS_TO_EVACUATED);
-    SlotsBuffer::UpdateSlotsRecordedIn(heap_,
-                                       migration_slots_buffer_,
-                                       code_slots_filtering_required);
+    if (parallel_compaction) {
+      List<SlotsBuffer*> chains(1);
+      chains.Add(migration_slots_buffer_);
+      chains.AddAll(*parallel_evacuator_.migration_slots_buffers());
+      parallel_evacuator_.UpdateSlots(&chains, code_slots_filtering_required);
+    } else {
+      SlotsBuffer::UpdateSlotsRecordedIn(heap_,
+                                         migration_slots_buffer_,
+                                         code_slots_filtering_required);
+    }
     if (FLAG_trace_fragmentation) {
       PrintF("  migration slots buffer: %d\n",
              SlotsBuffer::SizeOfChain(migration_slots_buffer_));
@@ -3357,15 +4498,26 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
   int npages = evacuation_candidates_.length();
   { GCTracer::Scope gc_scope(
       tracer_, GCTracer::Scope::MC_UPDATE_POINTERS_BETWEEN_EVACUATED);
+    if (parallel_compaction) {
+      List<SlotsBuffer*> chains(npages);
+      for (int i = 0; i < npages; i++) {
+        Page* p = evacuation_candidates_[i];
+        if (p->IsEvacuationCandidate()) chains.Add(p->slots_buffer());
+      }
+      parallel_evacuator_.UpdateSlots(&chains, code_slots_filtering_required);
+    }
+
     for (int i = 0; i < npages; i++) {
       Page* p = evacuation_candidates_[i];
       ASSERT(p->IsEvacuationCandidate() ||
              p->IsFlagSet(Page::RESCAN_ON_EVACUATION));
 
       if (p->IsEvacuationCandidate()) {
-        SlotsBuffer::UpdateSlotsRecordedIn(heap_,
-                                           p->slots_buffer(),
-                                           code_slots_filtering_required);
+        if (!parallel_compaction) {
+          SlotsBuffer::UpdateSlotsRecordedIn(heap_,
+                                             p->slots_buffer(),
+                                             code_slots_filtering_required);
+        }
         if (FLAG_trace_fragmentation) {
           PrintF("  page %p slots buffer: %d\n",
                  reinterpret_cast<void*>(p),
@@ -3390,12 +4542,16 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
             SweepConservatively<SWEEP_SEQUENTIALLY>(space, NULL, p);
             break;
           case OLD_POINTER_SPACE:
-            SweepPrecisely<SWEEP_AND_VISIT_LIVE_OBJECTS, IGNORE_SKIP_LIST>(
-                space, p, &updating_visitor);
+            SweepPrecisely<SWEEP_SEQUENTIALLY,
+                           SWEEP_AND_VISIT_LIVE_OBJECTS,
+                           IGNORE_SKIP_LIST>(space, NULL, p,
+                                             &updating_visitor);
             break;
           case CODE_SPACE:
-            SweepPrecisely<SWEEP_AND_VISIT_LIVE_OBJECTS, REBUILD_SKIP_LIST>(
-                space, p, &updating_visitor);
+            SweepPrecisely<SWEEP_SEQUENTIALLY,
+                           SWEEP_AND_VISIT_LIVE_OBJECTS,
+                           REBUILD_SKIP_LIST>(space, NULL, p,
+                                              &updating_visitor);
             break;
           default:
             UNREACHABLE();
@@ -3471,6 +4627,7 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
 
   slots_buffer_allocator_.DeallocateChain(&migration_slots_buffer_);
   ASSERT(migration_slots_buffer_ == NULL);
+  parallel_evacuator_.DeallocateMigrationSlotsBuffers();
 }
 
 
@@ -3780,19 +4937,6 @@ static inline Address StartOfLiveObject(Address block_address, uint32_t cell) {
 }
 
 
-template<MarkCompactCollector::SweepingParallelism mode>
-static intptr_t Free(PagedSpace* space,
-                     FreeList* free_list,
-                     Address start,
-                     int size) {
-  if (mode == MarkCompactCollector::SWEEP_SEQUENTIALLY) {
-    return space->Free(start, size);
-  } else {
-    return size - free_list->Free(start, size);
-  }
-}
-
-
 // Force instantiation of templatized SweepConservatively method for
 // SWEEP_SEQUENTIALLY mode.
 template intptr_t MarkCompactCollector::
@@ -3818,14 +4962,20 @@ template<MarkCompactCollector::SweepingParallelism mode>
 intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space,
                                                    FreeList* free_list,
                                                    Page* p) {
-  ASSERT(!p->IsEvacuationCandidate() && !p->WasSwept());
+  // Pages swept in parallel have been flagged as swept when they were queued,
+  // so that the sweeper threads do not race with the main thread on the page
+  // flags.
+  ASSERT(!p->IsEvacuationCandidate());
+  ASSERT(mode == MarkCompactCollector::SWEEP_IN_PARALLEL || !p->WasSwept());
   ASSERT((mode == MarkCompactCollector::SWEEP_IN_PARALLEL &&
          free_list != NULL) ||
          (mode == MarkCompactCollector::SWEEP_SEQUENTIALLY &&
          free_list == NULL));
 
   MarkBit::CellType* cells = p->markbits()->cells();
-  p->MarkSweptConservatively();
+  if (mode == MarkCompactCollector::SWEEP_SEQUENTIALLY) {
+    p->MarkSweptConservatively();
+  }
 
   int last_cell_index =
       Bitmap::IndexToCell(
@@ -3915,6 +5065,29 @@ intptr_t MarkCompactCollector::SweepConservatively(PagedSpace* space,
 }
 
 
+// Sweeps a page that was claimed from the sweeper threads' queue.  Code and
+// map space are swept precisely, the old spaces conservatively.
+static intptr_t SweepClaimedPage(PagedSpace* space,
+                                 FreeList* free_list,
+                                 Page* p) {
+  ASSERT(p->parallel_sweeping() ==
+         MemoryChunk::PARALLEL_SWEEPING_IN_PROGRESS);
+  if (p->WasSweptConservatively()) {
+    return MarkCompactCollector::
+        SweepConservatively<MarkCompactCollector::SWEEP_IN_PARALLEL>(
+            space, free_list, p);
+  } else if (space->identity() == CODE_SPACE) {
+    return SweepPrecisely<MarkCompactCollector::SWEEP_IN_PARALLEL,
+                          SWEEP_ONLY,
+                          REBUILD_SKIP_LIST>(space, free_list, p, NULL);
+  } else {
+    return SweepPrecisely<MarkCompactCollector::SWEEP_IN_PARALLEL,
+                          SWEEP_ONLY,
+                          IGNORE_SKIP_LIST>(space, free_list, p, NULL);
+  }
+}
+
+
 void MarkCompactCollector::SweepInParallel(PagedSpace* space,
                                            FreeList* private_free_list,
                                            FreeList* free_list) {
@@ -3923,13 +5096,54 @@ void MarkCompactCollector::SweepInParallel(PagedSpace* space,
     Page* p = it.next();
 
     if (p->TryParallelSweeping()) {
-      SweepConservatively<SWEEP_IN_PARALLEL>(space, private_free_list, p);
+      SweepClaimedPage(space, private_free_list, p);
       free_list->Concatenate(private_free_list);
+      // Publish the page only after its memory is visible to the main thread.
+      p->set_parallel_sweeping(MemoryChunk::PARALLEL_SWEEPING_DONE);
     }
   }
 }
 
 
+intptr_t MarkCompactCollector::SweepPageOnDemand(PagedSpace* space,
+                                                     Page* p) {
+  if (FLAG_gc_verbose) {
+    PrintF("Sweeping 0x%" V8PRIxPTR " on demand.\n",
+           reinterpret_cast<intptr_t>(p));
+  }
+  FreeList private_free_list(space);
+  SweepClaimedPage(space, &private_free_list, p);
+  intptr_t freed_bytes = space->free_list()->Concatenate(&private_free_list);
+  space->AddToAccountingStats(freed_bytes);
+  space->DecrementUnsweptFreeBytes(freed_bytes);
+  p->set_parallel_sweeping(MemoryChunk::PARALLEL_SWEEPING_DONE);
+  return freed_bytes;
+}
+
+
+intptr_t MarkCompactCollector::SweepPendingPage(PagedSpace* space) {
+  PageIterator it(space);
+  while (it.has_next()) {
+    Page* p = it.next();
+    if (p->TryParallelSweeping()) return SweepPageOnDemand(space, p);
+  }
+  return -1;
+}
+
+
+void MarkCompactCollector::EnsurePageIsSwept(Page* p) {
+  if (p->parallel_sweeping() == MemoryChunk::PARALLEL_SWEEPING_DONE) return;
+  if (p->TryParallelSweeping()) {
+    SweepPageOnDemand(static_cast<PagedSpace*>(p->owner()), p);
+    return;
+  }
+  // A sweeper thread got to the page first; it is done with it shortly.
+  while (p->parallel_sweeping() != MemoryChunk::PARALLEL_SWEEPING_DONE) {
+    Thread::YieldCPU();
+  }
+}
+
+
 void MarkCompactCollector::SweepSpace(PagedSpace* space, SweeperType sweeper) {
   space->set_was_swept_conservatively(sweeper == CONSERVATIVE ||
                                       sweeper == LAZY_CONSERVATIVE ||
@@ -3947,7 +5161,7 @@ void MarkCompactCollector::SweepSpace(PagedSpace* space, SweeperType sweeper) {
   while (it.has_next()) {
     Page* p = it.next();
 
-    ASSERT(p->parallel_sweeping() == 0);
+    ASSERT(p->parallel_sweeping() == MemoryChunk::PARALLEL_SWEEPING_DONE);
     ASSERT(!p->IsEvacuationCandidate());
 
     // Clear sweeping flags indicating that marking bits are still intact.
@@ -3961,8 +5175,10 @@ void MarkCompactCollector::SweepSpace(PagedSpace* space, SweeperType sweeper) {
     }
 
     // One unused page is kept, all further are released before sweeping them.
+    // When reducing memory only the first page of the space is kept.
     if (p->LiveBytes() == 0) {
-      if (unused_page_present) {
+      if (unused_page_present ||
+          (compact_all_fragmented_pages_ && p != space->FirstPage())) {
         if (FLAG_gc_verbose) {
           PrintF("Sweeping 0x%" V8PRIxPTR " released page.\n",
                  reinterpret_cast<intptr_t>(p));
@@ -4020,20 +5236,36 @@ void MarkCompactCollector::SweepSpace(PagedSpace* space, SweeperType sweeper) {
             PrintF("Sweeping 0x%" V8PRIxPTR " conservatively in parallel.\n",
                    reinterpret_cast<intptr_t>(p));
           }
-          p->set_parallel_sweeping(1);
           space->IncreaseUnsweptFreeBytes(p);
+          p->MarkSweptConservatively();
+          p->set_parallel_sweeping(MemoryChunk::PARALLEL_SWEEPING_PENDING);
+          sweeping_pending_ = true;
         }
         break;
       }
+      case CONCURRENT_PRECISE:
+      case PARALLEL_PRECISE: {
+        if (FLAG_gc_verbose) {
+          PrintF("Sweeping 0x%" V8PRIxPTR " precisely in parallel.\n",
+                 reinterpret_cast<intptr_t>(p));
+        }
+        space->IncreaseUnsweptFreeBytes(p);
+        p->MarkSweptPrecisely();
+        p->set_parallel_sweeping(MemoryChunk::PARALLEL_SWEEPING_PENDING);
+        sweeping_pending_ = true;
+        break;
+      }
       case PRECISE: {
         if (FLAG_gc_verbose) {
           PrintF("Sweeping 0x%" V8PRIxPTR " precisely.\n",
                  reinterpret_cast<intptr_t>(p));
         }
         if (space->identity() == CODE_SPACE) {
-          SweepPrecisely<SWEEP_ONLY, REBUILD_SKIP_LIST>(space, p, NULL);
+          SweepPrecisely<SWEEP_SEQUENTIALLY, SWEEP_ONLY, REBUILD_SKIP_LIST>(
+              space, NULL, p, NULL);
         } else {
-          SweepPrecisely<SWEEP_ONLY, IGNORE_SKIP_LIST>(space, p, NULL);
+          SweepPrecisely<SWEEP_SEQUENTIALLY, SWEEP_ONLY, IGNORE_SKIP_LIST>(
+              space, NULL, p, NULL);
         }
         pages_swept++;
         break;
@@ -4067,6 +5299,9 @@ void MarkCompactCollector::SweepSpaces() {
   if (FLAG_expose_gc) how_to_sweep = CONSERVATIVE;
   if (sweep_precisely_) how_to_sweep = PRECISE;
 
+  bool sweep_in_parallel = how_to_sweep == PARALLEL_CONSERVATIVE ||
+                           how_to_sweep == CONCURRENT_CONSERVATIVE;
+
   // Unlink evacuation candidates before sweeper threads access the list of
   // pages to avoid race condition.
   UnlinkEvacuationCandidates();
@@ -4077,21 +5312,26 @@ void MarkCompactCollector::SweepSpaces() {
   // the other spaces rely on possibly non-live maps to get the sizes for
   // non-live objects.
   SequentialSweepingScope scope(this);
-  SweepSpace(heap()->old_pointer_space(), how_to_sweep);
-  SweepSpace(heap()->old_data_space(), how_to_sweep);
 
-  if (how_to_sweep == PARALLEL_CONSERVATIVE ||
-      how_to_sweep == CONCURRENT_CONSERVATIVE) {
-    // TODO(hpayer): fix race with concurrent sweeper
+  // Code space has to be swept before evacuation: invalidated code is
+  // tracked with mark bits on code pages and updating the stack while
+  // evacuating looks code objects up in swept code pages.  The sweeper
+  // threads help with it but we wait for them.
+  RemoveDeadInvalidatedCode();
+  if (sweep_in_parallel) {
+    SweepSpace(heap()->code_space(), PARALLEL_PRECISE);
     StartSweeperThreads();
-  }
-
-  if (how_to_sweep == PARALLEL_CONSERVATIVE) {
+    while (SweepPendingPage(heap()->code_space()) >= 0) { }
     WaitUntilSweepingCompleted();
+  } else {
+    SweepSpace(heap()->code_space(), PRECISE);
   }
 
-  RemoveDeadInvalidatedCode();
-  SweepSpace(heap()->code_space(), PRECISE);
+  // Pages of the old spaces that are queued for the sweeper threads are
+  // swept on demand while evacuating.  The threads are only started after
+  // evacuation so that they never race with updating pointers.
+  SweepSpace(heap()->old_pointer_space(), how_to_sweep);
+  SweepSpace(heap()->old_data_space(), how_to_sweep);
 
   SweepSpace(heap()->cell_space(), PRECISE);
   SweepSpace(heap()->property_cell_space(), PRECISE);
@@ -4100,14 +5340,26 @@ void MarkCompactCollector::SweepSpaces() {
 
   // ClearNonLiveTransitions depends on precise sweeping of map space to
   // detect whether unmarked map became dead in this collection or in one
-  // of the previous ones.
-  SweepSpace(heap()->map_space(), PRECISE);
+  // of the previous ones.  Concurrent sweeping finishes before the next
+  // collection starts marking.
+  SweepSpace(heap()->map_space(),
+             sweep_in_parallel ? CONCURRENT_PRECISE : PRECISE);
 
   // Deallocate unmarked objects and clear marked bits for marked objects.
   heap_->lo_space()->FreeUnmarkedObjects();
 
   // Deallocate evacuated candidate pages.
   ReleaseEvacuationCandidates();
+
+  if (sweep_in_parallel) {
+    StartSweeperThreads();
+    if (how_to_sweep == PARALLEL_CONSERVATIVE) {
+      while (SweepPendingPage(heap()->old_pointer_space()) >= 0) { }
+      while (SweepPendingPage(heap()->old_data_space()) >= 0) { }
+      while (SweepPendingPage(heap()->map_space()) >= 0) { }
+      WaitUntilSweepingCompleted();
+    }
+  }
 }
 
 
@@ -4158,6 +5410,7 @@ Isolate* MarkCompactCollector::isolate() const {
 
 void MarkCompactCollector::Initialize() {
   MarkCompactMarkingVisitor::Initialize();
+  ParallelMarker::Initialize();
   IncrementalMarking::Initialize();
 }
 
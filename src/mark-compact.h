@@ -44,6 +44,7 @@ class CodeFlusher;
 class GCTracer;
 class MarkCompactCollector;
 class MarkingVisitor;
+class ParallelMarker;
 class RootMarkingVisitor;
 
 
@@ -170,7 +171,12 @@ class Marking {
 class MarkingDeque {
  public:
   MarkingDeque()
-      : array_(NULL), top_(0), bottom_(0), mask_(0), overflowed_(false) { }
+      : array_(NULL),
+        top_(0),
+        bottom_(0),
+        mask_(0),
+        overflowed_(false),
+        overflow_list_(NULL) { }
 
   void Initialize(Address low, Address high) {
     HeapObject** obj_low = reinterpret_cast<HeapObject**>(low);
@@ -179,12 +185,25 @@ class MarkingDeque {
     mask_ = RoundDownToPowerOf2(static_cast<int>(obj_high - obj_low)) - 1;
     top_ = bottom_ = 0;
     overflowed_ = false;
+    overflow_list_ = NULL;
   }
 
   inline bool IsFull() { return ((top_ + 1) & mask_) == bottom_; }
 
   inline bool IsEmpty() { return top_ == bottom_; }
 
+  inline int Length() { return (top_ - bottom_) & mask_; }
+
+  // When an overflow list is set, black objects that do not fit into the
+  // deque are added to the list instead of being turned grey, so no heap
+  // rescan is needed to find them again.  Used by parallel marking, which
+  // drains the list together with the deque.
+  List<HeapObject*>* overflow_list() { return overflow_list_; }
+
+  void set_overflow_list(List<HeapObject*>* overflow_list) {
+    overflow_list_ = overflow_list;
+  }
+
   bool overflowed() const { return overflowed_; }
 
   void ClearOverflowed() { overflowed_ = false; }
@@ -197,6 +216,10 @@ class MarkingDeque {
   INLINE(void PushBlack(HeapObject* object)) {
     ASSERT(object->IsHeapObject());
     if (IsFull()) {
+      if (overflow_list_ != NULL) {
+        overflow_list_->Add(object);
+        return;
+      }
       Marking::BlackToGrey(object);
       MemoryChunk::IncrementLiveBytesFromGC(object->address(), -object->Size());
       SetOverflowed();
@@ -249,6 +272,7 @@ class MarkingDeque {
   int bottom_;
   int mask_;
   bool overflowed_;
+  List<HeapObject*>* overflow_list_;
 
   DISALLOW_COPY_AND_ASSIGN(MarkingDeque);
 };
@@ -533,6 +557,372 @@ class CodeFlusher {
 class ThreadLocalTop;
 
 
+// -------------------------------------------------------------------------
+// Parallel marking
+
+// The state of a single participant of a parallel marking round.  Objects
+// are marked by atomically setting their mark bit, so each object is visited
+// by exactly one task.  Every task keeps the objects it still has to visit on
+// a private stack and moves part of them to a shared list whenever that list
+// is empty.  Idle tasks steal from the shared lists of the other tasks.
+//
+// Objects that need the special treatment of the full marking visitor
+// (maps, code, functions, weak maps, ...) are marked by the tasks but handed
+// back to the main thread, as are the slots that point to evacuation
+// candidates and have to be recorded in the slots buffers.
+class MarkingTask {
+ public:
+  MarkingTask();
+  ~MarkingTask();
+
+  void Initialize(ParallelMarker* marker, int task_id);
+
+  // Adds an already marked object to the shared list of this task.  Used to
+  // distribute the initial work of a round.
+  void AddSharedWork(HeapObject* object);
+
+  // Marks the objects referenced from the slots [start, end) of an object
+  // that is visited by this task.
+  INLINE(void VisitPointers(Object** start, Object** end));
+
+  // Defers visiting the body of an object to the main thread.
+  void DeferObject(HeapObject* object) { deferred_objects_.Add(object); }
+
+  // Visits objects until no task has work left or the budget of an
+  // incremental round is used up.
+  void Run();
+
+  // Records the collected slots and visits the bodies of the deferred
+  // objects.  Called by the main thread after all tasks are done.
+  void Finalize();
+
+  // Records the collected slots and returns all objects this task has not
+  // visited to the incremental marking deque.  Deferred objects are added to
+  // the main thread objects of the marker instead.
+  void FinalizeIncremental(MarkingDeque* marking_deque);
+
+  intptr_t marked_bytes() { return marked_bytes_; }
+  intptr_t visited_bytes() { return visited_bytes_; }
+  double time() { return time_; }
+  int visited_objects() { return visited_objects_; }
+  int deferred_objects() { return deferred_objects_.length(); }
+  int steals() { return steals_; }
+
+ private:
+  // Work is only shared once the private stack holds more objects than this.
+  static const int kMinWorkToShare = 64;
+
+  // Tasks of an incremental round charge the bytes they visited against the
+  // budget of the round in chunks of this size.
+  static const int kBytesPerBudgetUpdate = 16 * KB;
+
+  INLINE(void MarkObject(HeapObject* object));
+  INLINE(void VisitObject(HeapObject* object));
+
+  void ReturnToDeque(HeapObject* object, MarkingDeque* marking_deque);
+
+  void ShareWork();
+  // Moves objects from the shared list of the victim to the private stack.
+  // A task takes back all of its own shared work but only half of the work
+  // of another task.
+  bool TakeWork(MarkingTask* victim);
+  bool StealWork();
+
+  ParallelMarker* marker_;
+  MarkCompactCollector* collector_;
+  int task_id_;
+
+  List<HeapObject*> private_stack_;
+
+  Mutex* shared_mutex_;
+  List<HeapObject*> shared_list_;
+  volatile Atomic32 shared_length_;
+
+  List<HeapObject*> deferred_objects_;
+  // Pairs of anchor slot and slot pointing to an evacuation candidate.
+  List<Object**> recorded_slots_;
+
+  intptr_t marked_bytes_;
+  intptr_t visited_bytes_;
+  intptr_t unbudgeted_bytes_;
+  int visited_objects_;
+  int steals_;
+  double time_;
+
+  friend class ParallelMarker;
+
+  DISALLOW_COPY_AND_ASSIGN(MarkingTask);
+};
+
+
+// Drains the marking deque of the collector with the main thread and all
+// MarkingThreads.  A round is started by EmptyMarkingDeque once the deque
+// holds at least FLAG_parallel_marking_threshold objects, so long chains of
+// objects that only the main thread can visit are still marked serially
+// without synchronizing with the threads for every object.
+//
+// With FLAG_parallel_incremental_marking the marker also helps incremental
+// marking.  Such rounds take their work from the incremental marking deque,
+// stop after a budget of bytes and hand everything they did not get to back
+// to the main thread as grey objects.  The mutator never runs during a round,
+// so the incremental write barrier stays the only means to keep the marking
+// invariant between steps.
+class ParallelMarker {
+ public:
+  explicit ParallelMarker(MarkCompactCollector* collector);
+  ~ParallelMarker();
+
+  static void Initialize();
+
+  bool IsEnabled();
+
+  bool IsEnabledForIncrementalMarking();
+
+  bool ShouldMarkInParallel(MarkingDeque* marking_deque) {
+    return marking_deque->Length() >= FLAG_parallel_marking_threshold ||
+        !overflow_list_.is_empty();
+  }
+
+  // Marks everything reachable from the objects on the marking deque.  The
+  // bodies of deferred objects are visited by the main thread at the end of
+  // the round, so the objects they reference end up on the deque again.
+  void MarkInParallel(MarkingDeque* marking_deque);
+
+  // Marks objects from the incremental marking deque until about
+  // bytes_to_process bytes have been visited and returns the number of bytes
+  // visited.  Objects only the main thread can visit are left in
+  // main_thread_objects() as grey objects, all other unvisited objects are
+  // pushed back onto the deque.
+  intptr_t MarkIncrementallyInParallel(MarkingDeque* marking_deque,
+                                       intptr_t bytes_to_process);
+
+  // Entry point for every task, including the main thread (task 0).
+  void MarkInParallel(int task_id);
+
+  List<HeapObject*>* overflow_list() { return &overflow_list_; }
+
+  List<HeapObject*>* main_thread_objects() { return &main_thread_objects_; }
+
+  static MarkingTask* CurrentTask() {
+    return reinterpret_cast<MarkingTask*>(
+        Thread::GetThreadLocal(current_task_key_));
+  }
+
+  MarkCompactCollector* collector() { return collector_; }
+
+ private:
+  // Called by idle tasks.  Returns true once all tasks are idle and false if
+  // some task has shared work again.
+  bool TryToTerminate();
+  bool HasSharedWork();
+
+  // Charges bytes visited by a task against the budget of an incremental
+  // round.  Returns true if the budget is used up.
+  bool UpdateBudget(intptr_t bytes) {
+    return NoBarrier_AtomicIncrement(&remaining_bytes_, -bytes) <= 0;
+  }
+
+  bool IsBudgetExhausted() {
+    return incremental_ && NoBarrier_Load(&remaining_bytes_) <= 0;
+  }
+
+  void InitializeTasks();
+  void RunTasks();
+
+  // Reports the time the marking threads spent in the last round to the
+  // tracer of the current collection or, between collections, to
+  // incremental marking.
+  void RecordBackgroundTime();
+
+  void PrintStatistics(double time);
+
+  int task_count() { return FLAG_marking_threads + 1; }
+
+  MarkCompactCollector* collector_;
+  MarkingTask* tasks_;
+  List<HeapObject*> overflow_list_;
+  List<HeapObject*> main_thread_objects_;
+  volatile Atomic32 idle_tasks_;
+  bool incremental_;
+  volatile AtomicWord remaining_bytes_;
+
+  static Thread::LocalStorageKey current_task_key_;
+
+  friend class MarkingTask;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelMarker);
+};
+
+
+// -------------------------------------------------------------------------
+// Parallel compaction
+
+class ParallelEvacuator;
+
+// The state of a single participant of a parallel evacuation or pointer
+// updating phase.  Work items (new space pages, evacuation candidates or
+// slots buffers) are claimed one at a time, so every object is moved and
+// every slot is updated by exactly one task.  Each task allocates from its
+// own local allocation buffers and collects the slots it would otherwise
+// record in the shared migration slots buffer and in the store buffer.
+class EvacuationTask {
+ public:
+  EvacuationTask();
+
+  void Initialize(ParallelEvacuator* evacuator,
+                  MarkCompactCollector* collector);
+
+  // Evacuates the live objects in [start, end) of from-space.
+  void EvacuateNewSpacePage(Address start, Address end);
+
+  // Evacuates all live objects of an evacuation candidate.  Returns false if
+  // the space ran out of free memory, which the task cannot add to.  The
+  // mark bits of the objects left on the page are kept then.
+  bool EvacuatePage(Page* p);
+
+  // Updates the pointers of the objects in [start, end) of to-space.
+  void UpdatePointersInToSpace(Address start, Address end);
+
+  // Returns the unused parts of the allocation buffers to their spaces, enters
+  // the recorded old-to-new slots into the store buffer and hands the slots
+  // buffer of this task to the evacuator.  Called by the main thread.
+  void Finalize();
+
+  SlotsBuffer** migration_slots_buffer() { return &migration_slots_buffer_; }
+  List<Address>* old_to_new_slots() { return &old_to_new_slots_; }
+
+  int survivors_size() { return survivors_size_; }
+  intptr_t promoted_size() { return promoted_size_; }
+  int work_items() { return work_items_; }
+  double time() { return time_; }
+  void set_time(double time) { time_ = time; }
+  void increment_work_items() { work_items_++; }
+
+ private:
+  bool TryPromoteObject(HeapObject* object, int size);
+  HeapObject* Allocate(AllocationSpace space, int size_in_bytes);
+
+  ParallelEvacuator* evacuator_;
+  MarkCompactCollector* collector_;
+  Heap* heap_;
+
+  LocalAllocationBuffer to_space_buffer_;
+  LocalAllocationBuffer old_pointer_space_buffer_;
+  LocalAllocationBuffer old_data_space_buffer_;
+
+  SlotsBuffer* migration_slots_buffer_;
+  List<Address> old_to_new_slots_;
+
+  int survivors_size_;
+  intptr_t promoted_size_;
+  int work_items_;
+  double time_;
+
+  DISALLOW_COPY_AND_ASSIGN(EvacuationTask);
+};
+
+
+// Runs the evacuation and pointer updating phases of a compacting collection
+// with the main thread and up to FLAG_compaction_threads MarkingThreads.
+// Code space candidates and everything that touches the store buffer,
+// the free lists of swept pages or the roots stay on the main thread.  The
+// phases are only run in parallel if no logger or profiler has to be told
+// about moved objects.
+class ParallelEvacuator {
+ public:
+  enum Phase {
+    IDLE,
+    EVACUATE_NEW_SPACE,
+    EVACUATE_PAGES,
+    UPDATE_TO_SPACE,
+    UPDATE_SLOTS
+  };
+
+  explicit ParallelEvacuator(MarkCompactCollector* collector);
+  ~ParallelEvacuator();
+
+  bool IsEnabled();
+
+  bool IsActive() { return phase_ != IDLE; }
+
+  // Evacuates the live objects in [from_bottom, from_top) of from-space and
+  // stores the size of the survivors.  Returns false without evacuating
+  // anything if the old generation cannot make room for the objects the
+  // tasks might have to promote.
+  bool EvacuateNewSpace(Address from_bottom,
+                        Address from_top,
+                        int* survivors_size);
+
+  // Evacuates the given candidates.  Pages whose live objects do not fit
+  // into the free memory of their space are skipped and left to the caller.
+  // Pages the tasks started but could not finish are added to aborted_pages,
+  // the caller has to evacuate their remaining objects.
+  void EvacuatePages(List<Page*>* pages, List<Page*>* aborted_pages);
+
+  // Updates the pointers of all objects in [bottom, top) of to-space.
+  void UpdatePointersInToSpace(Address bottom, Address top);
+
+  // Updates the slots recorded in the given chains of slots buffers.
+  void UpdateSlots(List<SlotsBuffer*>* chains, bool code_slots_filtering);
+
+  // Entry point for every task, including the main thread (task 0).
+  void RunTask(int task_id);
+
+  // The chains of slots buffers filled by the tasks while migrating objects.
+  // They complement the migration slots buffer of the collector.
+  List<SlotsBuffer*>* migration_slots_buffers() {
+    return &migration_slots_buffers_;
+  }
+
+  void DeallocateMigrationSlotsBuffers();
+
+  Mutex* allocation_mutex() { return allocation_mutex_; }
+
+ private:
+  struct AddressRange {
+    AddressRange(Address start, Address end) : start(start), end(end) { }
+    Address start;
+    Address end;
+  };
+
+  void AddNewSpacePages(Address bottom, Address top);
+  bool ReserveOldSpace(intptr_t size_in_bytes);
+  bool ClaimWorkItem(int* index);
+  void RunPhase(Phase phase, int work_items);
+  void PrintStatistics(double time);
+
+  const char* PhaseName();
+
+  int task_count() {
+    int threads = FLAG_marking_threads;
+    if (FLAG_compaction_threads > 0) {
+      threads = Min(threads, FLAG_compaction_threads);
+    }
+    return threads + 1;
+  }
+
+  MarkCompactCollector* collector_;
+  Mutex* allocation_mutex_;
+  EvacuationTask* tasks_;
+
+  Phase phase_;
+  int work_items_;
+  volatile Atomic32 next_work_item_;
+  bool code_slots_filtering_;
+
+  List<AddressRange> new_space_pages_;
+  List<Page*>* pages_;
+  List<Page*>* aborted_pages_;
+  // Free bytes of each paged space that no task has claimed for evacuating
+  // a candidate yet.
+  intptr_t unclaimed_bytes_[LAST_PAGED_SPACE + 1];
+  List<SlotsBuffer*> slots_buffers_;
+  List<SlotsBuffer*> migration_slots_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelEvacuator);
+};
+
+
 // -------------------------------------------------------------------------
 // Mark-Compact collector
 class MarkCompactCollector {
@@ -623,6 +1013,8 @@ class MarkCompactCollector {
     LAZY_CONSERVATIVE,
     PARALLEL_CONSERVATIVE,
     CONCURRENT_CONSERVATIVE,
+    PARALLEL_PRECISE,
+    CONCURRENT_PRECISE,
     PRECISE
   };
 
@@ -693,6 +1085,17 @@ class MarkCompactCollector {
                      int size,
                      AllocationSpace to_old_space);
 
+  // Like above, but records slots pointing to evacuation candidates in the
+  // given slots buffer and, if old_to_new_slots is not NULL, collects slots
+  // pointing to new space there instead of entering them into the store
+  // buffer.  Used by the tasks of parallel evacuation.
+  void MigrateObject(Address dst,
+                     Address src,
+                     int size,
+                     AllocationSpace to_old_space,
+                     SlotsBuffer** slots_buffer,
+                     List<Address>* old_to_new_slots);
+
   bool TryPromoteObject(HeapObject* object, int object_size);
 
   inline Object* encountered_weak_maps() { return encountered_weak_maps_; }
@@ -700,6 +1103,13 @@ class MarkCompactCollector {
     encountered_weak_maps_ = weak_map;
   }
 
+  inline Object* encountered_allocation_sites() {
+    return encountered_allocation_sites_;
+  }
+  inline void set_encountered_allocation_sites(Object* site) {
+    encountered_allocation_sites_ = site;
+  }
+
   void InvalidateCode(Code* code);
 
   void ClearMarkbits();
@@ -710,11 +1120,22 @@ class MarkCompactCollector {
 
   MarkingParity marking_parity() { return marking_parity_; }
 
-  // Concurrent and parallel sweeping support.
+  // Concurrent and parallel sweeping support.  Pages are queued for the
+  // sweeper threads one by one and published to free_list as soon as each
+  // of them is swept.
   void SweepInParallel(PagedSpace* space,
                        FreeList* private_free_list,
                        FreeList* free_list);
 
+  // Sweeps one of the pages of the given space that are still queued for the
+  // sweeper threads and adds its free memory to the space's free list.
+  // Returns the number of bytes freed or -1 if no page is left in the queue.
+  intptr_t SweepPendingPage(PagedSpace* space);
+
+  // Makes sure the given page is not being swept concurrently anymore,
+  // sweeping it right away if no sweeper thread has started on it yet.
+  void EnsurePageIsSwept(Page* p);
+
   void WaitUntilSweepingCompleted();
 
   intptr_t StealMemoryFromSweeperThreads(PagedSpace* space);
@@ -736,6 +1157,21 @@ class MarkCompactCollector {
 
   void WaitUntilMarkingCompleted();
 
+  ParallelMarker* parallel_marker() { return &parallel_marker_; }
+
+  // Starts and waits for the first count marking threads.
+  void StartMarkingThreads(int count);
+  void WaitForMarkingThreads(int count);
+
+  // Runs whatever parallel job the main thread started on a marking thread.
+  void RunParallelTask(int task_id);
+
+  ParallelEvacuator* parallel_evacuator() { return &parallel_evacuator_; }
+
+  SlotsBufferAllocator* slots_buffer_allocator() {
+    return &slots_buffer_allocator_;
+  }
+
  private:
   MarkCompactCollector();
   ~MarkCompactCollector();
@@ -749,6 +1185,8 @@ class MarkCompactCollector {
 
   void StartSweeperThreads();
 
+  intptr_t SweepPageOnDemand(PagedSpace* space, Page* p);
+
 #ifdef DEBUG
   enum CollectorState {
     IDLE,
@@ -770,6 +1208,10 @@ class MarkCompactCollector {
 
   bool reduce_memory_footprint_;
 
+  // Select every fragmented page for evacuation and release all empty pages
+  // but the first one of each space.
+  bool compact_all_fragmented_pages_;
+
   bool abort_incremental_marking_;
 
   MarkingParity marking_parity_;
@@ -880,7 +1322,11 @@ class MarkCompactCollector {
   void ClearNonLiveMapTransitions(Map* map, MarkBit map_mark);
 
   void ClearAndDeoptimizeDependentCode(Map* map);
-  void ClearNonLiveDependentCode(Map* map);
+  void ClearNonLiveDependentCode(DependentCode* entries);
+
+  // The dependent code of allocation sites is weak as well, clear the dead
+  // and deoptimized entries of all sites encountered during marking.
+  void ClearNonLiveAllocationSiteDependentCode();
 
   // Marking detaches initial maps from SharedFunctionInfo objects
   // to make this reference weak. We need to reattach initial maps
@@ -934,8 +1380,11 @@ class MarkCompactCollector {
 
   Heap* heap_;
   MarkingDeque marking_deque_;
+  ParallelMarker parallel_marker_;
+  ParallelEvacuator parallel_evacuator_;
   CodeFlusher* code_flusher_;
   Object* encountered_weak_maps_;
+  Object* encountered_allocation_sites_;
 
   List<Page*> evacuation_candidates_;
   List<Code*> invalidated_code_;
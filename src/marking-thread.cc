@@ -35,21 +35,18 @@
 namespace v8 {
 namespace internal {
 
-MarkingThread::MarkingThread(Isolate* isolate)
+MarkingThread::MarkingThread(Isolate* isolate, int task_id)
      : Thread("MarkingThread"),
        isolate_(isolate),
        heap_(isolate->heap()),
        start_marking_semaphore_(OS::CreateSemaphore(0)),
        end_marking_semaphore_(OS::CreateSemaphore(0)),
-       stop_semaphore_(OS::CreateSemaphore(0)) {
+       stop_semaphore_(OS::CreateSemaphore(0)),
+       task_id_(task_id) {
   NoBarrier_Store(&stop_thread_, static_cast<AtomicWord>(false));
-  id_ = NoBarrier_AtomicIncrement(&id_counter_, 1);
 }
 
 
-Atomic32 MarkingThread::id_counter_ = -1;
-
-
 void MarkingThread::Run() {
   Isolate::SetIsolateThreadLocals(isolate_, NULL);
   DisallowHeapAllocation no_allocation;
@@ -64,6 +61,7 @@ void MarkingThread::Run() {
       return;
     }
 
+    heap_->mark_compact_collector()->RunParallelTask(task_id_);
     end_marking_semaphore_->Signal();
   }
 }
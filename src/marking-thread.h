@@ -42,7 +42,7 @@ namespace internal {
 
 class MarkingThread : public Thread {
  public:
-  explicit MarkingThread(Isolate* isolate);
+  MarkingThread(Isolate* isolate, int task_id);
 
   void Run();
   void Stop();
@@ -62,8 +62,7 @@ class MarkingThread : public Thread {
   Semaphore* end_marking_semaphore_;
   Semaphore* stop_semaphore_;
   volatile AtomicWord stop_thread_;
-  int id_;
-  static Atomic32 id_counter_;
+  int task_id_;
 };
 
 } }  // namespace v8::internal
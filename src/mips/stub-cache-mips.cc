@@ -213,6 +213,11 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   __ IncrementCounter(counters->megamorphic_stub_cache_probes(), 1,
                       extra2, extra3);
 
+  // The tables can grow, so the masks are loaded from the stub cache.  They
+  // are scaled by 1 << kHeapObjectTagSize, the offsets here are not.
+  ExternalReference primary_mask(mask_reference(kPrimary));
+  ExternalReference secondary_mask(mask_reference(kSecondary));
+
   // Check that the receiver isn't a smi.
   __ JumpIfSmi(receiver, &miss);
 
@@ -220,12 +225,17 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
   __ lw(scratch, FieldMemOperand(name, Name::kHashFieldOffset));
   __ lw(at, FieldMemOperand(receiver, HeapObject::kMapOffset));
   __ Addu(scratch, scratch, at);
-  uint32_t mask = kPrimaryTableSize - 1;
   // We shift out the last two bits because they are not part of the hash and
   // they are always 01 for maps.
   __ srl(scratch, scratch, kHeapObjectTagSize);
-  __ Xor(scratch, scratch, Operand((flags >> kHeapObjectTagSize) & mask));
-  __ And(scratch, scratch, Operand(mask));
+  // The bits of the flags above the largest table size do not affect the
+  // result.
+  uint32_t max_mask = (1 << kMaxTableBits) - 1;
+  __ Xor(scratch, scratch, Operand((flags >> kHeapObjectTagSize) & max_mask));
+  __ li(at, Operand(primary_mask));
+  __ lw(at, MemOperand(at));
+  __ srl(at, at, kHeapObjectTagSize);
+  __ And(scratch, scratch, Operand(at));
 
   // Probe the primary table.
   ProbeTable(isolate,
@@ -239,12 +249,17 @@ void StubCache::GenerateProbe(MacroAssembler* masm,
              extra2,
              extra3);
 
+  __ IncrementCounter(counters->megamorphic_stub_cache_primary_misses(), 1,
+                      extra2, extra3);
+
   // Primary miss: Compute hash for secondary probe.
   __ srl(at, name, kHeapObjectTagSize);
   __ Subu(scratch, scratch, at);
-  uint32_t mask2 = kSecondaryTableSize - 1;
-  __ Addu(scratch, scratch, Operand((flags >> kHeapObjectTagSize) & mask2));
-  __ And(scratch, scratch, Operand(mask2));
+  __ Addu(scratch, scratch, Operand((flags >> kHeapObjectTagSize) & max_mask));
+  __ li(at, Operand(secondary_mask));
+  __ lw(at, MemOperand(at));
+  __ srl(at, at, kHeapObjectTagSize);
+  __ And(scratch, scratch, Operand(at));
 
   // Probe the secondary table.
   ProbeTable(isolate,
@@ -345,7 +345,8 @@ int main(int argc, char** argv) {
     // Capture 100 frames if anything happens.
     V8::SetCaptureStackTraceForUncaughtExceptions(true, 100);
     HandleScope scope(isolate);
-    v8::Context::Scope(v8::Local<v8::Context>::New(isolate, context));
+    v8::Context::Scope context_scope(v8::Local<v8::Context>::New(isolate,
+                                                                 context));
     const char* name = i::FLAG_extra_code;
     FILE* file = i::OS::FOpen(name, "rb");
     if (file == NULL) {
@@ -389,6 +390,7 @@ int main(int argc, char** argv) {
       i::Isolate::Current()->bootstrapper()->NativesSourceLookup(i);
     }
   }
+  i::Serializer::ResetCompiledFunctions();
   // If we don't do this then we end up with a stray root pointing at the
   // context even after we have disposed of the context.
   HEAP->CollectAllGarbage(i::Heap::kNoGCFlags, "mksnapshot");
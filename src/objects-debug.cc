@@ -898,6 +898,18 @@ void TypeSwitchInfo::TypeSwitchInfoVerify() {
 }
 
 
+void AllocationSite::AllocationSiteVerify() {
+  CHECK(IsAllocationSite());
+  VerifyHeapPointer(boilerplate());
+  CHECK(boilerplate()->IsJSObject());
+  VerifyHeapPointer(dependent_code());
+  CHECK(dependent_code()->IsFixedArray());
+  CHECK(memento_found_count() >= 0);
+  CHECK(memento_create_count() >= 0);
+  CHECK(weak_next()->IsSmi() || weak_next()->IsAllocationSite());
+}
+
+
 void AllocationSiteInfo::AllocationSiteInfoVerify() {
   CHECK(IsAllocationSiteInfo());
   VerifyHeapPointer(payload());
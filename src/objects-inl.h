@@ -1216,6 +1216,18 @@ void HeapObject::set_map_word(MapWord map_word) {
 }
 
 
+bool HeapObject::compare_and_swap_map_word(MapWord old_map_word,
+                                           MapWord new_map_word) {
+  AtomicWord* location =
+      reinterpret_cast<AtomicWord*>(FIELD_ADDR(this, kMapOffset));
+  AtomicWord old_value = static_cast<AtomicWord>(old_map_word.value_);
+  return Release_CompareAndSwap(
+      location,
+      old_value,
+      static_cast<AtomicWord>(new_map_word.value_)) == old_value;
+}
+
+
 HeapObject* HeapObject::FromAddress(Address address) {
   ASSERT_TAG_ALIGNED(address);
   return reinterpret_cast<HeapObject*>(address + kHeapObjectTag);
@@ -1337,6 +1349,53 @@ AllocationSiteMode AllocationSiteInfo::GetMode(ElementsKind from,
 }
 
 
+AllocationSite::PretenureDecision AllocationSite::pretenure_decision() {
+  Object* value = READ_FIELD(this, kPretenureDecisionOffset);
+  return static_cast<PretenureDecision>(Smi::cast(value)->value());
+}
+
+
+void AllocationSite::set_pretenure_decision(PretenureDecision decision) {
+  WRITE_FIELD(this, kPretenureDecisionOffset, Smi::FromInt(decision));
+}
+
+
+AllocationSiteMode AllocationSite::GetMode() {
+  PretenureDecision decision = pretenure_decision();
+  if (decision == kTenure) return DONT_TRACK_ALLOCATION_SITE;
+  if (FLAG_allocation_site_pretenuring && decision == kUndecided) {
+    return TRACK_ALLOCATION_SITE;
+  }
+  JSObject* object = JSObject::cast(boilerplate());
+  if (!object->IsJSArray()) return DONT_TRACK_ALLOCATION_SITE;
+  return AllocationSiteInfo::GetMode(object->GetElementsKind());
+}
+
+
+PretenureFlag AllocationSite::GetPretenureMode() {
+  return pretenure_decision() == kTenure ? TENURED : NOT_TENURED;
+}
+
+
+void AllocationSite::IncrementMementoCreateCount() {
+  int count = memento_create_count();
+  if (count == Smi::kMaxValue) {
+    // None of the copies survived for a very long time, start over.
+    set_memento_found_count(0);
+    count = 0;
+  }
+  set_memento_create_count(count + 1);
+}
+
+
+bool AllocationSite::IncrementMementoFoundCount() {
+  AtomicWord* count = reinterpret_cast<AtomicWord*>(
+      FIELD_ADDR(this, kMementoFoundCountOffset));
+  AtomicWord one = reinterpret_cast<AtomicWord>(Smi::FromInt(1));
+  return NoBarrier_AtomicIncrement(count, one) == one;
+}
+
+
 MaybeObject* JSObject::EnsureCanContainHeapObjectElements() {
   ValidateElements();
   ElementsKind elements_kind = map()->elements_kind();
@@ -3559,7 +3618,8 @@ Code::Flags Code::flags() {
 
 
 inline bool Map::CanTrackAllocationSite() {
-  return instance_type() == JS_ARRAY_TYPE;
+  return instance_type() == JS_ARRAY_TYPE ||
+      instance_type() == JS_OBJECT_TYPE;
 }
 
 
@@ -4427,6 +4487,13 @@ ACCESSORS(SignatureInfo, args, Object, kArgsOffset)
 
 ACCESSORS(TypeSwitchInfo, types, Object, kTypesOffset)
 
+ACCESSORS(AllocationSite, boilerplate, Object, kBoilerplateOffset)
+ACCESSORS(AllocationSite, dependent_code, DependentCode,
+          kDependentCodeOffset)
+SMI_ACCESSORS(AllocationSite, memento_found_count, kMementoFoundCountOffset)
+SMI_ACCESSORS(AllocationSite, memento_create_count, kMementoCreateCountOffset)
+ACCESSORS(AllocationSite, weak_next, Object, kWeakNextOffset)
+
 ACCESSORS(AllocationSiteInfo, payload, Object, kPayloadOffset)
 
 ACCESSORS(Script, source, Object, kSourceOffset)
@@ -5795,6 +5862,7 @@ void Dictionary<Shape, Key>::SetEntry(int entry,
   FixedArray::set(index, key, mode);
   FixedArray::set(index+1, value, mode);
   FixedArray::set(index+2, details.AsSmi());
+  ClearEnumCache();
 }
 
 
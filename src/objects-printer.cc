@@ -1099,6 +1099,21 @@ void TypeSwitchInfo::TypeSwitchInfoPrint(FILE* out) {
 }
 
 
+void AllocationSite::AllocationSitePrint(FILE* out) {
+  HeapObject::PrintHeader(out, "AllocationSite");
+  PrintF(out, "\n - boilerplate: ");
+  boilerplate()->ShortPrint(out);
+  PrintF(out, "\n - dependent code: ");
+  dependent_code()->ShortPrint(out);
+  PrintF(out, "\n - mementos found: %d", memento_found_count());
+  PrintF(out, "\n - mementos created: %d", memento_create_count());
+  PrintF(out, "\n - pretenure decision: %d", pretenure_decision());
+  PrintF(out, "\n - weak next: ");
+  weak_next()->ShortPrint(out);
+  PrintF(out, "\n");
+}
+
+
 void AllocationSiteInfo::AllocationSiteInfoPrint(FILE* out) {
   HeapObject::PrintHeader(out, "AllocationSiteInfo");
   PrintF(out, " - payload: ");
@@ -1113,8 +1128,8 @@ void AllocationSiteInfo::AllocationSiteInfoPrint(FILE* out) {
       PrintF(out, "\n");
       return;
     }
-  } else if (payload()->IsJSArray()) {
-    PrintF(out, "Array literal ");
+  } else if (payload()->IsAllocationSite()) {
+    PrintF(out, "Literal allocation site ");
     payload()->ShortPrint(out);
     PrintF(out, "\n");
     return;
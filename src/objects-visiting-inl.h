@@ -87,6 +87,8 @@ void StaticNewSpaceVisitor<StaticVisitor>::Initialize() {
 
   table_.Register(kVisitJSWeakMap, &JSObjectVisitor::Visit);
 
+  table_.Register(kVisitAllocationSite, &StructVisitor::Visit);
+
   table_.Register(kVisitJSRegExp, &JSObjectVisitor::Visit);
 
   table_.template RegisterSpecializations<DataObjectVisitor,
@@ -177,6 +179,8 @@ void StaticMarkingVisitor<StaticVisitor>::Initialize() {
 
   table_.Register(kVisitJSWeakMap, &StaticVisitor::VisitJSWeakMap);
 
+  table_.Register(kVisitAllocationSite, &StaticVisitor::VisitAllocationSite);
+
   table_.Register(kVisitOddball,
                   &FixedBodyVisitor<StaticVisitor,
                   Oddball::BodyDescriptor,
@@ -93,6 +93,7 @@ class StaticVisitorBase : public AllStatic {
   V(SharedFunctionInfo)       \
   V(JSFunction)               \
   V(JSWeakMap)                \
+  V(AllocationSite)           \
   V(JSArrayBuffer)            \
   V(JSTypedArray)             \
   V(JSRegExp)
@@ -5578,7 +5578,8 @@ MUST_USE_RESULT MaybeObject* JSObject::Freeze(Isolate* isolate) {
 }
 
 
-MUST_USE_RESULT MaybeObject* JSObject::DeepCopy(Isolate* isolate) {
+MUST_USE_RESULT MaybeObject* JSObject::DeepCopy(Isolate* isolate,
+                                                AllocationSite* site) {
   StackLimitCheck check(isolate);
   if (check.HasOverflowed()) return isolate->StackOverflow();
 
@@ -5589,11 +5590,17 @@ MUST_USE_RESULT MaybeObject* JSObject::DeepCopy(Isolate* isolate) {
 
   Heap* heap = isolate->heap();
   Object* result;
-  { MaybeObject* maybe_result = heap->CopyJSObject(this);
+  { MaybeObject* maybe_result = heap->CopyJSObject(this, site);
     if (!maybe_result->ToObject(&result)) return maybe_result;
   }
   JSObject* copy = JSObject::cast(result);
 
+  // Nested objects of a pretenured literal are pretenured as well, but only
+  // the outermost copy is tracked by the allocation site.
+  PretenureFlag pretenure = NOT_TENURED;
+  if (site != NULL) pretenure = site->GetPretenureMode();
+  AllocationSite* nested_site = (pretenure == TENURED) ? site : NULL;
+
   // Deep copy local properties.
   if (copy->HasFastProperties()) {
     DescriptorArray* descriptors = copy->map()->instance_descriptors();
@@ -5605,12 +5612,12 @@ MUST_USE_RESULT MaybeObject* JSObject::DeepCopy(Isolate* isolate) {
       Object* value = RawFastPropertyAt(index);
       if (value->IsJSObject()) {
         JSObject* js_object = JSObject::cast(value);
-        MaybeObject* maybe_copy = js_object->DeepCopy(isolate);
+        MaybeObject* maybe_copy = js_object->DeepCopy(isolate, nested_site);
         if (!maybe_copy->To(&value)) return maybe_copy;
       } else {
         Representation representation = details.representation();
         MaybeObject* maybe_storage =
-            value->AllocateNewStorageFor(heap, representation);
+            value->AllocateNewStorageFor(heap, representation, pretenure);
         if (!maybe_storage->To(&value)) return maybe_storage;
       }
       copy->FastPropertyAtPut(index, value);
@@ -5635,7 +5642,8 @@ MUST_USE_RESULT MaybeObject* JSObject::DeepCopy(Isolate* isolate) {
           copy->GetProperty(key_string, &attributes)->ToObjectUnchecked();
       if (value->IsJSObject()) {
         JSObject* js_object = JSObject::cast(value);
-        { MaybeObject* maybe_result = js_object->DeepCopy(isolate);
+        { MaybeObject* maybe_result =
+              js_object->DeepCopy(isolate, nested_site);
           if (!maybe_result->ToObject(&result)) return maybe_result;
         }
         { MaybeObject* maybe_result =
@@ -5671,7 +5679,8 @@ MUST_USE_RESULT MaybeObject* JSObject::DeepCopy(Isolate* isolate) {
                  (IsFastObjectElementsKind(copy->GetElementsKind())));
           if (value->IsJSObject()) {
             JSObject* js_object = JSObject::cast(value);
-            { MaybeObject* maybe_result = js_object->DeepCopy(isolate);
+            { MaybeObject* maybe_result =
+                  js_object->DeepCopy(isolate, nested_site);
               if (!maybe_result->ToObject(&result)) return maybe_result;
             }
             elements->set(i, result);
@@ -5689,7 +5698,8 @@ MUST_USE_RESULT MaybeObject* JSObject::DeepCopy(Isolate* isolate) {
           Object* value = element_dictionary->ValueAt(i);
           if (value->IsJSObject()) {
             JSObject* js_object = JSObject::cast(value);
-            { MaybeObject* maybe_result = js_object->DeepCopy(isolate);
+            { MaybeObject* maybe_result =
+                  js_object->DeepCopy(isolate, nested_site);
               if (!maybe_result->ToObject(&result)) return maybe_result;
             }
             element_dictionary->ValueAtPut(i, result);
@@ -8884,6 +8894,49 @@ Handle<String> SeqString::Truncate(Handle<SeqString> string, int new_length) {
 }
 
 
+bool AllocationSite::DigestPretenuringFeedback() {
+  bool deoptimize = false;
+  int found_count = memento_found_count();
+  int create_count = memento_create_count();
+  if (pretenure_decision() == kUndecided &&
+      create_count >= kPretenureMinimumCreated) {
+    bool survives = found_count * 100 >= create_count *
+        kPretenureSurvivalPercent;
+    if (survives) {
+      set_pretenure_decision(kTenure);
+      deoptimize = dependent_code()->MarkCodeForDeoptimization(
+          GetIsolate(), DependentCode::kAllocationSiteTenuringChangedGroup);
+    } else {
+      // Code that counts copies of this site has nothing left to learn,
+      // so there is no point in keeping it around as a dependency.
+      set_pretenure_decision(kDontTenure);
+      dependent_code()->ClearGroup(
+          DependentCode::kAllocationSiteTenuringChangedGroup);
+    }
+    if (FLAG_trace_pretenuring) {
+      PrintF("AllocationSite %p: %d of %d copies survived, %s\n",
+             reinterpret_cast<void*>(this), found_count, create_count,
+             survives ? "tenuring" : "not tenuring");
+    }
+  }
+  set_memento_found_count(0);
+  set_memento_create_count(0);
+  return deoptimize;
+}
+
+
+void AllocationSite::AddDependentCompilationInfo(
+    Handle<AllocationSite> site,
+    DependentCode::DependencyGroup group,
+    CompilationInfo* info) {
+  Handle<DependentCode> dep(site->dependent_code());
+  Handle<DependentCode> codes =
+      DependentCode::Insert(dep, group, info->object_wrapper());
+  if (*codes != site->dependent_code()) site->set_dependent_code(*codes);
+  info->dependencies(group)->Add(Handle<HeapObject>(*site), info->zone());
+}
+
+
 AllocationSiteInfo* AllocationSiteInfo::FindForJSObject(JSObject* object) {
   // Currently, AllocationSiteInfo objects are only allocated immediately
   // after JSArrays in NewSpace, and detecting whether a JSArray has one
@@ -9533,7 +9586,12 @@ MaybeObject* JSFunction::SetInstancePrototype(Object* value) {
       if (ok->IsFailure()) return ok;
     }
 
+    // Optimized code that allocates instances with the old initial map
+    // inlined has to be deoptimized.
+    Map* old_map = initial_map();
     set_initial_map(new_map);
+    old_map->dependent_code()->DeoptimizeDependentCodeGroup(
+        GetIsolate(), DependentCode::kInitialMapChangedGroup);
   } else {
     // Put the value in the initial map field until an initial map is
     // needed.  At that point, a new initial map is created and the
@@ -10555,7 +10613,14 @@ void DeoptimizationInputData::DeoptimizationInputDataPrint(FILE* out) {
           break;
         }
 
-        case Translation::ARGUMENTS_OBJECT: {
+        case Translation::DUPLICATED_OBJECT: {
+          int object_index = iterator.Next();
+          PrintF(out, "{object_index=%d}", object_index);
+          break;
+        }
+
+        case Translation::ARGUMENTS_OBJECT:
+        case Translation::CAPTURED_OBJECT: {
           int args_length = iterator.Next();
           PrintF(out, "{length=%d}", args_length);
           break;
@@ -11112,7 +11177,7 @@ void Map::AddDependentCompilationInfo(DependentCode::DependencyGroup group,
   Handle<DependentCode> codes =
       DependentCode::Insert(dep, group, info->object_wrapper());
   if (*codes != dependent_code()) set_dependent_code(*codes);
-  info->dependent_maps(group)->Add(Handle<Map>(this), info->zone());
+  info->dependencies(group)->Add(Handle<HeapObject>(this), info->zone());
 }
 
 
@@ -11253,23 +11318,14 @@ bool DependentCode::Contains(DependencyGroup group, Code* code) {
 }
 
 
-class DeoptimizeDependentCodeFilter : public OptimizedFunctionFilter {
- public:
-  virtual bool TakeFunction(JSFunction* function) {
-    return function->code()->marked_for_deoptimization();
-  }
-};
-
-
-void DependentCode::DeoptimizeDependentCodeGroup(
+bool DependentCode::MarkCodeForDeoptimization(
     Isolate* isolate,
     DependentCode::DependencyGroup group) {
   DisallowHeapAllocation no_allocation_scope;
   DependentCode::GroupStartIndexes starts(this);
   int start = starts.at(group);
   int end = starts.at(group + 1);
-  int code_entries = starts.number_of_entries();
-  if (start == end) return;
+  if (start == end) return false;
   for (int i = start; i < end; i++) {
     if (is_code_at(i)) {
       Code* code = code_at(i);
@@ -11279,6 +11335,18 @@ void DependentCode::DeoptimizeDependentCodeGroup(
       info->AbortDueToDependentMap();
     }
   }
+  ClearGroup(group);
+  return true;
+}
+
+
+void DependentCode::ClearGroup(DependentCode::DependencyGroup group) {
+  DisallowHeapAllocation no_allocation_scope;
+  DependentCode::GroupStartIndexes starts(this);
+  int start = starts.at(group);
+  int end = starts.at(group + 1);
+  int code_entries = starts.number_of_entries();
+  if (start == end) return;
   // Compact the array by moving all subsequent groups to fill in the new holes.
   for (int src = end, dst = start; src < code_entries; src++, dst++) {
     copy(src, dst);
@@ -11289,8 +11357,25 @@ void DependentCode::DeoptimizeDependentCodeGroup(
     clear_at(i);
   }
   set_number_of_entries(group, 0);
-  DeoptimizeDependentCodeFilter filter;
-  Deoptimizer::DeoptimizeAllFunctionsWith(isolate, &filter);
+}
+
+
+void DependentCode::DeoptimizeDependentCodeGroup(
+    Isolate* isolate,
+    DependentCode::DependencyGroup group) {
+  if (MarkCodeForDeoptimization(isolate, group)) {
+    Deoptimizer::DeoptimizeMarkedCode(isolate);
+  }
+}
+
+
+DependentCode* DependentCode::ForObject(Handle<HeapObject> object,
+                                        DependencyGroup group) {
+  AllowDeferredHandleDereference dependencies_are_safe;
+  if (group == kAllocationSiteTenuringChangedGroup) {
+    return Handle<AllocationSite>::cast(object)->dependent_code();
+  }
+  return Handle<Map>::cast(object)->dependent_code();
 }
 
 
@@ -12317,8 +12402,10 @@ MaybeObject* JSObject::UpdateAllocationSiteInfo(ElementsKind to_kind) {
     return this;
   }
 
-  if (info->payload()->IsJSArray()) {
-    JSArray* payload = JSArray::cast(info->payload());
+  if (info->payload()->IsAllocationSite()) {
+    AllocationSite* site = AllocationSite::cast(info->payload());
+    if (!site->boilerplate()->IsJSArray()) return this;
+    JSArray* payload = JSArray::cast(site->boilerplate());
     ElementsKind kind = payload->GetElementsKind();
     if (AllocationSiteInfo::GetMode(kind, to_kind) == TRACK_ALLOCATION_SITE) {
       // If the array is huge, it's not likely to be defined in a local
@@ -383,6 +383,7 @@ const int kStubMinorKeyBits = kBitsPerInt - kSmiTagSize - kStubMajorKeyBits;
   V(OBJECT_TEMPLATE_INFO_TYPE)                                                 \
   V(SIGNATURE_INFO_TYPE)                                                       \
   V(TYPE_SWITCH_INFO_TYPE)                                                     \
+  V(ALLOCATION_SITE_TYPE)                                                      \
   V(ALLOCATION_SITE_INFO_TYPE)                                                 \
   V(SCRIPT_TYPE)                                                               \
   V(CODE_CACHE_TYPE)                                                           \
@@ -546,6 +547,7 @@ const int kStubMinorKeyBits = kBitsPerInt - kSmiTagSize - kStubMajorKeyBits;
   V(SIGNATURE_INFO, SignatureInfo, signature_info)                             \
   V(TYPE_SWITCH_INFO, TypeSwitchInfo, type_switch_info)                        \
   V(SCRIPT, Script, script)                                                    \
+  V(ALLOCATION_SITE, AllocationSite, allocation_site)                          \
   V(ALLOCATION_SITE_INFO, AllocationSiteInfo, allocation_site_info)            \
   V(CODE_CACHE, CodeCache, code_cache)                                         \
   V(POLYMORPHIC_CODE_CACHE, PolymorphicCodeCache, polymorphic_code_cache)      \
@@ -706,6 +708,7 @@ enum InstanceType {
   OBJECT_TEMPLATE_INFO_TYPE,
   SIGNATURE_INFO_TYPE,
   TYPE_SWITCH_INFO_TYPE,
+  ALLOCATION_SITE_TYPE,
   ALLOCATION_SITE_INFO_TYPE,
   SCRIPT_TYPE,
   CODE_CACHE_TYPE,
@@ -839,6 +842,7 @@ enum CompareResult {
 
 
 class AccessorPair;
+class AllocationSite;
 class DictionaryElementsAccessor;
 class ElementsAccessor;
 class Failure;
@@ -1398,6 +1402,12 @@ class HeapObject: public Object {
   inline MapWord map_word();
   inline void set_map_word(MapWord map_word);
 
+  // Atomically replaces the map word if it still holds old_map_word.  Used
+  // by parallel scavenges where several threads may race to install a
+  // forwarding address in the same object.  Returns true on success.
+  inline bool compare_and_swap_map_word(MapWord old_map_word,
+                                        MapWord new_map_word);
+
   // The Heap the object was allocated in. Used also to access Isolate.
   inline Heap* GetHeap();
 
@@ -2328,8 +2338,10 @@ class JSObject: public JSReceiver {
   // ES5 Object.freeze
   MUST_USE_RESULT MaybeObject* Freeze(Isolate* isolate);
 
-  // Copy object
-  MUST_USE_RESULT MaybeObject* DeepCopy(Isolate* isolate);
+  // Copy object. The copy of a literal boilerplate is tracked by, or
+  // pretenured for, the given allocation site.
+  MUST_USE_RESULT MaybeObject* DeepCopy(Isolate* isolate,
+                                        AllocationSite* site = NULL);
 
   // Dispatched behavior.
   void JSObjectShortPrint(StringStream* accumulator);
@@ -3360,6 +3372,7 @@ class Dictionary: public HashTable<Shape, Key> {
   // Set the details for entry.
   void DetailsAtPut(int entry, PropertyDetails value) {
     this->set(HashTable<Shape, Key>::EntryToIndex(entry) + 2, value.AsSmi());
+    ClearEnumCache();
   }
 
   // Sorting support
@@ -3442,9 +3455,19 @@ class Dictionary: public HashTable<Shape, Key> {
 
   // Generate new enumeration indices to avoid enumeration index overflow.
   MUST_USE_RESULT MaybeObject* GenerateNewEnumerationIndices();
+
+  // Dictionaries with enumerable keys cache the array of their enumerable
+  // keys. The cache is dropped whenever an entry is added or removed, or
+  // the details of an entry change.
+  void ClearEnumCache() {
+    if (Shape::kIsEnumerable) this->set_undefined(kEnumCacheIndex);
+  }
+
   static const int kMaxNumberKeyIndex =
       HashTable<Shape, Key>::kPrefixStartIndex;
   static const int kNextEnumerationIndexIndex = kMaxNumberKeyIndex + 1;
+  // Only present in dictionaries with enumerable keys.
+  static const int kEnumCacheIndex = kNextEnumerationIndexIndex + 1;
 };
 
 
@@ -3455,7 +3478,7 @@ class NameDictionaryShape : public BaseShape<Name*> {
   static inline uint32_t HashForObject(Name* key, Object* object);
   MUST_USE_RESULT static inline MaybeObject* AsObject(Heap* heap,
                                                       Name* key);
-  static const int kPrefixSize = 2;
+  static const int kPrefixSize = 3;
   static const int kEntrySize = 3;
   static const bool kIsEnumerable = true;
 };
@@ -3470,6 +3493,11 @@ class NameDictionary: public Dictionary<NameDictionaryShape, Name*> {
 
   // Copies enumerable keys to preallocated fixed array.
   FixedArray* CopyEnumKeysTo(FixedArray* storage);
+
+  // Returns the cached array of enumerable keys in enumeration order, or
+  // undefined if the keys have changed since it was cached.
+  Object* GetEnumCache() { return get(kEnumCacheIndex); }
+  void SetEnumCache(FixedArray* keys) { set(kEnumCacheIndex, keys); }
   static void DoGenerateNewEnumerationIndices(
       Handle<NameDictionary> dictionary);
 
@@ -5019,7 +5047,15 @@ class DependentCode: public FixedArray {
     // Group of code that depends on elements not being added to objects with
     // this map.
     kElementsCantBeAddedGroup,
-    kGroupCount = kElementsCantBeAddedGroup + 1
+    // Group of code that allocates the objects of an allocation site in new
+    // space and depends on being deoptimized when the site decides to
+    // pretenure them.
+    kAllocationSiteTenuringChangedGroup,
+    // Group of code that inlines the allocation of objects with this map as
+    // the initial map of their constructor and depends on being deoptimized
+    // when the constructor gets a new initial map.
+    kInitialMapChangedGroup,
+    kGroupCount = kInitialMapChangedGroup + 1
   };
 
   // Array for holding the index of the first code object of each group.
@@ -5044,8 +5080,18 @@ class DependentCode: public FixedArray {
   void RemoveCompilationInfo(DependentCode::DependencyGroup group,
                              CompilationInfo* info);
 
+  // Marks all code of the group for deoptimization and removes it from the
+  // group without deoptimizing it yet. Returns true if any code was marked.
+  bool MarkCodeForDeoptimization(Isolate* isolate,
+                                 DependentCode::DependencyGroup group);
   void DeoptimizeDependentCodeGroup(Isolate* isolate,
                                     DependentCode::DependencyGroup group);
+  // Removes all entries of the group without deoptimizing any code.
+  void ClearGroup(DependentCode::DependencyGroup group);
+
+  // Returns the dependent code of a map or an allocation site.
+  static DependentCode* ForObject(Handle<HeapObject> object,
+                                  DependencyGroup group);
 
   // The following low-level accessors should only be used by this class
   // and the mark compact collector.
@@ -7459,6 +7505,78 @@ enum AllocationSiteMode {
 };
 
 
+// An allocation site is stored in the literals array of a function for every
+// object and array literal. It holds the boilerplate of the literal and
+// gathers feedback about the copies made from it: the scavenger counts how
+// many copies carrying an allocation site info (memento) survive, and once
+// enough of them do, the site decides to allocate its copies directly in old
+// space.
+class AllocationSite: public Struct {
+ public:
+  enum PretenureDecision {
+    kUndecided = 0,
+    kDontTenure = 1,
+    kTenure = 2
+  };
+
+  // Minimum number of mementos created for a site before its survival rate
+  // is trusted, and the survival rate in percent above which it pretenures.
+  static const int kPretenureMinimumCreated = 100;
+  static const int kPretenureSurvivalPercent = 85;
+
+  DECL_ACCESSORS(boilerplate, Object)
+  DECL_ACCESSORS(dependent_code, DependentCode)
+  inline int memento_found_count();
+  inline void set_memento_found_count(int count);
+  inline int memento_create_count();
+  inline void set_memento_create_count(int count);
+  inline PretenureDecision pretenure_decision();
+  inline void set_pretenure_decision(PretenureDecision decision);
+  // Link in the list of sites encountered during marking, Smi 0 otherwise.
+  DECL_ACCESSORS(weak_next, Object)
+
+  static inline AllocationSite* cast(Object* obj);
+
+  // Dispatched behavior.
+  DECLARE_PRINTER(AllocationSite)
+  DECLARE_VERIFIER(AllocationSite)
+
+  // Copies of the boilerplate are followed by an allocation site info as
+  // long as the site gathers pretenuring feedback or array copies can still
+  // report elements kind transitions.
+  inline AllocationSiteMode GetMode();
+  inline PretenureFlag GetPretenureMode();
+
+  inline void IncrementMementoCreateCount();
+  // Counts a surviving copy. May be called from several scavenger threads
+  // at once; returns true for the first copy found since the last reset.
+  inline bool IncrementMementoFoundCount();
+
+  // Turns the counts gathered since the last scavenge into a pretenuring
+  // decision and resets them. Returns true if the site decided to tenure
+  // and dependent code has been marked for deoptimization.
+  bool DigestPretenuringFeedback();
+
+  static void AddDependentCompilationInfo(Handle<AllocationSite> site,
+                                          DependentCode::DependencyGroup group,
+                                          CompilationInfo* info);
+
+  static const int kBoilerplateOffset = HeapObject::kHeaderSize;
+  static const int kDependentCodeOffset = kBoilerplateOffset + kPointerSize;
+  static const int kMementoFoundCountOffset =
+      kDependentCodeOffset + kPointerSize;
+  static const int kMementoCreateCountOffset =
+      kMementoFoundCountOffset + kPointerSize;
+  static const int kPretenureDecisionOffset =
+      kMementoCreateCountOffset + kPointerSize;
+  static const int kWeakNextOffset = kPretenureDecisionOffset + kPointerSize;
+  static const int kSize = kWeakNextOffset + kPointerSize;
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(AllocationSite);
+};
+
+
 class AllocationSiteInfo: public Struct {
  public:
   DECL_ACCESSORS(payload, Object)
@@ -29,19 +29,47 @@
 
 #include "v8.h"
 
+#include "code-stubs.h"
+#include "deoptimizer.h"
+#include "full-codegen.h"
 #include "hydrogen.h"
 #include "isolate.h"
+#include "list-inl.h"
 #include "v8threads.h"
 
 namespace v8 {
 namespace internal {
 
 
-void OptimizingCompilerThread::Run() {
+class OptimizingCompilerThread::Worker : public Thread {
+ public:
+  explicit Worker(OptimizingCompilerThread* compiler_thread) :
+      Thread("OptimizingCompilerThread"),
+#ifdef DEBUG
+      thread_id_(0),
+#endif
+      compiler_thread_(compiler_thread),
+      time_spent_compiling_(0),
+      time_spent_total_(0) { }
+
+  void Run();
+
+#ifdef DEBUG
+  int thread_id_;
+#endif
+
+  OptimizingCompilerThread* compiler_thread_;
+  int64_t time_spent_compiling_;
+  int64_t time_spent_total_;
+};
+
+
+void OptimizingCompilerThread::Worker::Run() {
 #ifdef DEBUG
   thread_id_ = ThreadId::Current().ToInteger();
 #endif
-  Isolate::SetIsolateThreadLocals(isolate_, NULL);
+  Isolate* isolate = compiler_thread_->isolate_;
+  Isolate::SetIsolateThreadLocals(isolate, NULL);
   DisallowHeapAllocation no_allocation;
   DisallowHandleAllocation no_handles;
   DisallowHandleDereference no_deref;
@@ -50,26 +78,26 @@ void OptimizingCompilerThread::Run() {
   if (FLAG_trace_parallel_recompilation) epoch = OS::Ticks();
 
   while (true) {
-    input_queue_semaphore_->Wait();
+    compiler_thread_->input_queue_semaphore_->Wait();
     Logger::TimerEventScope timer(
-        isolate_, Logger::TimerEventScope::v8_recompile_parallel);
+        isolate, Logger::TimerEventScope::v8_recompile_parallel);
 
     if (FLAG_parallel_recompilation_delay != 0) {
       OS::Sleep(FLAG_parallel_recompilation_delay);
     }
 
-    if (Acquire_Load(&stop_thread_)) {
-      stop_semaphore_->Signal();
+    if (Acquire_Load(&compiler_thread_->stop_thread_)) {
       if (FLAG_trace_parallel_recompilation) {
         time_spent_total_ = OS::Ticks() - epoch;
       }
+      compiler_thread_->stop_semaphore_->Signal();
       return;
     }
 
     int64_t compiling_start = 0;
     if (FLAG_trace_parallel_recompilation) compiling_start = OS::Ticks();
 
-    CompileNext();
+    compiler_thread_->CompileNext();
 
     if (FLAG_trace_parallel_recompilation) {
       time_spent_compiling_ += OS::Ticks() - compiling_start;
@@ -78,32 +106,76 @@ void OptimizingCompilerThread::Run() {
 }
 
 
+OptimizingCompilerThread::~OptimizingCompilerThread() {
+  ASSERT(workers_ == NULL);
+  delete output_queue_mutex_;
+  delete input_queue_mutex_;
+  delete input_queue_semaphore_;
+  delete stop_semaphore_;
+}
+
+
+void OptimizingCompilerThread::Start(int number_of_workers) {
+  ASSERT(number_of_workers > 0);
+  ASSERT(workers_ == NULL);
+  number_of_workers_ = number_of_workers;
+  workers_ = new Worker*[number_of_workers_];
+  for (int i = 0; i < number_of_workers_; i++) {
+    workers_[i] = new Worker(this);
+    workers_[i]->Start();
+  }
+}
+
+
 void OptimizingCompilerThread::CompileNext() {
   OptimizingCompiler* optimizing_compiler = NULL;
-  input_queue_.Dequeue(&optimizing_compiler);
+  { ScopedLock lock(input_queue_mutex_);
+    ASSERT(!input_queue_.is_empty());
+    int hottest = 0;
+    for (int i = 1; i < input_queue_.length(); i++) {
+      if (input_queue_[i].priority > input_queue_[hottest].priority) {
+        hottest = i;
+      }
+    }
+    optimizing_compiler = input_queue_.Remove(hottest).compiler;
+  }
   Barrier_AtomicIncrement(&queue_length_, static_cast<Atomic32>(-1));
 
-  // The function may have already been optimized by OSR.  Simply continue.
-  OptimizingCompiler::Status status = optimizing_compiler->OptimizeGraph();
-  USE(status);   // Prevent an unused-variable error in release mode.
-  ASSERT(status != OptimizingCompiler::FAILED);
+  // A map the graph depends on may have changed while the function was
+  // queued, in which case the code would be deoptimized right away.  Do not
+  // waste time on the stale job, InstallOptimizedCode drops it.
+  if (!optimizing_compiler->info()->HasAbortedDueToDependentMap()) {
+    OptimizingCompiler::Status status = optimizing_compiler->OptimizeGraph();
+    USE(status);   // Prevent an unused-variable error in release mode.
+    ASSERT(status != OptimizingCompiler::FAILED);
+  }
 
   // The function may have already been optimized by OSR.  Simply continue.
   // Mark it for installing before queuing so that we can be sure of the write
   // order: marking first and (after being queued) installing code second.
-  { Heap::RelocationLock relocation_lock(isolate_->heap());
+  // On-stack replacement jobs leave the function alone.
+  if (optimizing_compiler->info()->osr_ast_id().IsNone()) {
+    Heap::RelocationLock relocation_lock(isolate_->heap());
     AllowHandleDereference ahd;
     optimizing_compiler->info()->closure()->MarkForInstallingRecompiledCode();
   }
-  output_queue_.Enqueue(optimizing_compiler);
+  { ScopedLock lock(output_queue_mutex_);
+    output_queue_.Enqueue(optimizing_compiler);
+  }
+  isolate_->stack_guard()->RequestInstallCode();
 }
 
 
 void OptimizingCompilerThread::Stop() {
   ASSERT(!IsOptimizerThread());
+  if (workers_ == NULL) return;
   Release_Store(&stop_thread_, static_cast<AtomicWord>(true));
-  input_queue_semaphore_->Signal();
-  stop_semaphore_->Wait();
+  for (int i = 0; i < number_of_workers_; i++) {
+    input_queue_semaphore_->Signal();
+  }
+  for (int i = 0; i < number_of_workers_; i++) {
+    stop_semaphore_->Wait();
+  }
 
   if (FLAG_parallel_recompilation_delay != 0) {
     InstallOptimizedFunctions();
@@ -115,11 +187,23 @@ void OptimizingCompilerThread::Stop() {
     }
   }
 
+  int64_t time_spent_compiling = 0;
+  int64_t time_spent_total = 0;
+  for (int i = 0; i < number_of_workers_; i++) {
+    workers_[i]->Join();
+    time_spent_compiling += workers_[i]->time_spent_compiling_;
+    time_spent_total += workers_[i]->time_spent_total_;
+    delete workers_[i];
+  }
+  delete[] workers_;
+  workers_ = NULL;
+  number_of_workers_ = 0;
+
   if (FLAG_trace_parallel_recompilation) {
-    double compile_time = static_cast<double>(time_spent_compiling_);
-    double total_time = static_cast<double>(time_spent_total_);
+    double compile_time = static_cast<double>(time_spent_compiling);
+    double total_time = static_cast<double>(time_spent_total);
     double percentage = (compile_time * 100) / total_time;
-    PrintF("  ** Compiler thread did %.2f%% useful work\n", percentage);
+    PrintF("  ** Compiler threads did %.2f%% useful work\n", percentage);
   }
 }
 
@@ -131,27 +215,134 @@ void OptimizingCompilerThread::InstallOptimizedFunctions() {
   while (!output_queue_.IsEmpty()) {
     OptimizingCompiler* compiler;
     output_queue_.Dequeue(&compiler);
-    Compiler::InstallOptimizedCode(compiler);
+    if (compiler->info()->osr_ast_id().IsNone()) {
+      Compiler::InstallOptimizedCode(compiler);
+    } else {
+      OnStackReplacementReady(compiler);
+    }
     functions_installed++;
   }
+  if (FLAG_trace_parallel_recompilation && functions_installed > 0) {
+    PrintF("  ** Installed %d function(s).\n", functions_installed);
+  }
 }
 
 
 void OptimizingCompilerThread::QueueForOptimization(
-    OptimizingCompiler* optimizing_compiler) {
+    OptimizingCompiler* optimizing_compiler,
+    int priority) {
   ASSERT(IsQueueAvailable());
   ASSERT(!IsOptimizerThread());
   Barrier_AtomicIncrement(&queue_length_, static_cast<Atomic32>(1));
-  optimizing_compiler->info()->closure()->MarkInRecompileQueue();
-  input_queue_.Enqueue(optimizing_compiler);
+  if (optimizing_compiler->info()->osr_ast_id().IsNone()) {
+    optimizing_compiler->info()->closure()->MarkInRecompileQueue();
+  } else {
+    OsrJob job = { optimizing_compiler, false };
+    osr_jobs_.Add(job);
+  }
+  { ScopedLock lock(input_queue_mutex_);
+    RecompileJob job = { optimizing_compiler, priority };
+    input_queue_.Add(job);
+  }
   input_queue_semaphore_->Signal();
 }
 
 
+bool OptimizingCompilerThread::IsQueuedForOnStackReplacement(
+    JSFunction* function) {
+  ASSERT(!IsOptimizerThread());
+  for (int i = 0; i < osr_jobs_.length(); i++) {
+    if (*osr_jobs_[i].compiler->info()->closure() == function) return true;
+  }
+  return false;
+}
+
+
+OptimizingCompiler* OptimizingCompilerThread::FindReadyOnStackReplacement(
+    JSFunction* function, BailoutId ast_id) {
+  ASSERT(!IsOptimizerThread());
+  for (int i = 0; i < osr_jobs_.length(); i++) {
+    CompilationInfo* info = osr_jobs_[i].compiler->info();
+    if (osr_jobs_[i].ready &&
+        *info->closure() == function &&
+        info->osr_ast_id() == ast_id) {
+      return osr_jobs_.Remove(i).compiler;
+    }
+  }
+  return NULL;
+}
+
+
+void OptimizingCompilerThread::OnStackReplacementReady(
+    OptimizingCompiler* compiler) {
+  int ready_jobs = 0;
+  for (int i = 0; i < osr_jobs_.length(); i++) {
+    if (osr_jobs_[i].compiler == compiler) osr_jobs_[i].ready = true;
+    if (osr_jobs_[i].ready) ready_jobs++;
+  }
+  for (int i = 0; ready_jobs > kMaxReadyOsrJobs; i++) {
+    if (!osr_jobs_[i].ready || osr_jobs_[i].compiler == compiler) continue;
+    CompilationInfo* info = osr_jobs_.Remove(i--).compiler->info();
+    if (FLAG_trace_osr) {
+      PrintF("[dropping on-stack replacement code for ");
+      info->closure()->PrintName();
+      PrintF("]\n");
+    }
+    // Releases the zone the compiler lives in.
+    delete info;
+    ready_jobs--;
+  }
+
+  // Patch the back edges down to the depth of the loop the job was compiled
+  // for, the same way the runtime profiler patches them level by level.
+  CompilationInfo* info = compiler->info();
+  Handle<Code> unoptimized(info->shared_info()->code(), isolate_);
+  if (unoptimized->kind() != Code::FUNCTION) return;
+  Address back_edge_cursor = unoptimized->instruction_start() +
+      unoptimized->back_edge_table_offset();
+  uint32_t table_length = Memory::uint32_at(back_edge_cursor);
+  back_edge_cursor += kIntSize;
+  int loop_depth = 0;
+  for (uint32_t i = 0; i < table_length; ++i) {
+    uint32_t ast_id = Memory::uint32_at(back_edge_cursor);
+    if (BailoutId(static_cast<int>(ast_id)) == info->osr_ast_id()) {
+      loop_depth = Memory::uint8_at(back_edge_cursor + 2 * kIntSize);
+      break;
+    }
+    back_edge_cursor += FullCodeGenerator::kBackEdgeEntrySize;
+  }
+  if (loop_depth == 0) return;
+
+  if (FLAG_trace_osr) {
+    PrintF("[patching back edges in ");
+    info->closure()->PrintName();
+    PrintF(" for ready on-stack replacement code]\n");
+  }
+  InterruptStub interrupt_stub;
+  Handle<Code> interrupt_code = interrupt_stub.GetCode(isolate_);
+  Handle<Code> replacement_code = isolate_->builtins()->OnStackReplacement();
+  if (unoptimized->back_edges_patched_for_osr()) {
+    Deoptimizer::RevertInterruptCode(*unoptimized,
+                                     *interrupt_code,
+                                     *replacement_code);
+  }
+  for (int depth = 1; depth <= loop_depth; depth++) {
+    unoptimized->set_allow_osr_at_loop_nesting_level(depth);
+    Deoptimizer::PatchInterruptCode(*unoptimized,
+                                    *interrupt_code,
+                                    *replacement_code);
+  }
+}
+
+
 #ifdef DEBUG
 bool OptimizingCompilerThread::IsOptimizerThread() {
   if (!FLAG_parallel_recompilation) return false;
-  return ThreadId::Current().ToInteger() == thread_id_;
+  int thread_id = ThreadId::Current().ToInteger();
+  for (int i = 0; i < number_of_workers_; i++) {
+    if (workers_[i]->thread_id_ == thread_id) return true;
+  }
+  return false;
 }
 #endif
 
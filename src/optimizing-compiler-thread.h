@@ -30,38 +30,53 @@
 
 #include "atomicops.h"
 #include "flags.h"
+#include "list.h"
 #include "platform.h"
 #include "unbound-queue.h"
+#include "utils.h"
 
 namespace v8 {
 namespace internal {
 
 class HOptimizedGraphBuilder;
+class JSFunction;
 class OptimizingCompiler;
 class SharedFunctionInfo;
 
-class OptimizingCompilerThread : public Thread {
+// Optimizes the graphs created on the main thread on a pool of
+// --recompilation-threads worker threads.  Queued functions are compiled
+// hottest first.  Finished functions are installed in batches when the main
+// thread handles the INSTALL_CODE interrupt the workers request.
+class OptimizingCompilerThread {
  public:
   explicit OptimizingCompilerThread(Isolate *isolate) :
-      Thread("OptimizingCompilerThread"),
-#ifdef DEBUG
-      thread_id_(0),
-#endif
       isolate_(isolate),
+      workers_(NULL),
+      number_of_workers_(0),
       stop_semaphore_(OS::CreateSemaphore(0)),
       input_queue_semaphore_(OS::CreateSemaphore(0)),
-      time_spent_compiling_(0),
-      time_spent_total_(0) {
+      input_queue_mutex_(OS::CreateMutex()),
+      output_queue_mutex_(OS::CreateMutex()) {
     NoBarrier_Store(&stop_thread_, static_cast<AtomicWord>(false));
     NoBarrier_Store(&queue_length_, static_cast<AtomicWord>(0));
   }
 
-  void Run();
+  void Start(int number_of_workers);
   void Stop();
   void CompileNext();
-  void QueueForOptimization(OptimizingCompiler* optimizing_compiler);
+  // The priority is the number of profiler ticks the function had when it
+  // was queued.  Jobs with equal priority are compiled in queue order.
+  void QueueForOptimization(OptimizingCompiler* optimizing_compiler,
+                            int priority);
   void InstallOptimizedFunctions();
 
+  // On-stack replacement jobs are not installed into their function.  Once
+  // one is ready the back edges of the unoptimized code are patched again,
+  // and the loop picks the job up at its next back edge.
+  bool IsQueuedForOnStackReplacement(JSFunction* function);
+  OptimizingCompiler* FindReadyOnStackReplacement(JSFunction* function,
+                                                  BailoutId ast_id);
+
   inline bool IsQueueAvailable() {
     // We don't need a barrier since we have a data dependency right
     // after.
@@ -80,25 +95,45 @@ class OptimizingCompilerThread : public Thread {
   bool IsOptimizerThread();
 #endif
 
-  ~OptimizingCompilerThread() {
-    delete input_queue_semaphore_;
-    delete stop_semaphore_;
-  }
+  ~OptimizingCompilerThread();
 
  private:
-#ifdef DEBUG
-  int thread_id_;
-#endif
+  class Worker;
+
+  struct RecompileJob {
+    OptimizingCompiler* compiler;
+    int priority;
+  };
+
+  struct OsrJob {
+    OptimizingCompiler* compiler;
+    bool ready;
+  };
+
+  // Ready jobs whose back edge is never reached again are dropped, oldest
+  // first, beyond this number.
+  static const int kMaxReadyOsrJobs = 4;
+
+  void OnStackReplacementReady(OptimizingCompiler* compiler);
 
   Isolate* isolate_;
+  Worker** workers_;
+  int number_of_workers_;
   Semaphore* stop_semaphore_;
   Semaphore* input_queue_semaphore_;
-  UnboundQueue<OptimizingCompiler*> input_queue_;
+  // The input queue is short (--parallel-recompilation-queue-length), so
+  // it is kept unsorted and searched for the hottest job on dequeue.
+  Mutex* input_queue_mutex_;
+  List<RecompileJob> input_queue_;
+  // Serializes the workers, the main thread is the only consumer.
+  Mutex* output_queue_mutex_;
   UnboundQueue<OptimizingCompiler*> output_queue_;
+  // Accessed by the main thread only.
+  List<OsrJob> osr_jobs_;
   volatile AtomicWord stop_thread_;
   volatile Atomic32 queue_length_;
-  int64_t time_spent_compiling_;
-  int64_t time_spent_total_;
+
+  friend class Worker;
 };
 
 } }  // namespace v8::internal
@@ -0,0 +1,509 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "v8.h"
+
+#include "parallel-scavenger.h"
+
+#include "codegen.h"
+#include "heap.h"
+#include "objects-visiting.h"
+#include "objects-visiting-inl.h"
+#include "scavenger-thread.h"
+#include "store-buffer.h"
+
+namespace v8 {
+namespace internal {
+
+
+Thread::LocalStorageKey ParallelScavenger::current_task_key_;
+
+
+// Visits the bodies of objects copied within new space.  Like the
+// NewSpaceScavenger of the serial scavenger it skips weak fields, but the
+// objects are evacuated by the task running on the current thread.
+class ParallelNewSpaceScavenger
+    : public StaticNewSpaceVisitor<ParallelNewSpaceScavenger> {
+ public:
+  static inline void VisitPointer(Heap* heap, Object** p) {
+    Object* object = *p;
+    if (!heap->InFromSpace(object)) return;
+    ParallelScavenger::CurrentTask()->ScavengeOwnedSlot(
+        p, HeapObject::cast(object));
+  }
+
+  static inline void VisitPointers(Heap* heap, Object** start, Object** end) {
+    ScavengeTask* task = ParallelScavenger::CurrentTask();
+    for (Object** p = start; p < end; p++) {
+      Object* object = *p;
+      if (heap->InFromSpace(object)) {
+        task->ScavengeOwnedSlot(p, HeapObject::cast(object));
+      }
+    }
+  }
+};
+
+
+// Visitor for the roots, which are only ever visited by the main thread.
+class ParallelScavengeRootVisitor : public ObjectVisitor {
+ public:
+  ParallelScavengeRootVisitor(Heap* heap, ScavengeTask* task)
+      : heap_(heap), task_(task) { }
+
+  void VisitPointer(Object** p) { ScavengePointer(p); }
+
+  void VisitPointers(Object** start, Object** end) {
+    for (Object** p = start; p < end; p++) ScavengePointer(p);
+  }
+
+ private:
+  void ScavengePointer(Object** p) {
+    Object* object = *p;
+    if (!heap_->InFromSpace(object)) return;
+    task_->ScavengeOwnedSlot(p, HeapObject::cast(object));
+  }
+
+  Heap* heap_;
+  ScavengeTask* task_;
+};
+
+
+ScavengeTask::ScavengeTask()
+    : scavenger_(NULL),
+      heap_(NULL),
+      copied_bytes_(0),
+      promoted_bytes_(0),
+      scanned_slots_(0),
+      time_(0.0) {
+}
+
+
+void ScavengeTask::Initialize(ParallelScavenger* scavenger, Heap* heap) {
+  ASSERT(copied_objects_.is_empty());
+  ASSERT(promoted_objects_.is_empty());
+  ASSERT(old_to_new_slots_.is_empty());
+  scavenger_ = scavenger;
+  heap_ = heap;
+  to_space_buffer_.Initialize(heap, NEW_SPACE);
+  old_pointer_space_buffer_.Initialize(heap, OLD_POINTER_SPACE);
+  old_data_space_buffer_.Initialize(heap, OLD_DATA_SPACE);
+  copied_bytes_ = 0;
+  promoted_bytes_ = 0;
+  scanned_slots_ = 0;
+  time_ = 0.0;
+}
+
+
+void ScavengeTask::ScavengeOwnedSlot(Object** slot, HeapObject* object) {
+  ASSERT(heap_->InFromSpace(object));
+  *slot = ForwardObject(object);
+}
+
+
+void ScavengeTask::ScavengeSharedSlot(Object** slot) {
+  scanned_slots_++;
+  Object* object = *slot;
+  if (!heap_->InFromSpace(object)) return;
+  HeapObject* target = ForwardObject(HeapObject::cast(object));
+  // If the slot no longer holds the old value, another task has either
+  // updated it already or the slot belonged to a dead object whose memory
+  // was reused for a promoted object.  In the latter case the promoted
+  // object is scanned by the task that copied it, so there is nothing left
+  // to do here.
+  NoBarrier_CompareAndSwap(reinterpret_cast<AtomicWord*>(slot),
+                           reinterpret_cast<AtomicWord>(object),
+                           reinterpret_cast<AtomicWord>(target));
+}
+
+
+HeapObject* ScavengeTask::ForwardObject(HeapObject* object) {
+  MapWord map_word = object->map_word();
+  if (map_word.IsForwardingAddress()) {
+    return map_word.ToForwardingAddress();
+  }
+  return EvacuateObject(object, map_word.ToMap());
+}
+
+
+static HeapObject* EnsureDoubleAligned(Heap* heap,
+                                       HeapObject* object,
+                                       int size) {
+  if ((OffsetFrom(object->address()) & kDoubleAlignmentMask) != 0) {
+    heap->CreateFillerObjectAt(object->address(), kPointerSize);
+    return HeapObject::FromAddress(object->address() + kPointerSize);
+  } else {
+    heap->CreateFillerObjectAt(object->address() + size - kPointerSize,
+                               kPointerSize);
+    return object;
+  }
+}
+
+
+HeapObject* ScavengeTask::EvacuateObject(HeapObject* object, Map* map) {
+  if (map->visitor_id() == StaticVisitorBase::kVisitShortcutCandidate &&
+      ConsString::cast(object)->unchecked_second() == heap_->empty_string()) {
+    return EvacuateShortcutCandidate(object, map);
+  }
+
+  InstanceType type = map->instance_type();
+  int object_size = object->SizeFromMap(map);
+  int allocation_size = object_size;
+  bool needs_alignment = (kDoubleAlignment != kObjectAlignment) &&
+      (type == FIXED_DOUBLE_ARRAY_TYPE);
+  if (needs_alignment) allocation_size += kPointerSize;
+
+  AllocationSpace old_space = heap_->TargetSpaceId(type);
+  if (allocation_size > Page::kMaxNonCodeHeapObjectSize) old_space = LO_SPACE;
+
+  AllocationSpace target_space = NEW_SPACE;
+  HeapObject* allocation = NULL;
+  if (heap_->ShouldBePromoted(object->address(), object_size)) {
+    target_space = old_space;
+    allocation = Allocate(old_space, allocation_size);
+  }
+  if (allocation == NULL) {
+    target_space = NEW_SPACE;
+    allocation = Allocate(NEW_SPACE, allocation_size);
+  }
+  if (allocation == NULL) {
+    // The space lost at the end of the allocation buffers can make
+    // to-space overflow if almost everything survives.  Promote instead.
+    target_space = old_space;
+    allocation = Allocate(old_space, allocation_size);
+    if (allocation == NULL) {
+      V8::FatalProcessOutOfMemory("ParallelScavenger::EvacuateObject");
+    }
+  }
+
+  HeapObject* target = allocation;
+  if (needs_alignment) {
+    target = EnsureDoubleAligned(heap_, allocation, allocation_size);
+  }
+  heap_->CopyBlock(target->address(), object->address(), object_size);
+  target->set_map_no_write_barrier(map);
+
+  if (!object->compare_and_swap_map_word(
+          MapWord::FromMap(map), MapWord::FromForwardingAddress(target))) {
+    // Another task evacuated the object first.  Turn our copy into a filler
+    // so the spaces stay iterable and use the winner's copy.  A large object
+    // page holding only a filler would stay until the next mark-compact, so
+    // release it instead.
+    if (target_space == LO_SPACE) {
+      ScopedLock lock(scavenger_->allocation_mutex());
+      heap_->lo_space()->FreeUnusedObject(allocation);
+    } else {
+      heap_->CreateFillerObjectAt(allocation->address(), allocation_size);
+    }
+    return object->map_word().ToForwardingAddress();
+  }
+  heap_->UpdateAllocationSiteFeedback(object, map);
+
+  if (target_space == NEW_SPACE) {
+    copied_objects_.Add(Entry(target, object_size));
+    copied_bytes_ += object_size;
+  } else {
+    if (heap_->TargetSpaceId(type) == OLD_POINTER_SPACE) {
+      int size_to_scan = (type == JS_FUNCTION_TYPE)
+          ? JSFunction::kNonWeakFieldsEndOffset
+          : object_size;
+      promoted_objects_.Add(Entry(target, size_to_scan));
+    }
+    promoted_bytes_ += object_size;
+  }
+  return target;
+}
+
+
+HeapObject* ScavengeTask::EvacuateShortcutCandidate(HeapObject* object,
+                                                    Map* map) {
+  HeapObject* first =
+      HeapObject::cast(ConsString::cast(object)->unchecked_first());
+  HeapObject* target = first;
+  if (heap_->InFromSpace(first)) target = ForwardObject(first);
+
+  if (!object->compare_and_swap_map_word(
+          MapWord::FromMap(map), MapWord::FromForwardingAddress(target))) {
+    return object->map_word().ToForwardingAddress();
+  }
+  return target;
+}
+
+
+HeapObject* ScavengeTask::Allocate(AllocationSpace space, int size_in_bytes) {
+  Object* result;
+  if (space == LO_SPACE) {
+    ScopedLock lock(scavenger_->allocation_mutex());
+    MaybeObject* maybe_result =
+        heap_->lo_space()->AllocateRaw(size_in_bytes, NOT_EXECUTABLE);
+    if (!maybe_result->ToObject(&result)) return NULL;
+    return HeapObject::cast(result);
+  }
+  LocalAllocationBuffer* buffer;
+  switch (space) {
+    case NEW_SPACE:
+      buffer = &to_space_buffer_;
+      break;
+    case OLD_POINTER_SPACE:
+      buffer = &old_pointer_space_buffer_;
+      break;
+    case OLD_DATA_SPACE:
+      buffer = &old_data_space_buffer_;
+      break;
+    default:
+      UNREACHABLE();
+      return NULL;
+  }
+  HeapObject* object = buffer->AllocateLinearly(size_in_bytes);
+  if (object != NULL) return object;
+  ScopedLock lock(scavenger_->allocation_mutex());
+  if (!buffer->SlowAllocateRaw(size_in_bytes)->ToObject(&result)) return NULL;
+  return HeapObject::cast(result);
+}
+
+
+void ScavengeTask::ScanPromotedObject(HeapObject* object, int size) {
+  Address slot_address = object->address();
+  Address end = slot_address + size;
+  for (; slot_address < end; slot_address += kPointerSize) {
+    Object** slot = reinterpret_cast<Object**>(slot_address);
+    Object* value = *slot;
+    if (!heap_->InFromSpace(value)) continue;
+    HeapObject* target = ForwardObject(HeapObject::cast(value));
+    *slot = target;
+    if (heap_->InNewSpace(target)) old_to_new_slots_.Add(slot_address);
+  }
+}
+
+
+void ScavengeTask::ProcessWorkLists() {
+  while (!copied_objects_.is_empty() || !promoted_objects_.is_empty()) {
+    while (!copied_objects_.is_empty()) {
+      HeapObject* object = copied_objects_.RemoveLast().object_;
+      ParallelNewSpaceScavenger::IterateBody(object->map(), object);
+    }
+    while (!promoted_objects_.is_empty()) {
+      Entry entry = promoted_objects_.RemoveLast();
+      ScanPromotedObject(entry.object_, entry.size_);
+    }
+  }
+}
+
+
+void ScavengeTask::Finalize() {
+  ASSERT(copied_objects_.is_empty());
+  ASSERT(promoted_objects_.is_empty());
+  to_space_buffer_.Close();
+  old_pointer_space_buffer_.Close();
+  old_data_space_buffer_.Close();
+
+  StoreBuffer* store_buffer = heap_->store_buffer();
+  for (int i = 0; i < old_to_new_slots_.length(); i++) {
+    store_buffer->EnterDirectlyIntoStoreBuffer(old_to_new_slots_[i]);
+  }
+  old_to_new_slots_.Clear();
+  copied_objects_.Clear();
+  promoted_objects_.Clear();
+}
+
+
+ParallelScavenger::ParallelScavenger(Heap* heap)
+    : heap_(heap),
+      allocation_mutex_(OS::CreateMutex()),
+      tasks_(NULL),
+      next_chunk_(0) {
+}
+
+
+void ParallelScavenger::Initialize() {
+  current_task_key_ = Thread::CreateThreadLocalKey();
+  ParallelNewSpaceScavenger::Initialize();
+}
+
+
+void ParallelScavenger::TearDown() {
+  delete[] tasks_;
+  tasks_ = NULL;
+  delete allocation_mutex_;
+  allocation_mutex_ = NULL;
+}
+
+
+bool ParallelScavenger::CanScavengeInParallel() {
+  return FLAG_parallel_scavenge &&
+      heap_->isolate()->scavenger_threads() != NULL &&
+      !heap_->incremental_marking()->IsMarking() &&
+      !heap_->IsLoggingOrProfiling();
+}
+
+
+bool ParallelScavenger::ReserveOldSpace(intptr_t new_space_size) {
+  intptr_t size = LocalAllocationBuffer::MaxWaste(new_space_size) +
+      task_count() * LocalAllocationBuffer::kSize;
+  return heap_->paged_space(OLD_POINTER_SPACE)->EnsureAvailable(size) &&
+      heap_->paged_space(OLD_DATA_SPACE)->EnsureAvailable(size);
+}
+
+
+void ParallelScavenger::RecordSlot(HeapObject** slot, HeapObject* object) {
+  ASSERT(object->GetHeap()->InFromSpace(object));
+  object->GetHeap()->parallel_scavenger()->slots_.Add(
+      reinterpret_cast<Object**>(slot));
+}
+
+
+void ParallelScavenger::RecordSlots(Object** start, Object** end) {
+  for (Object** p = start; p < end; p++) {
+    if (heap_->InFromSpace(*p)) slots_.Add(p);
+  }
+}
+
+
+void ParallelScavenger::RecordSlotsInCells() {
+  HeapObjectIterator cell_iterator(heap_->cell_space());
+  for (HeapObject* heap_object = cell_iterator.Next();
+       heap_object != NULL;
+       heap_object = cell_iterator.Next()) {
+    if (heap_object->IsCell()) {
+      Address value_address = Cell::cast(heap_object)->ValueAddress();
+      Object** value_slot = reinterpret_cast<Object**>(value_address);
+      RecordSlots(value_slot, value_slot + 1);
+    }
+  }
+
+  HeapObjectIterator property_cell_iterator(heap_->property_cell_space());
+  for (HeapObject* heap_object = property_cell_iterator.Next();
+       heap_object != NULL;
+       heap_object = property_cell_iterator.Next()) {
+    if (heap_object->IsJSGlobalPropertyCell()) {
+      JSGlobalPropertyCell* cell = JSGlobalPropertyCell::cast(heap_object);
+      Object** value_slot = reinterpret_cast<Object**>(cell->ValueAddress());
+      RecordSlots(value_slot, value_slot + 1);
+      Object** type_slot = reinterpret_cast<Object**>(cell->TypeAddress());
+      RecordSlots(type_slot, type_slot + 1);
+    }
+  }
+}
+
+
+void ParallelScavenger::ScavengeRoots(ScavengeTask* task) {
+  Thread::SetThreadLocal(current_task_key_, task);
+  ParallelScavengeRootVisitor root_visitor(heap_, task);
+  heap_->IterateRoots(&root_visitor, VISIT_ALL_IN_SCAVENGE);
+  task->ProcessWorkLists();
+  Thread::SetThreadLocal(current_task_key_, NULL);
+}
+
+
+void ParallelScavenger::Scavenge() {
+  double start_time = OS::TimeCurrentMillis();
+
+  // Collect the slots in the old generation that point into from-space.
+  // The slots are not updated here, so they are all entered into the store
+  // buffer again.  Entries that end up pointing into old space are filtered
+  // out by the next scavenge.
+  {
+    StoreBufferRebuildScope scope(heap_,
+                                  heap_->store_buffer(),
+                                  &Heap::ScavengeStoreBufferCallback);
+    heap_->store_buffer()->IteratePointersToNewSpace(&RecordSlot);
+  }
+  RecordSlotsInCells();
+
+  if (tasks_ == NULL) tasks_ = new ScavengeTask[task_count()];
+  for (int i = 0; i < task_count(); i++) {
+    tasks_[i].Initialize(this, heap_);
+  }
+  NoBarrier_Store(&next_chunk_, 0);
+
+  ScavengerThread** threads = heap_->isolate()->scavenger_threads();
+  for (int i = 0; i < FLAG_scavenger_threads; i++) {
+    threads[i]->StartScavenging();
+  }
+
+  ScavengeRoots(&tasks_[0]);
+  ScavengeInParallel(0);
+
+  for (int i = 0; i < FLAG_scavenger_threads; i++) {
+    threads[i]->WaitForScavengerThread();
+  }
+
+  {
+    StoreBufferRebuildScope scope(heap_,
+                                  heap_->store_buffer(),
+                                  &Heap::ScavengeStoreBufferCallback);
+    for (int i = 0; i < task_count(); i++) {
+      tasks_[i].Finalize();
+      heap_->tracer()->increment_promoted_objects_size(
+          static_cast<int>(tasks_[i].promoted_bytes()));
+    }
+  }
+
+  if (FLAG_trace_parallel_scavenge) {
+    PrintStatistics(OS::TimeCurrentMillis() - start_time);
+  }
+  slots_.Clear();
+}
+
+
+void ParallelScavenger::ScavengeInParallel(int task_id) {
+  double start_time = OS::TimeCurrentMillis();
+  ScavengeTask* task = &tasks_[task_id];
+  Thread::SetThreadLocal(current_task_key_, task);
+
+  int slot_count = slots_.length();
+  while (true) {
+    int chunk = NoBarrier_AtomicIncrement(&next_chunk_, 1) - 1;
+    int start = chunk * kSlotsPerChunk;
+    if (start >= slot_count) break;
+    int end = Min(start + kSlotsPerChunk, slot_count);
+    for (int i = start; i < end; i++) {
+      task->ScavengeSharedSlot(slots_[i]);
+    }
+    task->ProcessWorkLists();
+  }
+  task->ProcessWorkLists();
+
+  Thread::SetThreadLocal(current_task_key_, NULL);
+  task->set_time(OS::TimeCurrentMillis() - start_time);
+}
+
+
+void ParallelScavenger::PrintStatistics(double time) {
+  PrintF("parallel scavenge: %.1f ms, %d old-to-new slots\n",
+         time, slots_.length());
+  for (int i = 0; i < task_count(); i++) {
+    PrintF("  task %d: %.1f ms, %d slots, copied %" V8_PTR_PREFIX "d, "
+           "promoted %" V8_PTR_PREFIX "d\n",
+           i,
+           tasks_[i].time(),
+           tasks_[i].scanned_slots(),
+           tasks_[i].copied_bytes(),
+           tasks_[i].promoted_bytes());
+  }
+}
+
+} }  // namespace v8::internal
@@ -0,0 +1,199 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef V8_PARALLEL_SCAVENGER_H_
+#define V8_PARALLEL_SCAVENGER_H_
+
+#include "allocation.h"
+#include "atomicops.h"
+#include "flags.h"
+#include "list.h"
+#include "platform.h"
+#include "spaces.h"
+
+namespace v8 {
+namespace internal {
+
+// Forward declarations.
+class Heap;
+class HeapObject;
+class Map;
+class Object;
+class ParallelScavenger;
+
+
+// The state of a single participant of a parallel scavenge.  Every task owns
+// local allocation buffers in to-space and in the old generation, so
+// copying objects does not need any synchronization apart from installing
+// the forwarding address in the map word of the evacuated object.  Objects
+// copied by a task are recorded on its own work lists and are scanned by the
+// same task, which replaces the shared PromotionQueue and the to-space scan
+// pointer of the serial scavenger.
+class ScavengeTask {
+ public:
+  ScavengeTask();
+
+  void Initialize(ParallelScavenger* scavenger, Heap* heap);
+
+  // Scavenges the object referenced from a slot that is owned by this task
+  // (a root or a field of an object copied by this task).
+  inline void ScavengeOwnedSlot(Object** slot, HeapObject* object);
+
+  // Scavenges the object referenced from a slot in the old generation.  Such
+  // slots can be visited by several tasks, so the slot is updated with an
+  // atomic compare-and-swap.
+  void ScavengeSharedSlot(Object** slot);
+
+  // Scans the objects this task copied until its work lists are empty.
+  void ProcessWorkLists();
+
+  // Returns the unused parts of the allocation buffers to their spaces and
+  // enters the recorded old-to-new slots into the store buffer.  Called by
+  // the main thread after all tasks are done.
+  void Finalize();
+
+  intptr_t copied_bytes() { return copied_bytes_; }
+  intptr_t promoted_bytes() { return promoted_bytes_; }
+  int scanned_slots() { return scanned_slots_; }
+  double time() { return time_; }
+  void set_time(double time) { time_ = time; }
+
+ private:
+  struct Entry {
+    Entry(HeapObject* object, int size) : object_(object), size_(size) { }
+    HeapObject* object_;
+    int size_;
+  };
+
+  // Copies the object to to-space or promotes it and returns the address of
+  // the copy.  If another task evacuated the object first, the copy made by
+  // this task is discarded and the winner's copy is returned.
+  HeapObject* EvacuateObject(HeapObject* object, Map* map);
+  HeapObject* EvacuateShortcutCandidate(HeapObject* object, Map* map);
+  inline HeapObject* ForwardObject(HeapObject* object);
+
+  HeapObject* Allocate(AllocationSpace space, int size_in_bytes);
+
+  // Scans a promoted object for pointers into from-space and records the
+  // slots that still point into new space afterwards.
+  void ScanPromotedObject(HeapObject* object, int size);
+
+  ParallelScavenger* scavenger_;
+  Heap* heap_;
+
+  LocalAllocationBuffer to_space_buffer_;
+  LocalAllocationBuffer old_pointer_space_buffer_;
+  LocalAllocationBuffer old_data_space_buffer_;
+
+  // Objects copied within new space that still have to be scanned.
+  List<Entry> copied_objects_;
+  // Promoted pointer objects that still have to be scanned.
+  List<Entry> promoted_objects_;
+  // Slots of promoted objects that point into to-space.
+  List<Address> old_to_new_slots_;
+
+  intptr_t copied_bytes_;
+  intptr_t promoted_bytes_;
+  int scanned_slots_;
+  double time_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScavengeTask);
+};
+
+
+// Performs the copying phase of a scavenge with the main thread and all
+// ScavengerThreads.  Roots are scanned by the main thread, while slots in the
+// old generation (from the store buffer and from cells) are collected first
+// and then handed out to all tasks in chunks.  The serial parts of
+// Heap::Scavenge (weak handles, object groups, external strings, ...) run
+// afterwards and pick up where the parallel phase stopped.
+class ParallelScavenger {
+ public:
+  explicit ParallelScavenger(Heap* heap);
+
+  static void Initialize();
+
+  void TearDown();
+
+  // Returns true if the current scavenge can use the parallel phase.  Falls
+  // back to the serial scavenger while incremental marking is active, since
+  // the marking state of copied objects would have to be transferred.
+  bool CanScavengeInParallel();
+
+  // The tasks cannot expand the old generation.  Makes room there for the
+  // survivors of a new space of the given size that do not fit into
+  // to-space because of the memory lost at the ends of the to-space
+  // buffers.  Returns false if the old generation cannot grow that far.
+  bool ReserveOldSpace(intptr_t new_space_size);
+
+  // Runs the parallel phase on the main thread.  Afterwards every object
+  // reachable from the roots and from the old generation has been copied and
+  // all copies have been scanned.
+  void Scavenge();
+
+  // Entry point for every task, including the main thread (task 0).
+  void ScavengeInParallel(int task_id);
+
+  static ScavengeTask* CurrentTask() {
+    return reinterpret_cast<ScavengeTask*>(
+        Thread::GetThreadLocal(current_task_key_));
+  }
+
+  Heap* heap() { return heap_; }
+
+  Mutex* allocation_mutex() { return allocation_mutex_; }
+
+ private:
+  // Number of old-to-new slots claimed by a task at a time.
+  static const int kSlotsPerChunk = 256;
+
+  static void RecordSlot(HeapObject** slot, HeapObject* object);
+  void RecordSlots(Object** start, Object** end);
+  void RecordSlotsInCells();
+  void ScavengeRoots(ScavengeTask* task);
+  void PrintStatistics(double time);
+
+  int task_count() { return FLAG_scavenger_threads + 1; }
+
+  Heap* heap_;
+  Mutex* allocation_mutex_;
+  ScavengeTask* tasks_;
+
+  // Old-to-new slots collected before the parallel phase starts.
+  List<Object**> slots_;
+  volatile Atomic32 next_chunk_;
+
+  static Thread::LocalStorageKey current_task_key_;
+
+  friend class ScavengeTask;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavenger);
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_PARALLEL_SCAVENGER_H_
@@ -306,6 +306,23 @@ FunctionEntry ScriptDataImpl::GetFunctionEntry(int start) {
 }
 
 
+bool ScriptDataImpl::IsCompileHint(int start_position) {
+  unsigned position = static_cast<unsigned>(start_position);
+  int low = 0;
+  int high = compile_hints_.length() - 1;
+  while (low <= high) {
+    int mid = low + (high - low) / 2;
+    if (compile_hints_[mid] == position) return true;
+    if (compile_hints_[mid] < position) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return false;
+}
+
+
 int ScriptDataImpl::GetSymbolIdentifier() {
   return ReadNumber(&symbol_data_);
 }
@@ -4403,6 +4420,15 @@ FunctionLiteral* Parser::ParseFunctionLiteral(
                                !parenthesized_function_);
     parenthesized_function_ = false;  // The bit was set for this function only.
 
+    // Functions that had already been compiled when a code cache was created
+    // are compiled eagerly, like parenthesized functions, instead of being
+    // preparsed now and parsed again on their first call.
+    if (pre_parse_data_ != NULL &&
+        pre_parse_data()->IsCompileHint(scope->start_position())) {
+      is_lazily_compiled = false;
+      parenthesized = FunctionLiteral::kIsParenthesized;
+    }
+
     if (is_lazily_compiled) {
       int function_block_pos = scanner().location().beg_pos;
       FunctionEntry entry;
@@ -5800,6 +5826,7 @@ ParserMessage::~ParserMessage() {
 
 ScriptDataImpl::~ScriptDataImpl() {
   if (owns_store_) store_.Dispose();
+  compile_hints_.Dispose();
 }
 
 
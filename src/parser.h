@@ -136,8 +136,17 @@ class ScriptDataImpl : public ScriptData {
   unsigned magic() { return store_[PreparseDataConstants::kMagicOffset]; }
   unsigned version() { return store_[PreparseDataConstants::kVersionOffset]; }
 
+  // Start positions of the functions that should be compiled eagerly, in
+  // increasing order. Set when the data comes from a code cache.
+  void set_compile_hints(Vector<unsigned> hints) {
+    compile_hints_.Dispose();
+    compile_hints_ = hints;
+  }
+  bool IsCompileHint(int start_position);
+
  private:
   Vector<unsigned> store_;
+  Vector<unsigned> compile_hints_;
   unsigned char* symbol_data_;
   unsigned char* symbol_data_end_;
   int function_index_;
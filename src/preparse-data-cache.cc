@@ -0,0 +1,277 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "v8.h"
+
+#include "preparse-data-cache.h"
+
+#include "parser.h"
+#include "platform.h"
+#include "preparser.h"
+#include "preparse-data.h"
+#include "scanner-character-streams.h"
+
+namespace v8 {
+namespace internal {
+
+
+struct PreparseDataCacheEntry : public Malloced {
+  uint64_t hash;
+  int source_length;
+  int flags;
+  Vector<unsigned> data;
+  PreparseDataCacheEntry* previous;
+  PreparseDataCacheEntry* next;
+};
+
+
+static LazyMutex preparse_data_cache_mutex = LAZY_MUTEX_INITIALIZER;
+
+// Entries are kept in a doubly linked list ordered from the most recently to
+// the least recently used one. The number of large scripts in a process is
+// small, so lookups simply walk the list.
+static PreparseDataCacheEntry* most_recently_used = NULL;
+static PreparseDataCacheEntry* least_recently_used = NULL;
+static int entry_count = 0;
+static size_t total_size = 0;
+static int hit_count = 0;
+static int miss_count = 0;
+
+
+template <typename Char>
+static uint64_t HashCharacters(Vector<const Char> chars) {
+  uint64_t hash = V8_2PART_UINT64_C(0xcbf29ce4, 84222325);
+  for (int i = 0; i < chars.length(); i++) {
+    hash ^= static_cast<uint16_t>(chars[i]);
+    hash *= V8_2PART_UINT64_C(0x00000100, 000001b3);
+  }
+  return hash;
+}
+
+
+uint64_t PreparseDataCache::HashSource(Handle<String> source) {
+  source = FlattenGetString(source);
+  DisallowHeapAllocation no_allocation;
+  String::FlatContent content = source->GetFlatContent();
+  ASSERT(content.IsFlat());
+  return content.IsAscii() ? HashCharacters(content.ToOneByteVector())
+                           : HashCharacters(content.ToUC16Vector());
+}
+
+
+// The flags that change the result of preparsing are part of the key.
+static int PreparseFlags() {
+  return (FLAG_harmony_generators ? 1 << 0 : 0) |
+         (FLAG_harmony_iteration ? 1 << 1 : 0) |
+         (FLAG_harmony_scoping ? 1 << 2 : 0);
+}
+
+
+static size_t SizeOf(Vector<unsigned> data) {
+  return data.length() * sizeof(unsigned);
+}
+
+
+static void Unlink(PreparseDataCacheEntry* entry) {
+  if (entry->previous != NULL) {
+    entry->previous->next = entry->next;
+  } else {
+    most_recently_used = entry->next;
+  }
+  if (entry->next != NULL) {
+    entry->next->previous = entry->previous;
+  } else {
+    least_recently_used = entry->previous;
+  }
+  entry->previous = entry->next = NULL;
+}
+
+
+static void LinkFirst(PreparseDataCacheEntry* entry) {
+  entry->previous = NULL;
+  entry->next = most_recently_used;
+  if (most_recently_used != NULL) most_recently_used->previous = entry;
+  most_recently_used = entry;
+  if (least_recently_used == NULL) least_recently_used = entry;
+}
+
+
+static void Delete(PreparseDataCacheEntry* entry) {
+  Unlink(entry);
+  total_size -= SizeOf(entry->data);
+  entry_count--;
+  entry->data.Dispose();
+  delete entry;
+}
+
+
+// Must be called with the cache mutex held.
+static PreparseDataCacheEntry* Find(uint64_t hash, int length, int flags) {
+  for (PreparseDataCacheEntry* entry = most_recently_used;
+       entry != NULL;
+       entry = entry->next) {
+    if (entry->hash == hash &&
+        entry->source_length == length &&
+        entry->flags == flags) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+
+// Like PreParserApi::PreParse, but a stack overflow is not reported: the
+// compiler runs into it again while parsing and throws there.
+static ScriptDataImpl* Preparse(Isolate* isolate, Handle<String> source) {
+  CompleteParserRecorder recorder;
+  HistogramTimerScope timer(isolate->counters()->pre_parse());
+  Scanner scanner(isolate->unicode_cache());
+  intptr_t stack_limit = isolate->stack_guard()->real_climit();
+  preparser::PreParser preparser(&scanner, &recorder, stack_limit);
+  preparser.set_allow_lazy(true);
+  preparser.set_allow_generators(FLAG_harmony_generators);
+  preparser.set_allow_for_of(FLAG_harmony_iteration);
+  preparser.set_allow_harmony_scoping(FLAG_harmony_scoping);
+  GenericStringUtf16CharacterStream stream(source, 0, source->length());
+  scanner.Initialize(&stream);
+  preparser::PreParser::PreParseResult result = preparser.PreParseProgram();
+  if (result == preparser::PreParser::kPreParseStackOverflow) return NULL;
+  return new ScriptDataImpl(recorder.ExtractData());
+}
+
+
+static ScriptDataImpl* LookupByKey(Isolate* isolate,
+                                   uint64_t hash,
+                                   int length,
+                                   int flags) {
+  ScopedLock lock(preparse_data_cache_mutex.Pointer());
+  PreparseDataCacheEntry* entry = Find(hash, length, flags);
+  if (entry == NULL) {
+    miss_count++;
+    isolate->counters()->preparse_cache_misses()->Increment();
+    return NULL;
+  }
+  hit_count++;
+  isolate->counters()->preparse_cache_hits()->Increment();
+  Unlink(entry);
+  LinkFirst(entry);
+  return new ScriptDataImpl(entry->data.Clone());
+}
+
+
+static void InsertByKey(uint64_t hash,
+                        int length,
+                        int flags,
+                        ScriptDataImpl* data) {
+  Vector<unsigned> store(
+      reinterpret_cast<unsigned*>(const_cast<char*>(data->Data())),
+      data->Length() / static_cast<int>(sizeof(unsigned)));
+  size_t size = SizeOf(store);
+  size_t limit = static_cast<size_t>(FLAG_preparse_cache_size) * KB;
+  if (size > limit) return;
+
+  ScopedLock lock(preparse_data_cache_mutex.Pointer());
+  // Another isolate may have added the same script in the meantime.
+  if (Find(hash, length, flags) != NULL) return;
+  while (total_size + size > limit) {
+    ASSERT(least_recently_used != NULL);
+    Delete(least_recently_used);
+  }
+  PreparseDataCacheEntry* entry = new PreparseDataCacheEntry();
+  entry->hash = hash;
+  entry->source_length = length;
+  entry->flags = flags;
+  entry->data = store.Clone();
+  LinkFirst(entry);
+  total_size += size;
+  entry_count++;
+}
+
+
+ScriptDataImpl* PreparseDataCache::Lookup(Handle<String> source) {
+  return LookupByKey(source->GetIsolate(), HashSource(source),
+                     source->length(), PreparseFlags());
+}
+
+
+ScriptDataImpl* PreparseDataCache::LookupOrPreparse(Handle<String> source) {
+  uint64_t hash = HashSource(source);
+  int flags = PreparseFlags();
+  ScriptDataImpl* result =
+      LookupByKey(source->GetIsolate(), hash, source->length(), flags);
+  if (result != NULL) return result;
+
+  result = Preparse(source->GetIsolate(), source);
+  // Syntax errors are reported by the parser, the data of such scripts is
+  // not worth keeping.
+  if (result == NULL || !result->SanityCheck() || result->has_error()) {
+    delete result;
+    return NULL;
+  }
+  InsertByKey(hash, source->length(), flags, result);
+  return result;
+}
+
+
+void PreparseDataCache::Insert(Handle<String> source, ScriptDataImpl* data) {
+  InsertByKey(HashSource(source), source->length(), PreparseFlags(), data);
+}
+
+
+void PreparseDataCache::Clear() {
+  ScopedLock lock(preparse_data_cache_mutex.Pointer());
+  while (least_recently_used != NULL) Delete(least_recently_used);
+  ASSERT(entry_count == 0 && total_size == 0);
+  hit_count = 0;
+  miss_count = 0;
+}
+
+
+int PreparseDataCache::hits() {
+  ScopedLock lock(preparse_data_cache_mutex.Pointer());
+  return hit_count;
+}
+
+
+int PreparseDataCache::misses() {
+  ScopedLock lock(preparse_data_cache_mutex.Pointer());
+  return miss_count;
+}
+
+
+int PreparseDataCache::entries() {
+  ScopedLock lock(preparse_data_cache_mutex.Pointer());
+  return entry_count;
+}
+
+
+size_t PreparseDataCache::size_in_bytes() {
+  ScopedLock lock(preparse_data_cache_mutex.Pointer());
+  return total_size;
+}
+
+} }  // namespace v8::internal
@@ -0,0 +1,83 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef V8_PREPARSE_DATA_CACHE_H_
+#define V8_PREPARSE_DATA_CACHE_H_
+
+#include "allocation.h"
+#include "handles.h"
+
+namespace v8 {
+namespace internal {
+
+class ScriptDataImpl;
+
+
+// A process-wide cache of the preparse data of large scripts. The data
+// describes the boundaries, literal counts and language modes of all
+// functions and the symbols of a script, and does not reference any heap
+// object, so it can be shared between isolates. An isolate compiling a
+// script that another isolate has compiled before can then skip building the
+// AST of its lazily compiled functions without scanning their bodies again.
+//
+// Entries are keyed by a hash of the source contents and its length, and the
+// cache is bounded by --preparse-cache-size; least recently used entries are
+// evicted first. All operations are thread-safe.
+class PreparseDataCache : public AllStatic {
+ public:
+  // Returns a copy of the cached preparse data for the given source, which
+  // the caller owns, or NULL if there is none.
+  static ScriptDataImpl* Lookup(Handle<String> source);
+
+  // Returns preparse data for the given source, from the cache if possible
+  // or by preparsing the source and adding the result to the cache. The
+  // caller owns the result. Returns NULL if the source cannot be preparsed.
+  static ScriptDataImpl* LookupOrPreparse(Handle<String> source);
+
+  // Adds a copy of the given preparse data for the given source.
+  static void Insert(Handle<String> source, ScriptDataImpl* data);
+
+  // Removes all entries and resets the statistics.
+  static void Clear();
+
+  static void TearDown() { Clear(); }
+
+  // A 64-bit FNV-1a hash of the characters of the source. Unlike the hash
+  // stored in strings it is not seeded per isolate and covers the whole
+  // string, so it stays the same across isolates and processes.
+  static uint64_t HashSource(Handle<String> source);
+
+  // Statistics over all isolates.
+  static int hits();
+  static int misses();
+  static int entries();
+  static size_t size_in_bytes();
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_PREPARSE_DATA_CACHE_H_
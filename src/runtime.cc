@@ -448,6 +448,58 @@ static Handle<Object> CreateLiteralBoilerplate(
 }
 
 
+// Returns the allocation site stored in the literals array at the given
+// index, creating the boilerplate and its site if this is the first time
+// the object literal is evaluated.
+static Handle<AllocationSite> GetObjectLiteralAllocationSite(
+    Isolate* isolate,
+    Handle<FixedArray> literals,
+    int literals_index,
+    Handle<FixedArray> constant_properties,
+    int flags) {
+  Handle<Object> literal_site(literals->get(literals_index), isolate);
+  if (*literal_site != isolate->heap()->undefined_value()) {
+    return Handle<AllocationSite>::cast(literal_site);
+  }
+  bool should_have_fast_elements = (flags & ObjectLiteral::kFastElements) != 0;
+  bool has_function_literal = (flags & ObjectLiteral::kHasFunction) != 0;
+  Handle<Object> boilerplate =
+      CreateObjectLiteralBoilerplate(isolate,
+                                     literals,
+                                     constant_properties,
+                                     should_have_fast_elements,
+                                     has_function_literal);
+  if (boilerplate.is_null()) return Handle<AllocationSite>::null();
+  Handle<AllocationSite> site = isolate->factory()->NewAllocationSite(
+      Handle<JSObject>::cast(boilerplate));
+  // Update the functions literal and return the site.
+  literals->set(literals_index, *site);
+  return site;
+}
+
+
+// Same as above for array literals.
+static Handle<AllocationSite> GetArrayLiteralAllocationSite(
+    Isolate* isolate,
+    Handle<FixedArray> literals,
+    int literals_index,
+    Handle<FixedArray> elements) {
+  Handle<Object> literal_site(literals->get(literals_index), isolate);
+  if (*literal_site != isolate->heap()->undefined_value()) {
+    return Handle<AllocationSite>::cast(literal_site);
+  }
+  ASSERT(*elements != isolate->heap()->empty_fixed_array());
+  Handle<Object> boilerplate =
+      Runtime::CreateArrayLiteralBoilerplate(isolate, literals, elements);
+  if (boilerplate.is_null()) return Handle<AllocationSite>::null();
+  Handle<AllocationSite> site = isolate->factory()->NewAllocationSite(
+      Handle<JSObject>::cast(boilerplate));
+  // Update the functions literal and return the site.
+  literals->set(literals_index, *site);
+  return site;
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_CreateObjectLiteral) {
   HandleScope scope(isolate);
   ASSERT(args.length() == 4);
@@ -455,22 +507,12 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CreateObjectLiteral) {
   CONVERT_SMI_ARG_CHECKED(literals_index, 1);
   CONVERT_ARG_HANDLE_CHECKED(FixedArray, constant_properties, 2);
   CONVERT_SMI_ARG_CHECKED(flags, 3);
-  bool should_have_fast_elements = (flags & ObjectLiteral::kFastElements) != 0;
-  bool has_function_literal = (flags & ObjectLiteral::kHasFunction) != 0;
 
   // Check if boilerplate exists. If not, create it first.
-  Handle<Object> boilerplate(literals->get(literals_index), isolate);
-  if (*boilerplate == isolate->heap()->undefined_value()) {
-    boilerplate = CreateObjectLiteralBoilerplate(isolate,
-                                                 literals,
-                                                 constant_properties,
-                                                 should_have_fast_elements,
-                                                 has_function_literal);
-    if (boilerplate.is_null()) return Failure::Exception();
-    // Update the functions literal and return the boilerplate.
-    literals->set(literals_index, *boilerplate);
-  }
-  return JSObject::cast(*boilerplate)->DeepCopy(isolate);
+  Handle<AllocationSite> site = GetObjectLiteralAllocationSite(
+      isolate, literals, literals_index, constant_properties, flags);
+  if (site.is_null()) return Failure::Exception();
+  return JSObject::cast(site->boilerplate())->DeepCopy(isolate, *site);
 }
 
 
@@ -481,22 +523,13 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CreateObjectLiteralShallow) {
   CONVERT_SMI_ARG_CHECKED(literals_index, 1);
   CONVERT_ARG_HANDLE_CHECKED(FixedArray, constant_properties, 2);
   CONVERT_SMI_ARG_CHECKED(flags, 3);
-  bool should_have_fast_elements = (flags & ObjectLiteral::kFastElements) != 0;
-  bool has_function_literal = (flags & ObjectLiteral::kHasFunction) != 0;
 
   // Check if boilerplate exists. If not, create it first.
-  Handle<Object> boilerplate(literals->get(literals_index), isolate);
-  if (*boilerplate == isolate->heap()->undefined_value()) {
-    boilerplate = CreateObjectLiteralBoilerplate(isolate,
-                                                 literals,
-                                                 constant_properties,
-                                                 should_have_fast_elements,
-                                                 has_function_literal);
-    if (boilerplate.is_null()) return Failure::Exception();
-    // Update the functions literal and return the boilerplate.
-    literals->set(literals_index, *boilerplate);
-  }
-  return isolate->heap()->CopyJSObject(JSObject::cast(*boilerplate));
+  Handle<AllocationSite> site = GetObjectLiteralAllocationSite(
+      isolate, literals, literals_index, constant_properties, flags);
+  if (site.is_null()) return Failure::Exception();
+  return isolate->heap()->CopyJSObject(JSObject::cast(site->boilerplate()),
+                                       *site);
 }
 
 
@@ -508,16 +541,10 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CreateArrayLiteral) {
   CONVERT_ARG_HANDLE_CHECKED(FixedArray, elements, 2);
 
   // Check if boilerplate exists. If not, create it first.
-  Handle<Object> boilerplate(literals->get(literals_index), isolate);
-  if (*boilerplate == isolate->heap()->undefined_value()) {
-    ASSERT(*elements != isolate->heap()->empty_fixed_array());
-    boilerplate =
-        Runtime::CreateArrayLiteralBoilerplate(isolate, literals, elements);
-    if (boilerplate.is_null()) return Failure::Exception();
-    // Update the functions literal and return the boilerplate.
-    literals->set(literals_index, *boilerplate);
-  }
-  return JSObject::cast(*boilerplate)->DeepCopy(isolate);
+  Handle<AllocationSite> site = GetArrayLiteralAllocationSite(
+      isolate, literals, literals_index, elements);
+  if (site.is_null()) return Failure::Exception();
+  return JSObject::cast(site->boilerplate())->DeepCopy(isolate, *site);
 }
 
 
@@ -529,28 +556,15 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CreateArrayLiteralShallow) {
   CONVERT_ARG_HANDLE_CHECKED(FixedArray, elements, 2);
 
   // Check if boilerplate exists. If not, create it first.
-  Handle<Object> boilerplate(literals->get(literals_index), isolate);
-  if (*boilerplate == isolate->heap()->undefined_value()) {
-    ASSERT(*elements != isolate->heap()->empty_fixed_array());
-    boilerplate =
-        Runtime::CreateArrayLiteralBoilerplate(isolate, literals, elements);
-    if (boilerplate.is_null()) return Failure::Exception();
-    // Update the functions literal and return the boilerplate.
-    literals->set(literals_index, *boilerplate);
-  }
-  if (JSObject::cast(*boilerplate)->elements()->map() ==
+  Handle<AllocationSite> site = GetArrayLiteralAllocationSite(
+      isolate, literals, literals_index, elements);
+  if (site.is_null()) return Failure::Exception();
+  JSObject* boilerplate = JSObject::cast(site->boilerplate());
+  if (boilerplate->elements()->map() ==
       isolate->heap()->fixed_cow_array_map()) {
     isolate->counters()->cow_arrays_created_runtime()->Increment();
   }
-
-  JSObject* boilerplate_object = JSObject::cast(*boilerplate);
-  AllocationSiteMode mode = AllocationSiteInfo::GetMode(
-      boilerplate_object->GetElementsKind());
-  if (mode == TRACK_ALLOCATION_SITE) {
-    return isolate->heap()->CopyJSObjectWithAllocationSite(boilerplate_object);
-  }
-
-  return isolate->heap()->CopyJSObject(boilerplate_object);
+  return isolate->heap()->CopyJSObject(boilerplate, *site);
 }
 
 
@@ -4978,8 +4992,8 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_StoreArrayLiteralElement) {
   CONVERT_ARG_HANDLE_CHECKED(FixedArray, literals, 3);
   CONVERT_SMI_ARG_CHECKED(literal_index, 4);
 
-  Object* raw_boilerplate_object = literals->get(literal_index);
-  Handle<JSArray> boilerplate_object(JSArray::cast(raw_boilerplate_object));
+  AllocationSite* site = AllocationSite::cast(literals->get(literal_index));
+  Handle<JSArray> boilerplate_object(JSArray::cast(site->boilerplate()));
   ElementsKind elements_kind = object->GetElementsKind();
   ASSERT(IsFastElementsKind(elements_kind));
   // Smis should never trigger transitions.
@@ -7903,9 +7917,10 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_ParallelRecompile) {
     function->ReplaceCode(function->shared()->code());
     return isolate->heap()->undefined_value();
   }
-  function->shared()->code()->set_profiler_ticks(0);
   ASSERT(FLAG_parallel_recompilation);
-  Compiler::RecompileParallel(function);
+  Compiler::RecompileParallel(function, BailoutId::None());
+  // RecompileParallel reads the ticks to prioritize the function.
+  function->shared()->code()->set_profiler_ticks(0);
   return isolate->heap()->undefined_value();
 }
 
@@ -8144,6 +8159,46 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_GetOptimizationCount) {
 }
 
 
+RUNTIME_FUNCTION(MaybeObject*, Runtime_GetInlineCacheSummary) {
+  HandleScope scope(isolate);
+  ASSERT(args.length() == 1);
+  CONVERT_ARG_HANDLE_CHECKED(JSFunction, function, 0);
+  return *IC::SummarizeStates(function);
+}
+
+
+// Enters the on-stack replacement code compiled on the optimizing compiler
+// threads if it is ready, and queues it for compilation otherwise.  The loop
+// keeps running in unoptimized code until the code is ready, at which point
+// the back edges are patched again.  Returns true if the function has been
+// optimized.
+static bool CompileForOnStackReplacementInParallel(Isolate* isolate,
+                                                   Handle<JSFunction> function,
+                                                   BailoutId ast_id) {
+  OptimizingCompilerThread* thread = isolate->optimizing_compiler_thread();
+  OptimizingCompiler* compiler =
+      thread->FindReadyOnStackReplacement(*function, ast_id);
+  if (compiler != NULL) {
+    Compiler::InstallOptimizedCode(compiler);
+    return function->IsOptimized();
+  }
+  if (!thread->IsQueuedForOnStackReplacement(*function) &&
+      Compiler::RecompileParallel(function, ast_id)) {
+    if (FLAG_trace_osr) {
+      PrintF("[queued on-stack replacement for ");
+      function->PrintName();
+      PrintF("]\n");
+    }
+    // The queued job takes the place of the regular recompilation.
+    if (function->IsMarkedForLazyRecompilation() ||
+        function->IsMarkedForParallelRecompilation()) {
+      function->ReplaceCode(function->shared()->code());
+    }
+  }
+  return false;
+}
+
+
 RUNTIME_FUNCTION(MaybeObject*, Runtime_CompileForOnStackReplacement) {
   HandleScope scope(isolate);
   ASSERT(args.length() == 1);
@@ -8207,11 +8262,20 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CompileForOnStackReplacement) {
       PrintF("]\n");
     }
 
-    // Try to compile the optimized code.  A true return value from
-    // CompileOptimized means that compilation succeeded, not necessarily
-    // that optimization succeeded.
-    if (JSFunction::CompileOptimized(function, ast_id, CLEAR_EXCEPTION) &&
-        function->IsOptimized()) {
+    bool optimized;
+    if (FLAG_parallel_recompilation && FLAG_parallel_osr) {
+      optimized = CompileForOnStackReplacementInParallel(isolate,
+                                                         function,
+                                                         ast_id);
+    } else {
+      // Try to compile the optimized code.  A true return value from
+      // CompileOptimized means that compilation succeeded, not necessarily
+      // that optimization succeeded.
+      optimized =
+          JSFunction::CompileOptimized(function, ast_id, CLEAR_EXCEPTION) &&
+          function->IsOptimized();
+    }
+    if (optimized) {
       DeoptimizationInputData* data = DeoptimizationInputData::cast(
           function->code()->deoptimization_data());
       if (data->OsrPcOffset()->value() >= 0) {
@@ -8236,12 +8300,14 @@ RUNTIME_FUNCTION(MaybeObject*, Runtime_CompileForOnStackReplacement) {
     function->PrintName();
     PrintF("]\n");
   }
-  InterruptStub interrupt_stub;
-  Handle<Code> interrupt_code = interrupt_stub.GetCode(isolate);
-  Handle<Code> replacement_code = isolate->builtins()->OnStackReplacement();
-  Deoptimizer::RevertInterruptCode(*unoptimized,
-                                   *interrupt_code,
-                                   *replacement_code);
+  if (unoptimized->back_edges_patched_for_osr()) {
+    InterruptStub interrupt_stub;
+    Handle<Code> interrupt_code = interrupt_stub.GetCode(isolate);
+    Handle<Code> replacement_code = isolate->builtins()->OnStackReplacement();
+    Deoptimizer::RevertInterruptCode(*unoptimized,
+                                     *interrupt_code,
+                                     *replacement_code);
+  }
 
   // Allow OSR only at nesting level zero again.
   unoptimized->set_allow_osr_at_loop_nesting_level(0);
@@ -0,0 +1,222 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "v8.h"
+
+#include "script-code-cache.h"
+
+#include "parser.h"
+#include "platform.h"
+#include "preparse-data-cache.h"
+#include "preparse-data-format.h"
+#include "version.h"
+
+namespace v8 {
+namespace internal {
+
+
+// The code cache as handed out to the embedder.
+class ScriptCodeCacheData : public v8::ScriptData {
+ public:
+  explicit ScriptCodeCacheData(Vector<unsigned> store) : store_(store) { }
+  virtual ~ScriptCodeCacheData() { store_.Dispose(); }
+
+  virtual int Length() {
+    return store_.length() * static_cast<int>(sizeof(unsigned));
+  }
+  virtual const char* Data() {
+    return reinterpret_cast<const char*>(store_.start());
+  }
+  virtual bool HasError() { return false; }
+
+ private:
+  Vector<unsigned> store_;
+};
+
+
+static unsigned VersionHash() {
+  return (static_cast<unsigned>(Version::GetMajor()) << 24) ^
+         (static_cast<unsigned>(Version::GetMinor()) << 16) ^
+         (static_cast<unsigned>(Version::GetBuild()) << 4) ^
+         static_cast<unsigned>(Version::GetPatch());
+}
+
+
+// The flags that change how a script is parsed or which functions are
+// compiled lazily.
+static unsigned ParserFlags() {
+  return (FLAG_lazy ? 1 << 0 : 0) |
+         (FLAG_use_strict ? 1 << 1 : 0) |
+         (FLAG_harmony_scoping ? 1 << 2 : 0) |
+         (FLAG_harmony_modules ? 1 << 3 : 0) |
+         (FLAG_harmony_generators ? 1 << 4 : 0) |
+         (FLAG_harmony_iteration ? 1 << 5 : 0) |
+         (FLAG_allow_natives_syntax ? 1 << 6 : 0);
+}
+
+
+v8::ScriptData* ScriptCodeCache::Create(Handle<SharedFunctionInfo> shared) {
+  // The preparser always starts in classic mode.
+  if (FLAG_use_strict) return NULL;
+  Isolate* isolate = shared->GetIsolate();
+  Handle<Script> script(Script::cast(shared->script()), isolate);
+  if (!script->source()->IsString()) return NULL;
+  Handle<String> source(String::cast(script->source()), isolate);
+  ScriptDataImpl* pre_data = PreparseDataCache::LookupOrPreparse(source);
+  if (pre_data == NULL) return NULL;
+
+  // Collect the start and end positions of the functions of the script that
+  // have been compiled so far.
+  List<unsigned> starts;
+  List<unsigned> ends;
+  { Heap* heap = isolate->heap();
+    heap->EnsureHeapIsIterable();
+    DisallowHeapAllocation no_allocation;
+    HeapIterator iterator(heap);
+    for (HeapObject* obj = iterator.next(); obj != NULL;
+         obj = iterator.next()) {
+      if (!obj->IsSharedFunctionInfo()) continue;
+      SharedFunctionInfo* function = SharedFunctionInfo::cast(obj);
+      if (function->script() != *script ||
+          function->is_toplevel() ||
+          !function->is_compiled()) {
+        continue;
+      }
+      starts.Add(function->start_position());
+      ends.Add(function->end_position());
+    }
+  }
+  starts.Sort(PointerValueCompare<unsigned>);
+  ends.Sort(PointerValueCompare<unsigned>);
+
+  Vector<unsigned> preparse(
+      reinterpret_cast<unsigned*>(const_cast<char*>(pre_data->Data())),
+      pre_data->Length() / static_cast<int>(sizeof(unsigned)));
+  int functions_size =
+      static_cast<int>(preparse[PreparseDataConstants::kFunctionsSizeOffset]);
+
+  List<unsigned> store(kHeaderSize + starts.length() +
+                       PreparseDataConstants::kHeaderSize + functions_size);
+  uint64_t hash = PreparseDataCache::HashSource(source);
+  store.Add(static_cast<unsigned>(kMagicNumber));
+  store.Add(VersionHash());
+  store.Add(ParserFlags());
+  store.Add(static_cast<unsigned>(source->length()));
+  store.Add(static_cast<unsigned>(hash));
+  store.Add(static_cast<unsigned>(hash >> 32));
+  store.Add(static_cast<unsigned>(starts.length()));
+  store.AddAll(starts);
+
+  // The compiled functions are parsed eagerly, so their entries would only
+  // get in the way of the sequential lookup of the remaining ones. The symbol
+  // data covers the bodies of all lazily compiled functions and is dropped.
+  int preparse_start = store.length();
+  for (int i = 0; i < PreparseDataConstants::kHeaderSize; i++) {
+    store.Add(preparse[i]);
+  }
+  int kept_size = 0;
+  for (int i = PreparseDataConstants::kHeaderSize;
+       i < PreparseDataConstants::kHeaderSize + functions_size;
+       i += FunctionEntry::kSize) {
+    unsigned end_position = preparse[i + FunctionEntry::kEndPositionIndex];
+    if (SortedListBSearch(ends, end_position) >= 0) continue;
+    for (int j = 0; j < FunctionEntry::kSize; j++) {
+      store.Add(preparse[i + j]);
+    }
+    kept_size += FunctionEntry::kSize;
+  }
+  store[preparse_start + PreparseDataConstants::kFunctionsSizeOffset] =
+      kept_size;
+  store[preparse_start + PreparseDataConstants::kSymbolCountOffset] = 0;
+  delete pre_data;
+
+  return new ScriptCodeCacheData(store.ToVector().Clone());
+}
+
+
+bool ScriptCodeCache::IsCodeCache(v8::ScriptData* data) {
+  if (data->Length() < kHeaderSize * static_cast<int>(sizeof(unsigned))) {
+    return false;
+  }
+  unsigned magic;
+  OS::MemCopy(&magic, data->Data(), sizeof(magic));
+  return magic == kMagicNumber;
+}
+
+
+static ScriptDataImpl* Reject(Isolate* isolate, Vector<unsigned> store) {
+  isolate->counters()->script_code_cache_rejects()->Increment();
+  store.Dispose();
+  return NULL;
+}
+
+
+ScriptDataImpl* ScriptCodeCache::Consume(Handle<String> source,
+                                         v8::ScriptData* data) {
+  Isolate* isolate = source->GetIsolate();
+  int length = data->Length();
+  if (length % sizeof(unsigned) != 0) {
+    return Reject(isolate, Vector<unsigned>());
+  }
+  // Copy the data to ensure it is properly aligned.
+  Vector<unsigned> store =
+      Vector<unsigned>::New(length / static_cast<int>(sizeof(unsigned)));
+  OS::MemCopy(store.start(), data->Data(), length);
+
+  if (store.length() < kHeaderSize ||
+      store[kMagicOffset] != kMagicNumber ||
+      store[kVersionHashOffset] != VersionHash() ||
+      store[kFlagsOffset] != ParserFlags() ||
+      store[kSourceLengthOffset] != static_cast<unsigned>(source->length())) {
+    return Reject(isolate, store);
+  }
+  uint64_t hash = PreparseDataCache::HashSource(source);
+  if (store[kSourceHashLowOffset] != static_cast<unsigned>(hash) ||
+      store[kSourceHashHighOffset] != static_cast<unsigned>(hash >> 32)) {
+    return Reject(isolate, store);
+  }
+  unsigned count = store[kCompiledFunctionCountOffset];
+  if (count > static_cast<unsigned>(store.length() - kHeaderSize)) {
+    return Reject(isolate, store);
+  }
+  int preparse_start = kHeaderSize + static_cast<int>(count);
+  Vector<unsigned> hints(store.start() + kHeaderSize,
+                         static_cast<int>(count));
+  Vector<unsigned> preparse(store.start() + preparse_start,
+                            store.length() - preparse_start);
+  ScriptDataImpl* result = new ScriptDataImpl(preparse.Clone());
+  if (!result->SanityCheck() || result->has_error()) {
+    delete result;
+    return Reject(isolate, store);
+  }
+  result->set_compile_hints(hints.Clone());
+  store.Dispose();
+  isolate->counters()->script_code_cache_hits()->Increment();
+  return result;
+}
+
+} }  // namespace v8::internal
@@ -0,0 +1,87 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef V8_SCRIPT_CODE_CACHE_H_
+#define V8_SCRIPT_CODE_CACHE_H_
+
+#include "allocation.h"
+#include "handles.h"
+
+namespace v8 {
+namespace internal {
+
+class ScriptDataImpl;
+
+
+// A code cache lets an embedder that compiles the same script in every run
+// skip most of the compile work that happened before the script reached a
+// steady state. It holds the preparse data of the script and the positions
+// of the functions that had been compiled when the cache was created. When
+// the script is compiled with the cache, those functions are compiled
+// together with the top-level code instead of being preparsed first and
+// parsed again on their first call, and all other functions are skipped
+// using the preparse data.
+//
+// The cache only describes the source text; it holds no heap objects or
+// machine code. It is rejected when the source, the V8 version, or any flag
+// that affects parsing differs from the time it was created.
+//
+// Layout, in unsigned words:
+//   header (kHeaderSize words)
+//   start positions of the compiled functions, in increasing order
+//   preparse data, without symbol data and without the entries of the
+//   compiled functions
+class ScriptCodeCache : public AllStatic {
+ public:
+  static const unsigned kMagicNumber = 0xC0DECAC4;
+
+  static const int kMagicOffset = 0;
+  static const int kVersionHashOffset = 1;
+  static const int kFlagsOffset = 2;
+  static const int kSourceLengthOffset = 3;
+  static const int kSourceHashLowOffset = 4;
+  static const int kSourceHashHighOffset = 5;
+  static const int kCompiledFunctionCountOffset = 6;
+  static const int kHeaderSize = 7;
+
+  // Creates the code cache of the script of the given top-level function.
+  // The caller owns the result. Returns NULL if the script cannot be
+  // preparsed, e.g. because of --use-strict.
+  static v8::ScriptData* Create(Handle<SharedFunctionInfo> shared);
+
+  // Returns true if the data starts like a code cache.
+  static bool IsCodeCache(v8::ScriptData* data);
+
+  // Returns the preparse data and compile hints of a code cache, which the
+  // caller owns, or NULL if the cache is malformed or does not match the
+  // source or the current configuration.
+  static ScriptDataImpl* Consume(Handle<String> source, v8::ScriptData* data);
+};
+
+} }  // namespace v8::internal
+
+#endif  // V8_SCRIPT_CODE_CACHE_H_
@@ -64,6 +64,9 @@ static int* GetInternalPointer(StatsCounter* counter) {
 }
 
 
+const intptr_t* ExternalReferenceTable::embedder_references_ = NULL;
+
+
 ExternalReferenceTable* ExternalReferenceTable::instance(Isolate* isolate) {
   ExternalReferenceTable* external_reference_table =
       isolate->external_reference_table();
@@ -291,6 +294,14 @@ void ExternalReferenceTable::PopulateTable(Isolate* isolate) {
       STUB_CACHE_TABLE,
       6,
       "StubCache::secondary_->map");
+  Add(stub_cache->mask_reference(StubCache::kPrimary).address(),
+      STUB_CACHE_TABLE,
+      7,
+      "StubCache::primary_mask_");
+  Add(stub_cache->mask_reference(StubCache::kSecondary).address(),
+      STUB_CACHE_TABLE,
+      8,
+      "StubCache::secondary_mask_");
 
   // Runtime entries
   Add(ExternalReference::perform_gc_function(isolate).address(),
@@ -589,6 +600,17 @@ void ExternalReferenceTable::PopulateTable(Isolate* isolate) {
         Deoptimizer::CALCULATE_ENTRY_ADDRESS);
     Add(address, LAZY_DEOPTIMIZATION, 63 + entry, "lazy_deopt");
   }
+
+  // Embedder functions, numbered in the order they were registered.
+  if (embedder_references_ != NULL) {
+    for (int i = 0; embedder_references_[i] != 0; i++) {
+      ASSERT(i <= kReferenceIdMask);
+      Add(reinterpret_cast<Address>(embedder_references_[i]),
+          EMBEDDER,
+          i,
+          "embedder");
+    }
+  }
 }
 
 
@@ -605,7 +627,7 @@ ExternalReferenceEncoder::ExternalReferenceEncoder()
 
 uint32_t ExternalReferenceEncoder::Encode(Address key) const {
   int index = IndexOf(key);
-  ASSERT(key == NULL || index >= 0);
+  CHECK(key == NULL || index >= 0);
   return index >=0 ?
          ExternalReferenceTable::instance(isolate_)->code(index) : 0;
 }
@@ -1132,6 +1154,84 @@ Serializer::~Serializer() {
 }
 
 
+// Returns whether the code of the given function can be dropped from the
+// snapshot and recompiled from source on its first call.  This mirrors the
+// checks of the code flusher, except that we can leave out everything to do
+// with code age and liveness: nothing is running while we serialize.
+static bool CanResetToLazyCompile(SharedFunctionInfo* shared,
+                                  const List<Code*>& builtin_code) {
+  if (!shared->is_compiled()) return false;
+  if (shared->script()->IsUndefined() ||
+      Script::cast(shared->script())->source()->IsUndefined()) {
+    return false;
+  }
+  if (shared->function_data()->IsFunctionTemplateInfo()) return false;
+  Code* code = shared->code();
+  if (code->kind() != Code::FUNCTION) return false;
+  if (!shared->allows_lazy_compilation()) return false;
+  if (shared->is_generator()) return false;
+  if (shared->is_toplevel()) return false;
+  if (shared->dont_flush()) return false;
+  // The JavaScript builtins object caches the code of the functions that
+  // the runtime calls directly, keep those compiled.
+  return !builtin_code.Contains(code);
+}
+
+
+void Serializer::ResetCompiledFunctions() {
+  if (!FLAG_lazy_snapshot_functions) return;
+  Isolate* isolate = Isolate::Current();
+  Heap* heap = isolate->heap();
+  heap->CollectAllGarbage(Heap::kMakeHeapIterableMask,
+                          "Serializer::ResetCompiledFunctions");
+  Code* lazy_compile = isolate->builtins()->builtin(Builtins::kLazyCompile);
+  DisallowHeapAllocation no_allocation;
+
+  List<Code*> builtin_code;
+  HeapIterator builtins_iterator(heap);
+  for (HeapObject* obj = builtins_iterator.next();
+       obj != NULL;
+       obj = builtins_iterator.next()) {
+    if (!obj->IsJSBuiltinsObject()) continue;
+    JSBuiltinsObject* builtins = JSBuiltinsObject::cast(obj);
+    for (int i = 0; i < Builtins::NumberOfJavaScriptBuiltins(); i++) {
+      Builtins::JavaScript id = static_cast<Builtins::JavaScript>(i);
+      builtin_code.Add(builtins->javascript_builtin_code(id));
+    }
+  }
+
+  // Closures share the code of their SharedFunctionInfo (crankshaft is off
+  // while serializing), so reset the closures first while we can still
+  // recognize them.
+  int count = 0;
+  HeapIterator function_iterator(heap);
+  for (HeapObject* obj = function_iterator.next();
+       obj != NULL;
+       obj = function_iterator.next()) {
+    if (!obj->IsJSFunction()) continue;
+    JSFunction* function = JSFunction::cast(obj);
+    if (function->code() == function->shared()->code() &&
+        CanResetToLazyCompile(function->shared(), builtin_code)) {
+      function->set_code(lazy_compile);
+    }
+  }
+  HeapIterator shared_iterator(heap);
+  for (HeapObject* obj = shared_iterator.next();
+       obj != NULL;
+       obj = shared_iterator.next()) {
+    if (!obj->IsSharedFunctionInfo()) continue;
+    SharedFunctionInfo* shared = SharedFunctionInfo::cast(obj);
+    if (CanResetToLazyCompile(shared, builtin_code)) {
+      shared->set_code(lazy_compile);
+      count++;
+    }
+  }
+  if (FLAG_trace_code_flushing) {
+    PrintF("[snapshot: %d functions left to lazy compilation]\n", count);
+  }
+}
+
+
 void StartupSerializer::SerializeStrongReferences() {
   Isolate* isolate = Isolate::Current();
   // No active threads.
@@ -1139,8 +1239,9 @@ void StartupSerializer::SerializeStrongReferences() {
   // No active or weak handles.
   CHECK(isolate->handle_scope_implementer()->blocks()->is_empty());
   CHECK_EQ(0, isolate->global_handles()->NumberOfWeakHandles());
-  // We don't support serializing installed extensions.
-  CHECK(!isolate->has_installed_extensions());
+  // Installed extensions can only be serialized if the callbacks of their
+  // native functions are registered as embedder references; the encoder
+  // checks that every external reference it sees is known.
 
   HEAP->IterateStrongRoots(this, VISIT_ONLY_STRONG);
 }
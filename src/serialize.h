@@ -48,10 +48,11 @@ enum TypeCode {
   ACCESSOR,
   RUNTIME_ENTRY,
   STUB_CACHE_TABLE,
-  LAZY_DEOPTIMIZATION
+  LAZY_DEOPTIMIZATION,
+  EMBEDDER
 };
 
-const int kTypeCodeCount = LAZY_DEOPTIMIZATION + 1;
+const int kTypeCodeCount = EMBEDDER + 1;
 const int kFirstTypeCode = UNCLASSIFIED;
 
 const int kReferenceIdBits = 16;
@@ -81,6 +82,15 @@ class ExternalReferenceTable {
 
   int max_id(int code) { return max_id_[code]; }
 
+  // Registers the addresses of the embedder's functions that may be
+  // referenced from a snapshot, e.g. the callbacks of API templates. The
+  // array is terminated by 0 and must be the same in the process creating
+  // the snapshot and the processes using it. Only affects tables of isolates
+  // that are initialized afterwards.
+  static void SetEmbedderReferences(const intptr_t* references) {
+    embedder_references_ = references;
+  }
+
  private:
   explicit ExternalReferenceTable(Isolate* isolate) : refs_(64) {
       PopulateTable(isolate);
@@ -105,6 +115,8 @@ class ExternalReferenceTable {
 
   List<ExternalReferenceEntry> refs_;
   int max_id_[kTypeCodeCount];
+
+  static const intptr_t* embedder_references_;
 };
 
 
@@ -480,6 +492,11 @@ class Serializer : public SerializerDeserializer {
   // going on.
   static void TooLateToEnableNow() { too_late_to_enable_now_ = true; }
   static bool enabled() { return serialization_enabled_; }
+  // Drops the code of compiled functions that can be recompiled from their
+  // source, so that they are deserialized pointing to the lazy compile
+  // builtin and only compiled again when they are first called.  Call this
+  // right before serializing.
+  static void ResetCompiledFunctions();
   SerializationAddressMapper* address_mapper() { return &address_mapper_; }
   void PutRoot(int index,
                HeapObject* object,
@@ -33,11 +33,72 @@
 #include "serialize.h"
 #include "snapshot.h"
 #include "platform.h"
+#include "version.h"
 
 namespace v8 {
 namespace internal {
 
 
+// A blob holds the startup snapshot followed by the context snapshot, behind
+// a header of ints that records what is needed to deserialize them.
+static const int kBlobMagicNumber = 0x534e4150;
+static const int kBlobSpaceCount = LO_SPACE;
+
+static const int kBlobMagicIndex = 0;
+static const int kBlobVersionIndex = 1;
+static const int kBlobPointerSizeIndex = 2;
+static const int kBlobStartupSizeIndex = 3;
+static const int kBlobContextSizeIndex = 4;
+static const int kBlobStartupSpacesIndex = 5;
+static const int kBlobContextSpacesIndex =
+    kBlobStartupSpacesIndex + kBlobSpaceCount;
+static const int kBlobHeaderLength = kBlobContextSpacesIndex + kBlobSpaceCount;
+static const int kBlobHeaderSize = kBlobHeaderLength * kIntSize;
+
+
+const byte* Snapshot::blob_ = NULL;
+
+
+static int BlobVersion() {
+  return (Version::GetMajor() << 24) ^
+         (Version::GetMinor() << 16) ^
+         (Version::GetBuild() << 4) ^
+         Version::GetPatch();
+}
+
+
+// The blob may come straight from a file and need not be aligned.
+static int BlobHeaderValue(const byte* blob, int index) {
+  int value;
+  OS::MemCopy(&value, blob + index * kIntSize, kIntSize);
+  return value;
+}
+
+
+static void ReserveSpaceForBlob(Deserializer* deserializer,
+                                const byte* blob,
+                                int first_space_index) {
+  for (int space = 0; space < kBlobSpaceCount; space++) {
+    deserializer->set_reservation(
+        space, BlobHeaderValue(blob, first_space_index + space));
+  }
+}
+
+
+// Collects the serialized data in memory.
+class ListSnapshotSink : public SnapshotByteSink {
+ public:
+  explicit ListSnapshotSink(List<byte>* data) : data_(data) { }
+  virtual void Put(int byte, const char* description) {
+    data_->Add(byte);
+  }
+  virtual int Position() { return data_->length(); }
+
+ private:
+  List<byte>* data_;
+};
+
+
 static void ReserveSpaceForSnapshot(Deserializer* deserializer,
                                     const char* file_name) {
   int file_name_length = StrLength(file_name) + 10;
@@ -101,6 +162,12 @@ bool Snapshot::Initialize(const char* snapshot_file) {
     }
     DeleteArray(str);
     return success;
+  } else if (blob_ != NULL) {
+    SnapshotByteSource source(blob_ + kBlobHeaderSize,
+                              BlobHeaderValue(blob_, kBlobStartupSizeIndex));
+    Deserializer deserializer(&source);
+    ReserveSpaceForBlob(&deserializer, blob_, kBlobStartupSpacesIndex);
+    return V8::Initialize(&deserializer);
   } else if (size_ > 0) {
     SnapshotByteSource source(raw_data_, raw_size_);
     Deserializer deserializer(&source);
@@ -112,11 +179,24 @@ bool Snapshot::Initialize(const char* snapshot_file) {
 
 
 bool Snapshot::HaveASnapshotToStartFrom() {
-  return size_ != 0;
+  return size_ != 0 || blob_ != NULL;
 }
 
 
 Handle<Context> Snapshot::NewContextFromSnapshot() {
+  if (blob_ != NULL) {
+    int context_size = BlobHeaderValue(blob_, kBlobContextSizeIndex);
+    if (context_size == 0) return Handle<Context>();
+    int startup_size = BlobHeaderValue(blob_, kBlobStartupSizeIndex);
+    SnapshotByteSource source(blob_ + kBlobHeaderSize + startup_size,
+                              context_size);
+    Deserializer deserializer(&source);
+    ReserveSpaceForBlob(&deserializer, blob_, kBlobContextSpacesIndex);
+    Object* root;
+    deserializer.DeserializePartial(&root);
+    CHECK(root->IsContext());
+    return Handle<Context>(Context::cast(root));
+  }
   if (context_size_ == 0) {
     return Handle<Context>();
   }
@@ -137,4 +217,59 @@ Handle<Context> Snapshot::NewContextFromSnapshot() {
   return Handle<Context>(Context::cast(root));
 }
 
+
+Vector<byte> Snapshot::CreateBlob(Object* context) {
+  ASSERT(Serializer::enabled());
+  List<byte> startup_data;
+  List<byte> context_data;
+  ListSnapshotSink startup_sink(&startup_data);
+  ListSnapshotSink context_sink(&context_data);
+
+  StartupSerializer startup_serializer(&startup_sink);
+  startup_serializer.SerializeStrongReferences();
+  PartialSerializer partial_serializer(&startup_serializer, &context_sink);
+  partial_serializer.Serialize(&context);
+  startup_serializer.SerializeWeakReferences();
+
+  int header[kBlobHeaderLength];
+  header[kBlobMagicIndex] = kBlobMagicNumber;
+  header[kBlobVersionIndex] = BlobVersion();
+  header[kBlobPointerSizeIndex] = kPointerSize;
+  header[kBlobStartupSizeIndex] = startup_data.length();
+  header[kBlobContextSizeIndex] = context_data.length();
+  for (int space = 0; space < kBlobSpaceCount; space++) {
+    header[kBlobStartupSpacesIndex + space] =
+        startup_serializer.CurrentAllocationAddress(space);
+    header[kBlobContextSpacesIndex + space] =
+        partial_serializer.CurrentAllocationAddress(space);
+  }
+
+  Vector<byte> blob = Vector<byte>::New(
+      kBlobHeaderSize + startup_data.length() + context_data.length());
+  OS::MemCopy(blob.start(), header, kBlobHeaderSize);
+  byte* position = blob.start() + kBlobHeaderSize;
+  for (int i = 0; i < startup_data.length(); i++) *position++ = startup_data[i];
+  for (int i = 0; i < context_data.length(); i++) *position++ = context_data[i];
+  return blob;
+}
+
+
+bool Snapshot::SetBlob(const byte* blob, int size) {
+  if (size < kBlobHeaderSize ||
+      BlobHeaderValue(blob, kBlobMagicIndex) != kBlobMagicNumber ||
+      BlobHeaderValue(blob, kBlobVersionIndex) != BlobVersion() ||
+      BlobHeaderValue(blob, kBlobPointerSizeIndex) != kPointerSize) {
+    return false;
+  }
+  int startup_size = BlobHeaderValue(blob, kBlobStartupSizeIndex);
+  int context_size = BlobHeaderValue(blob, kBlobContextSizeIndex);
+  if (startup_size <= 0 || context_size < 0 ||
+      startup_size > size - kBlobHeaderSize ||
+      context_size > size - kBlobHeaderSize - startup_size) {
+    return false;
+  }
+  blob_ = blob;
+  return true;
+}
+
 } }  // namespace v8::internal
@@ -46,7 +46,19 @@ class Snapshot {
   static Handle<Context> NewContextFromSnapshot();
 
   // Returns whether or not the snapshot is enabled.
-  static bool IsEnabled() { return size_ != 0; }
+  static bool IsEnabled() { return size_ != 0 || blob_ != NULL; }
+
+  // Serializes the heap of the current isolate, with the given context as
+  // the partial snapshot, into a blob that SetBlob() accepts. The serializer
+  // must have been enabled before the heap was set up. The caller owns the
+  // result.
+  static Vector<byte> CreateBlob(Object* context);
+
+  // Makes isolates that are initialized afterwards start from the snapshot in
+  // the given blob instead of the linked-in one. The blob must stay alive
+  // until V8 is torn down. Returns false if the blob is malformed or was
+  // created by a different version or for a different architecture.
+  static bool SetBlob(const byte* blob, int size);
 
   // Write snapshot to the given file. Returns true if snapshot was written
   // successfully.
@@ -89,6 +101,7 @@ class Snapshot {
   static const int raw_size_;
   static const int context_size_;
   static const int context_raw_size_;
+  static const byte* blob_;
 
   static void ReserveSpaceForLinkedInSnapshot(Deserializer* deserializer);
 
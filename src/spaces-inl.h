@@ -340,6 +340,17 @@ MaybeObject* NewSpace::AllocateRaw(int size_in_bytes) {
 }
 
 
+// -----------------------------------------------------------------------------
+// LocalAllocationBuffer
+
+HeapObject* LocalAllocationBuffer::AllocateLinearly(int size_in_bytes) {
+  Address current_top = top_;
+  if (limit_ - current_top < size_in_bytes) return NULL;
+  top_ = current_top + size_in_bytes;
+  return HeapObject::FromAddress(current_top);
+}
+
+
 LargePage* LargePage::Initialize(Heap* heap, MemoryChunk* chunk) {
   heap->incremental_marking()->SetOldSpacePageFlags(chunk);
   return static_cast<LargePage*>(chunk);
@@ -79,6 +79,7 @@ HeapObjectIterator::HeapObjectIterator(Page* page,
              page->area_end(),
              kOnePageOnly,
              size_func);
+  page->heap()->mark_compact_collector()->EnsurePageIsSwept(page);
   ASSERT(page->WasSweptPrecisely());
 }
 
@@ -112,6 +113,7 @@ bool HeapObjectIterator::AdvanceToNextPage() {
   }
   cur_page = cur_page->next_page();
   if (cur_page == space_->anchor()) return false;
+  space_->heap()->mark_compact_collector()->EnsurePageIsSwept(cur_page);
   cur_addr_ = cur_page->area_start();
   cur_end_ = cur_page->area_end();
   ASSERT(cur_page->WasSweptPrecisely());
@@ -467,7 +469,7 @@ MemoryChunk* MemoryChunk::Initialize(Heap* heap,
   chunk->write_barrier_counter_ = kWriteBarrierCounterGranularity;
   chunk->progress_bar_ = 0;
   chunk->high_water_mark_ = static_cast<int>(area_start - base);
-  chunk->parallel_sweeping_ = 0;
+  chunk->set_parallel_sweeping(PARALLEL_SWEEPING_DONE);
   chunk->available_in_small_free_list_ = 0;
   chunk->available_in_medium_free_list_ = 0;
   chunk->available_in_large_free_list_ = 0;
@@ -908,8 +910,17 @@ bool MemoryAllocator::CommitExecutableMemory(VirtualMemory* vm,
 
 void MemoryChunk::IncrementLiveBytesFromMutator(Address address, int by) {
   MemoryChunk* chunk = MemoryChunk::FromAddress(address);
-  if (!chunk->InNewSpace() && !static_cast<Page*>(chunk)->WasSwept()) {
-    static_cast<PagedSpace*>(chunk->owner())->IncrementUnsweptFreeBytes(-by);
+  if (!chunk->InNewSpace()) {
+    if (!static_cast<Page*>(chunk)->WasSwept() ||
+        chunk->parallel_sweeping() != PARALLEL_SWEEPING_DONE) {
+      static_cast<PagedSpace*>(chunk->owner())->IncrementUnsweptFreeBytes(-by);
+    }
+    // The sweeper threads reset the live bytes of the pages they sweep, so
+    // there is nothing to keep track of until sweeping has completed.
+    if (chunk->heap()->mark_compact_collector()->
+            IsConcurrentSweepingInProgress()) {
+      return;
+    }
   }
   chunk->IncrementLiveBytes(by);
 }
@@ -1463,6 +1474,76 @@ void NewSpace::Verify() {
 }
 #endif
 
+// -----------------------------------------------------------------------------
+// LocalAllocationBuffer implementation
+
+void LocalAllocationBuffer::Initialize(Heap* heap, AllocationSpace identity) {
+  ASSERT(top_ == limit_);
+  ASSERT(identity == NEW_SPACE ||
+         (identity >= FIRST_PAGED_SPACE && identity <= LAST_PAGED_SPACE &&
+          identity != CODE_SPACE));
+  heap_ = heap;
+  identity_ = identity;
+}
+
+
+MaybeObject* LocalAllocationBuffer::SlowAllocateRaw(int size_in_bytes) {
+  Object* result;
+  if (identity_ == NEW_SPACE) {
+    NewSpace* new_space = heap_->new_space();
+    if (size_in_bytes > kMaxObjectSize) {
+      return new_space->AllocateRaw(size_in_bytes);
+    }
+    Close();
+    MaybeObject* maybe_buffer = new_space->AllocateRaw(kSize);
+    if (!maybe_buffer->ToObject(&result)) {
+      // No room for a whole buffer.  Try to fit just this object.
+      return new_space->AllocateRaw(size_in_bytes);
+    }
+    Address start = HeapObject::cast(result)->address();
+    top_ = start + size_in_bytes;
+    limit_ = start + kSize;
+    return result;
+  }
+
+  PagedSpace* space = heap_->paged_space(identity_);
+  if (size_in_bytes > kMaxObjectSize) {
+    HeapObject* object = space->AllocateRawFromFreeList(size_in_bytes);
+    if (object == NULL) return Failure::RetryAfterGC(identity_);
+    return object;
+  }
+  // Allocate the object from the space and split the buffer off the linear
+  // allocation area of the space.  Buffers thereby use the free list blocks
+  // in the same way a single allocator would and do not make the space
+  // expand just to get a whole buffer.
+  Close();
+  HeapObject* object = space->AllocateRawFromFreeList(size_in_bytes);
+  if (object == NULL) return Failure::RetryAfterGC(identity_);
+  top_ = space->top();
+  limit_ = Min(space->limit(), top_ + kSize);
+  space->SetTop(limit_, space->limit());
+  return object;
+}
+
+
+void LocalAllocationBuffer::Close() {
+  int remaining = static_cast<int>(limit_ - top_);
+  if (remaining > 0) {
+    if (identity_ == NEW_SPACE) {
+      heap_->CreateFillerObjectAt(top_, remaining);
+    } else {
+      PagedSpace* space = heap_->paged_space(identity_);
+      if (space->top() == limit_) {
+        // The buffer still borders the linear allocation area of the space.
+        space->SetTop(top_, space->limit());
+      } else {
+        space->Free(top_, remaining);
+      }
+    }
+  }
+  top_ = limit_ = NULL;
+}
+
 // -----------------------------------------------------------------------------
 // SemiSpace implementation
 
@@ -2363,7 +2444,15 @@ HeapObject* FreeList::Allocate(int size_in_bytes) {
       size_in_bytes - old_linear_size);
 
   int new_node_size = 0;
-  FreeListNode* new_node = FindNodeFor(size_in_bytes, &new_node_size);
+  FreeListNode* new_node = NULL;
+  if (size_in_bytes < kMinLinearAllocationAreaSize) {
+    // The rest of the node becomes the new linear allocation area, which is
+    // also where local allocation buffers come from.  Prefer a node that is
+    // big enough for a useful area so that runs of small allocations do not
+    // come back to the free list for every small block.
+    new_node = FindNodeFor(kMinLinearAllocationAreaSize, &new_node_size);
+  }
+  if (new_node == NULL) new_node = FindNodeFor(size_in_bytes, &new_node_size);
   if (new_node == NULL) {
     owner_->SetTop(NULL, NULL);
     return NULL;
@@ -2574,6 +2663,22 @@ bool PagedSpace::ReserveSpace(int size_in_bytes) {
 }
 
 
+HeapObject* PagedSpace::AllocateRawFromFreeList(int size_in_bytes) {
+  ASSERT(identity() != CODE_SPACE);
+  HeapObject* object = AllocateLinearly(size_in_bytes);
+  if (object != NULL) return object;
+  return free_list_.Allocate(size_in_bytes);
+}
+
+
+bool PagedSpace::EnsureAvailable(intptr_t size_in_bytes) {
+  while (Available() < size_in_bytes) {
+    if (!Expand()) return false;
+  }
+  return true;
+}
+
+
 intptr_t PagedSpace::SizeOfObjects() {
   ASSERT(!heap()->IsSweepingComplete() || (unswept_free_bytes_ == 0));
   return Size() - unswept_free_bytes_ - (limit() - top());
@@ -2650,7 +2755,15 @@ bool PagedSpace::EnsureSweeperProgress(intptr_t size_in_bytes) {
   MarkCompactCollector* collector = heap()->mark_compact_collector();
   if (collector->AreSweeperThreadsActivated()) {
     if (collector->IsConcurrentSweepingInProgress()) {
-      if (collector->StealMemoryFromSweeperThreads(this) < size_in_bytes) {
+      intptr_t freed_bytes = collector->StealMemoryFromSweeperThreads(this);
+      // Rather than blocking on the sweeper threads, sweep pages that none of
+      // them has picked up yet ourselves.
+      while (freed_bytes < size_in_bytes) {
+        intptr_t freed_on_page = collector->SweepPendingPage(this);
+        if (freed_on_page < 0) break;
+        freed_bytes += freed_on_page;
+      }
+      if (freed_bytes < size_in_bytes) {
         if (!collector->sequential_sweeping()) {
           collector->WaitUntilSweepingCompleted();
           return true;
@@ -2696,7 +2809,8 @@ HeapObject* PagedSpace::SlowAllocateRaw(int size_in_bytes) {
 
   // Last ditch, sweep all the remaining pages to try to find space.  This may
   // cause a pause.
-  if (!IsLazySweepingComplete()) {
+  if (!IsLazySweepingComplete() ||
+      heap()->mark_compact_collector()->IsConcurrentSweepingInProgress()) {
     EnsureSweeperProgress(kMaxInt);
 
     // Retry the free list allocation.
@@ -3078,31 +3192,12 @@ void LargeObjectSpace::FreeUnmarkedObjects() {
       current = current->next_page();
     } else {
       LargePage* page = current;
-      // Cut the chunk out from the chunk list.
       current = current->next_page();
-      if (previous == NULL) {
-        first_page_ = current;
-      } else {
-        previous->set_next_page(current);
-      }
 
       // Free the chunk.
       heap()->mark_compact_collector()->ReportDeleteIfNeeded(
           object, heap()->isolate());
-      size_ -= static_cast<int>(page->size());
-      objects_size_ -= object->Size();
-      page_count_--;
-
-      // Remove entries belonging to this page.
-      // Use variable alignment to help pass length check (<= 80 characters)
-      // of single line in tools/presubmit.py.
-      const intptr_t alignment = MemoryChunk::kAlignment;
-      uintptr_t base = reinterpret_cast<uintptr_t>(page)/alignment;
-      uintptr_t limit = base + (page->size()-1)/alignment;
-      for (uintptr_t key = base; key <= limit; key++) {
-        chunk_map_.Remove(reinterpret_cast<void*>(key),
-                          static_cast<uint32_t>(key));
-      }
+      RemovePage(page, previous);
 
       if (is_pointer_object) {
         heap()->QueueMemoryChunkForFree(page);
@@ -3115,6 +3210,46 @@ void LargeObjectSpace::FreeUnmarkedObjects() {
 }
 
 
+void LargeObjectSpace::FreeUnusedObject(HeapObject* object) {
+  LargePage* page = FindPage(object->address());
+  ASSERT(page != NULL && page->GetObject() == object);
+  LargePage* previous = NULL;
+  for (LargePage* current = first_page_;
+       current != page;
+       current = current->next_page()) {
+    previous = current;
+  }
+  RemovePage(page, previous);
+  // Nothing has recorded slots in the object, so there is no need to wait
+  // for the store buffer before freeing the chunk.
+  heap()->isolate()->memory_allocator()->Free(page);
+}
+
+
+void LargeObjectSpace::RemovePage(LargePage* page, LargePage* previous) {
+  // Cut the chunk out from the chunk list.
+  if (previous == NULL) {
+    first_page_ = page->next_page();
+  } else {
+    previous->set_next_page(page->next_page());
+  }
+  size_ -= static_cast<int>(page->size());
+  objects_size_ -= page->GetObject()->Size();
+  page_count_--;
+
+  // Remove entries belonging to this page.
+  // Use variable alignment to help pass length check (<= 80 characters)
+  // of single line in tools/presubmit.py.
+  const intptr_t alignment = MemoryChunk::kAlignment;
+  uintptr_t base = reinterpret_cast<uintptr_t>(page)/alignment;
+  uintptr_t limit = base + (page->size()-1)/alignment;
+  for (uintptr_t key = base; key <= limit; key++) {
+    chunk_map_.Remove(reinterpret_cast<void*>(key),
+                      static_cast<uint32_t>(key));
+  }
+}
+
+
 bool LargeObjectSpace::Contains(HeapObject* object) {
   Address address = object->address();
   MemoryChunk* chunk = MemoryChunk::FromAddress(address);
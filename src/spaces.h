@@ -138,6 +138,22 @@ class MarkBit {
   inline bool Get() { return (*cell_ & mask_) != 0; }
   inline void Clear() { *cell_ &= ~mask_; }
 
+  // Sets the bit with an atomic read-modify-write of the cell, so bits of
+  // the same cell can be set concurrently.  Returns false if the bit was
+  // already set, i.e. exactly one of several racing threads succeeds.
+  inline bool AtomicSet() {
+    volatile Atomic32* cell = reinterpret_cast<volatile Atomic32*>(cell_);
+    Atomic32 mask = static_cast<Atomic32>(mask_);
+    Atomic32 old_value;
+    do {
+      old_value = NoBarrier_Load(cell);
+      if ((old_value & mask) != 0) return false;
+    } while (NoBarrier_CompareAndSwap(cell,
+                                      old_value,
+                                      old_value | mask) != old_value);
+    return true;
+  }
+
   inline bool data_only() { return data_only_; }
 
   inline MarkBit Next() {
@@ -455,16 +471,30 @@ class MemoryChunk {
   // Return all current flags.
   intptr_t GetFlags() { return flags_; }
 
-  intptr_t parallel_sweeping() const {
-    return parallel_sweeping_;
+  // A page queued for parallel or concurrent sweeping is PENDING until a
+  // sweeper thread (or the main thread, on demand) claims it.  It stays
+  // IN_PROGRESS while being swept and becomes DONE once its free memory has
+  // been published to the owning space's sweeper free lists.
+  enum ParallelSweepingState {
+    PARALLEL_SWEEPING_DONE,
+    PARALLEL_SWEEPING_IN_PROGRESS,
+    PARALLEL_SWEEPING_PENDING
+  };
+
+  ParallelSweepingState parallel_sweeping() {
+    return static_cast<ParallelSweepingState>(
+        Acquire_Load(&parallel_sweeping_));
   }
 
-  void set_parallel_sweeping(intptr_t state) {
-    parallel_sweeping_ = state;
+  void set_parallel_sweeping(ParallelSweepingState state) {
+    Release_Store(&parallel_sweeping_, state);
   }
 
   bool TryParallelSweeping() {
-    return NoBarrier_CompareAndSwap(&parallel_sweeping_, 1, 0) == 1;
+    return Acquire_CompareAndSwap(&parallel_sweeping_,
+                                  PARALLEL_SWEEPING_PENDING,
+                                  PARALLEL_SWEEPING_IN_PROGRESS) ==
+        PARALLEL_SWEEPING_PENDING;
   }
 
   // Manage live byte count (count of bytes known to be live,
@@ -527,6 +557,14 @@ class MemoryChunk {
     MemoryChunk::FromAddress(address)->IncrementLiveBytes(by);
   }
 
+  // Used by parallel marking, where several threads account live objects
+  // on the same page.
+  static void IncrementLiveBytesFromGCAtomically(Address address, int by) {
+    MemoryChunk* chunk = MemoryChunk::FromAddress(address);
+    NoBarrier_AtomicIncrement(
+        reinterpret_cast<volatile Atomic32*>(&chunk->live_byte_count_), by);
+  }
+
   static void IncrementLiveBytesFromMutator(Address address, int by);
 
   static const intptr_t kAlignment =
@@ -700,7 +738,7 @@ class MemoryChunk {
   // count highest number of bytes ever allocated on the page.
   int high_water_mark_;
 
-  intptr_t parallel_sweeping_;
+  AtomicWord parallel_sweeping_;
 
   // PagedSpace free-list statistics.
   intptr_t available_in_small_free_list_;
@@ -1574,6 +1612,9 @@ class FreeList BASE_EMBEDDED {
   static const int kSmallAllocationMax = kSmallListMin - kPointerSize;
   static const int kMediumAllocationMax = kSmallListMax;
   static const int kLargeAllocationMax = kMediumListMax;
+  // Allocate() refills the linear allocation area from blocks of at least
+  // this size while there are any.
+  static const int kMinLinearAllocationAreaSize = kMediumAllocationMax;
   FreeListCategory small_list_;
   FreeListCategory medium_list_;
   FreeListCategory large_list_;
@@ -1697,6 +1738,16 @@ class PagedSpace : public Space {
 
   virtual bool ReserveSpace(int bytes);
 
+  // Allocates from the linear allocation area or the free list.  Unlike
+  // AllocateRaw this neither sweeps nor expands the space, so threads other
+  // than the main thread can use it as long as they serialize their calls.
+  // Returns NULL if the object does not fit.
+  HeapObject* AllocateRawFromFreeList(int size_in_bytes);
+
+  // Expands the space until at least size_in_bytes are on the free list.
+  // Returns false if the space cannot grow that far.
+  bool EnsureAvailable(intptr_t size_in_bytes);
+
   // Give a block of memory to the space's free list.  It might be added to
   // the free list or accounted as waste.
   // If add_to_freelist is false then just accounting stats are updated and
@@ -1872,6 +1923,7 @@ class PagedSpace : public Space {
   // Slow path of AllocateRaw.  This function is space-dependent.
   MUST_USE_RESULT virtual HeapObject* SlowAllocateRaw(int size_in_bytes);
 
+  friend class MarkCompactCollector;
   friend class PageIterator;
   friend class SweeperThread;
 };
@@ -2522,6 +2574,64 @@ class NewSpace : public Space {
 };
 
 
+// -----------------------------------------------------------------------------
+// A local allocation buffer (LAB) is a piece of a space that is owned by one
+// allocator.  Allocation from the buffer only bumps the buffer's top and does
+// not touch the space, so allocators running on different threads only have
+// to synchronize when they refill or close their buffers.  Buffers in paged
+// spaces are split off the linear allocation area of the space, which the
+// space refills with large free list blocks; buffers in new space are
+// allocated from to-space.  Buffers in paged spaces are only refilled from
+// the linear allocation area and the free list, never by sweeping or by
+// expanding the space, so the main thread has to make sure that enough
+// memory is available (see PagedSpace::EnsureAvailable) before other
+// threads start allocating.  The unused rest of a buffer is not iterable and
+// has to be handed back with Close() before the heap is iterated.
+
+class LocalAllocationBuffer BASE_EMBEDDED {
+ public:
+  static const int kSize = 8 * KB;
+  // Objects larger than this are allocated directly in the space to keep the
+  // memory lost at the end of the buffers low.
+  static const int kMaxObjectSize = kSize / 4;
+
+  // Returns an upper bound of the memory lost at the ends of buffers that
+  // were filled with size_in_bytes worth of objects.
+  static intptr_t MaxWaste(intptr_t size_in_bytes) {
+    return size_in_bytes / (kSize / kMaxObjectSize);
+  }
+
+  LocalAllocationBuffer()
+      : heap_(NULL), identity_(NEW_SPACE), top_(NULL), limit_(NULL) { }
+
+  // The space has to be new space or one of the paged spaces.
+  void Initialize(Heap* heap, AllocationSpace identity);
+
+  // Allocates from the buffer.  Returns NULL if the object does not fit.
+  inline HeapObject* AllocateLinearly(int size_in_bytes);
+
+  // Allocates the object in the space and refills the buffer if the object
+  // is small.  Returns a failure if the space is full.  Uses the space, so
+  // concurrent callers have to serialize this and Close().
+  MUST_USE_RESULT MaybeObject* SlowAllocateRaw(int size_in_bytes);
+
+  // Hands the unused rest of the buffer back to the space.
+  void Close();
+
+  AllocationSpace identity() { return identity_; }
+  Address top() { return top_; }
+  Address limit() { return limit_; }
+
+ private:
+  Heap* heap_;
+  AllocationSpace identity_;
+  Address top_;
+  Address limit_;
+
+  DISALLOW_COPY_AND_ASSIGN(LocalAllocationBuffer);
+};
+
+
 // -----------------------------------------------------------------------------
 // Old object space (excluding map objects)
 
@@ -2741,6 +2851,10 @@ class LargeObjectSpace : public Space {
   // Frees unmarked objects.
   void FreeUnmarkedObjects();
 
+  // Frees the page of an object that was allocated but never made reachable,
+  // e.g. a copy made by a scavenger task that lost the race for an object.
+  void FreeUnusedObject(HeapObject* object);
+
   // Checks whether a heap object is in this space; O(1).
   bool Contains(HeapObject* obj);
 
@@ -2768,6 +2882,9 @@ class LargeObjectSpace : public Space {
   bool SlowContains(Address addr) { return !FindObject(addr)->IsFailure(); }
 
  private:
+  // Cuts the page out of the page list and the chunk map.
+  void RemovePage(LargePage* page, LargePage* previous);
+
   intptr_t max_capacity_;
   // The head of the linked list of large object chunks.
   LargePage* first_page_;
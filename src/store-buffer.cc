@@ -500,6 +500,10 @@ void StoreBuffer::FindPointersToNewSpaceOnPage(
     Page* page,
     RegionCallback region_callback,
     ObjectSlotCallback slot_callback) {
+  // The sweeper threads must not write free space into the page while we
+  // scan it.
+  heap_->mark_compact_collector()->EnsurePageIsSwept(page);
+
   Address visitable_start = page->area_start();
   Address end_of_page = page->area_end();
 
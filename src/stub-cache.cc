@@ -44,15 +44,59 @@ namespace internal {
 
 
 StubCache::StubCache(Isolate* isolate, Zone* zone)
-    : isolate_(isolate) {
+    : recent_updates_(0),
+      recent_collisions_(0),
+      isolate_(isolate) {
   ASSERT(isolate == Isolate::Current());
+  int primary_bits = ClampTableBits(FLAG_stub_cache_primary_bits);
+  int secondary_bits = ClampTableBits(FLAG_stub_cache_secondary_bits);
+  primary_size_ = 1 << primary_bits;
+  secondary_size_ = 1 << secondary_bits;
+  max_primary_size_ =
+      1 << Max(primary_bits, ClampTableBits(FLAG_stub_cache_max_primary_bits));
+  max_secondary_size_ = 1 <<
+      Max(secondary_bits, ClampTableBits(FLAG_stub_cache_max_secondary_bits));
+  primary_mask_ = (primary_size_ - 1) << kHeapObjectTagSize;
+  secondary_mask_ = (secondary_size_ - 1) << kHeapObjectTagSize;
+  primary_ = NewArray<Entry>(max_primary_size_);
+  secondary_ = NewArray<Entry>(max_secondary_size_);
+}
+
+
+StubCache::~StubCache() {
+  DeleteArray(primary_);
+  DeleteArray(secondary_);
 }
 
 
 void StubCache::Initialize() {
-  ASSERT(IsPowerOf2(kPrimaryTableSize));
-  ASSERT(IsPowerOf2(kSecondaryTableSize));
+  ASSERT(IsPowerOf2(primary_size_));
+  ASSERT(IsPowerOf2(secondary_size_));
+  Clear();
+  isolate()->counters()->megamorphic_stub_cache_primary_size()->Set(
+      primary_size_);
+}
+
+
+void StubCache::GrowIfThrashing() {
+  // Look at the tables once for every primary_size_ updates.  If more than
+  // half of those updates had to retire a live entry, the working set does
+  // not fit and the probes keep missing into the runtime.
+  if (recent_updates_ < primary_size_) return;
+  bool thrashing = recent_collisions_ * 2 > recent_updates_;
+  recent_updates_ = 0;
+  recent_collisions_ = 0;
+  if (!thrashing || primary_size_ == max_primary_size_) return;
+
+  primary_size_ *= 2;
+  if (secondary_size_ < max_secondary_size_) secondary_size_ *= 2;
+  primary_mask_ = (primary_size_ - 1) << kHeapObjectTagSize;
+  secondary_mask_ = (secondary_size_ - 1) << kHeapObjectTagSize;
+  // The hash of every entry changes with the masks.
   Clear();
+  Counters* counters = isolate()->counters();
+  counters->megamorphic_stub_cache_resizes()->Increment();
+  counters->megamorphic_stub_cache_primary_size()->Set(primary_size_);
 }
 
 
@@ -75,19 +119,29 @@ Code* StubCache::Set(Name* name, Map* map, Code* code) {
   // Make sure that the code type is not included in the hash.
   ASSERT(Code::ExtractTypeFromFlags(flags) == 0);
 
+  GrowIfThrashing();
+
   // Compute the primary entry.
   int primary_offset = PrimaryOffset(name, flags, map);
   Entry* primary = entry(primary_, primary_offset);
   Code* old_code = primary->value;
+  Code* empty = isolate_->builtins()->builtin(Builtins::kIllegal);
+  Counters* counters = isolate()->counters();
 
   // If the primary entry has useful data in it, we retire it to the
   // secondary cache before overwriting it.
-  if (old_code != isolate_->builtins()->builtin(Builtins::kIllegal)) {
+  recent_updates_++;
+  if (old_code != empty) {
+    recent_collisions_++;
+    counters->megamorphic_stub_cache_collisions()->Increment();
     Map* old_map = primary->map;
     Code::Flags old_flags = Code::RemoveTypeFromFlags(old_code->flags());
     int seed = PrimaryOffset(primary->key, old_flags, old_map);
     int secondary_offset = SecondaryOffset(primary->key, old_flags, seed);
     Entry* secondary = entry(secondary_, secondary_offset);
+    if (secondary->value != empty) {
+      counters->megamorphic_stub_cache_evictions()->Increment();
+    }
     *secondary = *primary;
   }
 
@@ -95,7 +149,7 @@ Code* StubCache::Set(Name* name, Map* map, Code* code) {
   primary->key = name;
   primary->value = code;
   primary->map = map;
-  isolate()->counters()->megamorphic_stub_cache_updates()->Increment();
+  counters->megamorphic_stub_cache_updates()->Increment();
   return code;
 }
 
@@ -1032,12 +1086,12 @@ Handle<Code> StubCache::ComputeCallDebugPrepareStepIn(int argc,
 
 void StubCache::Clear() {
   Code* empty = isolate_->builtins()->builtin(Builtins::kIllegal);
-  for (int i = 0; i < kPrimaryTableSize; i++) {
+  for (int i = 0; i < primary_size_; i++) {
     primary_[i].key = heap()->empty_string();
     primary_[i].map = NULL;
     primary_[i].value = empty;
   }
-  for (int j = 0; j < kSecondaryTableSize; j++) {
+  for (int j = 0; j < secondary_size_; j++) {
     secondary_[j].key = heap()->empty_string();
     secondary_[j].map = NULL;
     secondary_[j].value = empty;
@@ -1050,7 +1104,7 @@ void StubCache::CollectMatchingMaps(SmallMapList* types,
                                     Code::Flags flags,
                                     Handle<Context> native_context,
                                     Zone* zone) {
-  for (int i = 0; i < kPrimaryTableSize; i++) {
+  for (int i = 0; i < primary_size_; i++) {
     if (primary_[i].key == *name) {
       Map* map = primary_[i].map;
       // Map can be NULL, if the stub is constant function call
@@ -1065,7 +1119,7 @@ void StubCache::CollectMatchingMaps(SmallMapList* types,
     }
   }
 
-  for (int i = 0; i < kSecondaryTableSize; i++) {
+  for (int i = 0; i < secondary_size_; i++) {
     if (secondary_[i].key == *name) {
       Map* map = secondary_[i].map;
       // Map can be NULL, if the stub is constant function call
@@ -353,6 +353,18 @@ class StubCache {
   }
 
 
+  // The probes mask the hash with the current table size, which they read
+  // from here at runtime.  The mask is scaled by 1 << kHeapObjectTagSize.
+  SCTableReference mask_reference(StubCache::Table table) {
+    return SCTableReference(reinterpret_cast<Address>(
+        table == kPrimary ? &primary_mask_ : &secondary_mask_));
+  }
+
+
+  int primary_size() const { return primary_size_; }
+  int secondary_size() const { return secondary_size_; }
+
+
   StubCache::Entry* first_entry(StubCache::Table table) {
     switch (table) {
       case StubCache::kPrimary: return StubCache::primary_;
@@ -368,6 +380,11 @@ class StubCache {
 
  private:
   StubCache(Isolate* isolate, Zone* zone);
+  ~StubCache();
+
+  // Grows the tables if too many of the recent updates had to evict a live
+  // entry from the primary table.
+  void GrowIfThrashing();
 
   Handle<Code> ComputeCallInitialize(int argc,
                                      RelocInfo::Mode mode,
@@ -383,7 +400,7 @@ class StubCache {
   // Hash algorithm for the primary table.  This algorithm is replicated in
   // assembler for every architecture.  Returns an index into the table that
   // is scaled by 1 << kHeapObjectTagSize.
-  static int PrimaryOffset(Name* name, Code::Flags flags, Map* map) {
+  int PrimaryOffset(Name* name, Code::Flags flags, Map* map) {
     // This works well because the heap object tag size and the hash
     // shift are equal.  Shifting down the length field to get the
     // hash code would effectively throw away two bits of the hash
@@ -403,13 +420,13 @@ class StubCache {
         (static_cast<uint32_t>(flags) & ~Code::kFlagsNotUsedInLookup);
     // Base the offset on a simple combination of name, flags, and map.
     uint32_t key = (map_low32bits + field) ^ iflags;
-    return key & ((kPrimaryTableSize - 1) << kHeapObjectTagSize);
+    return key & primary_mask_;
   }
 
   // Hash algorithm for the secondary table.  This algorithm is replicated in
   // assembler for every architecture.  Returns an index into the table that
   // is scaled by 1 << kHeapObjectTagSize.
-  static int SecondaryOffset(Name* name, Code::Flags flags, int seed) {
+  int SecondaryOffset(Name* name, Code::Flags flags, int seed) {
     // Use the seed from the primary cache in the secondary cache.
     uint32_t name_low32bits =
         static_cast<uint32_t>(reinterpret_cast<uintptr_t>(name));
@@ -418,7 +435,7 @@ class StubCache {
     uint32_t iflags =
         (static_cast<uint32_t>(flags) & ~Code::kFlagsNotUsedInLookup);
     uint32_t key = (seed - name_low32bits) + iflags;
-    return key & ((kSecondaryTableSize - 1) << kHeapObjectTagSize);
+    return key & secondary_mask_;
   }
 
   // Compute the entry for a given offset in exactly the same way as
@@ -432,13 +449,27 @@ class StubCache {
         reinterpret_cast<Address>(table) + offset * multiplier);
   }
 
-  static const int kPrimaryTableBits = 11;
-  static const int kPrimaryTableSize = (1 << kPrimaryTableBits);
-  static const int kSecondaryTableBits = 9;
-  static const int kSecondaryTableSize = (1 << kSecondaryTableBits);
+  // The tables are allocated at their maximum size up front, because the
+  // generated code embeds their addresses.  Only the first primary_size_ and
+  // secondary_size_ entries are in use, the rest is never touched.
+  static const int kMaxTableBits = 16;
+
+  static int ClampTableBits(int bits) {
+    return Max(1, Min(bits, kMaxTableBits));
+  }
 
-  Entry primary_[kPrimaryTableSize];
-  Entry secondary_[kSecondaryTableSize];
+  Entry* primary_;
+  Entry* secondary_;
+  int primary_size_;
+  int secondary_size_;
+  int max_primary_size_;
+  int max_secondary_size_;
+  uint32_t primary_mask_;
+  uint32_t secondary_mask_;
+  // Updates and evictions of live primary entries since the tables were
+  // last checked for thrashing.
+  int recent_updates_;
+  int recent_collisions_;
   Isolate* isolate_;
 
   friend class Isolate;
@@ -47,9 +47,13 @@ SweeperThread::SweeperThread(Isolate* isolate)
        stop_semaphore_(OS::CreateSemaphore(0)),
        free_list_old_data_space_(heap_->paged_space(OLD_DATA_SPACE)),
        free_list_old_pointer_space_(heap_->paged_space(OLD_POINTER_SPACE)),
+       free_list_code_space_(heap_->paged_space(CODE_SPACE)),
+       free_list_map_space_(heap_->paged_space(MAP_SPACE)),
        private_free_list_old_data_space_(heap_->paged_space(OLD_DATA_SPACE)),
        private_free_list_old_pointer_space_(
-           heap_->paged_space(OLD_POINTER_SPACE)) {
+           heap_->paged_space(OLD_POINTER_SPACE)),
+       private_free_list_code_space_(heap_->paged_space(CODE_SPACE)),
+       private_free_list_map_space_(heap_->paged_space(MAP_SPACE)) {
   NoBarrier_Store(&stop_thread_, static_cast<AtomicWord>(false));
 }
 
@@ -74,6 +78,12 @@ void SweeperThread::Run() {
     collector_->SweepInParallel(heap_->old_pointer_space(),
                                 &private_free_list_old_pointer_space_,
                                 &free_list_old_pointer_space_);
+    collector_->SweepInParallel(heap_->code_space(),
+                                &private_free_list_code_space_,
+                                &free_list_code_space_);
+    collector_->SweepInParallel(heap_->map_space(),
+                                &private_free_list_map_space_,
+                                &free_list_map_space_);
     end_sweeping_semaphore_->Signal();
   }
 }
@@ -84,6 +94,10 @@ intptr_t SweeperThread::StealMemory(PagedSpace* space) {
     return space->free_list()->Concatenate(&free_list_old_pointer_space_);
   } else if (space->identity() == OLD_DATA_SPACE) {
     return space->free_list()->Concatenate(&free_list_old_data_space_);
+  } else if (space->identity() == CODE_SPACE) {
+    return space->free_list()->Concatenate(&free_list_code_space_);
+  } else if (space->identity() == MAP_SPACE) {
+    return space->free_list()->Concatenate(&free_list_map_space_);
   }
   return 0;
 }
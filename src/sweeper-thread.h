@@ -65,8 +65,12 @@ class SweeperThread : public Thread {
   Semaphore* stop_semaphore_;
   FreeList free_list_old_data_space_;
   FreeList free_list_old_pointer_space_;
+  FreeList free_list_code_space_;
+  FreeList free_list_map_space_;
   FreeList private_free_list_old_data_space_;
   FreeList private_free_list_old_pointer_space_;
+  FreeList private_free_list_code_space_;
+  FreeList private_free_list_map_space_;
   volatile AtomicWord stop_thread_;
 };
 
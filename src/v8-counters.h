@@ -114,6 +114,10 @@ namespace internal {
   SC(arguments_adaptors, V8.ArgumentsAdaptors)                        \
   SC(compilation_cache_hits, V8.CompilationCacheHits)                 \
   SC(compilation_cache_misses, V8.CompilationCacheMisses)             \
+  SC(preparse_cache_hits, V8.PreparseCacheHits)                       \
+  SC(preparse_cache_misses, V8.PreparseCacheMisses)                   \
+  SC(script_code_cache_hits, V8.ScriptCodeCacheHits)                  \
+  SC(script_code_cache_rejects, V8.ScriptCodeCacheRejects)            \
   SC(regexp_cache_hits, V8.RegExpCacheHits)                           \
   SC(regexp_cache_misses, V8.RegExpCacheMisses)                       \
   SC(string_ctor_calls, V8.StringConstructorCalls)                    \
@@ -168,7 +172,6 @@ namespace internal {
   /* How is the generic keyed-load stub used? */                      \
   SC(keyed_load_generic_smi, V8.KeyedLoadGenericSmi)                  \
   SC(keyed_load_generic_symbol, V8.KeyedLoadGenericSymbol)            \
-  SC(keyed_load_generic_lookup_cache, V8.KeyedLoadGenericLookupCache) \
   SC(keyed_load_generic_slow, V8.KeyedLoadGenericSlow)                \
   SC(keyed_load_polymorphic_stubs, V8.KeyedLoadPolymorphicStubs)      \
   SC(keyed_load_external_array_slow, V8.KeyedLoadExternalArraySlow)   \
@@ -237,6 +240,15 @@ namespace internal {
   SC(megamorphic_stub_cache_probes, V8.MegamorphicStubCacheProbes)    \
   SC(megamorphic_stub_cache_misses, V8.MegamorphicStubCacheMisses)    \
   SC(megamorphic_stub_cache_updates, V8.MegamorphicStubCacheUpdates)  \
+  SC(megamorphic_stub_cache_primary_misses,                           \
+     V8.MegamorphicStubCachePrimaryMisses)                            \
+  SC(megamorphic_stub_cache_collisions,                               \
+     V8.MegamorphicStubCacheCollisions)                               \
+  SC(megamorphic_stub_cache_evictions,                                \
+     V8.MegamorphicStubCacheEvictions)                                \
+  SC(megamorphic_stub_cache_resizes, V8.MegamorphicStubCacheResizes)  \
+  SC(megamorphic_stub_cache_primary_size,                             \
+     V8.MegamorphicStubCachePrimarySize)                              \
   SC(array_function_runtime, V8.ArrayFunctionRuntime)                 \
   SC(array_function_native, V8.ArrayFunctionNative)                   \
   SC(for_in, V8.ForIn)                                                \
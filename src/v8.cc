@@ -40,6 +40,7 @@
 #include "objects.h"
 #include "once.h"
 #include "platform.h"
+#include "preparse-data-cache.h"
 #include "sampler.h"
 #include "runtime-profiler.h"
 #include "serialize.h"
@@ -113,6 +114,7 @@ void V8::TearDown() {
   delete isolate;
 
   ElementsAccessor::TearDown();
+  PreparseDataCache::TearDown();
   LOperand::TearDownCaches();
   ExternalReference::TearDownMathExpData();
   RegisteredExtension::UnregisterAll();
@@ -271,6 +273,8 @@ void V8::InitializeOncePerProcessImpl() {
     FLAG_max_new_space_size = (1 << (kPageSizeBits - 10)) * 2;
   }
   if (FLAG_trace_hydrogen) FLAG_parallel_recompilation = false;
+  // The hydrogen statistics are not synchronized between compiler threads.
+  if (FLAG_hydrogen_stats) FLAG_recompilation_threads = 1;
   OS::SetUp();
   Sampler::SetUp();
   CPU::SetUp();
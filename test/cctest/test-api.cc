@@ -41,6 +41,7 @@
 #include "execution.h"
 #include "objects.h"
 #include "snapshot.h"
+#include "stub-cache.h"
 #include "platform.h"
 #include "utils.h"
 #include "cctest.h"
@@ -13426,6 +13427,72 @@ TEST(PreCompileAPIVariationsAreSame) {
 }
 
 
+static bool IsFunctionCompiled(const char* name) {
+  v8::Local<v8::Value> value = v8::Context::GetCurrent()->Global()->Get(
+      v8_str(name));
+  i::Handle<i::JSFunction> function =
+      i::Handle<i::JSFunction>::cast(v8::Utils::OpenHandle(*value));
+  return function->shared()->is_compiled();
+}
+
+
+TEST(CodeCache) {
+  const char* source =
+      "function used(a) { return a + 1; }\n"
+      "function unused(a) { return a + 2; }\n";
+  const char* other_source =
+      "function used(a) { return a + 3; }\n"
+      "function unused(a) { return a + 4; }\n";
+  char* cache_data = NULL;
+  int cache_length = 0;
+
+  v8::Isolate* isolate = v8::Isolate::New();
+  isolate->Enter();
+  {
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+    v8::Local<v8::Script> script = v8::Script::Compile(v8_str(source));
+    script->Run();
+    CHECK_EQ(2, CompileRun("used(1)")->Int32Value());
+    v8::ScriptData* cache = script->CreateCodeCache();
+    CHECK(cache != NULL);
+    CHECK(!cache->HasError());
+    cache_length = cache->Length();
+    cache_data = i::NewArray<char>(cache_length);
+    i::OS::MemCopy(cache_data, cache->Data(), cache_length);
+    delete cache;
+  }
+  isolate->Exit();
+  isolate->Dispose();
+
+  // The next run compiles the function that was used together with the
+  // script.
+  isolate = v8::Isolate::New();
+  isolate->Enter();
+  {
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+    v8::ScriptData* cache = v8::ScriptData::New(cache_data, cache_length);
+    v8::Script::Compile(v8_str(source), NULL, cache)->Run();
+    CHECK(IsFunctionCompiled("used"));
+    CHECK(!IsFunctionCompiled("unused"));
+    CHECK_EQ(4, CompileRun("used(1) + unused(0)")->Int32Value());
+
+    // The cache does not match a different source of the same length.
+    v8::Script::Compile(v8_str(other_source), NULL, cache)->Run();
+    CHECK(!IsFunctionCompiled("used"));
+    CHECK(!IsFunctionCompiled("unused"));
+    CHECK_EQ(8, CompileRun("used(1) + unused(0)")->Int32Value());
+    delete cache;
+  }
+  isolate->Exit();
+  isolate->Dispose();
+  i::DeleteArray(cache_data);
+}
+
+
 // This tests that we do not allow dictionary load/call inline caches
 // to use functions that have not yet been compiled.  The potential
 // problem of loading a function that has not yet been compiled can
@@ -16216,6 +16283,64 @@ TEST(IdleNotificationWithLargeHint) {
 }
 
 
+// Test that deadline based idle notifications eventually collect garbage.
+TEST(IdleNotificationWithDeadline) {
+  const intptr_t MB = 1024 * 1024;
+  const int kIdleTimeInMs = 100;
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  v8::HandleScope scope(isolate);
+  intptr_t initial_size = HEAP->SizeOfObjects();
+  CreateGarbageInOldSpace();
+  intptr_t size_with_garbage = HEAP->SizeOfObjects();
+  CHECK_GT(size_with_garbage, initial_size + MB);
+  // Without any idle time no work is done.
+  isolate->IdleNotification(0);
+  CHECK_EQ(size_with_garbage, HEAP->SizeOfObjects());
+  bool finished = false;
+  for (int i = 0; i < 200 && !finished; i++) {
+    finished = isolate->IdleNotification(kIdleTimeInMs);
+  }
+  intptr_t final_size = HEAP->SizeOfObjects();
+  CHECK(finished);
+  CHECK_LT(final_size, initial_size + 1);
+
+  v8::GCTimeEstimates estimates;
+  isolate->GetGCTimeEstimates(&estimates);
+  CHECK_GT(estimates.incremental_marking_speed(), 0);
+  CHECK_GT(estimates.full_gc_time_in_ms(), 0);
+  CHECK_GT(estimates.incremental_marking_time_in_ms(), 0);
+}
+
+
+// Test that an isolate that stays inactive during idle notifications gets
+// its memory reduced exactly once.
+TEST(IdleNotificationReducesMemoryWhenInactive) {
+  i::FLAG_memory_reducer_delay = 0;
+  const int kIdleTimeInMs = 100;
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  v8::HandleScope scope(isolate);
+  HEAP->new_space()->Grow();
+  CHECK_GT(HEAP->new_space()->Capacity(),
+           HEAP->new_space()->InitialCapacity());
+  CreateGarbageInOldSpace();
+  bool finished = false;
+  for (int i = 0; i < 200 && !finished; i++) {
+    finished = isolate->IdleNotification(kIdleTimeInMs);
+  }
+  CHECK(finished);
+  unsigned int ms_count = HEAP->ms_count();
+  for (int i = 0; i < 3; i++) {
+    CHECK(isolate->IdleNotification(kIdleTimeInMs));
+  }
+  CHECK_EQ(static_cast<int>(ms_count + 1),
+           static_cast<int>(HEAP->ms_count()));
+  CHECK_EQ(HEAP->new_space()->InitialCapacity(),
+           static_cast<int>(HEAP->new_space()->Capacity()));
+}
+
+
 TEST(Regress2107) {
   const intptr_t MB = 1024 * 1024;
   const int kShortIdlePauseInMs = 100;
@@ -16339,6 +16464,103 @@ THREADED_TEST(GetHeapStatistics) {
 }
 
 
+THREADED_TEST(GetHeapSpaceStatistics) {
+  LocalContext c1;
+  v8::Isolate* isolate = c1->GetIsolate();
+  v8::HandleScope scope(isolate);
+  v8::HeapStatistics heap_statistics;
+  isolate->GetHeapStatistics(&heap_statistics);
+  size_t total_size = 0;
+  size_t total_used_size = 0;
+  for (size_t i = 0; i < isolate->NumberOfHeapSpaces(); i++) {
+    v8::HeapSpaceStatistics space_statistics;
+    CHECK(isolate->GetHeapSpaceStatistics(&space_statistics, i));
+    CHECK_NE(NULL, space_statistics.space_name());
+    CHECK_LE(space_statistics.space_used_size(),
+             space_statistics.space_size());
+    total_size += space_statistics.space_size();
+    total_used_size += space_statistics.space_used_size();
+  }
+  CHECK_EQ(static_cast<int>(heap_statistics.total_heap_size()),
+           static_cast<int>(total_size));
+  CHECK_EQ(static_cast<int>(heap_statistics.used_heap_size()),
+           static_cast<int>(total_used_size));
+  v8::HeapSpaceStatistics space_statistics;
+  CHECK(!isolate->GetHeapSpaceStatistics(&space_statistics,
+                                         isolate->NumberOfHeapSpaces()));
+}
+
+
+static int soft_heap_limit_calls = 0;
+static v8::SoftHeapLimitAction soft_heap_limit_action;
+
+static v8::SoftHeapLimitAction SoftHeapLimitCallback(v8::Isolate* isolate,
+                                                     size_t used_heap_size,
+                                                     size_t* soft_heap_limit) {
+  CHECK_GT(used_heap_size, *soft_heap_limit);
+  soft_heap_limit_calls++;
+  if (soft_heap_limit_action == v8::kSoftHeapLimitRaise) {
+    *soft_heap_limit = used_heap_size + 64 * i::MB;
+  }
+  return soft_heap_limit_action;
+}
+
+
+static void CheckSoftHeapLimitAction(v8::SoftHeapLimitAction action) {
+  soft_heap_limit_calls = 0;
+  soft_heap_limit_action = action;
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  v8::HandleScope scope(isolate);
+  HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+  isolate->SetSoftHeapLimit(HEAP->SizeOfObjects() + i::MB,
+                            SoftHeapLimitCallback);
+  // Below the limit the callback is not called.
+  HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+  CHECK_EQ(0, soft_heap_limit_calls);
+  v8::TryCatch try_catch;
+  CompileRun("var retained = [];"
+             "for (var i = 0; i < 100000; i++) retained.push({ x: [i] });");
+  HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+  CHECK_LE(1, soft_heap_limit_calls);
+  isolate->SetSoftHeapLimit(0, NULL);
+}
+
+
+TEST(SoftHeapLimitRaise) {
+  CheckSoftHeapLimitAction(v8::kSoftHeapLimitRaise);
+  // The raised limit keeps the callback quiet for the rest of the script.
+  CHECK_EQ(1, soft_heap_limit_calls);
+}
+
+
+TEST(SoftHeapLimitReduceMemory) {
+  CheckSoftHeapLimitAction(v8::kSoftHeapLimitReduceMemory);
+}
+
+
+TEST(SoftHeapLimitTerminate) {
+  soft_heap_limit_calls = 0;
+  soft_heap_limit_action = v8::kSoftHeapLimitTerminate;
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  v8::HandleScope scope(isolate);
+  HEAP->CollectAllGarbage(i::Heap::kNoGCFlags);
+  isolate->SetSoftHeapLimit(HEAP->SizeOfObjects() + i::MB,
+                            SoftHeapLimitCallback);
+  // The runaway script is terminated instead of exhausting the heap.
+  v8::TryCatch try_catch;
+  v8::Handle<v8::Value> result =
+      CompileRun("var retained = [];"
+                 "while (true) retained.push({ x: [retained.length] });");
+  CHECK(result.IsEmpty());
+  CHECK(try_catch.HasCaught());
+  CHECK(!try_catch.CanContinue());
+  CHECK_LE(1, soft_heap_limit_calls);
+  isolate->SetSoftHeapLimit(0, NULL);
+}
+
+
 class VisitorImpl : public v8::ExternalResourceVisitor {
  public:
   explicit VisitorImpl(TestResource** resource) {
@@ -16735,6 +16957,50 @@ THREADED_TEST(FunctionGetScriptId) {
 }
 
 
+static int GetSummaryCount(v8::Handle<v8::Object> summary, const char* name) {
+  return summary->Get(v8::String::New(name))->Int32Value();
+}
+
+
+TEST(FunctionGetInlineCacheSummary) {
+  i::FLAG_always_opt = false;
+  LocalContext env;
+  v8::HandleScope scope(env->GetIsolate());
+  CompileRun(
+      "function get(o) { return o.x; }"
+      "var objects = [];"
+      "for (var i = 0; i < 10; i++) {"
+      "  var o = { x: i };"
+      "  o['p' + i] = i;"
+      "  objects.push(o);"
+      "}"
+      "function set(o) { o.y = 1; }"
+      "set({}); set({});");
+  v8::Local<v8::Function> get = v8::Local<v8::Function>::Cast(
+      env->Global()->Get(v8::String::New("get")));
+  v8::Local<v8::Function> set = v8::Local<v8::Function>::Cast(
+      env->Global()->Get(v8::String::New("set")));
+
+  v8::Local<v8::Object> summary = set->GetInlineCacheSummary();
+  CHECK_EQ(1, GetSummaryCount(summary, "monomorphic"));
+  CHECK_EQ(1, GetSummaryCount(summary, "maps"));
+  CHECK_EQ(0, GetSummaryCount(summary, "megamorphic"));
+
+  CompileRun("for (var i = 0; i < objects.length; i++) get(objects[i]);");
+  summary = get->GetInlineCacheSummary();
+  CHECK_EQ(0, GetSummaryCount(summary, "monomorphic"));
+  CHECK_EQ(1, GetSummaryCount(summary, "megamorphic"));
+  v8::Local<v8::Array> positions = v8::Local<v8::Array>::Cast(
+      summary->Get(v8::String::New("megamorphicPositions")));
+  CHECK_EQ(1, positions->Length());
+  CHECK_EQ(0, GetSummaryCount(summary, "deoptCount"));
+
+  // The summary can be exported as JSON.
+  env->Global()->Set(v8::String::New("summary"), summary);
+  ExpectString("JSON.parse(JSON.stringify(summary)).name", "get");
+}
+
+
 static v8::Handle<Value> GetterWhichReturns42(Local<String> name,
                                               const AccessorInfo& info) {
   CHECK(v8::Utils::OpenHandle(*info.This())->IsJSObject());
@@ -18899,6 +19165,52 @@ TEST(PrimaryStubCache) {
 }
 
 
+// Test that the stub cache tables grow when a megamorphic site sees more
+// receiver maps than fit into them.
+TEST(StubCacheGrowsWhenThrashing) {
+  int saved_primary_bits = i::FLAG_stub_cache_primary_bits;
+  int saved_secondary_bits = i::FLAG_stub_cache_secondary_bits;
+  int saved_max_primary_bits = i::FLAG_stub_cache_max_primary_bits;
+  int saved_max_secondary_bits = i::FLAG_stub_cache_max_secondary_bits;
+  i::FLAG_stub_cache_primary_bits = 2;
+  i::FLAG_stub_cache_secondary_bits = 1;
+  i::FLAG_stub_cache_max_primary_bits = 8;
+  i::FLAG_stub_cache_max_secondary_bits = 6;
+  v8::Isolate* isolate = v8::Isolate::New();
+  isolate->Enter();
+  {
+    i::StubCache* stub_cache =
+        reinterpret_cast<i::Isolate*>(isolate)->stub_cache();
+    CHECK_EQ(4, stub_cache->primary_size());
+    CHECK_EQ(2, stub_cache->secondary_size());
+    v8::HandleScope scope(isolate);
+    LocalContext env;
+    CompileRun(
+        "var objects = [];"
+        "for (var i = 0; i < 64; i++) {"
+        "  var o = { x: i };"
+        "  o['p' + i] = i;"
+        "  objects.push(o);"
+        "}"
+        "function get(o) { return o.x; }"
+        "var sum = 0;"
+        "for (var j = 0; j < 100; j++) {"
+        "  for (var i = 0; i < objects.length; i++) sum += get(objects[i]);"
+        "}");
+    CHECK_EQ(100 * 63 * 64 / 2, CompileRun("sum")->Int32Value());
+    CHECK_GT(stub_cache->primary_size(), 4);
+    CHECK_GT(stub_cache->secondary_size(), 2);
+    CHECK_LE(stub_cache->primary_size(), 1 << 8);
+  }
+  isolate->Exit();
+  isolate->Dispose();
+  i::FLAG_stub_cache_primary_bits = saved_primary_bits;
+  i::FLAG_stub_cache_secondary_bits = saved_secondary_bits;
+  i::FLAG_stub_cache_max_primary_bits = saved_max_primary_bits;
+  i::FLAG_stub_cache_max_secondary_bits = saved_max_secondary_bits;
+}
+
+
 static int fatal_error_callback_counter = 0;
 static void CountingErrorCallback(const char* location, const char* message) {
   printf("CountingErrorCallback(\"%s\", \"%s\")\n", location, message);
@@ -376,6 +376,47 @@ TEST(OptimizedCodeSharing) {
 }
 
 
+// Measures how long it takes to optimize a large function with many values
+// that stay live across a long chain of diamonds, which makes the time
+// spent in the register allocator dominate.  Run with --hydrogen-stats for
+// a breakdown by phase.
+TEST(RegisterAllocationOfLargeFunction) {
+  FLAG_allow_natives_syntax = true;
+  CcTest::InitializeVM();
+  v8::HandleScope scope(CcTest::isolate());
+  LocalContext env;
+
+  static const int kValues = 64;
+  static const int kDiamonds = 1000;
+  StringBuilder builder(128 * KB);
+  builder.AddString("function big(a) {\n");
+  for (int i = 0; i < kValues; i++) {
+    builder.AddFormatted("  var v%d = a + %d;\n", i, i);
+  }
+  for (int i = 0; i < kDiamonds; i++) {
+    int x = i % kValues;
+    int y = (i * 7 + 3) % kValues;
+    builder.AddFormatted(
+        "  if (a & %d) { v%d = (v%d + v%d) | 0; } else { v%d = v%d - 1; }\n",
+        1 << (i % 8), x, x, y, y, x);
+  }
+  builder.AddString("  return v0");
+  for (int i = 1; i < kValues; i++) builder.AddFormatted(" + v%d", i);
+  builder.AddString(";\n}\n");
+  SmartArrayPointer<char> source(builder.Finalize());
+  CompileRun(*source);
+
+  double expected = CompileRun("big(1); big(2); big(3)")->NumberValue();
+  int64_t start = OS::Ticks();
+  double result =
+      CompileRun("%OptimizeFunctionOnNextCall(big); big(3)")->NumberValue();
+  int64_t elapsed = OS::Ticks() - start;
+  CHECK_EQ(expected, result);
+  PrintF("RegisterAllocationOfLargeFunction: %d values, %d diamonds, "
+         "%.3f ms\n", kValues, kDiamonds, elapsed / 1000.0);
+}
+
+
 #ifdef ENABLE_DISASSEMBLER
 static Handle<JSFunction> GetJSFunction(v8::Handle<v8::Object> obj,
                                  const char* property_name) {
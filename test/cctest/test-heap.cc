@@ -29,6 +29,7 @@
 
 #include "v8.h"
 
+#include "code-stubs.h"
 #include "compilation-cache.h"
 #include "execution.h"
 #include "factory.h"
@@ -2207,6 +2208,70 @@ TEST(OptimizedPretenuringCallNew) {
   CHECK(HEAP->InOldPointerSpace(*o));
 }
 
+// Test that literals whose copies survive scavenges are pretenured.
+TEST(AllocationSitePretenuring) {
+  i::FLAG_allow_natives_syntax = true;
+  CcTest::InitializeVM();
+  if (!i::FLAG_allocation_site_pretenuring) return;
+  if (i::FLAG_gc_global || i::FLAG_stress_compaction) return;
+  v8::HandleScope scope(CcTest::isolate());
+
+  // Keep all copies alive across the next scavenge.
+  CompileRun(
+      "var survivors = [];"
+      "function f() { return { a: 1, b: 2 }; }"
+      "function g() { return [1, 2, 3]; }"
+      "for (var i = 0; i < 200; i++) {"
+      "  survivors.push(f());"
+      "  survivors.push(g());"
+      "}");
+  HEAP->CollectGarbage(NEW_SPACE);
+
+  v8::Local<v8::Value> res = CompileRun("f();");
+  Handle<JSObject> o =
+      v8::Utils::OpenHandle(*v8::Handle<v8::Object>::Cast(res));
+  CHECK(HEAP->InOldPointerSpace(*o));
+
+  res = CompileRun("g();");
+  o = v8::Utils::OpenHandle(*v8::Handle<v8::Object>::Cast(res));
+  CHECK(HEAP->InOldPointerSpace(*o));
+
+  // Optimized code keeps allocating in old space.
+  res = CompileRun("%OptimizeFunctionOnNextCall(f); f(); f();");
+  o = v8::Utils::OpenHandle(*v8::Handle<v8::Object>::Cast(res));
+  CHECK(HEAP->InOldPointerSpace(*o));
+}
+
+
+// Test that the literal clone stubs can be built while they gather
+// pretenuring feedback.
+TEST(AllocationSitePretenuringCloneStubs) {
+  i::FLAG_allocation_site_pretenuring = true;
+  CcTest::InitializeVM();
+  Isolate* isolate = Isolate::Current();
+  v8::HandleScope scope(CcTest::isolate());
+
+  for (int i = 0; i <= FastCloneShallowArrayStub::LAST_CLONE_MODE; i++) {
+    FastCloneShallowArrayStub::Mode mode =
+        static_cast<FastCloneShallowArrayStub::Mode>(i);
+    FastCloneShallowArrayStub tracking(mode, TRACK_ALLOCATION_SITE, 3);
+    CHECK(tracking.GetCode(isolate)->IsCode());
+    FastCloneShallowArrayStub not_tracking(mode, DONT_TRACK_ALLOCATION_SITE, 3);
+    CHECK(not_tracking.GetCode(isolate)->IsCode());
+  }
+
+  FastCloneShallowObjectStub object_stub(2);
+  CHECK(object_stub.GetCode(isolate)->IsCode());
+
+  // Run the stubs on undecided sites.
+  v8::Local<v8::Value> res = CompileRun(
+      "function f() { return { a: 1, b: 2 }; }"
+      "function g() { return [1.5, 2.5, 3.5]; }"
+      "f(); g(); f(); g().length + f().b;");
+  CHECK_EQ(5, res->Int32Value());
+}
+
+
 static int CountMapTransitions(Map* map) {
   return map->transitions()->number_of_transitions();
 }
@@ -3179,3 +3244,161 @@ TEST(IncrementalMarkingStepMakesBigProgressWithLargeObjects) {
   marking->Step(100 * MB, IncrementalMarking::NO_GC_VIA_STACK_GUARD);
   ASSERT(marking->IsComplete());
 }
+
+
+TEST(ParallelScavenge) {
+  i::FLAG_parallel_scavenge = true;
+  i::FLAG_scavenger_threads = 2;
+  CcTest::InitializeVM();
+  Isolate* isolate = Isolate::Current();
+  Heap* heap = isolate->heap();
+  Factory* factory = isolate->factory();
+  v8::HandleScope scope(CcTest::isolate());
+  CHECK(heap->parallel_scavenger()->CanScavengeInParallel());
+
+  // An old-space array referencing new-space objects exercises the slots
+  // that are shared between the scavenging tasks.
+  static const int kLength = 1000;
+  Handle<FixedArray> old_array = factory->NewFixedArray(kLength, TENURED);
+  for (int i = 0; i < kLength; i++) {
+    Handle<HeapNumber> number = factory->NewHeapNumber(i);
+    old_array->set(i, *number);
+  }
+  Handle<FixedArray> new_array = factory->NewFixedArray(kLength);
+  for (int i = 0; i < kLength; i++) {
+    new_array->set(i, old_array->get(i));
+  }
+  CHECK(heap->InNewSpace(*new_array));
+  CHECK(heap->InNewSpace(old_array->get(0)));
+
+  CompileRun("var list = null;"
+             "for (var i = 0; i < 10000; i++) {"
+             "  list = { value: i, next: list, s: 'x' + i };"
+             "}");
+
+  for (int i = 0; i < 3; i++) heap->CollectGarbage(NEW_SPACE);
+
+  for (int i = 0; i < kLength; i++) {
+    CHECK_EQ(static_cast<double>(i),
+             HeapNumber::cast(old_array->get(i))->value());
+    CHECK_EQ(old_array->get(i), new_array->get(i));
+  }
+  CHECK(!heap->InNewSpace(old_array->get(0)));
+
+  v8::Local<v8::Value> sum = CompileRun(
+      "var sum = 0;"
+      "for (var o = list; o != null; o = o.next) {"
+      "  if (o.s != 'x' + o.value) throw 'bad string';"
+      "  sum += o.value;"
+      "}"
+      "sum;");
+  CHECK_EQ(49995000, sum->Int32Value());
+}
+
+
+static GCIdleTimeHandler::HeapState DefaultIdleTimeHeapState() {
+  GCIdleTimeHandler::HeapState state;
+  state.contexts_disposed = 0;
+  state.size_of_objects = 10 * MB;
+  state.new_space_size = 0;
+  state.new_space_capacity = 1 * MB;
+  state.incremental_marking_stopped = false;
+  state.incremental_marking_complete = false;
+  state.can_start_incremental_marking = true;
+  state.sweeping_in_progress = false;
+  return state;
+}
+
+
+TEST(GCIdleTimeHandler) {
+  GCIdleTimeHandler handler;
+  GCIdleTimeHandler::HeapState state = DefaultIdleTimeHeapState();
+
+  // Without idle time nothing is done.
+  CHECK_EQ(GCIdleTimeAction::DO_NOTHING, handler.Compute(0, state).type());
+
+  // The step size follows the measured marking speed.
+  GCIdleTimeAction action = handler.Compute(10, state);
+  CHECK_EQ(GCIdleTimeAction::DO_INCREMENTAL_MARKING, action.type());
+  intptr_t initial_step = action.step_size();
+  CHECK_GT(initial_step, 0);
+  handler.RecordIncrementalMarkingStep(10 * MB, 1);
+  action = handler.Compute(10, state);
+  CHECK_EQ(GCIdleTimeAction::DO_INCREMENTAL_MARKING, action.type());
+  CHECK_GT(action.step_size(), initial_step);
+
+  // An almost full new space is scavenged if the scavenge fits.
+  state.new_space_size = state.new_space_capacity;
+  CHECK_EQ(GCIdleTimeAction::DO_INCREMENTAL_MARKING,
+           handler.Compute(1, state).type());
+  handler.RecordScavenge(1 * MB, 1);
+  CHECK_EQ(GCIdleTimeAction::DO_SCAVENGE, handler.Compute(1, state).type());
+  state.new_space_size = 0;
+
+  // Complete marking is finalized once the finalization fits.
+  state.incremental_marking_complete = true;
+  CHECK_EQ(GCIdleTimeAction::DO_NOTHING, handler.Compute(1, state).type());
+  handler.RecordFinalization(100 * MB, 1);
+  CHECK_EQ(GCIdleTimeAction::DO_FINALIZE_MARKING,
+           handler.Compute(1, state).type());
+  state.incremental_marking_complete = false;
+
+  // Disposed contexts trigger a full GC while marking is stopped.
+  state.incremental_marking_stopped = true;
+  state.contexts_disposed = 1;
+  CHECK_EQ(GCIdleTimeAction::DO_INCREMENTAL_MARKING,
+           handler.Compute(1, state).type());
+  handler.RecordMarkCompact(100 * MB, 1);
+  CHECK_EQ(GCIdleTimeAction::DO_FULL_GC, handler.Compute(1, state).type());
+  state.contexts_disposed = 0;
+
+  // Sweeping comes before starting marking.
+  state.sweeping_in_progress = true;
+  CHECK_EQ(GCIdleTimeAction::DO_SWEEPING, handler.Compute(10, state).type());
+  state.sweeping_in_progress = false;
+
+  // Nothing left to do.
+  state.can_start_incremental_marking = false;
+  CHECK_EQ(GCIdleTimeAction::DONE, handler.Compute(10, state).type());
+  CHECK_EQ(GCIdleTimeAction::DONE, handler.Compute(0, state).type());
+}
+
+
+TEST(ReduceMemory) {
+  i::FLAG_stress_compaction = false;
+  CcTest::InitializeVM();
+  Isolate* isolate = Isolate::Current();
+  Heap* heap = isolate->heap();
+  Factory* factory = isolate->factory();
+  v8::HandleScope scope(CcTest::isolate());
+
+  heap->new_space()->Grow();
+  CHECK_GT(heap->new_space()->Capacity(),
+           heap->new_space()->InitialCapacity());
+
+  // Keep every tenth array alive to spread the live objects over many
+  // old space pages.
+  static const int kArrays = 5000;
+  static const int kSurvivors = kArrays / 10;
+  Handle<FixedArray> survivors = factory->NewFixedArray(kSurvivors, TENURED);
+  {
+    AlwaysAllocateScope always_allocate;
+    for (int i = 0; i < kArrays; i++) {
+      HandleScope inner_scope(isolate);
+      Handle<FixedArray> array = factory->NewFixedArray(100, TENURED);
+      array->set(0, Smi::FromInt(i));
+      if (i % 10 == 0) survivors->set(i / 10, *array);
+    }
+  }
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+  intptr_t old_space_before = heap->old_pointer_space()->CommittedMemory();
+
+  CHECK_GT(heap->ReduceMemory("test"), 0);
+  CHECK_LT(heap->old_pointer_space()->CommittedMemory(), old_space_before);
+  CHECK_EQ(heap->new_space()->InitialCapacity(),
+           static_cast<int>(heap->new_space()->Capacity()));
+  for (int i = 0; i < kSurvivors; i++) {
+    FixedArray* array = FixedArray::cast(survivors->get(i));
+    CHECK_EQ(Smi::FromInt(i * 10), array->get(0));
+  }
+}
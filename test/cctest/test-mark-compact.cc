@@ -72,6 +72,232 @@ TEST(MarkingDeque) {
 }
 
 
+TEST(MarkingDequeOverflowList) {
+  CcTest::InitializeVM();
+  int mem_size = 20 * kPointerSize;
+  byte* mem = NewArray<byte>(20*kPointerSize);
+  Address low = reinterpret_cast<Address>(mem);
+  Address high = low + mem_size;
+  MarkingDeque s;
+  s.Initialize(low, high);
+  List<HeapObject*> overflow_list;
+  s.set_overflow_list(&overflow_list);
+
+  Address current_address = reinterpret_cast<Address>(&s);
+  while (!s.IsFull()) {
+    s.PushBlack(HeapObject::FromAddress(current_address));
+    current_address += kPointerSize;
+  }
+  CHECK_EQ(s.mask(), s.Length());
+
+  // Objects that do not fit are kept in the list instead of overflowing.
+  s.PushBlack(HeapObject::FromAddress(current_address));
+  CHECK(!s.overflowed());
+  CHECK_EQ(1, overflow_list.length());
+  CHECK_EQ(current_address, overflow_list[0]->address());
+
+  DeleteArray(mem);
+}
+
+
+TEST(ParallelMarking) {
+  FLAG_parallel_marking = true;
+  FLAG_marking_threads = 2;
+  FLAG_parallel_marking_threshold = 1;
+  CcTest::InitializeVM();
+  Heap* heap = HEAP;
+  v8::HandleScope scope(CcTest::isolate());
+  CHECK(heap->mark_compact_collector()->parallel_marker()->IsEnabled());
+
+  // A wide and deep object graph mixing objects marked by all tasks with
+  // functions and maps that are handed back to the main thread.
+  CompileRun("var root = [];"
+             "for (var i = 0; i < 200; i++) {"
+             "  var list = null;"
+             "  for (var j = 0; j < 50; j++) {"
+             "    list = { next: list, value: i * 50 + j, s: 'v' + j,"
+             "             f: function() { return j; } };"
+             "  }"
+             "  root.push(list);"
+             "}");
+
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+
+  v8::Local<v8::Value> sum = CompileRun(
+      "var sum = 0;"
+      "for (var i = 0; i < root.length; i++) {"
+      "  for (var o = root[i]; o != null; o = o.next) {"
+      "    if (o.s != 'v' + (o.value % 50)) throw 'bad string';"
+      "    sum += o.value + o.f();"
+      "  }"
+      "}"
+      "sum;");
+  CHECK_EQ(49995000 + 200 * 50 * 50, sum->Int32Value());
+}
+
+
+TEST(ParallelIncrementalMarking) {
+  if (!FLAG_incremental_marking) return;
+  FLAG_parallel_incremental_marking = true;
+  FLAG_marking_threads = 2;
+  FLAG_parallel_marking_threshold = 1;
+  CcTest::InitializeVM();
+  Heap* heap = HEAP;
+  v8::HandleScope scope(CcTest::isolate());
+  ParallelMarker* parallel_marker =
+      heap->mark_compact_collector()->parallel_marker();
+  CHECK(parallel_marker->IsEnabledForIncrementalMarking());
+
+  CompileRun("var root = [];"
+             "function addLists(n) {"
+             "  for (var i = 0; i < n; i++) {"
+             "    var list = null;"
+             "    for (var j = 0; j < 50; j++) {"
+             "      list = { next: list, value: root.length * 50 + j,"
+             "               s: 'v' + j, f: function() { return j; } };"
+             "    }"
+             "    root.push(list);"
+             "  }"
+             "}"
+             "addLists(100);");
+
+  MarkCompactCollector* collector = heap->mark_compact_collector();
+  if (collector->IsConcurrentSweepingInProgress()) {
+    collector->WaitUntilSweepingCompleted();
+  }
+  IncrementalMarking* marking = heap->incremental_marking();
+  marking->Start();
+  CHECK(marking->IsMarking());
+
+  // Small steps leave work behind after every round.  Objects allocated and
+  // stored into marked objects in between have to be found through the
+  // write barrier.
+  for (int i = 0; i < 100 && !marking->IsComplete(); i++) {
+    marking->Step(16 * KB, IncrementalMarking::NO_GC_VIA_STACK_GUARD);
+    if (i < 10) CompileRun("addLists(10);");
+  }
+  CHECK(parallel_marker->main_thread_objects()->is_empty());
+
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+
+  v8::Local<v8::Value> sum = CompileRun(
+      "var sum = 0;"
+      "for (var i = 0; i < root.length; i++) {"
+      "  for (var o = root[i]; o != null; o = o.next) {"
+      "    if (o.s != 'v' + (o.value % 50)) throw 'bad string';"
+      "    sum += o.value + o.f();"
+      "  }"
+      "}"
+      "sum;");
+  CHECK_EQ(49995000 + 200 * 50 * 50, sum->Int32Value());
+}
+
+
+TEST(ParallelCompaction) {
+  FLAG_parallel_compaction = true;
+  FLAG_marking_threads = 2;
+  FLAG_always_compact = true;
+  CcTest::InitializeVM();
+  Heap* heap = HEAP;
+  v8::HandleScope scope(CcTest::isolate());
+  CHECK(heap->mark_compact_collector()->parallel_evacuator()->IsEnabled());
+
+  // Fragment old space by dropping every other list, so that there are
+  // candidates to evacuate, and keep some fresh objects in new space.
+  CompileRun("var root = [];"
+             "for (var i = 0; i < 400; i++) {"
+             "  var list = null;"
+             "  for (var j = 0; j < 50; j++) {"
+             "    list = { next: list, value: i * 50 + j, s: 'v' + j,"
+             "             d: [j, j + 0.5] };"
+             "  }"
+             "  root.push(list);"
+             "}");
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+  CompileRun("for (var i = 0; i < 400; i += 2) root[i] = null;"
+             "var young = [];"
+             "for (var i = 0; i < 100; i++) young.push({ value: i });");
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+
+  v8::Local<v8::Value> sum = CompileRun(
+      "var sum = 0;"
+      "for (var i = 1; i < root.length; i += 2) {"
+      "  for (var o = root[i]; o != null; o = o.next) {"
+      "    if (o.s != 'v' + (o.value % 50)) throw 'bad string';"
+      "    if (o.d[1] != (o.value % 50) + 0.5) throw 'bad array';"
+      "    sum += o.value;"
+      "  }"
+      "}"
+      "for (var i = 0; i < young.length; i++) sum += young[i].value;"
+      "sum;");
+  // Odd lists hold 50 * (50 * i) + 1225 for i = 1, 3, ..., 399.
+  CHECK_EQ(2500 * 40000 + 200 * 1225 + 4950, sum->Int32Value());
+}
+
+
+TEST(ConcurrentSweeping) {
+  FLAG_concurrent_sweeping = true;
+  FLAG_sweeper_threads = 1;
+  CcTest::InitializeVM();
+  Heap* heap = HEAP;
+  MarkCompactCollector* collector = heap->mark_compact_collector();
+  v8::HandleScope scope(CcTest::isolate());
+  CHECK(collector->AreSweeperThreadsActivated());
+
+  // Tenure several pages worth of objects, every fourth of them with a map
+  // of its own, and drop most of them again.
+  CompileRun("var root = [];"
+             "for (var i = 0; i < 20000; i++) {"
+             "  var o = { value: i, s: 'v' + i, d: [i, i + 0.5] };"
+             "  if (i % 4 == 0) o['p' + i] = i;"
+             "  root.push(o);"
+             "}");
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+  CompileRun("for (var i = 0; i < root.length; i++) {"
+             "  if (i % 10 != 0) root[i] = null;"
+             "}");
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK(collector->IsConcurrentSweepingInProgress());
+
+  // Allocating tenured memory sweeps pages on demand if needed.
+  for (int i = 0; i < 100; i++) {
+    heap->isolate()->factory()->NewFixedArray(1000, TENURED);
+  }
+  while (collector->SweepPendingPage(heap->old_data_space()) >= 0) { }
+
+  // Iterating map space has to finish sweeping of its pages first.
+  int maps = 0;
+  HeapObjectIterator it(heap->map_space());
+  for (HeapObject* obj = it.Next(); obj != NULL; obj = it.Next()) {
+    if (obj->IsMap()) maps++;
+  }
+  CHECK_GT(maps, 0);
+  PageIterator pages(heap->map_space());
+  while (pages.has_next()) {
+    CHECK_EQ(MemoryChunk::PARALLEL_SWEEPING_DONE,
+             pages.next()->parallel_sweeping());
+  }
+
+  const char* check =
+      "var sum = 0;"
+      "for (var i = 0; i < root.length; i += 10) {"
+      "  var o = root[i];"
+      "  if (o.s != 'v' + i) throw 'bad string';"
+      "  if (o.d[1] != i + 0.5) throw 'bad array';"
+      "  if (i % 4 == 0 && o['p' + i] != i) throw 'bad property';"
+      "  sum += o.value;"
+      "}"
+      "sum;";
+  CHECK_EQ(19990000, CompileRun(check)->Int32Value());
+
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+  CHECK_EQ(19990000, CompileRun(check)->Int32Value());
+}
+
+
 TEST(Promotion) {
   // This test requires compaction. If compaction is turned off, we
   // skip the entire test.
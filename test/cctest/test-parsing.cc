@@ -36,6 +36,7 @@
 #include "execution.h"
 #include "isolate.h"
 #include "parser.h"
+#include "preparse-data-cache.h"
 #include "preparser.h"
 #include "scanner-character-streams.h"
 #include "token.h"
@@ -1318,3 +1319,66 @@ TEST(PreparserStrictOctal) {
   CHECK_EQ("SyntaxError: Octal literals are not allowed in strict mode.",
            *exception);
 }
+
+
+// Builds a script that is large enough to be preparsed and consists mostly
+// of lazily compiled functions.
+static void BuildLibraryScript(i::Vector<char> buffer) {
+  int length = 0;
+  for (int i = 0; i < 100; i++) {
+    length += i::OS::SNPrintF(buffer + length,
+                              "function f%d(a) { return a + %d; }\n", i, i);
+  }
+  i::OS::SNPrintF(buffer + length, "f99(1);");
+}
+
+
+static int CompileAndRunInNewIsolate(const char* source) {
+  v8::Isolate* isolate = v8::Isolate::New();
+  isolate->Enter();
+  int result;
+  {
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+    result = v8::Script::Compile(v8::String::New(source))->Run()->Int32Value();
+  }
+  isolate->Exit();
+  isolate->Dispose();
+  return result;
+}
+
+
+TEST(PreparseDataCacheSharedBetweenIsolates) {
+  i::ScopedVector<char> source(8 * i::KB);
+  BuildLibraryScript(source);
+  CHECK_GT(i::StrLength(source.start()), i::FLAG_min_preparse_length);
+
+  i::PreparseDataCache::Clear();
+  CHECK_EQ(100, CompileAndRunInNewIsolate(source.start()));
+  CHECK_EQ(0, i::PreparseDataCache::hits());
+  CHECK_EQ(1, i::PreparseDataCache::misses());
+  CHECK_EQ(1, i::PreparseDataCache::entries());
+
+  // The second isolate reuses the preparse data of the first one.
+  CHECK_EQ(100, CompileAndRunInNewIsolate(source.start()));
+  CHECK_EQ(1, i::PreparseDataCache::hits());
+  CHECK_EQ(1, i::PreparseDataCache::misses());
+  CHECK_EQ(1, i::PreparseDataCache::entries());
+  i::PreparseDataCache::Clear();
+}
+
+
+TEST(PreparseDataCacheBounded) {
+  i::ScopedVector<char> source(8 * i::KB);
+  BuildLibraryScript(source);
+
+  int cache_size = i::FLAG_preparse_cache_size;
+  i::FLAG_preparse_cache_size = 0;
+  i::PreparseDataCache::Clear();
+  CHECK_EQ(100, CompileAndRunInNewIsolate(source.start()));
+  CHECK_EQ(1, i::PreparseDataCache::misses());
+  CHECK_EQ(0, i::PreparseDataCache::entries());
+  CHECK_EQ(0, static_cast<int>(i::PreparseDataCache::size_in_bytes()));
+  i::FLAG_preparse_cache_size = cache_size;
+}
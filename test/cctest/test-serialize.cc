@@ -630,6 +630,105 @@ DEPENDENT_TEST(ContextDeserialization, ContextSerialization) {
 }
 
 
+// Legacy InvocationCallbacks are tracked in the per-isolate CallbackTable,
+// which is not part of the snapshot, so native functions in a snapshot blob
+// must use the FunctionCallback signature.
+static void SnapshotBlobAnswer(
+    const v8::FunctionCallbackInfo<v8::Value>& info) {
+  info.GetReturnValue().Set(42);
+}
+
+
+static const intptr_t snapshot_blob_references[] = {
+  reinterpret_cast<intptr_t>(SnapshotBlobAnswer),
+  0
+};
+
+
+class SnapshotBlobExtension : public v8::Extension {
+ public:
+  SnapshotBlobExtension()
+      : v8::Extension("snapshot-blob", "native function answer();") { }
+  virtual v8::Handle<v8::FunctionTemplate> GetNativeFunction(
+      v8::Handle<v8::String> name) {
+    return v8::FunctionTemplate::New(SnapshotBlobAnswer);
+  }
+};
+
+
+TEST(SnapshotDataBlob) {
+  if (!Snapshot::HaveASnapshotToStartFrom()) {
+    v8::V8::SetEmbedderExternalReferences(snapshot_blob_references);
+    v8::RegisterExtension(new SnapshotBlobExtension());
+    const char* extension_names[] = { "snapshot-blob" };
+    v8::ExtensionConfiguration extensions(1, extension_names);
+    v8::StartupData blob = v8::V8::CreateSnapshotDataBlob(
+        "var cached = answer();"
+        "function f() { return cached + answer(); }",
+        &extensions);
+    CHECK_NE(NULL, blob.data);
+
+    FILE* fp = OS::FOpen(FLAG_testing_serialization_file, "wb");
+    CHECK_NE(NULL, fp);
+    CHECK_EQ(blob.raw_size,
+             static_cast<int>(fwrite(blob.data, 1, blob.raw_size, fp)));
+    fclose(fp);
+    delete[] blob.data;
+  }
+}
+
+
+DEPENDENT_TEST(SnapshotDataBlobDeserialization, SnapshotDataBlob) {
+  if (!Snapshot::HaveASnapshotToStartFrom()) {
+    v8::V8::SetEmbedderExternalReferences(snapshot_blob_references);
+    int size = 0;
+    byte* data = ReadBytes(FLAG_testing_serialization_file, &size);
+    v8::StartupData blob = { reinterpret_cast<const char*>(data), size, size };
+    CHECK(v8::V8::SetSnapshotDataBlob(&blob));
+
+    v8::Isolate* isolate = v8::Isolate::GetCurrent();
+    {
+      v8::HandleScope scope(isolate);
+      v8::Local<v8::Context> context = v8::Context::New(isolate);
+      v8::Context::Scope context_scope(context);
+      // The script ran when the snapshot was created, the native function is
+      // bound to the registered callback.
+      CHECK_EQ(84, CompileRun("f()")->Int32Value());
+      CHECK_EQ(42, CompileRun("cached")->Int32Value());
+    }
+    v8::V8::Dispose();
+    DeleteArray(data);
+  }
+}
+
+
+// Test that functions are left to lazy compilation in a snapshot and can
+// still be called afterwards.
+TEST(SerializeResetsCompiledFunctions) {
+  if (!Snapshot::HaveASnapshotToStartFrom()) {
+    Serializer::Enable();
+    v8::V8::Initialize();
+    v8::Isolate* isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+    CompileRun("function g() { return 1; } g();");
+    v8::Local<v8::Function> api_g = v8::Local<v8::Function>::Cast(
+        context->Global()->Get(v8_str("g")));
+    Handle<JSFunction> g = v8::Utils::OpenHandle(*api_g);
+    CHECK(g->shared()->is_compiled());
+
+    Serializer::ResetCompiledFunctions();
+    CHECK(!g->shared()->is_compiled());
+    CHECK(!g->is_compiled());
+
+    CHECK_EQ(1, CompileRun("g()")->Int32Value());
+    CHECK(g->shared()->is_compiled());
+    CHECK(g->is_compiled());
+  }
+}
+
+
 TEST(TestThatAlwaysSucceeds) {
 }
 
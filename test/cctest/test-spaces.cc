@@ -404,3 +404,54 @@ TEST(LargeObjectSpace) {
 
   CHECK(lo->AllocateRaw(lo_size, NOT_EXECUTABLE)->IsFailure());
 }
+
+
+TEST(LocalAllocationBuffer) {
+  v8::V8::Initialize();
+  Heap* heap = HEAP;
+  heap->CollectAllGarbage(Heap::kMakeHeapIterableMask);
+  OldSpace* space = heap->old_data_space();
+
+  // Buffers never expand the space themselves.
+  CHECK(space->EnsureAvailable(4 * LocalAllocationBuffer::kSize));
+
+  LocalAllocationBuffer buffer;
+  buffer.Initialize(heap, OLD_DATA_SPACE);
+  const int kObjectSize = 4 * kPointerSize;
+  CHECK_EQ(NULL, buffer.AllocateLinearly(kObjectSize));
+  HeapObject* object =
+      HeapObject::cast(buffer.SlowAllocateRaw(kObjectSize)->ToObjectChecked());
+  heap->CreateFillerObjectAt(object->address(), kObjectSize);
+  CHECK(space->Contains(object));
+  CHECK_EQ(object->address() + kObjectSize, buffer.top());
+  CHECK_LE(buffer.limit() - buffer.top(), LocalAllocationBuffer::kSize);
+  // The buffer was split off the linear allocation area of the space.
+  CHECK_EQ(buffer.limit(), space->top());
+
+  // Small objects are bump allocated without touching the space.
+  Address space_top = space->top();
+  while (buffer.limit() - buffer.top() >= 2 * kObjectSize) {
+    Address expected = buffer.top();
+    object = buffer.AllocateLinearly(kObjectSize);
+    CHECK_EQ(expected, object->address());
+    heap->CreateFillerObjectAt(object->address(), kObjectSize);
+  }
+  CHECK_EQ(space_top, space->top());
+
+  // Large objects do not come from the buffer.
+  const int kLargeObjectSize =
+      LocalAllocationBuffer::kMaxObjectSize + kPointerSize;
+  Address buffer_top = buffer.top();
+  object = HeapObject::cast(
+      buffer.SlowAllocateRaw(kLargeObjectSize)->ToObjectChecked());
+  heap->CreateFillerObjectAt(object->address(), kLargeObjectSize);
+  CHECK(object->address() != buffer_top);
+  CHECK_EQ(buffer_top, buffer.top());
+
+  // Closing the buffer hands the rest back to the space.
+  bool borders_linear_area = space->top() == buffer.limit();
+  buffer.Close();
+  CHECK(buffer.top() == NULL && buffer.limit() == NULL);
+  if (borders_linear_area) CHECK_EQ(buffer_top, space->top());
+  heap->CollectAllGarbage(Heap::kNoGCFlags);
+}
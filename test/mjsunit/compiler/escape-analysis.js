@@ -0,0 +1,131 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --use-escape-analysis
+
+// Test stores and loads on an allocation that does not escape.
+(function testSimple() {
+  function Point(x, y) {
+    this.x = x;
+    this.y = y;
+  }
+  function length2(a, b) {
+    var p = new Point(a, b);
+    return p.x * p.x + p.y * p.y;
+  }
+  assertEquals(25, length2(3, 4));
+  assertEquals(25, length2(3, 4));
+  %OptimizeFunctionOnNextCall(length2);
+  assertEquals(25, length2(3, 4));
+  assertEquals(169, length2(5, 12));
+})();
+
+
+// Test field values merged at control flow joins and loops.
+(function testJoinsAndLoops() {
+  function Counter() {
+    this.value = 0;
+  }
+  function count(n, flag) {
+    var c = new Counter();
+    for (var i = 0; i < n; i++) {
+      if (flag) {
+        c.value += 2;
+      } else {
+        c.value += 1;
+      }
+    }
+    return c.value;
+  }
+  assertEquals(10, count(5, true));
+  assertEquals(5, count(5, false));
+  %OptimizeFunctionOnNextCall(count);
+  assertEquals(20, count(10, true));
+  assertEquals(10, count(10, false));
+  assertEquals(0, count(0, true));
+})();
+
+
+// Test materialization of the object on deoptimization.
+(function testDeoptimize() {
+  function Pair(a, b) {
+    this.a = a;
+    this.b = b;
+  }
+  function make(x, y, deopt) {
+    var p = new Pair(x, y);
+    p.b = p.b * 2;
+    if (deopt) %DeoptimizeFunction(make);
+    return p.a + p.b;
+  }
+  assertEquals(6, make(1, 2.5, false));
+  assertEquals(6, make(1, 2.5, false));
+  %OptimizeFunctionOnNextCall(make);
+  assertEquals(6, make(1, 2.5, false));
+  assertEquals(6, make(1, 2.5, true));
+  assertEquals(9, make(2, 3.5, true));
+})();
+
+
+// Test deoptimization inside of an inlined constructor.
+(function testDeoptimizeInConstructor() {
+  var deopt = false;
+  function Box(v) {
+    this.v = v;
+    if (deopt) %DeoptimizeFunction(unbox);
+    this.w = this.v + 1;
+  }
+  function unbox(v) {
+    var b = new Box(v);
+    return b.v + b.w;
+  }
+  assertEquals(3, unbox(1));
+  assertEquals(3, unbox(1));
+  %OptimizeFunctionOnNextCall(unbox);
+  assertEquals(5, unbox(2));
+  deopt = true;
+  assertEquals(7, unbox(3));
+})();
+
+
+// Test that changing the prototype of a constructor is observed.
+(function testInitialMapChange() {
+  function C() {
+    this.f = 1;
+  }
+  function make() {
+    var c = new C();
+    return c.f;
+  }
+  assertEquals(1, make());
+  assertEquals(1, make());
+  %OptimizeFunctionOnNextCall(make);
+  assertEquals(1, make());
+  C.prototype = { g: 2 };
+  assertEquals(1, make());
+  assertEquals(2, new C().g);
+})();
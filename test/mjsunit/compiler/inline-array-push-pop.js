@@ -0,0 +1,127 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Test inlined Array.prototype.push and pop on the fast elements kinds.
+
+function push(a, v) {
+  return a.push(v);
+}
+
+function pop(a) {
+  return a.pop();
+}
+
+// Push into smi elements, growing the backing store several times.
+(function testPushSmi() {
+  function build(n) {
+    var a = [];
+    for (var i = 0; i < n; i++) a.push(i);
+    return a;
+  }
+  build(3);
+  build(3);
+  %OptimizeFunctionOnNextCall(build);
+  var a = build(100);
+  assertEquals(100, a.length);
+  for (var i = 0; i < 100; i++) assertEquals(i, a[i]);
+})();
+
+
+// Push returns the new length, pop returns the removed element.
+(function testPushPop() {
+  var a = [1, 2];
+  a.push(3);
+  assertEquals(4, push(a, 4));
+  assertEquals(4, pop(a));
+  %OptimizeFunctionOnNextCall(push);
+  %OptimizeFunctionOnNextCall(pop);
+  assertEquals(4, push(a, 5));
+  assertEquals([1, 2, 3, 5], a);
+  assertEquals(5, pop(a));
+  assertEquals(3, pop(a));
+  assertEquals(2, a.length);
+  assertEquals(2, pop(a));
+  assertEquals(1, pop(a));
+  assertEquals(undefined, pop(a));
+  assertEquals(0, a.length);
+})();
+
+
+// Values that do not fit the elements kind deoptimize before the array is
+// modified.
+(function testPushDouble() {
+  function pushDouble(a, v) {
+    return a.push(v);
+  }
+  var a = [1.5, 2.5];
+  assertEquals(3, pushDouble(a, 3.5));
+  assertEquals(4, pushDouble(a, 4.5));
+  %OptimizeFunctionOnNextCall(pushDouble);
+  assertEquals(5, pushDouble(a, 5.5));
+  assertEquals(6, pushDouble(a, undefined));
+  assertEquals([1.5, 2.5, 3.5, 4.5, 5.5, undefined], a);
+})();
+
+
+// Holes found by pop are looked up in the prototype chain.
+(function testPopHoley() {
+  function popHoley(a) {
+    return a.pop();
+  }
+  var a = [1, , 3];
+  assertEquals(3, popHoley(a));
+  a = ["a", , "b"];
+  assertEquals("b", popHoley(a));
+  %OptimizeFunctionOnNextCall(popHoley);
+  assertEquals(undefined, popHoley(a));
+  assertEquals(1, a.length);
+  Array.prototype[0] = "proto";
+  a = [, "x"];
+  assertEquals("x", popHoley(a));
+  assertEquals("proto", popHoley(a));
+  delete Array.prototype[0];
+})();
+
+
+// The popped slot is cleared, so growing the array again exposes no stale
+// values.
+(function testPopThenGrow() {
+  function popThenGrow(a) {
+    var x = a.pop();
+    a.length = 3;
+    return x;
+  }
+  var a = [{}, {}, {}];
+  popThenGrow(a);
+  a = [{}, {}, {}];
+  %OptimizeFunctionOnNextCall(popThenGrow);
+  var last = a[2];
+  assertSame(last, popThenGrow(a));
+  assertFalse(2 in a);
+})();
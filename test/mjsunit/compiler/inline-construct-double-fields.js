@@ -0,0 +1,113 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --inline-construct --track-double-fields
+// Flags: --expose-gc
+
+// Test inlined constructors that store doubles into fields, whose boxes are
+// allocated together with the receiver.
+
+function Point(x, y) {
+  this.x = x;
+  this.y = y;
+  this.tag = "point";
+}
+
+function makePoint(x, y) {
+  return new Point(x, y);
+}
+
+function check(p, x, y) {
+  assertEquals(x, p.x);
+  assertEquals(y, p.y);
+  assertEquals("point", p.tag);
+}
+
+check(makePoint(1.5, 2.5), 1.5, 2.5);
+check(makePoint(3.5, 4.5), 3.5, 4.5);
+%OptimizeFunctionOnNextCall(makePoint);
+var points = [];
+for (var i = 0; i < 100; i++) {
+  points.push(makePoint(i + 0.5, i + 0.25));
+  if (i % 10 == 0) gc();
+}
+for (var i = 0; i < points.length; i++) {
+  check(points[i], i + 0.5, i + 0.25);
+}
+
+// The boxes are not shared between objects or fields.
+var a = makePoint(1.5, 1.5);
+var b = makePoint(1.5, 1.5);
+a.x += 1;
+a.y -= 1;
+check(a, 2.5, 0.5);
+check(b, 1.5, 1.5);
+
+// A constructor that only conditionally adds a double field.
+function Record(value, add_extra) {
+  this.value = value;
+  if (add_extra) this.extra = value * 2;
+  this.done = true;
+}
+
+function makeRecord(value, add_extra) {
+  return new Record(value, add_extra);
+}
+
+makeRecord(0.5, true);
+makeRecord(1.5, true);
+%OptimizeFunctionOnNextCall(makeRecord);
+var r1 = makeRecord(2.5, true);
+var r2 = makeRecord(3.5, false);
+gc();
+assertEquals(2.5, r1.value);
+assertEquals(5, r1.extra);
+assertEquals(3.5, r2.value);
+assertFalse("extra" in r2);
+assertTrue(r2.done);
+
+// Deoptimization in the middle of the constructor.
+function Mixed(x, y) {
+  this.x = x;
+  this.y = y;
+}
+
+function makeMixed(x, y) {
+  return new Mixed(x, y);
+}
+
+makeMixed(0.5, 1.5);
+makeMixed(0.5, 1.5);
+%OptimizeFunctionOnNextCall(makeMixed);
+var m = makeMixed(2.5, 3.5);
+assertEquals(2.5, m.x);
+assertEquals(3.5, m.y);
+m = makeMixed(4.5, "string");
+assertEquals(4.5, m.x);
+assertEquals("string", m.y);
+gc();
+assertEquals(4.5, m.x);
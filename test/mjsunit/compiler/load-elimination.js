@@ -0,0 +1,134 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --use-load-elimination
+
+// Test repeated loads and loads of stored values.
+(function testLoadAfterStore() {
+  function Point(x, y) {
+    this.x = x;
+    this.y = y;
+  }
+  function test(p, v) {
+    var a = p.x + p.x;
+    p.y = v;
+    return a + p.y + p.x;
+  }
+  var p = new Point(1, 2);
+  assertEquals(6, test(p, 3));
+  assertEquals(6, test(p, 3));
+  %OptimizeFunctionOnNextCall(test);
+  assertEquals(7, test(p, 4));
+  assertEquals(4, p.y);
+})();
+
+
+// Test that stores through a possible alias invalidate known values.
+(function testAliasing() {
+  function Box(value) {
+    this.value = value;
+  }
+  function test(a, b) {
+    var before = a.value;
+    b.value = before + 1;
+    return a.value + before;
+  }
+  var a = new Box(1);
+  var b = new Box(1);
+  assertEquals(2, test(a, b));
+  assertEquals(3, test(a, a));
+  %OptimizeFunctionOnNextCall(test);
+  assertEquals(4, test(b, a));
+  assertEquals(5, test(b, b));
+  assertEquals(3, b.value);
+})();
+
+
+// Test that objects with different maps are not aliases, and that the
+// result is still correct when they are the same object.
+(function testDisjointMaps() {
+  function A() { this.f = 1; }
+  function B() { this.f = 2; }
+  function test(a, b) {
+    var x = a.f;
+    b.f = 10;
+    return x + a.f;
+  }
+  var a = new A();
+  var b = new B();
+  assertEquals(2, test(a, b));
+  assertEquals(2, test(a, b));
+  %OptimizeFunctionOnNextCall(test);
+  assertEquals(2, test(a, b));
+  assertEquals(20, test(b, b));
+})();
+
+
+// Test loads in loops that store other fields or call functions.
+(function testLoops() {
+  function Accumulator() {
+    this.step = 1;
+    this.sum = 0;
+  }
+  var callback = function() { };
+  function test(acc, n) {
+    for (var i = 0; i < n; i++) {
+      acc.sum += acc.step;
+      callback(acc);
+    }
+    return acc.sum;
+  }
+  var acc = new Accumulator();
+  assertEquals(3, test(acc, 3));
+  %OptimizeFunctionOnNextCall(test);
+  acc = new Accumulator();
+  assertEquals(5, test(acc, 5));
+  callback = function(acc) { acc.step = 2; };
+  acc = new Accumulator();
+  assertEquals(9, test(acc, 5));
+})();
+
+
+// Test that values are merged correctly at control flow joins.
+(function testJoins() {
+  function Cell(v) {
+    this.v = v;
+  }
+  function test(c, flag, w) {
+    var x = c.v;
+    if (flag) c.v = w;
+    return x + c.v;
+  }
+  var c = new Cell(1);
+  assertEquals(2, test(c, false, 5));
+  assertEquals(6, test(c, true, 5));
+  %OptimizeFunctionOnNextCall(test);
+  c = new Cell(1);
+  assertEquals(2, test(c, false, 5));
+  assertEquals(8, test(c, true, 7));
+  assertEquals(14, test(c, false, 0));
+})();
@@ -0,0 +1,99 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Test that the cached enumeration keys of dictionary-mode objects are
+// dropped whenever the properties of the object change.
+
+function keys(o) {
+  var result = [];
+  for (var key in o) result.push(key);
+  return result;
+}
+
+var o = {};
+for (var i = 0; i < 100; i++) o["k" + i] = i;
+delete o.k0;
+assertFalse(%HasFastProperties(o));
+
+var expected = [];
+for (var i = 1; i < 100; i++) expected.push("k" + i);
+assertEquals(expected, keys(o));
+assertEquals(expected, keys(o));
+assertEquals(expected, Object.keys(o));
+
+// Changing values keeps the keys.
+o.k1 = "changed";
+assertEquals(expected, keys(o));
+
+// Adding properties appends them in insertion order.
+o.added = 1;
+expected.push("added");
+assertEquals(expected, keys(o));
+
+// Deleting properties removes them.
+delete o.k50;
+expected.splice(expected.indexOf("k50"), 1);
+assertEquals(expected, keys(o));
+
+// Re-adding a deleted property puts it last.
+o.k50 = 50;
+expected.push("k50");
+assertEquals(expected, keys(o));
+
+// Making a property non-enumerable hides it.
+Object.defineProperty(o, "k2", { enumerable: false });
+expected.splice(expected.indexOf("k2"), 1);
+assertEquals(expected, keys(o));
+Object.defineProperty(o, "k2", { enumerable: true });
+assertEquals(expected.length + 1, keys(o).length);
+assertTrue(keys(o).indexOf("k2") >= 0);
+
+// Mutating the result of Object.keys does not affect the cache.
+var object_keys = Object.keys(o);
+object_keys[0] = "bogus";
+assertEquals("k1", keys(o)[0]);
+
+// Many deletions regenerate the enumeration indices.
+for (var i = 3; i < 90; i++) delete o["k" + i];
+assertEquals(["k1", "k90", "k91", "k92", "k93", "k94", "k95", "k96", "k97",
+              "k98", "k99", "added", "k2"].sort(), keys(o).sort());
+assertEquals("k1", keys(o)[0]);
+
+// Objects sharing a normalized map do not share the cache.
+var a = {};
+var b = {};
+for (var i = 0; i < 50; i++) {
+  a["a" + i] = i;
+  b["b" + i] = i;
+}
+delete a.a0;
+delete b.b0;
+assertEquals("a1", keys(a)[0]);
+assertEquals("b1", keys(b)[0]);
+assertEquals("a1", keys(a)[0]);
@@ -0,0 +1,92 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax --noalways-opt
+
+// Test the inline cache state summary of functions.
+
+function load(o) {
+  return o.x;
+}
+
+var summary = %GetInlineCacheSummary(load);
+assertEquals("load", summary.name);
+assertEquals(0, summary.monomorphic);
+assertEquals(0, summary.megamorphic);
+assertEquals(0, summary.maps);
+assertEquals([], summary.megamorphicPositions);
+
+load({x: 1});
+load({x: 1});
+summary = %GetInlineCacheSummary(load);
+assertEquals(1, summary.monomorphic);
+assertEquals(1, summary.maps);
+
+load({x: 1, y: 2});
+summary = %GetInlineCacheSummary(load);
+assertEquals(0, summary.monomorphic);
+assertEquals(1, summary.polymorphic);
+assertEquals(2, summary.maps);
+
+var objects = [];
+for (var i = 0; i < 10; i++) {
+  var o = {x: i};
+  o["p" + i] = i;
+  objects.push(o);
+}
+for (var i = 0; i < objects.length; i++) load(objects[i]);
+summary = %GetInlineCacheSummary(load);
+assertEquals(0, summary.polymorphic);
+assertEquals(1, summary.megamorphic);
+assertEquals(1, summary.megamorphicPositions.length);
+assertTrue(summary.megamorphicPositions[0] > 0);
+
+// The summary is plain data.
+var json = JSON.parse(JSON.stringify(summary));
+assertEquals(summary.megamorphic, json.megamorphic);
+assertEquals(summary.optCount, json.optCount);
+assertEquals(summary.deoptCount, json.deoptCount);
+
+// Optimization and deoptimization counts are reported.
+function add(a, b) {
+  return a + b;
+}
+add(1, 2);
+add(1, 2);
+%OptimizeFunctionOnNextCall(add);
+add(1, 2);
+add("a", "b");
+summary = %GetInlineCacheSummary(add);
+assertEquals(%GetOptimizationCount(add), summary.optCount);
+assertTrue(summary.deoptCount <= summary.optCount);
+assertEquals(%GetOptimizationStatus(add) == 1, summary.optimized);
+
+// Functions that have not been compiled have no inline caches.
+function lazy() { return this.y; }
+summary = %GetInlineCacheSummary(lazy);
+assertEquals(0, summary.icTotalCount);
+assertEquals(0, summary.uninitialized);
@@ -0,0 +1,107 @@
+// Copyright 2013 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Flags: --allow-natives-syntax
+
+// Test that the generic keyed load stub returns correct results for unique
+// name keys that are looked up through the stub cache, including loads from
+// the prototype chain, accessors, missing properties and receivers whose
+// maps change after the handlers have been cached.
+
+function load(o, key) {
+  return o[key];
+}
+
+function Proto() {}
+Proto.prototype.inherited = "inherited";
+Object.defineProperty(Proto.prototype, "getter", {
+  get: function() { return this.a + 1; }
+});
+
+var keys = ["a", "b", "c", "inherited", "getter", "missing"];
+
+function makeRecord(i) {
+  var o = new Proto();
+  o.a = i;
+  o.b = "b" + i;
+  // Give every fifth record a different shape.
+  if (i % 5 == 0) o["x" + i] = i;
+  o.c = i * 2;
+  return o;
+}
+
+var records = [];
+for (var i = 0; i < 50; i++) records.push(makeRecord(i));
+
+function check(o, i) {
+  assertEquals(i, load(o, "a"));
+  assertEquals("b" + i, load(o, "b"));
+  assertEquals(i * 2, load(o, "c"));
+  assertEquals("inherited", load(o, "inherited"));
+  assertEquals(i + 1, load(o, "getter"));
+  assertEquals(undefined, load(o, "missing"));
+}
+
+// Mix in smi keys so the site goes generic.
+var array = [1, 2, 3];
+assertEquals(2, load(array, 1));
+
+for (var round = 0; round < 3; round++) {
+  for (var i = 0; i < records.length; i++) check(records[i], i);
+  if (round == 1) %OptimizeFunctionOnNextCall(load);
+}
+
+// Changes to the prototype chain invalidate the cached handlers.
+Proto.prototype.missing = "found";
+Proto.prototype.inherited = "changed";
+for (var i = 0; i < records.length; i++) {
+  assertEquals("found", load(records[i], "missing"));
+  assertEquals("changed", load(records[i], "inherited"));
+}
+
+// Changing the receiver's map is noticed as well.
+var o = records[3];
+delete o.b;
+assertEquals(undefined, load(o, "b"));
+o.b = "again";
+assertEquals("again", load(o, "b"));
+
+// Functions and dictionary-mode receivers.
+function f() {}
+assertEquals(f.prototype, load(f, "prototype"));
+assertEquals(0, load(f, "length"));
+var dict = {};
+for (var i = 0; i < 100; i++) dict["k" + i] = i;
+delete dict.k0;
+for (var i = 1; i < 100; i++) assertEquals(i, load(dict, "k" + i));
+assertEquals(undefined, load(dict, "k0"));
+
+// String keys that are not internalized and numeric strings.
+for (var i = 0; i < 10; i++) {
+  assertEquals(i, load(records[i], "a" + ""));
+  assertEquals(3, load(array, "" + 2));
+}
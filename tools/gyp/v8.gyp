@@ -305,6 +305,8 @@
         '../../src/full-codegen.h',
         '../../src/func-name-inferrer.cc',
         '../../src/func-name-inferrer.h',
+        '../../src/gc-idle-time-handler.cc',
+        '../../src/gc-idle-time-handler.h',
         '../../src/gdb-jit.cc',
         '../../src/gdb-jit.h',
         '../../src/global-handles.cc',
@@ -322,10 +324,15 @@
         '../../src/heap-snapshot-generator.h',
         '../../src/heap.cc',
         '../../src/heap.h',
+        '../../src/hydrogen-alias-analysis.h',
         '../../src/hydrogen-environment-liveness.cc',
         '../../src/hydrogen-environment-liveness.h',
+        '../../src/hydrogen-escape-analysis.cc',
+        '../../src/hydrogen-escape-analysis.h',
         '../../src/hydrogen-instructions.cc',
         '../../src/hydrogen-instructions.h',
+        '../../src/hydrogen-load-elimination.cc',
+        '../../src/hydrogen-load-elimination.h',
         '../../src/hydrogen.cc',
         '../../src/hydrogen.h',
         '../../src/hydrogen-gvn.cc',
@@ -380,6 +387,8 @@
         '../../src/once.h',
         '../../src/optimizing-compiler-thread.h',
         '../../src/optimizing-compiler-thread.cc',
+        '../../src/parallel-scavenger.cc',
+        '../../src/parallel-scavenger.h',
         '../../src/parser.cc',
         '../../src/parser.h',
         '../../src/platform-posix.h',
@@ -387,6 +396,8 @@
         '../../src/platform-tls-win32.h',
         '../../src/platform-tls.h',
         '../../src/platform.h',
+        '../../src/preparse-data-cache.cc',
+        '../../src/preparse-data-cache.h',
         '../../src/preparse-data-format.h',
         '../../src/preparse-data.cc',
         '../../src/preparse-data.h',
@@ -423,10 +434,14 @@
         '../../src/scanner-character-streams.h',
         '../../src/scanner.cc',
         '../../src/scanner.h',
+        '../../src/scavenger-thread.cc',
+        '../../src/scavenger-thread.h',
         '../../src/scopeinfo.cc',
         '../../src/scopeinfo.h',
         '../../src/scopes.cc',
         '../../src/scopes.h',
+        '../../src/script-code-cache.cc',
+        '../../src/script-code-cache.h',
         '../../src/serialize.cc',
         '../../src/serialize.h',
         '../../src/small-pointer-list.h',